@@ -33,6 +33,9 @@ main (int argc, char *argv[]){
 
 	std::string parameterFileName="parametros.txt"; //Nombre por defecto del archivo de parametros
 	uint64_t runNumber=0; //RunNumber
+	uint32_t replications=0; //Cantidad de replicas a ejecutar en este proceso (0 = ejecucion simple)
+	uint32_t workers=1; //Cantidad de replicas a ejecutar en paralelo
+	std::string sweepFileName; //Archivo de barrido de parametros (Vacio = sin barrido)
 	if (argc>=2){
 		runNumber = atoll(argv[1]);
 		RngSeedManager::SetRun(runNumber);
@@ -40,6 +43,35 @@ main (int argc, char *argv[]){
 	if (argc>=3){
 		parameterFileName=argv[2];
 	}
+	if (argc>=4){
+		replications=atoi(argv[3]);
+	}
+	if (argc>=5){
+		workers=atoi(argv[4]);
+	}
+	if (argc>=6){
+		sweepFileName=argv[5];
+	}
+
+	if(!sweepFileName.empty()){
+		/* Barrido: las replicas de cada combinacion de valores del archivo de barrido
+		 * se reparten en "workers" procesos (0 = uno por nucleo), ver ArapSweep
+		 */
+		ArapSweep sweep(parameterFileName,sweepFileName,replications,workers);
+		sweep.Run();
+		NS_LOG_UNCOND ("Simulador Arap - FIN BARRIDO");
+		return 0;
+	}
+
+	if(replications>0){
+		/* Las replicas usan los numeros de ejecucion runNumber, runNumber+1, ...
+		 * y al finalizar se combinan sus salidas (Ver ArapReplications)
+		 */
+		ArapReplications replicas(parameterFileName,replications,workers);
+		replicas.Run();
+		NS_LOG_UNCOND ("Simulador Arap - FIN REPLICAS");
+		return 0;
+	}
 
 	/* En ArapSimulator::ConfigSimulator se realiza la creación y
 	 * configuración de la red y las aplicaciones, en los nodos a simular.
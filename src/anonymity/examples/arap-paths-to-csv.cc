@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/core-module.h"
+#include "ns3/arap-path-logger.h"
+
+// Convierte un archivo de caminos de hormigas de carga en formato binario
+// ("formato-caminos binario") al formato CSV usado por defecto.
+//
+// Uso: arap-paths-to-csv --entrada=<archivo.bin> [--salida=<archivo.csv>]
+//
+// Si no se indica el archivo de salida, se usa el mismo nombre de la entrada
+// cambiando la extension por ".csv".
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ArapPathsToCsv");
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("entrada", "Archivo de caminos en formato binario", input);
+  cmd.AddValue ("salida", "Archivo CSV a crear", output);
+  cmd.Parse (argc,argv);
+
+  if (input.empty ())
+    {
+      NS_LOG_UNCOND ("Debe indicar el archivo de entrada con --entrada=<archivo.bin>");
+      return 1;
+    }
+  if (output.empty ())
+    {
+      output = input;
+      std::string::size_type dot = output.rfind (".bin");
+      if (dot != std::string::npos)
+        {
+          output.erase (dot);
+        }
+      output += ".csv";
+    }
+
+  if (!ArapPathLogger::ConvertToCsv (input, output))
+    {
+      NS_LOG_UNCOND ("No se pudo convertir el archivo " << input);
+      return 1;
+    }
+  NS_LOG_UNCOND ("Archivo convertido: " << output);
+  return 0;
+}
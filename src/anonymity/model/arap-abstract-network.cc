@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-abstract-network.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapAbstractNetwork");
+
+ArapAbstractNetwork::ArapAbstractNetwork()
+:m_queueSize(0){
+}
+
+ArapAbstractNetwork::~ArapAbstractNetwork(){
+}
+
+void
+ArapAbstractNetwork::Build(uint32_t numNodes, uint64_t hubDataRate){
+	m_uplinks.assign(numNodes,LinkQueue());
+	m_downlinks.assign(numNodes,LinkQueue());
+	m_linkDelays.assign(numNodes,Time(0));
+	m_delayProcesses.clear();
+	for(uint32_t i=0;i<numNodes;i++)
+		m_downlinks[i].dataRate = hubDataRate;
+	NS_LOG_INFO("Red abstracta creada con "<<numNodes<<" nodos");
+}
+
+void
+ArapAbstractNetwork::SetDataRate(uint32_t index, uint64_t dataRate){
+	NS_ABORT_MSG_IF(dataRate==0,"ERROR: El DataRate del nodo "<<index<<" debe ser mayor a cero");
+	m_uplinks[index].dataRate = dataRate;
+}
+
+void
+ArapAbstractNetwork::SetLinkDelay(uint32_t index, const Time& delay){
+	m_linkDelays[index] = delay;
+}
+
+void
+ArapAbstractNetwork::SetDelayProcesses(const std::vector<Ptr<ArapDelayProcess> >& processes){
+	NS_ABORT_MSG_IF(processes.size()!=m_linkDelays.size(),"ERROR: Se requiere un proceso de delay por enlace");
+	m_delayProcesses = processes;
+}
+
+void
+ArapAbstractNetwork::SetQueueSize(uint32_t packets){
+	m_queueSize = packets;
+}
+
+double
+ArapAbstractNetwork::Enqueue(LinkQueue& queue, double bits){
+	double now = Simulator::Now().GetSeconds();
+	queue.load *= std::exp((queue.lastArrival-now)/ABSTRACT_RATE_TIME_CONSTANT);
+	queue.lastArrival = now;
+	double utilization = std::min(queue.load/(ABSTRACT_RATE_TIME_CONSTANT*queue.dataRate),ABSTRACT_MAX_UTILIZATION);
+	queue.load += bits;
+
+	double service = bits/queue.dataRate;
+	double wait = service*utilization/(1-utilization);
+	if(m_queueSize>0)
+		wait = std::min(wait,service*m_queueSize);
+	return service+wait;
+}
+
+Time
+ArapAbstractNetwork::Deliver(LinkQueue& queue, Time delivery){
+	if(delivery<queue.lastDelivery)
+		delivery = queue.lastDelivery;
+	queue.lastDelivery = delivery;
+	return delivery;
+}
+
+Time
+ArapAbstractNetwork::Transmit(uint32_t source, uint32_t target, uint32_t bytes){
+	double bits = (bytes+ABSTRACT_HEADER_BYTES)*8.0;
+	Time now = Simulator::Now();
+	Time sourceDelay = m_delayProcesses.empty() ? m_linkDelays[source] : m_delayProcesses[source]->GetDelay(now);
+	Time targetDelay = m_delayProcesses.empty() ? m_linkDelays[target] : m_delayProcesses[target]->GetDelay(now);
+	/* Si el delay o la espera bajaron desde el envío anterior, la hormiga espera a la
+	 * anterior de la misma cola en lugar de adelantarla
+	 */
+	Time hub = Deliver(m_uplinks[source],now+Seconds(Enqueue(m_uplinks[source],bits))+sourceDelay);
+	Time arrival = Deliver(m_downlinks[target],hub+Seconds(Enqueue(m_downlinks[target],bits))+targetDelay);
+	return arrival-now;
+}
+
+} /* namespace ns3 */
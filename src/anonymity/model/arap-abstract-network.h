@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_ABSTRACT_NETWORK_H
+#define ARAP_ABSTRACT_NETWORK_H
+
+#include "ns3/nstime.h"
+#include "arap-delay-channel.h"
+#include <stdint.h>
+#include <vector>
+
+#define ABSTRACT_HEADER_BYTES 42 //!< Bytes de las cabeceras PPP (2), IPv4 (20) y TCP (20) que se suman a cada hormiga en el motor abstracto
+#define ABSTRACT_RATE_TIME_CONSTANT 1.0 //!< Constante de tiempo (Segundos) del promedio exponencial del tráfico de cada cola del motor abstracto
+#define ABSTRACT_MAX_UTILIZATION 0.99 //!< Máxima utilización de una cola considerada en la estimación de la espera
+
+namespace ns3 {
+
+/**
+ * Red del motor abstracto (Ver PARAM_ENGINE): reemplaza a la topología, la pila TCP/IP y los
+ * dispositivos punto a punto por un modelo analítico del tiempo de cada salto de las hormigas.
+ *
+ * La red es una estrella: cada nodo tiene un enlace con el hub, y un salto de A hacia B pasa
+ * por la cola de subida de A (Hacia el hub, con el DataRate de A) y la cola de bajada hacia B
+ * (Con el DataRate del hub). En cada cola el tiempo es el de serialización más la espera
+ * estimada de una cola M/M/1, ρ/(1-ρ) veces el tiempo de serialización, acotada por el tamaño
+ * máximo de la cola. La utilización ρ se estima con el promedio exponencial de los bits que
+ * llegaron a la cola (Constante de tiempo ABSTRACT_RATE_TIME_CONSTANT), registrando cada hormiga
+ * en el instante de su envío. A esto se suma el delay de propagación de ambos enlaces, que se
+ * cambia periódicamente igual que en la red de paquetes (ArapSimulator::ChangeLinkDelay()) o,
+ * con SetDelayProcesses(), se obtiene del proceso de cada enlace en el instante del envío.
+ *
+ * Las hormigas no se pierden ni se reordenan por la red, como con TCP: como la espera y el
+ * delay cambian entre envíos, la salida de cada cola se acota para que no sea anterior a la de
+ * la hormiga previa de la misma cola (Cada cola es FIFO), por lo que todas las hormigas hacia
+ * un nodo llegan en el orden en que se enviaron.
+ */
+class ArapAbstractNetwork {
+
+public:
+
+	ArapAbstractNetwork();
+	~ArapAbstractNetwork();
+
+	/**
+	 * Crea los enlaces de los nodos, sin delay y sin tráfico.
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red
+	 *
+	 * @param[in] hubDataRate DataRate (bps) de las colas de bajada del hub
+	 */
+	void Build(uint32_t numNodes, uint64_t hubDataRate);
+
+	/**
+	 * @param[in] index Índice del nodo en ArapNodeDirectory
+	 *
+	 * @param[in] dataRate DataRate (bps) de la cola de subida del nodo
+	 */
+	void SetDataRate(uint32_t index, uint64_t dataRate);
+
+	/**
+	 * @param[in] index Índice del nodo en ArapNodeDirectory
+	 *
+	 * @param[in] delay Delay de propagación del enlace del nodo con el hub
+	 */
+	void SetLinkDelay(uint32_t index, const Time& delay);
+
+	/**
+	 * Reemplaza los delays fijados con SetLinkDelay() por procesos evaluados en cada envío.
+	 *
+	 * @param[in] processes Proceso del delay de propagación del enlace de cada nodo
+	 */
+	void SetDelayProcesses(const std::vector<Ptr<ArapDelayProcess> >& processes);
+
+	/**
+	 * @param[in] packets Tamaño máximo (En paquetes) de las colas, 0 = sin límite
+	 */
+	void SetQueueSize(uint32_t packets);
+
+	/**
+	 * Registra el envío de una hormiga y calcula el tiempo hasta su llegada.
+	 *
+	 * @param[in] source Índice del nodo que envía
+	 *
+	 * @param[in] target Índice del nodo que recibe
+	 *
+	 * @param[in] bytes Tamaño de la hormiga (Sin cabeceras)
+	 *
+	 * @return Tiempo desde el envío hasta la recepción (Nunca antes que la hormiga anterior
+	 * enviada por la misma cola de subida o recibida por la misma cola de bajada)
+	 */
+	Time Transmit(uint32_t source, uint32_t target, uint32_t bytes);
+
+private:
+
+	/**
+	 * Cola de un sentido de un enlace.
+	 */
+	struct LinkQueue {
+		double dataRate; //!< DataRate (bps)
+		double load; //!< Bits recibidos, con peso exponencial según su antigüedad
+		double lastArrival; //!< Instante (Segundos) del último registro de tráfico
+		Time lastDelivery; //!< Instante en que la última hormiga llegó al final del enlace (Hub o nodo destino)
+
+		LinkQueue():dataRate(0),load(0),lastArrival(0),lastDelivery(0){};
+	};
+
+	/**
+	 * Registra una hormiga en una cola y calcula su tiempo en ella.
+	 *
+	 * @param[in,out] queue Cola
+	 *
+	 * @param[in] bits Tamaño de la hormiga con las cabeceras
+	 *
+	 * @return Tiempo de serialización más la espera estimada (Segundos)
+	 */
+	double Enqueue(LinkQueue& queue, double bits);
+
+	/**
+	 * Acota el instante de llegada al final del enlace de una cola para que no sea anterior
+	 * al de la hormiga previa (FIFO), y lo registra.
+	 *
+	 * @param[in,out] queue Cola
+	 *
+	 * @param[in] delivery Instante de llegada calculado
+	 *
+	 * @return Instante de llegada acotado
+	 */
+	Time Deliver(LinkQueue& queue, Time delivery);
+
+	std::vector<LinkQueue> m_uplinks; //!< Cola de subida de cada nodo (Posición: índice en ArapNodeDirectory)
+	std::vector<LinkQueue> m_downlinks; //!< Cola de bajada del hub hacia cada nodo
+	std::vector<Time> m_linkDelays; //!< Delay de propagación del enlace de cada nodo
+	std::vector<Ptr<ArapDelayProcess> > m_delayProcesses; //!< Proceso del delay de cada enlace (Vacío = se usa m_linkDelays)
+	uint32_t m_queueSize; //!< Tamaño máximo (En paquetes) de las colas
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_ABSTRACT_NETWORK_H */
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-anonymity-metrics.h"
+#include "ns3/log.h"
+#include <fstream>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapAnonymityMetrics");
+
+/**
+ * @param[in] c Conteo
+ *
+ * @return c·log2(c), 0 si c=0
+ */
+static double
+CLogC(uint64_t c){
+	return (c==0) ? 0 : c*std::log((double)c)/std::log(2.0);
+}
+
+ArapAnonymityMetrics::ArapAnonymityMetrics()
+:m_totalPaths(0){
+}
+
+ArapAnonymityMetrics::~ArapAnonymityMetrics(){
+}
+
+void
+ArapAnonymityMetrics::Record(const std::list<Ipv4Address>& path, const ArapNodeDirectory& directory){
+	if(m_targets.empty()){
+		m_targets.assign(directory.GetCount(),TargetMetrics());
+		m_intermediateUsage.assign(directory.GetCount(),0);
+	}
+	TargetMetrics& target = m_targets[directory.GetIndex(path.back())];
+	if(target.usage.empty())
+		target.usage.assign(directory.GetCount(),0);
+
+	uint64_t hash = 14695981039346656037ULL; //FNV-1a de la secuencia de intermedios
+	std::list<Ipv4Address>::const_iterator last = --path.end();
+	for(std::list<Ipv4Address>::const_iterator it = path.begin();it!=last;it++){
+		uint32_t index = directory.GetIndex(*it);
+		uint64_t& count = target.usage[index];
+		target.sumCLogC += CLogC(count+1)-CLogC(count);
+		if(count==0)
+			target.used++;
+		count++;
+		if(count>target.maxUsage)
+			target.maxUsage = count;
+		target.choices++;
+		m_intermediateUsage[index]++;
+		hash = (hash^index)*1099511628211ULL;
+	}
+	target.distinctPaths.Add(hash);
+	target.paths++;
+	m_totalPaths++;
+}
+
+uint64_t
+ArapAnonymityMetrics::GetPathCount(uint32_t targetIndex) const{
+	return m_targets.empty() ? 0 : m_targets[targetIndex].paths;
+}
+
+uint64_t
+ArapAnonymityMetrics::GetDistinctPathCount(uint32_t targetIndex) const{
+	return m_targets.empty() ? 0 : m_targets[targetIndex].distinctPaths.GetCount();
+}
+
+uint32_t
+ArapAnonymityMetrics::GetUsedIntermediates(uint32_t targetIndex) const{
+	return m_targets.empty() ? 0 : m_targets[targetIndex].used;
+}
+
+double
+ArapAnonymityMetrics::GetEntropy(uint32_t targetIndex) const{
+	if(m_targets.empty() || m_targets[targetIndex].choices==0)
+		return 0;
+	const TargetMetrics& target = m_targets[targetIndex];
+	double entropy = std::log((double)target.choices)/std::log(2.0)-target.sumCLogC/target.choices;
+	return (entropy>0) ? entropy : 0; //Evita valores negativos por redondeo con un solo intermedio
+}
+
+double
+ArapAnonymityMetrics::GetMinEntropy(uint32_t targetIndex) const{
+	if(m_targets.empty() || m_targets[targetIndex].choices==0)
+		return 0;
+	const TargetMetrics& target = m_targets[targetIndex];
+	return std::log((double)target.choices/target.maxUsage)/std::log(2.0);
+}
+
+uint64_t
+ArapAnonymityMetrics::GetIntermediateUsage(uint32_t intermediateIndex) const{
+	return m_intermediateUsage.empty() ? 0 : m_intermediateUsage[intermediateIndex];
+}
+
+uint64_t
+ArapAnonymityMetrics::GetTotalPaths() const{
+	return m_totalPaths;
+}
+
+void
+ArapAnonymityMetrics::Print(const std::string& filename, const Ipv4Address& localIP, const ArapNodeDirectory& directory) const{
+	std::ofstream file (filename.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+filename);
+		return;
+	}
+	uint32_t localIndex = directory.GetIndex(localIP);
+	uint32_t numNodes = directory.GetCount();
+	//Los candidatos a intermedio son todos los nodos menos el local y el destino
+	double maxEntropy = (numNodes>3) ? std::log((double)(numNodes-2))/std::log(2.0) : 0;
+
+	file<<" ";
+	for(uint32_t i=0;i<numNodes;i++){
+		if(i!=localIndex)
+			file<<","<<directory.GetAddress(i);
+	}
+	file<<",Caminos,\"Caminos distintos\",\"Intermedios usados\",Entropia,\"Entropia normalizada\",Min-entropia\n";
+
+	for(uint32_t i=0;i<numNodes;i++){
+		if(i==localIndex)
+			continue;
+		file<<directory.GetAddress(i);
+		for(uint32_t j=0;j<numNodes;j++){
+			if(j==localIndex)
+				continue;
+			bool recorded = !m_targets.empty() && !m_targets[i].usage.empty();
+			file<<","<<(recorded ? m_targets[i].usage[j] : 0);
+		}
+		double entropy = GetEntropy(i);
+		file<<","<<GetPathCount(i)<<","<<GetDistinctPathCount(i)<<","<<GetUsedIntermediates(i)<<","<<entropy
+				<<","<<((maxEntropy>0) ? entropy/maxEntropy : 0)<<","<<GetMinEntropy(i)<<"\n";
+	}
+	file.close();
+}
+
+} /* namespace ns3 */
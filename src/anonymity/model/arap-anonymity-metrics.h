@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_ANONYMITY_METRICS_H
+#define ARAP_ANONYMITY_METRICS_H
+
+#include "ns3/ipv4-address.h"
+#include "arap-node-directory.h"
+#include "distinct-counter.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+
+namespace ns3 {
+
+/**
+ * Métricas de anonimato de los caminos de las hormigas de carga de un nodo, calculadas en
+ * memoria a medida que se crean los caminos en lugar de procesar el registro de caminos.
+ *
+ * Para cada destino se cuenta cuántas veces se eligió cada nodo como intermedio (En cualquier
+ * posición del camino), y con esos conteos se mantienen de manera incremental:
+ * - Entropía de Shannon (bits) de la elección de intermedios: log2(T) - S/T, con T el total de
+ *   elecciones y S la suma de c·log2(c) de los conteos, que se actualiza en O(1) por salto.
+ * - Min-entropía (bits): log2(T) - log2(máximo conteo).
+ * - Diversidad: cantidad de caminos distintos (Secuencias de intermedios) y de intermedios usados.
+ *   Los caminos distintos se cuentan con un DistinctCounter por destino (Memoria acotada aunque
+ *   se registren millones de caminos): el conteo es exacto hasta DISTINCT_EXACT_LIMIT caminos
+ *   distintos y estimado a partir de ahí.
+ *
+ * Además se cuentan las elecciones de cada nodo como intermedio sumando todos los destinos.
+ *
+ * @see PARAM_ANONYMITY_METRICS
+ */
+class ArapAnonymityMetrics {
+
+public:
+
+	ArapAnonymityMetrics();
+	~ArapAnonymityMetrics();
+
+	/**
+	 * Registra el camino de una hormiga de carga.
+	 *
+	 * @param[in] path Camino (Intermedios en orden, el último elemento es el destino)
+	 *
+	 * @param[in] directory Directorio de los nodos de la red
+	 */
+	void Record(const std::list<Ipv4Address>& path, const ArapNodeDirectory& directory);
+
+	/**
+	 * @param[in] targetIndex Índice del destino
+	 *
+	 * @return Cantidad de caminos registrados hacia el destino
+	 */
+	uint64_t GetPathCount(uint32_t targetIndex) const;
+
+	/**
+	 * @param[in] targetIndex Índice del destino
+	 *
+	 * @return Cantidad de caminos distintos hacia el destino (Estimada si supera DISTINCT_EXACT_LIMIT)
+	 */
+	uint64_t GetDistinctPathCount(uint32_t targetIndex) const;
+
+	/**
+	 * @param[in] targetIndex Índice del destino
+	 *
+	 * @return Cantidad de nodos elegidos al menos una vez como intermedio hacia el destino
+	 */
+	uint32_t GetUsedIntermediates(uint32_t targetIndex) const;
+
+	/**
+	 * @param[in] targetIndex Índice del destino
+	 *
+	 * @return Entropía de Shannon (bits) de la elección de intermedios hacia el destino
+	 */
+	double GetEntropy(uint32_t targetIndex) const;
+
+	/**
+	 * @param[in] targetIndex Índice del destino
+	 *
+	 * @return Min-entropía (bits) de la elección de intermedios hacia el destino
+	 */
+	double GetMinEntropy(uint32_t targetIndex) const;
+
+	/**
+	 * @param[in] intermediateIndex Índice del nodo
+	 *
+	 * @return Cantidad de veces que el nodo se eligió como intermedio (Todos los destinos)
+	 */
+	uint64_t GetIntermediateUsage(uint32_t intermediateIndex) const;
+
+	/**
+	 * @return Cantidad de caminos registrados
+	 */
+	uint64_t GetTotalPaths() const;
+
+	/**
+	 * Escribe las métricas de cada destino en un archivo CSV con el formato de las tablas de
+	 * probabilidad: una fila por destino con los conteos de cada intermedio y las métricas.
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[in] localIP IP del nodo dueño de las métricas (Se omite su fila y su columna)
+	 *
+	 * @param[in] directory Directorio de los nodos de la red
+	 */
+	void Print(const std::string& filename, const Ipv4Address& localIP, const ArapNodeDirectory& directory) const;
+
+private:
+
+	/**
+	 * Métricas de los caminos hacia un destino.
+	 */
+	struct TargetMetrics {
+		std::vector<uint64_t> usage; //!< Elecciones de cada nodo como intermedio (Vacío hasta el primer camino)
+		uint64_t paths; //!< Caminos registrados
+		uint64_t choices; //!< Total de elecciones de intermedios (T)
+		double sumCLogC; //!< Suma de c·log2(c) de los conteos (S)
+		uint64_t maxUsage; //!< Máximo conteo
+		uint32_t used; //!< Intermedios con conteo mayor a cero
+		DistinctCounter distinctPaths; //!< Conteo de los hashes de los caminos distintos
+
+		TargetMetrics():paths(0),choices(0),sumCLogC(0),maxUsage(0),used(0){};
+	};
+
+	std::vector<TargetMetrics> m_targets; //!< Métricas de cada destino (Posición: índice en ArapNodeDirectory)
+	std::vector<uint64_t> m_intermediateUsage; //!< Elecciones de cada nodo como intermedio (Todos los destinos)
+	uint64_t m_totalPaths; //!< Caminos registrados
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_ANONYMITY_METRICS_H */
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-ant-header.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapAntHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (ArapAntHeader);
+
+const uint32_t ArapAntHeader::MEDIUM_LAYER_SIZE;
+const uint32_t ArapAntHeader::FINAL_LAYER_SIZE;
+
+ArapAntHeader::ArapAntHeader()
+:m_antID(0), m_layerType(LAYER_MEDIUM), m_layerSize(0), m_antType(ANT_EXPLORER), m_sendTime(0), m_messageSize(0){
+}
+
+ArapAntHeader::~ArapAntHeader(){
+}
+
+TypeId
+ArapAntHeader::GetTypeId (void){
+	static TypeId tid = TypeId ("ns3::ArapAntHeader")
+		.SetParent<Header> ()
+		.SetGroupName ("Anonymity")
+		.AddConstructor<ArapAntHeader> ();
+	return tid;
+}
+
+TypeId
+ArapAntHeader::GetInstanceTypeId (void) const{
+	return GetTypeId ();
+}
+
+void
+ArapAntHeader::Print (std::ostream &os) const{
+	os<<"id="<<m_antID;
+	if(IsMedium())
+		os<<" MEDIO siguiente="<<m_nextHop<<" capas="<<m_layerSize;
+	else
+		os<<" FINAL hormiga="<<((m_antType==ANT_LOAD) ? "carga" : "exploradora")
+			<<" envio="<<m_sendTime<<" destino="<<m_target<<" mensaje="<<m_messageSize;
+}
+
+uint32_t
+ArapAntHeader::GetSerializedSize (void) const{
+	return IsMedium() ? MEDIUM_LAYER_SIZE : FINAL_LAYER_SIZE;
+}
+
+void
+ArapAntHeader::Serialize (Buffer::Iterator start) const{
+	Buffer::Iterator i = start;
+	i.WriteHtonU64(m_antID);
+	i.WriteU8(m_layerType);
+	if(IsMedium()){
+		i.WriteHtonU32(m_nextHop.Get());
+		i.WriteHtonU32(m_layerSize);
+	}
+	else{
+		i.WriteU8(m_antType);
+		i.WriteHtonU64(m_sendTime);
+		i.WriteHtonU32(m_target.Get());
+		i.WriteHtonU32(m_messageSize);
+	}
+}
+
+uint32_t
+ArapAntHeader::Deserialize (Buffer::Iterator start){
+	Buffer::Iterator i = start;
+	m_antID = i.ReadNtohU64();
+	m_layerType = i.ReadU8();
+	if(IsMedium()){
+		m_nextHop.Set(i.ReadNtohU32());
+		m_layerSize = i.ReadNtohU32();
+	}
+	else{
+		m_antType = i.ReadU8();
+		m_sendTime = i.ReadNtohU64();
+		m_target.Set(i.ReadNtohU32());
+		m_messageSize = i.ReadNtohU32();
+	}
+	return i.GetDistanceFrom(start);
+}
+
+void
+ArapAntHeader::SetMediumLayer(uint64_t antID, const Ipv4Address& nextHop, uint32_t layerSize){
+	m_antID = antID;
+	m_layerType = LAYER_MEDIUM;
+	m_nextHop = nextHop;
+	m_layerSize = layerSize;
+}
+
+void
+ArapAntHeader::SetFinalLayer(uint64_t antID, AntType antType, uint64_t sendTime, const Ipv4Address& target, uint32_t messageSize){
+	m_antID = antID;
+	m_layerType = LAYER_FINAL;
+	m_antType = antType;
+	m_sendTime = sendTime;
+	m_target = target;
+	m_messageSize = messageSize;
+}
+
+uint64_t
+ArapAntHeader::GetAntID() const{
+	return m_antID;
+}
+
+ArapAntHeader::LayerType
+ArapAntHeader::GetLayerType() const{
+	return (LayerType)m_layerType;
+}
+
+bool
+ArapAntHeader::IsMedium() const{
+	return m_layerType==LAYER_MEDIUM;
+}
+
+bool
+ArapAntHeader::IsFinal() const{
+	return m_layerType==LAYER_FINAL;
+}
+
+const Ipv4Address&
+ArapAntHeader::GetNextHop() const{
+	return m_nextHop;
+}
+
+uint32_t
+ArapAntHeader::GetLayerSize() const{
+	return m_layerSize;
+}
+
+ArapAntHeader::AntType
+ArapAntHeader::GetAntType() const{
+	return (AntType)m_antType;
+}
+
+uint64_t
+ArapAntHeader::GetSendTime() const{
+	return m_sendTime;
+}
+
+const Ipv4Address&
+ArapAntHeader::GetTarget() const{
+	return m_target;
+}
+
+uint32_t
+ArapAntHeader::GetMessageSize() const{
+	return m_messageSize;
+}
+
+} /* namespace ns3 */
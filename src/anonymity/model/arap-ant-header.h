@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_ANT_HEADER_H
+#define ARAP_ANT_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+/**
+ * Cabecera de una capa de la hormiga (Una capa por cada nodo del camino).
+ *
+ * Todas las capas inician con el ID de la hormiga y un Byte con el tipo de capa:
+ * - Capa de nodo intermedio: IP del siguiente salto y tamaño en Bytes del resto de las capas.
+ * - Capa de nodo final: tipo de hormiga (1 Byte), tiempo de envio, IP destino y tamaño del
+ * mensaje que sigue a la cabecera.
+ *
+ * Todos los campos son de tamaño fijo y se escriben en orden de red, por lo que el tamaño
+ * de la cabecera solo depende del tipo de capa. Al ser una %ns3::Header, la capa se muestra
+ * decodificada en las trazas ".tr" y ".pcap".
+ */
+class ArapAntHeader : public Header {
+
+public:
+
+	/**
+	 * Tipos de capa.
+	 */
+	enum LayerType{LAYER_MEDIUM=1, LAYER_FINAL=2};
+
+	/**
+	 * Tipos de hormiga (Solo en las capas de nodo final).
+	 */
+	enum AntType{ANT_EXPLORER=0, ANT_LOAD=1};
+
+	ArapAntHeader();
+	virtual ~ArapAntHeader();
+
+	/**
+	 * Método requerido por el sistema de tipos de NS3.
+	 *
+	 * @return TypeId de la cabecera
+	 */
+	static TypeId GetTypeId (void);
+	virtual TypeId GetInstanceTypeId (void) const;
+	virtual void Print (std::ostream &os) const;
+	virtual uint32_t GetSerializedSize (void) const;
+	virtual void Serialize (Buffer::Iterator start) const;
+	virtual uint32_t Deserialize (Buffer::Iterator start);
+
+	/**
+	 * Configura la cabecera como capa de nodo intermedio.
+	 *
+	 * @param[in] antID ID de la hormiga
+	 *
+	 * @param[in] nextHop IP del siguiente salto
+	 *
+	 * @param[in] layerSize Tamaño en Bytes del resto de las capas
+	 */
+	void SetMediumLayer(uint64_t antID, const Ipv4Address& nextHop, uint32_t layerSize);
+
+	/**
+	 * Configura la cabecera como capa de nodo final.
+	 *
+	 * @param[in] antID ID de la hormiga
+	 *
+	 * @param[in] antType Tipo de hormiga
+	 *
+	 * @param[in] sendTime Tiempo (En pasos de tiempo de NS3) en que se envió la hormiga original
+	 *
+	 * @param[in] target IP del nodo destino
+	 *
+	 * @param[in] messageSize Tamaño en Bytes del mensaje que sigue a la cabecera
+	 */
+	void SetFinalLayer(uint64_t antID, AntType antType, uint64_t sendTime, const Ipv4Address& target, uint32_t messageSize);
+
+	/** \addtogroup CamposCabecera Campos de la cabecera de una capa
+	 * @{
+	 */
+	uint64_t GetAntID() const; //!< ID de hormiga
+	LayerType GetLayerType() const; //!< Tipo de capa
+	bool IsMedium() const; //!< true si es una capa de nodo intermedio
+	bool IsFinal() const; //!< true si es una capa de nodo final
+	const Ipv4Address& GetNextHop() const; //!< IP del siguiente salto (Capa intermedia)
+	uint32_t GetLayerSize() const; //!< Tamaño en Bytes del resto de las capas (Capa intermedia)
+	AntType GetAntType() const; //!< Tipo de hormiga (Capa final)
+	uint64_t GetSendTime() const; //!< Tiempo de envio (Capa final)
+	const Ipv4Address& GetTarget() const; //!< IP destino (Capa final)
+	uint32_t GetMessageSize() const; //!< Tamaño en Bytes del mensaje (Capa final)
+	/** @} */
+
+	/**
+	 * Tamaño en Bytes de una capa de nodo intermedio.
+	 */
+	static const uint32_t MEDIUM_LAYER_SIZE = sizeof(uint64_t)+1+4+sizeof(uint32_t);
+
+	/**
+	 * Tamaño en Bytes de la cabecera de una capa de nodo final (Sin el mensaje).
+	 */
+	static const uint32_t FINAL_LAYER_SIZE = sizeof(uint64_t)+1+1+sizeof(uint64_t)+4+sizeof(uint32_t);
+
+private:
+
+	uint64_t m_antID; //!< ID de la hormiga
+	uint8_t m_layerType; //!< Tipo de capa (LayerType)
+	Ipv4Address m_nextHop; //!< IP del siguiente salto (Capa intermedia)
+	uint32_t m_layerSize; //!< Tamaño en Bytes del resto de las capas (Capa intermedia)
+	uint8_t m_antType; //!< Tipo de hormiga (Capa final)
+	uint64_t m_sendTime; //!< Tiempo de envio (Capa final)
+	Ipv4Address m_target; //!< IP destino (Capa final)
+	uint32_t m_messageSize; //!< Tamaño en Bytes del mensaje (Capa final)
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_ANT_HEADER_H */
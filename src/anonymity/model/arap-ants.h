@@ -5,65 +5,28 @@
 
 #include <stdio.h>
 #include <string>
+#include <list>
 #include <stdint.h>
 #include "ns3/ipv4.h"
-
-/**
- * Tamaño en Bytes de una dirección IPV4
- */
-#define IPV4_SIZE 4
+#include "ns3/packet.h"
+#include "ns3/arap-ant-header.h"
 
 namespace ns3 {
 
 /**
- * Clase encargada de manejar la estructura interna de las hormigas, así como
- * de leer y escribir los diferentes campos de las mismas.
+ * Clase encargada de construir las hormigas como paquetes de NS3.
+ *
+ * Cada hormiga es una pila de cabeceras ArapAntHeader (Una capa de nodo intermedio
+ * por cada salto y una capa de nodo final), seguida del mensaje de la capa final y
+ * de Bytes en cero hasta completar el tamaño de hormiga de la simulación.
  */
 class ArapAnts {
 
 public:
-	/**
-	 * Enum para identificar los tipos de hormiga:
-	 * - Exploradora
-	 * - De carga
-	 */
-	enum AntType{ANT_EXPLORER, ANT_LOAD};
-
-	/**
-	 * Constante para identificar un nodo como intermedio.
-	 */
-	static const std::string NODE_TYPE_MEDIUM;
-
-	/**
-	 * Constante para identificar un nodo como final.
-	 */
-	static const std::string NODE_TYPE_FINAL;
-
-	/**
-	 * Tamaño en Bytes del identificador de tipo de nodo.
-	 */
-	static const uint32_t NODE_TYPE_SIZE;
 
 	ArapAnts();
 	~ArapAnts();
 
-	/** \addtogroup CamposHormigas Campos de las Hormigas
-	 * Métodos para leer los distintos campos de una hormiga enviada a través de la red.
-	 * Reciben como parametro el array de bytes que contiene la data de la hormiga.
-	 * @{
-	 */
-	static const uint64_t ReadAntID(const uint8_t* data); //!< Leer ID de hormiga
-	static const std::string ReadNodeType(const uint8_t* data); //!< Leer tipo de nodo
-	static const Ipv4Address ReadNextJumpIP(const uint8_t* data); //!< Leer IP del siguiente salto
-	static const uint32_t ReadLayerSize(const uint8_t* data); //!< Leer tamaño en Bytes de la capa
-	static const AntType ReadAntType(const uint8_t* data); //!< Leer tipo  de hormiga
-	static const uint64_t ReadSendTime(const uint8_t* data); //!< Leer tiempo de envio
-	static const Ipv4Address ReadTargetIP(const uint8_t* data); //!< Leer IP destino
-	static const uint32_t ReadMessageSize(const uint8_t* data); //!< Leer tamaño en bytes del mensaje
-	static const std::string ReadMessage(const uint8_t* data, const uint32_t messageSize); //!< Leer mensaje
-	/** @} */
-
-
 	/**
 	 * Crear paquete para hormiga de carga.
 	 *
@@ -71,107 +34,79 @@ public:
 	 *
 	 * @param[in] message Mensaje a enviar al nodo final.
 	 *
-	 * @return ID de la hormiga creada
+	 * @param[out] antID ID de la hormiga creada
+	 *
+	 * @return Hormiga creada
 	 */
-	const uint64_t CreateLoadAnt(std::list<Ipv4Address>& path, const std::string& message);
+	static Ptr<Packet> CreateLoadAnt(const std::list<Ipv4Address>& path, const std::string& message, uint64_t& antID);
 
 	/**
 	 * Crear hormiga exploradora.
 	 *
 	 * @param[in] target IP del nodo destino hacia el cual se esta explorando el camino.
 	 *
-	 * @return ID de la hormiga creada
-	 */
-	const uint64_t CreateExplorerAnt(const Ipv4Address& target);
-
-	/**
-	 * Crea una hormiga de respuesta desde un nodo intermedio al siguiente.
-	 *
-	 * @param[in] dataIn Data de la hormiga recibida
+	 * @param[out] antID ID de la hormiga creada
 	 *
-	 * @param[out] dataOut Data de la nueva hormiga a enviar
+	 * @return Hormiga creada
 	 */
-	void CreateMediumAnt(const uint8_t* dataIn ,uint8_t * const dataOut);
+	static Ptr<Packet> CreateExplorerAnt(const Ipv4Address& target, uint64_t& antID);
 
 	/**
-	 * Crea una hormiga de respuesta desde el nodo final (A donde se dirige finalmente un request)
-	 *
-	 * @param[in] dataIn Data de la hormiga recibida
-	 *
-	 * @param[out] dataOut Data de la nueva hormiga a enviar
+	 * Crea una hormiga de respuesta desde el nodo final (A donde se dirige finalmente un request).
 	 *
 	 * @param[in] sendTime Tiempo en el que se envio la hormiga original
 	 *
-	 * @param[in] antID ID de la hormiga recibida y al cual se le creará la respuesta
+	 * @param[in] target IP del nodo destino de la hormiga original
 	 *
-	 * @param[in] aswer Mensaje de respuesta a enviar
-	 */
-	void CreateAnswerAnt(uint8_t * const dataOut, const uint64_t& sendTime, const Ipv4Address& target, const uint64_t& antID, const std::string& answer);
-
-	/**
-	 * Crea la "Data" de una hormiga exploradora,
-	 *
-	 * @param[out] data Puntero a un vector de bytes donde se escribira la data creada
-	 *
-	 * @param[in] target IP del nodo destino hacia el cual se esta explorando el camino.
+	 * @param[in] antID ID de la hormiga recibida y al cual se le creará la respuesta
 	 *
-	 * @return Tamaño en Bytes de la data creada (Tamaño de data)
+	 * @param[in] answer Mensaje de respuesta a enviar
 	 *
-	 * @see CreateExplorerAnt()
+	 * @return Hormiga creada
 	 */
-	uint32_t const CreateExplorerAntData(uint8_t*& data, const Ipv4Address& target);
+	static Ptr<Packet> CreateAnswerAnt(uint64_t sendTime, const Ipv4Address& target, uint64_t antID, const std::string& answer);
 
 	/**
-	 * Crea la "Data" de una hormiga de carga.
-	 *
-	 * @param[out] data Puntero a un vector de bytes donde se escribira la data creada
-	 *
-	 * @param[in] sendTime Tiempo en el que se envio el paquete original
-	 *
-	 * @param[in] target IP del nodo destino hacia el cual se enviara la hormiga.
-	 *
-	 * @param[in] message Mensaje a enviar al nodo final.
+	 * Quita la capa leida por un nodo intermedio directamente sobre el paquete recibido
+	 * (Sin copiar la hormiga), y agrega al final la misma cantidad de Bytes en cero para
+	 * mantener el tamaño de la hormiga.
 	 *
-	 * @return Tamaño en Bytes de la data creada (Tamaño de data)
-	 *
-	 * @see CreateLoadAnt()
+	 * @param[in,out] ant Hormiga recibida, que queda lista para enviar al siguiente salto
 	 */
-	uint32_t const CreateLoadAntData(uint8_t*& data, const uint64_t& sendTime, const Ipv4Address& target, const std::string& message);
+	static void PeelMediumLayer(Ptr<Packet> ant);
 
 	/**
-	 * @return El buffer interno donde se escribe el contenido de la hormiga creada.
+	 * @return El contador de ID de las hormigas creadas en la simulación en curso.
 	 *
-	 * @see CreateLoadAnt()
-	 * @see CreateExplorerAnt()
-	 */
-	const uint8_t* GetBuffer() const;
-
-	/**
-	 * @return El contador de ID de las hormigas creadas.
+	 * El contador se incrementa cada vez que se crea una hormiga exploradora o de carga, y
+	 * pertenece al contexto de ArapSimulator activo.
+	 *
+	 * @see ArapSimulator::NextAntID()
 	 */
 	static const uint64_t GetAntID();
 
 private:
 
-	uint8_t* m_buffer; //!< Buffer interno para mantener la data del paquete creado
-
 	/**
-	 * ID para idenfiticar inequivocamente cada hormiga.
+	 * Crea el paquete con el mensaje y la capa de nodo final, completando con Bytes en cero
+	 * el espacio que dejarán libre las capas de nodo intermedio.
+	 *
+	 * @param[in] antID ID de la hormiga
+	 *
+	 * @param[in] antType Tipo de hormiga
+	 *
+	 * @param[in] sendTime Tiempo en el que se envio la hormiga original
+	 *
+	 * @param[in] target IP del nodo destino
+	 *
+	 * @param[in] message Mensaje a enviar al nodo final
 	 *
-	 * Se incrementa cada vez que se crea una hormiga exploradora o de carga
+	 * @param[in] mediumLayers Cantidad de capas de nodo intermedio que se agregarán luego
 	 *
-	 * @see CreateLoadAnt()
-	 * @see CreateExplorerAnt()
+	 * @return Paquete con la capa final
 	 */
-	static uint64_t m_antID;
-	static const uint32_t m_offsetAntID; //!< Offset de Bytes para leer el ID de hormiga
-	static const uint32_t m_offsetNodeType; //!< Offset de Bytes para leer el Tipo de nodo
-	static const uint32_t m_offsetNextJumpIP; //!< Offset de Bytes para leer la IP del siguiente salto
-	static const uint32_t m_offsetLayerSize; //!< Offset de Bytes para leer el tamaño de la capa
-	static const uint32_t m_offsetAntType; //!< Offset de Bytes para leer el tipo de hormiga
-	static const uint32_t m_offsetSendTime; //!< Offset de Bytes para leer el tiempo de envio
-	static const uint32_t m_offsetTargetIP; //!< Offset para la IP del nodo destino
-	static const uint32_t m_offsetMessageSize; //!< Offset de Bytes para leer el tamaño del mensaje
+	static Ptr<Packet> CreateFinalLayer(uint64_t antID, ArapAntHeader::AntType antType, uint64_t sendTime,
+			const Ipv4Address& target, const std::string& message, uint32_t mediumLayers);
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-computing-server.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapComputingServer");
+
+ArapComputingServer::ArapComputingServer()
+:m_workers(0), m_discipline(DISCIPLINE_FIFO), m_queueLength(0), m_served(0), m_queued(0), m_totalWait(0),
+ m_maxWait(0), m_maxQueueLength(0){
+}
+
+ArapComputingServer::~ArapComputingServer(){
+}
+
+void
+ArapComputingServer::Setup(uint32_t workers, Discipline discipline, SendCallback send){
+	m_workers = workers;
+	m_discipline = discipline;
+	m_send = send;
+	m_current.assign(workers,Job());
+	m_completion.assign(workers,EventId());
+	m_idle.clear();
+	//Los trabajadores libres se toman desde el final, asi el primero en usarse es el 0
+	for(uint32_t i=workers;i>0;i--)
+		m_idle.push_back(i-1);
+}
+
+void
+ArapComputingServer::Submit(Ptr<Packet> ant, const Ipv4Address& source, const Ipv4Address& target, uint64_t antID, bool isRequest,
+		Priority priority, const Time& serviceTime){
+	Job job;
+	job.ant = ant;
+	job.source = source;
+	job.target = target;
+	job.antID = antID;
+	job.isRequest = isRequest;
+	job.serviceTime = serviceTime;
+	job.arrival = Simulator::Now();
+
+	if(m_workers==0){
+		Simulator::Schedule(serviceTime,&ArapComputingServer::Execute,this,job);
+		return;
+	}
+	if(!m_idle.empty()){
+		uint32_t worker = m_idle.back();
+		m_idle.pop_back();
+		Start(worker,job);
+		return;
+	}
+	m_queue[(m_discipline==DISCIPLINE_PRIORITY) ? priority : 0].push_back(job);
+	m_queued++;
+	m_queueLength++;
+	if(m_queueLength>m_maxQueueLength)
+		m_maxQueueLength = m_queueLength;
+}
+
+void
+ArapComputingServer::Start(uint32_t worker, const Job& job){
+	Time wait = Simulator::Now()-job.arrival;
+	m_totalWait += wait;
+	if(wait>m_maxWait)
+		m_maxWait = wait;
+	m_current[worker] = job;
+	m_completion[worker] = Simulator::Schedule(job.serviceTime,&ArapComputingServer::Complete,this,worker);
+}
+
+void
+ArapComputingServer::Complete(uint32_t worker){
+	Job job = m_current[worker];
+	m_current[worker].ant = 0;
+	bool started = false;
+	for(uint32_t i=0;i<PRIORITY_COUNT && !started;i++){
+		if(m_queue[i].empty())
+			continue;
+		Start(worker,m_queue[i].front());
+		m_queue[i].pop_front();
+		m_queueLength--;
+		started = true;
+	}
+	if(!started)
+		m_idle.push_back(worker);
+	Execute(job);
+}
+
+void
+ArapComputingServer::Execute(Job job){
+	m_served++;
+	m_send(job.ant,job.source,job.target,job.antID,job.isRequest);
+}
+
+void
+ArapComputingServer::Dispose(){
+	for(uint32_t i=0;i<m_completion.size();i++)
+		Simulator::Cancel(m_completion[i]);
+	for(uint32_t i=0;i<PRIORITY_COUNT;i++)
+		m_queue[i].clear();
+	m_current.clear();
+	m_queueLength = 0;
+	m_send = SendCallback();
+}
+
+uint32_t
+ArapComputingServer::GetWorkers() const{
+	return m_workers;
+}
+
+uint64_t
+ArapComputingServer::GetServedCount() const{
+	return m_served;
+}
+
+uint64_t
+ArapComputingServer::GetQueuedCount() const{
+	return m_queued;
+}
+
+const Time&
+ArapComputingServer::GetTotalWait() const{
+	return m_totalWait;
+}
+
+const Time&
+ArapComputingServer::GetMaxWait() const{
+	return m_maxWait;
+}
+
+uint32_t
+ArapComputingServer::GetMaxQueueLength() const{
+	return m_maxQueueLength;
+}
+
+} /* namespace ns3 */
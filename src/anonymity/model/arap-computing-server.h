@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_COMPUTING_SERVER_H
+#define ARAP_COMPUTING_SERVER_H
+
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Servidor de cómputo de un nodo: procesa las hormigas que el nodo envía (Propias o reenviadas)
+ * durante su delay de cómputo antes de entregarlas a la red.
+ *
+ * Con 0 trabajadores (Por defecto) el nodo procesa cualquier cantidad de hormigas en paralelo,
+ * cada una termina su delay de cómputo de manera independiente. Con N trabajadores a lo sumo N
+ * hormigas se procesan a la vez y las demás esperan en cola; cada trabajador tiene un solo evento
+ * programado (El fin de la hormiga que está procesando), por lo que las hormigas en espera no
+ * ocupan la cola de eventos del simulador.
+ *
+ * El tiempo de servicio de cada hormiga se obtiene al llegar al servidor, de manera que los
+ * valores aleatorios se piden en el mismo orden con cualquier cantidad de trabajadores.
+ *
+ * La cola puede atender en orden de llegada o por prioridad: primero las respuestas, luego las
+ * peticiones reenviadas y por último las hormigas nuevas del nodo (Las que más trabajo de la
+ * red ya consumieron se atienden primero), en orden de llegada dentro de cada clase.
+ *
+ * @see PARAM_COMPUTING_SERVER
+ */
+class ArapComputingServer {
+
+public:
+
+	/**
+	 * Orden de atención de la cola.
+	 */
+	enum Discipline {
+		DISCIPLINE_FIFO, //!< Orden de llegada
+		DISCIPLINE_PRIORITY //!< Por clase de hormiga (Ver Priority), en orden de llegada dentro de cada clase
+	};
+
+	/**
+	 * Clase de una hormiga para la disciplina por prioridad (Menor valor = mayor prioridad).
+	 */
+	enum Priority {
+		PRIORITY_RESPONSE, //!< Respuesta (Reenviada o generada en el destino)
+		PRIORITY_FORWARD, //!< Petición reenviada por un intermedio
+		PRIORITY_NEW, //!< Hormiga nueva del nodo (Carga o exploradora)
+		PRIORITY_COUNT //!< Cantidad de clases
+	};
+
+	/**
+	 * Callback que envia una hormiga procesada (Ver ArapNode::SendDelayedAnt()).
+	 */
+	typedef Callback<void,Ptr<Packet>,const Ipv4Address&,const Ipv4Address&,const uint64_t&,bool> SendCallback;
+
+	ArapComputingServer();
+	~ArapComputingServer();
+
+	/**
+	 * @param[in] workers Cantidad de hormigas que se procesan a la vez (0 = sin límite)
+	 *
+	 * @param[in] discipline Orden de atención de la cola
+	 *
+	 * @param[in] send Callback que envia cada hormiga al terminar su procesamiento
+	 */
+	void Setup(uint32_t workers, Discipline discipline, SendCallback send);
+
+	/**
+	 * Agrega una hormiga al servidor. Se procesa de inmediato si hay un trabajador libre.
+	 *
+	 * @param[in] ant Hormiga a enviar
+	 *
+	 * @param[in] source IP del nodo desde donde se esta enviando la hormiga (Fila de la tabla de enrutamiento)
+	 *
+	 * @param[in] target IP del nodo siguiente al cual enviar la hormiga
+	 *
+	 * @param[in] antID ID de la hormiga
+	 *
+	 * @param[in] isRequest Indica si la hormiga es una petición (Request) o una respuesta (Response)
+	 *
+	 * @param[in] priority Clase de la hormiga
+	 *
+	 * @param[in] serviceTime Delay de cómputo de la hormiga
+	 */
+	void Submit(Ptr<Packet> ant, const Ipv4Address& source, const Ipv4Address& target, uint64_t antID, bool isRequest,
+			Priority priority, const Time& serviceTime);
+
+	/**
+	 * Cancela los procesamientos en curso y descarta la cola.
+	 */
+	void Dispose();
+
+	/**
+	 * @return Cantidad de trabajadores (0 = sin límite)
+	 */
+	uint32_t GetWorkers() const;
+
+	/**
+	 * @return Cantidad de hormigas que terminaron su procesamiento
+	 */
+	uint64_t GetServedCount() const;
+
+	/**
+	 * @return Cantidad de hormigas que tuvieron que esperar en cola
+	 */
+	uint64_t GetQueuedCount() const;
+
+	/**
+	 * @return Suma de los tiempos de espera en cola de las hormigas que ya comenzaron su procesamiento
+	 */
+	const Time& GetTotalWait() const;
+
+	/**
+	 * @return Máximo tiempo de espera en cola
+	 */
+	const Time& GetMaxWait() const;
+
+	/**
+	 * @return Máxima cantidad de hormigas en cola
+	 */
+	uint32_t GetMaxQueueLength() const;
+
+private:
+
+	/**
+	 * Hormiga en el servidor.
+	 */
+	struct Job {
+		Ptr<Packet> ant; //!< Hormiga a enviar
+		Ipv4Address source; //!< IP de origen para la tabla de enrutamiento
+		Ipv4Address target; //!< IP del siguiente nodo
+		uint64_t antID; //!< ID de la hormiga
+		bool isRequest; //!< Petición o respuesta
+		Time serviceTime; //!< Delay de cómputo
+		Time arrival; //!< Instante de llegada al servidor
+	};
+
+	/**
+	 * Inicia el procesamiento de una hormiga en un trabajador libre.
+	 *
+	 * @param[in] worker Índice del trabajador
+	 *
+	 * @param[in] job Hormiga a procesar
+	 */
+	void Start(uint32_t worker, const Job& job);
+
+	/**
+	 * Fin del procesamiento de un trabajador: envia su hormiga y toma la siguiente de la cola.
+	 *
+	 * @param[in] worker Índice del trabajador
+	 */
+	void Complete(uint32_t worker);
+
+	/**
+	 * Envia una hormiga procesada (Sin límite de trabajadores).
+	 *
+	 * @param[in] job Hormiga procesada
+	 */
+	void Execute(Job job);
+
+	uint32_t m_workers; //!< Cantidad de trabajadores (0 = sin límite)
+	Discipline m_discipline; //!< Orden de atención de la cola
+	SendCallback m_send; //!< Envio de las hormigas procesadas
+	std::vector<Job> m_current; //!< Hormiga que procesa cada trabajador
+	std::vector<EventId> m_completion; //!< Evento de fin de procesamiento de cada trabajador
+	std::vector<uint32_t> m_idle; //!< Trabajadores libres
+	std::deque<Job> m_queue[PRIORITY_COUNT]; //!< Hormigas en espera de cada clase (Solo la primera con DISCIPLINE_FIFO)
+	uint32_t m_queueLength; //!< Hormigas en espera
+	uint64_t m_served; //!< Hormigas procesadas
+	uint64_t m_queued; //!< Hormigas que esperaron en cola
+	Time m_totalWait; //!< Suma de las esperas en cola
+	Time m_maxWait; //!< Máxima espera en cola
+	uint32_t m_maxQueueLength; //!< Máximo de hormigas en espera
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_COMPUTING_SERVER_H */
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-connection-pool.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapConnectionPool");
+
+ArapConnectionPool::ArapConnectionPool()
+:m_port(0), m_segmentSize(0), m_sendBufferSize(DEFAULT_SEND_BUFFER_SIZE), m_maxConnections(DEFAULT_MAX_CONNECTIONS),
+ m_maxPending(DEFAULT_MAX_PENDING_ANTS), m_idleTimeout(0), m_peakOpen(0), m_opened(0), m_evicted(0), m_idleClosed(0), m_queued(0),
+ m_dropped(0), m_peakPending(0){
+}
+
+ArapConnectionPool::~ArapConnectionPool(){
+}
+
+void
+ArapConnectionPool::Setup(Ptr<Node> node, uint16_t port, uint32_t segmentSize, uint32_t sendBufferSize,
+		uint32_t maxConnections, uint32_t maxPending, const Time& idleTimeout, Callback<void, Ptr<Socket>, uint32_t> sendCallback){
+	m_node = node;
+	m_port = port;
+	m_segmentSize = segmentSize;
+	m_sendBufferSize = sendBufferSize;
+	m_maxConnections = maxConnections;
+	m_maxPending = maxPending;
+	m_idleTimeout = idleTimeout;
+	m_sendCallback = sendCallback;
+}
+
+ArapConnectionPool::Connection*
+ArapConnectionPool::Open(const Ipv4Address& target){
+	if(m_maxConnections>0 && m_connections.size()>=m_maxConnections && !EvictLeastRecentlyUsed()){
+		NS_LOG_LOGIC("Todas las conexiones tienen hormigas en espera, no se abre la conexion hacia "<<target);
+		return NULL;
+	}
+
+	Ptr<Socket> client = Socket::CreateSocket (m_node, TcpSocketFactory::GetTypeId());
+	client->SetAttribute("SegmentSize",UintegerValue(m_segmentSize));
+	client->SetAttribute("SndBufSize",UintegerValue(m_sendBufferSize));
+	client->Bind(); //No se asigna a un puerto especifico ya que es cliente
+	client->ShutdownRecv(); //Este socket no recibe (Es cliente)
+	client->SetSendCallback(m_sendCallback);
+	client->Connect(InetSocketAddress(target,m_port));
+
+	m_lru.push_front(target);
+	Connection& connection = m_connections[target];
+	connection.socket = client;
+	connection.lru = m_lru.begin();
+	m_socketTargets[client] = target;
+
+	m_opened++;
+	if(m_connections.size()>m_peakOpen)
+		m_peakOpen = m_connections.size();
+	if(m_idleTimeout.IsStrictlyPositive() && !m_idleEvent.IsRunning())
+		m_idleEvent = Simulator::Schedule(m_idleTimeout,&ArapConnectionPool::CloseIdleConnections,this);
+	NS_LOG_LOGIC("Se abrio una conexion hacia "<<target<<" ("<<m_connections.size()<<" abiertas)");
+	return &connection;
+}
+
+bool
+ArapConnectionPool::EvictLeastRecentlyUsed(){
+	for(std::list<Ipv4Address>::reverse_iterator it = m_lru.rbegin();it!=m_lru.rend();it++){
+		ConnectionMap::iterator connection = m_connections.find(*it);
+		if(!connection->second.pending.empty())
+			continue;
+		NS_LOG_LOGIC("Se cierra la conexion hacia "<<*it<<" por ser la menos usada");
+		CloseConnection(connection);
+		m_evicted++;
+		return true;
+	}
+	return false;
+}
+
+void
+ArapConnectionPool::CloseConnection(ConnectionMap::iterator connection){
+	Ptr<Socket> socket = connection->second.socket;
+	socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+	socket->Close(); //TCP termina de enviar lo que queda en el buffer antes de cerrar
+	m_socketTargets.erase(socket);
+	m_lru.erase(connection->second.lru);
+	m_connections.erase(connection);
+}
+
+void
+ArapConnectionPool::CloseIdleConnections(){
+	/* m_lru esta ordenada por uso, por lo que las conexiones inactivas estan al final;
+	 * las que tienen hormigas en espera se mantienen hasta vaciar su cola
+	 */
+	Time limit = Simulator::Now()-m_idleTimeout;
+	std::list<Ipv4Address>::iterator it = m_lru.end();
+	while(it!=m_lru.begin()){
+		ConnectionMap::iterator connection = m_connections.find(*--it);
+		if(connection->second.lastUsed>limit)
+			break;
+		if(!connection->second.pending.empty())
+			continue;
+		NS_LOG_LOGIC("Se cierra la conexion hacia "<<*it<<" por inactividad");
+		it++; //La posicion de la conexion en m_lru se borra al cerrarla
+		CloseConnection(connection);
+		m_idleClosed++;
+	}
+	if(!m_connections.empty())
+		m_idleEvent = Simulator::Schedule(m_idleTimeout,&ArapConnectionPool::CloseIdleConnections,this);
+}
+
+bool
+ArapConnectionPool::Send(const Ipv4Address& target, Ptr<Packet> ant){
+	ConnectionMap::iterator it = m_connections.find(target);
+	Connection* connection = (it!=m_connections.end()) ? &it->second : Open(target);
+	if(connection==NULL){
+		m_dropped++;
+		return false;
+	}
+	m_lru.splice(m_lru.begin(),m_lru,connection->lru);
+	connection->lastUsed = Simulator::Now();
+
+	if(connection->pending.empty() && connection->socket->GetTxAvailable()>=ant->GetSize()){
+		if(connection->socket->Send(ant)==-1)
+			NS_ABORT_MSG("FALLO EL ENVIO DEL PAQUETE. VALOR DE ERRNO: "<<connection->socket->GetErrno());
+		return true;
+	}
+	if(m_maxPending>0 && connection->pending.size()>=m_maxPending){
+		NS_LOG_LOGIC("Cola de la conexion hacia "<<target<<" llena, se descarta la hormiga");
+		m_dropped++;
+		return false;
+	}
+	connection->pending.push_back(ant);
+	m_queued++;
+	if(connection->pending.size()>m_peakPending)
+		m_peakPending = connection->pending.size();
+	return true;
+}
+
+void
+ArapConnectionPool::Flush(Connection& connection){
+	while(!connection.pending.empty() && connection.socket->GetTxAvailable()>=connection.pending.front()->GetSize()){
+		if(connection.socket->Send(connection.pending.front())==-1)
+			NS_ABORT_MSG("FALLO EL ENVIO DEL PAQUETE. VALOR DE ERRNO: "<<connection.socket->GetErrno());
+		connection.pending.pop_front();
+	}
+}
+
+void
+ArapConnectionPool::HandleSendSpace(Ptr<Socket> socket){
+	std::map<Ptr<Socket>, Ipv4Address>::iterator it = m_socketTargets.find(socket);
+	if(it==m_socketTargets.end())
+		return;
+	Flush(m_connections[it->second]);
+}
+
+void
+ArapConnectionPool::CloseAll(){
+	Simulator::Cancel(m_idleEvent);
+	for(ConnectionMap::iterator it = m_connections.begin();it!=m_connections.end();it++)
+		it->second.socket->Close();
+	m_connections.clear();
+	m_socketTargets.clear();
+	m_lru.clear();
+}
+
+void
+ArapConnectionPool::Dispose(){
+	Simulator::Cancel(m_idleEvent);
+	m_connections.clear();
+	m_socketTargets.clear();
+	m_lru.clear();
+	m_sendCallback = MakeNullCallback<void, Ptr<Socket>, uint32_t> ();
+	m_node = 0;
+}
+
+uint32_t
+ArapConnectionPool::GetOpenCount() const{
+	return m_connections.size();
+}
+
+uint32_t
+ArapConnectionPool::GetPeakOpenCount() const{
+	return m_peakOpen;
+}
+
+uint64_t
+ArapConnectionPool::GetOpenedCount() const{
+	return m_opened;
+}
+
+uint64_t
+ArapConnectionPool::GetEvictedCount() const{
+	return m_evicted;
+}
+
+uint64_t
+ArapConnectionPool::GetIdleClosedCount() const{
+	return m_idleClosed;
+}
+
+uint64_t
+ArapConnectionPool::GetDroppedCount() const{
+	return m_dropped;
+}
+
+uint64_t
+ArapConnectionPool::GetQueuedCount() const{
+	return m_queued;
+}
+
+uint32_t
+ArapConnectionPool::GetMaxPending() const{
+	return m_peakPending;
+}
+
+} /* namespace ns3 */
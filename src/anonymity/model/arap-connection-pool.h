@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_CONNECTION_POOL_H
+#define ARAP_CONNECTION_POOL_H
+
+#include "ns3/socket.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include <map>
+#include <list>
+#include <deque>
+
+/**
+ * Tamaño por defecto (En Bytes) del buffer de envio de cada socket cliente
+ * (Valor por defecto de %ns3::TcpSocket).
+ */
+#define DEFAULT_SEND_BUFFER_SIZE 131072
+
+/**
+ * Cantidad máxima por defecto de conexiones abiertas por nodo (0 = sin límite).
+ */
+#define DEFAULT_MAX_CONNECTIONS 0
+
+/**
+ * Cantidad máxima por defecto de hormigas en espera en cada conexión (0 = sin límite).
+ */
+#define DEFAULT_MAX_PENDING_ANTS 1024
+
+namespace ns3 {
+
+/**
+ * Conjunto de conexiones TCP salientes de un nodo.
+ *
+ * Las conexiones se abren la primera vez que se envia una hormiga a cada nodo (No al
+ * iniciar la simulación), por lo que el costo de configuración y la memoria dependen de
+ * los pares de nodos que realmente se comunican. Si se alcanza el máximo de conexiones
+ * abiertas, se cierra la conexión usada hace más tiempo que no tenga hormigas en espera
+ * (LRU); el cierre de TCP termina de enviar los datos que quedaron en su buffer. Si todas
+ * tienen hormigas en espera no se abre la conexión y la hormiga se descarta. Opcionalmente
+ * también se cierran las conexiones sin hormigas en espera que no se usan por un tiempo.
+ *
+ * Cada socket tiene un buffer de envio acotado. Cuando una hormiga no cabe en el buffer
+ * queda en una cola de espera de la conexión, que se vacía cuando el socket notifica
+ * espacio disponible (Callback de envio del socket). La cola también está acotada: si está
+ * llena la hormiga se descarta, igual que una cola de paquetes llena en la red.
+ */
+class ArapConnectionPool {
+
+public:
+
+	ArapConnectionPool();
+	~ArapConnectionPool();
+
+	/**
+	 * Configura los parámetros de las conexiones a crear.
+	 *
+	 * @param[in] node Nodo al que pertenecen los sockets
+	 *
+	 * @param[in] port Puerto del socket servidor de los demás nodos
+	 *
+	 * @param[in] segmentSize Tamaño máximo de segmento de los sockets
+	 *
+	 * @param[in] sendBufferSize Tamaño en Bytes del buffer de envio de cada socket
+	 *
+	 * @param[in] maxConnections Cantidad máxima de conexiones abiertas (0 = sin límite)
+	 *
+	 * @param[in] maxPending Cantidad máxima de hormigas en espera en cada conexión (0 = sin límite)
+	 *
+	 * @param[in] idleTimeout Tiempo sin envios luego del cual se cierra una conexión sin hormigas en espera (0 = no se cierran)
+	 *
+	 * @param[in] sendCallback Callback que se asigna a cada socket para notificar espacio
+	 * disponible en el buffer de envio, debe llamar a HandleSendSpace()
+	 */
+	void Setup(Ptr<Node> node, uint16_t port, uint32_t segmentSize, uint32_t sendBufferSize,
+			uint32_t maxConnections, uint32_t maxPending, const Time& idleTimeout, Callback<void, Ptr<Socket>, uint32_t> sendCallback);
+
+	/**
+	 * Envia una hormiga al nodo indicado, abriendo la conexión si no existe. Si la hormiga no
+	 * cabe en el buffer de envio, o hay hormigas esperando, se agrega a la cola de la conexión.
+	 *
+	 * @param[in] target IP del nodo destino
+	 *
+	 * @param[in] ant Hormiga a enviar
+	 *
+	 * @return false si la hormiga se descartó (Cola de la conexión llena, o máximo de
+	 * conexiones alcanzado con hormigas en espera en todas)
+	 */
+	bool Send(const Ipv4Address& target, Ptr<Packet> ant);
+
+	/**
+	 * Envia las hormigas en espera de la conexión del socket mientras quepan en su buffer.
+	 *
+	 * @param[in] socket Socket que notificó espacio disponible en su buffer de envio
+	 */
+	void HandleSendSpace(Ptr<Socket> socket);
+
+	/**
+	 * Cierra todas las conexiones abiertas.
+	 */
+	void CloseAll();
+
+	/**
+	 * Libera los sockets y el nodo sin cerrar las conexiones (Al destruir la simulación).
+	 */
+	void Dispose();
+
+	/**
+	 * @return Cantidad de conexiones abiertas
+	 */
+	uint32_t GetOpenCount() const;
+
+	/**
+	 * @return Cantidad máxima de conexiones abiertas al mismo tiempo
+	 */
+	uint32_t GetPeakOpenCount() const;
+
+	/**
+	 * @return Cantidad de conexiones abiertas durante la simulación
+	 */
+	uint64_t GetOpenedCount() const;
+
+	/**
+	 * @return Cantidad de conexiones cerradas por alcanzar el máximo de conexiones
+	 */
+	uint64_t GetEvictedCount() const;
+
+	/**
+	 * @return Cantidad de conexiones cerradas por inactividad
+	 */
+	uint64_t GetIdleClosedCount() const;
+
+	/**
+	 * @return Cantidad de hormigas descartadas por cola llena o por el máximo de conexiones
+	 */
+	uint64_t GetDroppedCount() const;
+
+	/**
+	 * @return Cantidad de hormigas que tuvieron que esperar espacio en el buffer de envio
+	 */
+	uint64_t GetQueuedCount() const;
+
+	/**
+	 * @return Cantidad máxima de hormigas en espera en una conexión
+	 */
+	uint32_t GetMaxPending() const;
+
+private:
+
+	/**
+	 * Conexión abierta a un nodo.
+	 */
+	struct Connection {
+		Ptr<Socket> socket; //!< Socket cliente
+		std::deque<Ptr<Packet> > pending; //!< Hormigas esperando espacio en el buffer de envio
+		std::list<Ipv4Address>::iterator lru; //!< Posición de la conexión en m_lru
+		Time lastUsed; //!< Instante del último envio por la conexión
+	};
+
+	typedef std::map<Ipv4Address, Connection> ConnectionMap; //!< Conexiones indexadas por IP destino
+
+	/**
+	 * Abre una conexión al nodo indicado, cerrando antes la conexión menos usada
+	 * recientemente si se alcanzó el máximo.
+	 *
+	 * @param[in] target IP del nodo destino
+	 *
+	 * @return Conexión creada, o NULL si se alcanzó el máximo y todas las conexiones tienen hormigas en espera
+	 */
+	Connection* Open(const Ipv4Address& target);
+
+	/**
+	 * Cierra la conexión usada hace más tiempo sin hormigas en espera.
+	 *
+	 * @return false si todas las conexiones tienen hormigas en espera
+	 */
+	bool EvictLeastRecentlyUsed();
+
+	/**
+	 * Cierra una conexión sin hormigas en espera.
+	 *
+	 * @param[in] connection Conexión a cerrar
+	 */
+	void CloseConnection(ConnectionMap::iterator connection);
+
+	/**
+	 * Cierra las conexiones sin hormigas en espera que no se usaron en el último
+	 * m_idleTimeout, y programa la próxima revisión si quedan conexiones abiertas.
+	 */
+	void CloseIdleConnections();
+
+	/**
+	 * Envia las hormigas en espera de una conexión mientras quepan en su buffer.
+	 *
+	 * @param[in] connection Conexión
+	 */
+	void Flush(Connection& connection);
+
+	Ptr<Node> m_node; //!< Nodo al que pertenecen los sockets
+	uint16_t m_port; //!< Puerto del socket servidor de los demás nodos
+	uint32_t m_segmentSize; //!< Tamaño máximo de segmento de los sockets
+	uint32_t m_sendBufferSize; //!< Tamaño en Bytes del buffer de envio de cada socket
+	uint32_t m_maxConnections; //!< Cantidad máxima de conexiones abiertas (0 = sin límite)
+	uint32_t m_maxPending; //!< Cantidad máxima de hormigas en espera en cada conexión (0 = sin límite)
+	Time m_idleTimeout; //!< Tiempo sin envios luego del cual se cierra una conexión (0 = no se cierran)
+	EventId m_idleEvent; //!< Próxima revisión de las conexiones inactivas
+	Callback<void, Ptr<Socket>, uint32_t> m_sendCallback; //!< Callback de espacio disponible de los sockets
+	ConnectionMap m_connections; //!< Conexiones abiertas
+	std::map<Ptr<Socket>, Ipv4Address> m_socketTargets; //!< IP destino de cada socket abierto
+	std::list<Ipv4Address> m_lru; //!< IP destino de las conexiones, de la usada más recientemente a la menos usada
+	uint32_t m_peakOpen; //!< Cantidad máxima de conexiones abiertas al mismo tiempo
+	uint64_t m_opened; //!< Cantidad de conexiones abiertas durante la simulación
+	uint64_t m_evicted; //!< Cantidad de conexiones cerradas por alcanzar el máximo
+	uint64_t m_idleClosed; //!< Cantidad de conexiones cerradas por inactividad
+	uint64_t m_queued; //!< Cantidad de hormigas que esperaron espacio en el buffer
+	uint64_t m_dropped; //!< Cantidad de hormigas descartadas
+	uint32_t m_peakPending; //!< Cantidad máxima de hormigas en espera en una conexión
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_CONNECTION_POOL_H */
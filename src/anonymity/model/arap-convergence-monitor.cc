@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-convergence-monitor.h"
+#include "ns3/arap-simulator.h"
+#include "ns3/arap-node.h"
+#include "ns3/arap-distributed.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapConvergenceMonitor");
+
+ArapConvergenceMonitor::ArapConvergenceMonitor()
+:m_enabled(false), m_interval(0), m_tableThreshold(0), m_rttThreshold(0), m_windows(1), m_action(ACTION_STOP),
+ m_previousSamples(0), m_previousRttSum(0), m_previousWindowRtt(-1), m_stableChecks(0), m_streakStart(0), m_convergenceTime(-1){
+}
+
+ArapConvergenceMonitor::~ArapConvergenceMonitor(){
+	if(m_series.is_open())
+		m_series.close();
+}
+
+void
+ArapConvergenceMonitor::Enable(const Time& interval, double tableThreshold, double rttThreshold, uint32_t windows, Action action){
+	m_enabled = true;
+	m_interval = interval;
+	m_tableThreshold = tableThreshold;
+	m_rttThreshold = rttThreshold;
+	m_windows = windows;
+	m_action = action;
+}
+
+bool
+ArapConvergenceMonitor::IsEnabled() const{
+	return m_enabled;
+}
+
+Time
+ArapConvergenceMonitor::GetConvergenceTime() const{
+	return m_convergenceTime;
+}
+
+void
+ArapConvergenceMonitor::Start(const std::string& filename){
+	if(!m_enabled)
+		return;
+	if(ArapDistributed::IsRoot()){
+		m_series.open(filename.c_str());
+		if(!m_series.is_open())
+			NS_LOG_INFO("Fallo el crear el archivo de nombre: "+filename);
+		else
+			m_series<<"\"Tiempo simulado (s)\",\"Cambio L1 maximo de las tablas\",\"Deriva relativa del RTT\",\"Chequeos estables\"\n";
+	}
+	m_checkEvent = Simulator::Schedule(m_interval,&ArapConvergenceMonitor::Check,this);
+}
+
+void
+ArapConvergenceMonitor::Stop(){
+	if(!m_enabled)
+		return;
+	Simulator::Cancel(m_checkEvent);
+	if(!m_series.is_open())
+		return;
+	m_series<<"\"Tiempo de convergencia (s)\",";
+	if(m_convergenceTime.IsNegative())
+		m_series<<"\"No convergio\"\n";
+	else
+		m_series<<m_convergenceTime.GetSeconds()<<"\n";
+	m_series.close();
+}
+
+/**
+ * @param[in] a Fila (Pares índice, probabilidad en orden de índice)
+ *
+ * @param[in] b Fila (Pares índice, probabilidad en orden de índice)
+ *
+ * @return Distancia L1 entre las filas (Las columnas que faltan valen cero)
+ */
+static double
+RowDistance(const std::vector<std::pair<uint32_t,double> >& a, const std::vector<std::pair<uint32_t,double> >& b){
+	double distance = 0;
+	uint32_t i = 0, j = 0;
+	while(i<a.size() || j<b.size()){
+		if(j==b.size() || (i<a.size() && a[i].first<b[j].first))
+			distance += std::fabs(a[i++].second);
+		else if(i==a.size() || b[j].first<a[i].first)
+			distance += std::fabs(b[j++].second);
+		else
+			distance += std::fabs(a[i++].second-b[j++].second);
+	}
+	return distance;
+}
+
+double
+ArapConvergenceMonitor::GetTableChange(){
+	const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+	uint32_t numNodes = directory.GetCount();
+	bool first = m_previousTables.empty();
+	if(first)
+		m_previousTables.resize(numNodes);
+	double maxChange = 0;
+	for(uint32_t i=0;i<numNodes;i++){
+		Ptr<Node> node = directory.GetNode(i);
+		if(!ArapDistributed::IsLocal(node))
+			continue;
+		const ArapPathManager& manager = DynamicCast<ArapNode>(node->GetApplication(0))->GetPathManager();
+
+		/* Solo se comparan las filas cuya versión cambió desde el chequeo anterior, y cada
+		 * una con las columnas que guarda el ArapPathManager (K en SparsePathManager)
+		 */
+		TableSnapshot& previous = m_previousTables[i];
+		bool hasPrevious = !previous.versions.empty();
+		if(!hasPrevious){
+			previous.versions.assign(numNodes,0);
+			previous.rows.resize(numNodes);
+		}
+		for(uint32_t target=0;target<numNodes;target++){
+			uint32_t version = manager.GetRowVersion(target);
+			if(hasPrevious && version==previous.versions[target])
+				continue;
+			manager.ExportRow(target,m_row);
+			if(hasPrevious){
+				double change = RowDistance(previous.rows[target],m_row);
+				if(change>maxChange)
+					maxChange = change;
+			}
+			previous.rows[target].swap(m_row);
+			previous.versions[target] = version;
+		}
+	}
+	return first ? std::numeric_limits<double>::infinity() : maxChange;
+}
+
+double
+ArapConvergenceMonitor::GetRttDrift(){
+	const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+	uint64_t samples = 0;
+	double rttSum = 0;
+	for(uint32_t i=0;i<directory.GetCount();i++){
+		Ptr<Node> node = directory.GetNode(i);
+		if(!ArapDistributed::IsLocal(node))
+			continue;
+		const LoadAntsStatistics& model = DynamicCast<ArapNode>(node->GetApplication(0))->GetLoadAntsDelayModel();
+		samples += model.GetNumSamples();
+		rttSum += model.GetMean()*model.GetNumSamples();
+	}
+	samples = ArapDistributed::Sum(samples);
+	rttSum = ArapDistributed::Sum(rttSum);
+
+	double windowRtt = (samples>m_previousSamples) ? (rttSum-m_previousRttSum)/(samples-m_previousSamples) : -1;
+	double drift = std::numeric_limits<double>::infinity();
+	if(windowRtt>0 && m_previousWindowRtt>0)
+		drift = std::fabs(windowRtt-m_previousWindowRtt)/m_previousWindowRtt;
+	m_previousSamples = samples;
+	m_previousRttSum = rttSum;
+	m_previousWindowRtt = windowRtt;
+	return drift;
+}
+
+void
+ArapConvergenceMonitor::Check(){
+	double tableChange = ArapDistributed::Max(GetTableChange());
+	double rttDrift = GetRttDrift();
+	Time now = Simulator::Now();
+	if(tableChange<=m_tableThreshold && rttDrift<=m_rttThreshold){
+		if(m_stableChecks==0)
+			m_streakStart = now;
+		m_stableChecks++;
+	}
+	else
+		m_stableChecks = 0;
+	if(m_series.is_open())
+		m_series<<now.GetSeconds()<<","<<tableChange<<","<<rttDrift<<","<<m_stableChecks<<"\n";
+
+	if(m_stableChecks<m_windows){
+		m_checkEvent = Simulator::Schedule(m_interval,&ArapConvergenceMonitor::Check,this);
+		return;
+	}
+
+	//Convergencia: no se programan mas chequeos
+	m_convergenceTime = m_streakStart;
+	if(ArapDistributed::IsRoot())
+		NS_LOG_UNCOND("Convergencia detectada en t="<<m_convergenceTime.GetSeconds()<<"s (Chequeo en t="<<now.GetSeconds()<<"s)");
+	if(m_action==ACTION_STOP){
+		Simulator::Stop();
+		return;
+	}
+	const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+	for(uint32_t i=0;i<directory.GetCount();i++){
+		Ptr<Node> node = directory.GetNode(i);
+		if(ArapDistributed::IsLocal(node))
+			DynamicCast<ArapNode>(node->GetApplication(0))->ResetLoadAntsStatistics();
+	}
+	if(ArapDistributed::IsRoot())
+		NS_LOG_UNCOND("Inicio de la fase de medicion en t="<<now.GetSeconds()<<"s");
+}
+
+} /* namespace ns3 */
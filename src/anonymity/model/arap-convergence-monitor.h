@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_CONVERGENCE_MONITOR_H
+#define ARAP_CONVERGENCE_MONITOR_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+
+namespace ns3 {
+
+/**
+ * Monitor de convergencia (Uno por simulación) que detecta cuando el aprendizaje de los
+ * nodos se estabilizó, para no simular el estado estacionario más de lo necesario.
+ *
+ * Cada intervalo se calculan dos medidas sobre la ventana transcurrida desde el chequeo anterior:
+ * - Cambio de las tablas: el máximo, entre todos los nodos y todas sus filas, de la distancia L1
+ *   entre la fila actual y la del chequeo anterior.
+ * - Deriva del RTT: la variación relativa entre el RTT medio de las hormigas de carga (De todos
+ *   los nodos) que volvieron en esta ventana y el de la ventana anterior. Si alguna de las dos
+ *   ventanas no tiene muestras la deriva no se puede calcular y la ventana no es estable.
+ *
+ * Cuando ambas medidas quedan bajo sus umbrales en la cantidad indicada de chequeos seguidos,
+ * la simulación convergió en el tiempo del primero de ellos, y según la acción configurada se
+ * detiene la simulación o se reinician las estadísticas de las hormigas de carga para medir
+ * solo el estado estacionario (Fase de medición, hasta el tiempo de fin configurado).
+ *
+ * La serie de las medidas y el tiempo de convergencia se escriben en:\n
+ * "load-ants-model/convergence_<exploradoras>_<Semilla>_<Run>.csv"
+ */
+class ArapConvergenceMonitor {
+
+public:
+
+	/**
+	 * Acción a realizar cuando se detecta la convergencia.
+	 */
+	enum Action {
+		ACTION_STOP, //!< Detener la simulación
+		ACTION_MEASURE //!< Reiniciar las estadísticas de las hormigas de carga y continuar
+	};
+
+	ArapConvergenceMonitor();
+	~ArapConvergenceMonitor();
+
+	/**
+	 * Habilita el monitor.
+	 *
+	 * @param[in] interval Tiempo simulado entre chequeos (Largo de cada ventana)
+	 *
+	 * @param[in] tableThreshold Umbral del cambio L1 de las filas de las tablas
+	 *
+	 * @param[in] rttThreshold Umbral de la deriva relativa del RTT de las hormigas de carga
+	 *
+	 * @param[in] windows Cantidad de chequeos seguidos bajo los umbrales para considerar la convergencia
+	 *
+	 * @param[in] action Acción a realizar al converger
+	 */
+	void Enable(const Time& interval, double tableThreshold, double rttThreshold, uint32_t windows, Action action);
+
+	/**
+	 * @return true si el monitor está habilitado
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Abre el archivo de la serie y programa el primer chequeo (Solo si está habilitado).
+	 *
+	 * @param[in] filename Nombre del archivo de la serie
+	 */
+	void Start(const std::string& filename);
+
+	/**
+	 * Cancela el próximo chequeo y escribe el tiempo de convergencia al final de la serie.
+	 */
+	void Stop();
+
+	/**
+	 * @return Tiempo de convergencia, o un tiempo negativo si la simulación no convergió
+	 */
+	Time GetConvergenceTime() const;
+
+private:
+
+	/**
+	 * Calcula las medidas de la ventana, actúa si se detecta la convergencia y programa el
+	 * próximo chequeo.
+	 */
+	void Check();
+
+	/**
+	 * @return Máximo cambio L1 de las filas de las tablas de los nodos de este proceso desde
+	 * el chequeo anterior (Infinito en el primer chequeo)
+	 */
+	double GetTableChange();
+
+	/**
+	 * @return Deriva relativa del RTT medio de las hormigas de carga entre esta ventana y la anterior
+	 */
+	double GetRttDrift();
+
+	/**
+	 * Filas de la tabla de un nodo en el chequeo anterior.
+	 */
+	struct TableSnapshot {
+		std::vector<uint32_t> versions; //!< Versión de cada fila (Ver ArapPathManager::GetRowVersion())
+		std::vector<std::vector<std::pair<uint32_t,double> > > rows; //!< Probabilidades distintas de cero de cada fila
+	};
+
+	bool m_enabled; //!< Monitor habilitado
+	Time m_interval; //!< Tiempo simulado entre chequeos
+	double m_tableThreshold; //!< Umbral del cambio L1 de las filas
+	double m_rttThreshold; //!< Umbral de la deriva relativa del RTT
+	uint32_t m_windows; //!< Chequeos seguidos bajo los umbrales necesarios para converger
+	Action m_action; //!< Acción al converger
+	std::vector<TableSnapshot> m_previousTables; //!< Tabla de cada nodo (Posición: índice en ArapNodeDirectory) en el chequeo anterior
+	std::vector<std::pair<uint32_t,double> > m_row; //!< Fila exportada en el chequeo actual (Se reutiliza entre filas)
+	uint64_t m_previousSamples; //!< Hormigas de carga de todos los nodos que volvieron hasta el chequeo anterior
+	double m_previousRttSum; //!< Suma de los RTT de las hormigas de carga hasta el chequeo anterior
+	double m_previousWindowRtt; //!< RTT medio de la ventana anterior (Negativo si no tuvo muestras)
+	uint32_t m_stableChecks; //!< Chequeos seguidos bajo los umbrales
+	Time m_streakStart; //!< Tiempo del primer chequeo de la racha actual bajo los umbrales
+	Time m_convergenceTime; //!< Tiempo de convergencia (Negativo si no convergió)
+	std::ofstream m_series; //!< Archivo de la serie de las medidas (Solo en el rango 0)
+	EventId m_checkEvent; //!< Evento del próximo chequeo
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_CONVERGENCE_MONITOR_H */
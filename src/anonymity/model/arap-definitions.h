@@ -114,6 +114,23 @@ using namespace ns3;
  */
 #define PARAM_EXPLORER_INTERVAL "intervalo-exploradoras"
 
+/**
+ * Planificador del envío de hormigas exploradoras de cada nodo.
+ *
+ * Formato en el archivo: <nombre> <identificador de caso> [<parámetros de caso>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_EXPLORER_SCHEDULER
+ * - identificador de caso y parámetros (Definidos en ExplorerSchedulerFactory::GetInstance()):
+ *   - inundacion : Cada PARAM_EXPLORER_INTERVAL se exploran todos los caminos a la vez (Por defecto)
+ *   - presupuesto <exploradoras por segundo> [<jitter>] : Envíos de a uno con intervalo medio
+ *     1/<exploradoras por segundo> y variación relativa <jitter> \f$ \in \f$ [0,1] (Por defecto 0.5),
+ *     priorizando los destinos explorados hace más tiempo y con modelos más inciertos
+ *
+ * @see ArapExplorerScheduler
+ */
+#define PARAM_EXPLORER_SCHEDULER "planificador-exploradoras"
+
 /**
  * DataRate (bits por segundo) a asignar a los nodos especificados en el rango.
  *
@@ -311,6 +328,9 @@ using namespace ns3;
  * - parámetros de caso: Lista de parámetros definida según el caso en el método
  * PathManagerFactory::GetInstance()
  *
+ * Para redes grandes SparsePathManager guarda solo K intermedios candidatos por destino
+ * ("SparsePathManagerDefault [<K> [<rotación>]]").
+ *
  * @see PathManagerFactory::GetInstance()
  */
 #define PARAM_PATH_MANAGER "path-manager"
@@ -371,6 +391,284 @@ using namespace ns3;
  */
 #define PARAM_LOAD_ANT_TARGET_DIST "hormigacarga-destino-dist"
 
+/**
+ * Formato del archivo donde se registran los caminos de las hormigas de carga
+ * (Carpeta "load-ants-paths").
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_PATHS_FORMAT
+ * - valor : "csv" (Por defecto, un archivo ".csv"), "binario" (Un archivo ".bin" compacto, que
+ * se puede convertir a CSV con el programa de ejemplo "arap-paths-to-csv") o "ninguno" (No se
+ * registran los caminos, ver PARAM_ANONYMITY_METRICS)
+ *
+ * @see ArapPathLogger
+ */
+#define PARAM_PATHS_FORMAT "formato-caminos"
+
+/**
+ * Múltiplo del RTT observado por cada nodo luego del cual expiran las filas de la tabla de
+ * enrutamiento que no recibieron respuesta (Hormigas descartadas en la red).
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_ROUTING_RTT_MULTIPLE
+ * - valor : real >= 0 (0 deshabilita la expiración de filas)
+ *
+ * @see RoutingTable
+ */
+#define PARAM_ROUTING_RTT_MULTIPLE "tabla-rutas-expiracion"
+
+/**
+ * Tamaño en Bytes del buffer de envio de cada socket cliente. Las hormigas que no caben en
+ * el buffer esperan en la conexión hasta que se libere espacio.
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_SEND_BUFFER_SIZE
+ * - valor : entero >= tamaño de las hormigas
+ *
+ * @see ArapConnectionPool
+ */
+#define PARAM_SEND_BUFFER_SIZE "tamanio-buffer-envio"
+
+/**
+ * Cantidad máxima de conexiones salientes abiertas al mismo tiempo en cada nodo. Al alcanzar
+ * el máximo se cierra la conexión usada hace más tiempo sin hormigas en espera; si todas tienen
+ * hormigas en espera la hormiga a enviar se descarta. Un máximo menor a la cantidad de nodos
+ * a los que envia cada nodo hace que las conexiones se cierren y se vuelvan a abrir continuamente.
+ *
+ * Formato en el archivo: <nombre> <valor> [<espera> [<inactividad>]]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_MAX_CONNECTIONS
+ * - valor : entero >= 0 (0 no limita la cantidad de conexiones)
+ * - espera : entero >= 0 (Máximo de hormigas en espera de cada conexión, las demás se descartan;
+ *   0 = sin límite, por defecto DEFAULT_MAX_PENDING_ANTS)
+ * - inactividad : real >= 0 (Segundos sin envios luego de los cuales se cierra una conexión sin
+ *   hormigas en espera, 0 = no se cierran, por defecto)
+ *
+ * @see ArapConnectionPool
+ */
+#define PARAM_MAX_CONNECTIONS "conexiones-maximas"
+
+/**
+ * Protocolo de transporte usado para enviar las hormigas entre los nodos.
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_TRANSPORT
+ * - valor : "tcp" (Por defecto, una conexión por cada par de nodos) o "udp" (Un socket de
+ * datagramas por nodo, sin conexiones ni retransmisiones; las hormigas descartadas en la red
+ * se pierden)
+ *
+ * @see Transport
+ */
+#define PARAM_TRANSPORT "transporte"
+
+/**
+ * Habilita el perfilado del tiempo real que consumen los métodos de los nodos. El resumen se
+ * escribe al finalizar la simulación, y opcionalmente una serie de tiempo con los contadores.
+ *
+ * Formato en el archivo: <nombre> <valor> [<intervalo>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_PROFILING
+ * - valor : bool (1 habilita el perfilado)
+ * - intervalo : real >= 0, intervalo de la serie de tiempo en segundos simulados (0 o ausente = sin serie)
+ *
+ * @see ArapProfiler
+ */
+#define PARAM_PROFILING "perfilado"
+
+/**
+ * Topología de la red sobre la que se ejecuta la red anónima. Los nodos se conectan cada uno
+ * a un enrutador, repartidos en bloques contiguos de nodos entre los enrutadores.
+ *
+ * Formato en el archivo: <nombre> <identificador de caso> [<parámetros de caso>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_TOPOLOGY
+ * - identificador de caso y parámetros (Definidos en TopologyFactory::GetInstance()):
+ *   - estrella : Un solo enrutador (Por defecto)
+ *   - multi-hub <cantidad> : <cantidad> (>= 2) enrutadores unidos en anillo
+ *   - dumbbell : Dos enrutadores unidos por un solo enlace
+ *   - grilla <filas> <columnas> : Grilla de enrutadores
+ *   - archivo <formato> <ruta> : Enrutadores y enlaces leidos de un archivo Inet, Orbis o Rocketfuel
+ *
+ * @see ArapTopology
+ */
+#define PARAM_TOPOLOGY "topologia"
+
+/**
+ * Simulación distribuida entre varios procesos con MPI. El programa se debe ejecutar con
+ * "mpirun -np <procesos>" y NS3 se debe configurar con --enable-mpi. Los nodos se reparten
+ * entre los procesos en bloques contiguos, y el delay de los enlaces entre nodos de distintos
+ * procesos no baja del mínimo sorteado al inicio (Lookahead del simulador distribuido).
+ * No se puede usar junto con las réplicas.
+ *
+ * Formato en el archivo: <nombre> <valor> [<algoritmo>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_DISTRIBUTED
+ * - valor : bool (1 habilita la simulación distribuida)
+ * - algoritmo : "ventana" (Ventana de tiempo concedida, por defecto) o "mensajes-nulos"
+ *
+ * @see ArapDistributed
+ */
+#define PARAM_DISTRIBUTED "simulacion-distribuida"
+
+/**
+ * Guardar el estado aprendido de todos los nodos (Tablas de probabilidad, modelos de las
+ * exploradoras y estadísticas de las hormigas de carga) en un archivo binario, para iniciar
+ * otras simulaciones a partir de él (Ver PARAM_LOAD_STATE). En una simulación distribuida
+ * cada proceso guarda sus nodos en su propio archivo: el proceso 0 en "<archivo>" y el proceso r
+ * en "<archivo>.r<r>" (Ver ArapDistributed::GetRankFilename()). Con réplicas solo guarda la primera.
+ *
+ * Formato en el archivo: <nombre> <tiempo> <archivo>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_SAVE_STATE
+ * - tiempo : real >= 0 (Segundos de simulación, <= PARAM_SIMULATOR_STOP_TIME)
+ * - archivo : Ruta del archivo a crear
+ */
+#define PARAM_SAVE_STATE "guardar-estado"
+
+/**
+ * Iniciar la simulación con el estado guardado por otra (Ver PARAM_SAVE_STATE) en lugar de
+ * las tablas uniformes. La red (Cantidad de nodos, topología y PARAM_PATH_MANAGER) debe ser la
+ * misma con la que se guardó el estado. Solo se restaura el estado aprendido: el tiempo de
+ * simulación, las hormigas en tránsito y las tablas de enrutamiento comienzan desde cero.
+ * En una simulación distribuida cada proceso lee el archivo que guardó (Ver PARAM_SAVE_STATE),
+ * por lo que la cantidad de procesos también debe ser la misma.
+ *
+ * Formato en el archivo: <nombre> <archivo> [<estadisticas>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_LOAD_STATE
+ * - archivo : Ruta del archivo guardado
+ * - estadisticas : bool, restaurar también las estadísticas de las hormigas de carga (Por defecto 1).
+ *   Con 0 la medición de la nueva simulación comienza sin muestras
+ */
+#define PARAM_LOAD_STATE "cargar-estado"
+
+/**
+ * Monitor de convergencia: detiene la simulación (O inicia la fase de medición) cuando el
+ * cambio de las tablas de probabilidad y la deriva del RTT de las hormigas de carga se mantienen
+ * bajo los umbrales durante varios chequeos seguidos.
+ *
+ * Formato en el archivo: <nombre> <intervalo> <umbral tablas> <umbral rtt> <chequeos> [<accion>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_CONVERGENCE
+ * - intervalo : real > 0 (Segundos simulados entre chequeos)
+ * - umbral tablas : real >= 0 (Máximo cambio L1 de una fila de una tabla entre dos chequeos)
+ * - umbral rtt : real >= 0 (Máxima variación relativa del RTT medio de las hormigas de carga entre dos ventanas)
+ * - chequeos : entero >= 1 (Chequeos seguidos bajo los umbrales)
+ * - accion : "detener" (Por defecto) o "medir" (Reinicia las estadísticas de las hormigas de carga y continúa)
+ *
+ * @see ArapConvergenceMonitor
+ */
+#define PARAM_CONVERGENCE "convergencia"
+
+/**
+ * Motor de la simulación.
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_ENGINE
+ * - valor : "paquetes" (Por defecto, cada salto de las hormigas pasa por la pila TCP/IP y los
+ * enlaces punto a punto de la topología) o "abstracto" (Cada salto se calcula analíticamente en
+ * una red estrella, sin pila TCP/IP, para estudiar los algoritmos en redes más grandes o por más
+ * tiempo). El motor abstracto no se puede usar con PARAM_TOPOLOGY ni con PARAM_DISTRIBUTED, e
+ * ignora PARAM_TRANSPORT, PARAM_ENABLE_TRACING y los parámetros de las conexiones
+ *
+ * @see Engine
+ * @see ArapAbstractNetwork
+ */
+#define PARAM_ENGINE "motor"
+
+/**
+ * Servidor de cómputo de cada nodo: limita la cantidad de hormigas que un nodo procesa a la
+ * vez durante su delay de cómputo, las demás esperan en cola.
+ *
+ * Formato en el archivo: <nombre> <trabajadores> [<disciplina>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_COMPUTING_SERVER
+ * - trabajadores : entero >= 0 (Hormigas procesadas a la vez en cada nodo, 0 = sin límite, por defecto)
+ * - disciplina : "fifo" (Por defecto, orden de llegada) o "prioridad" (Primero las respuestas,
+ *   luego las peticiones reenviadas y por último las hormigas nuevas del nodo)
+ *
+ * @see ArapComputingServer
+ */
+#define PARAM_COMPUTING_SERVER "servidor-computo"
+
+
+/**
+ * Modelo del delay de los enlaces en el tiempo.
+ *
+ * Formato en el archivo: <nombre> <modelo> [<archivo>]
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_LINK_DELAY_MODEL
+ * - modelo : "barrido" (Por defecto, cada PARAM_LINK_DELAY_INTERVAL se cambia el delay de todos
+ *   los enlaces con PARAM_LINK_DELAY_DIST), "canal" (Los mismos intervalos y distribución, pero
+ *   cada enlace obtiene su delay al transmitir, sin eventos de cambio) o "traza" (Cada enlace
+ *   interpola linealmente los puntos de su traza al transmitir)
+ * - archivo : Archivo de trazas, solo con "traza" (Ver ArapTraceDelayProcess::ReadFile()). Los
+ *   enlaces se numeran como en ArapTopology::GetChannels() (Motor abstracto: índice del nodo)
+ *
+ * Los modelos "canal" y "traza" no se pueden usar con PARAM_DISTRIBUTED.
+ *
+ * @see LinkDelayModel
+ * @see ArapDelayChannel
+ */
+#define PARAM_LINK_DELAY_MODEL "delay-enlaces-modelo"
+
+/**
+ * Métricas de anonimato calculadas en memoria a medida que se crean los caminos de las
+ * hormigas de carga: conteos de uso de cada intermedio por destino, entropía de Shannon y
+ * min-entropía de la elección de intermedios y diversidad de caminos. Se imprimen junto con las
+ * tablas de probabilidad (Carpeta "tablas", archivos "anonimato_*") y al final se escribe un
+ * resumen por nodo en la carpeta "load-ants-model". Junto con PARAM_PATHS_FORMAT "ninguno"
+ * evita registrar y procesar todos los caminos. La memoria por destino es acotada: los caminos
+ * distintos se estiman con un DistinctCounter.
+ *
+ * Formato en el archivo: <nombre> <valor>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_ANONYMITY_METRICS
+ * - valor : 0 (Por defecto) o 1
+ *
+ * @see ArapAnonymityMetrics
+ */
+#define PARAM_ANONYMITY_METRICS "metricas-anonimato"
+
+/**
+ * Traza de carga: graba los envíos de hormigas de carga de la simulación (Instante, origen,
+ * destino y cantidad) o los reproduce desde una traza grabada en lugar de usar las
+ * distribuciones de carga, para comparar configuraciones con exactamente el mismo tráfico.
+ *
+ * Formato en el archivo: <nombre> <modo> <archivo>
+ *
+ * Donde:
+ * - nombre : VALOR DE PARAM_WORKLOAD
+ * - modo : "grabar" (Solo la primera réplica graba) o "reproducir" (La red debe tener la misma
+ *   cantidad de nodos que la traza; las distribuciones de carga se leen pero no se usan)
+ * - archivo : Nombre del archivo de la traza
+ *
+ * No se puede usar con PARAM_DISTRIBUTED.
+ *
+ * @see ArapWorkload
+ */
+#define PARAM_WORKLOAD "traza-carga"
+
 
 /** \addtogroup Distribuciones
  * Distribuciones de probabilidad validas para ser usada en los
@@ -419,7 +717,55 @@ enum StringValue {
 	PARAM_LOAD_ANT_TIME_DIST_V,
 	PARAM_LOAD_ANT_QUANTITY_DIST_V,
 	PARAM_LOAD_ANT_TARGET_DIST_V,
-	PARAM_PRINT_PROB_TABLES_INTERVAL_V
+	PARAM_PRINT_PROB_TABLES_INTERVAL_V,
+	PARAM_PATHS_FORMAT_V,
+	PARAM_ROUTING_RTT_MULTIPLE_V,
+	PARAM_SEND_BUFFER_SIZE_V,
+	PARAM_MAX_CONNECTIONS_V,
+	PARAM_TRANSPORT_V,
+	PARAM_PROFILING_V,
+	PARAM_TOPOLOGY_V,
+	PARAM_DISTRIBUTED_V,
+	PARAM_EXPLORER_SCHEDULER_V,
+	PARAM_SAVE_STATE_V,
+	PARAM_LOAD_STATE_V,
+	PARAM_CONVERGENCE_V,
+	PARAM_ENGINE_V,
+	PARAM_COMPUTING_SERVER_V,
+	PARAM_LINK_DELAY_MODEL_V,
+	PARAM_ANONYMITY_METRICS_V,
+	PARAM_WORKLOAD_V
+};
+
+/**
+ * Protocolos de transporte para el envio de las hormigas.
+ *
+ * @see PARAM_TRANSPORT
+ */
+enum Transport {
+	TRANSPORT_TCP,
+	TRANSPORT_UDP
+};
+
+/**
+ * Motores de la simulación.
+ *
+ * @see PARAM_ENGINE
+ */
+enum Engine {
+	ENGINE_PACKET,
+	ENGINE_ABSTRACT
+};
+
+/**
+ * Modelos del delay de los enlaces.
+ *
+ * @see PARAM_LINK_DELAY_MODEL
+ */
+enum LinkDelayModel {
+	LINK_DELAY_SWEEP,
+	LINK_DELAY_CHANNEL,
+	LINK_DELAY_TRACE
 };
 
 /**
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-delay-channel.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapDelayChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (ArapDelayChannel);
+
+ArapDelayProcess::~ArapDelayProcess(){
+}
+
+ArapRandomDelayProcess::ArapRandomDelayProcess(Ptr<RandomVariableStream> stream, const Time& interval)
+:m_stream(stream), m_interval(interval), m_nextChange(0), m_delay(0){
+}
+
+Time
+ArapRandomDelayProcess::GetDelay(const Time& now){
+	if(now<m_nextChange)
+		return m_delay;
+	m_delay = MilliSeconds(m_stream->GetValue());
+	if(m_interval.IsStrictlyPositive()){
+		//Los intervalos empiezan en multiplos de m_interval, igual que los cambios periodicos
+		int64_t current = now.GetTimeStep()/m_interval.GetTimeStep();
+		m_nextChange = Time((current+1)*m_interval.GetTimeStep());
+	}
+	else
+		m_nextChange = now;
+	return m_delay;
+}
+
+ArapTraceDelayProcess::ArapTraceDelayProcess()
+:m_segment(0){
+}
+
+void
+ArapTraceDelayProcess::AddPoint(const Time& time, const Time& delay){
+	NS_ABORT_MSG_IF(!m_points.empty() && time<m_points.back().first,"ERROR: Los puntos de la traza de delay deben estar en orden de tiempo");
+	m_points.push_back(std::make_pair(time,delay));
+}
+
+uint32_t
+ArapTraceDelayProcess::GetPointCount() const{
+	return m_points.size();
+}
+
+Time
+ArapTraceDelayProcess::GetDelay(const Time& now){
+	while(m_segment+1<m_points.size() && m_points[m_segment+1].first<=now)
+		m_segment++;
+	const std::pair<Time,Time>& from = m_points[m_segment];
+	if(now<=from.first || m_segment+1==m_points.size())
+		return from.second;
+	const std::pair<Time,Time>& to = m_points[m_segment+1];
+	double fraction = (now-from.first).GetSeconds()/(to.first-from.first).GetSeconds();
+	return from.second+Seconds((to.second-from.second).GetSeconds()*fraction);
+}
+
+bool
+ArapTraceDelayProcess::CompareTime(const std::pair<Time,Time>& a, const std::pair<Time,Time>& b){
+	return a.first<b.first;
+}
+
+std::vector<Ptr<ArapDelayProcess> >
+ArapTraceDelayProcess::ReadFile(const std::string& filename, uint32_t links){
+	std::vector<std::vector<std::pair<Time,Time> > > points(links);
+	std::string line, link;
+	std::ifstream file (filename.c_str());
+	if (!file.is_open())
+		NS_ABORT_MSG("ERROR: No se pudo leer el archivo de trazas de delay "<<filename);
+
+	NS_LOG_UNCOND("Leyendo trazas de delay desde archivo: \""<<filename<<"\"");
+	while (std::getline (file,line)) {
+		std::istringstream iss(line);
+		if(!(iss>>link) || link[0]=='#') //Linea vacia o comentario
+			continue;
+		double time, delay;
+		iss>>time>>delay;
+		NS_ABORT_MSG_IF(iss.fail() || time<0 || delay<0,"ERROR: Linea no valida en el archivo de trazas de delay: "<<line);
+		if(link=="*"){
+			for(uint32_t i=0;i<links;i++)
+				points[i].push_back(std::make_pair(Seconds(time),MilliSeconds(delay)));
+			continue;
+		}
+		std::istringstream linkStream(link);
+		uint32_t index;
+		NS_ABORT_MSG_IF(!(linkStream>>index) || !linkStream.eof() || index>=links,"ERROR: Enlace no valido en el archivo de trazas de delay: "<<line);
+		points[index].push_back(std::make_pair(Seconds(time),MilliSeconds(delay)));
+	}
+	file.close();
+
+	std::vector<Ptr<ArapDelayProcess> > processes;
+	for(uint32_t i=0;i<links;i++){
+		NS_ABORT_MSG_IF(points[i].empty(),"ERROR: El enlace "<<i<<" no tiene puntos en el archivo de trazas de delay");
+		//Los puntos de "*" y los del enlace pueden venir mezclados, con igual instante se respeta el orden del archivo
+		std::stable_sort(points[i].begin(),points[i].end(),CompareTime);
+		Ptr<ArapTraceDelayProcess> trace = Create<ArapTraceDelayProcess>();
+		for(uint32_t j=0;j<points[i].size();j++)
+			trace->AddPoint(points[i][j].first,points[i][j].second);
+		processes.push_back(trace);
+	}
+	return processes;
+}
+
+TypeId
+ArapDelayChannel::GetTypeId (void) {
+	static TypeId tid = TypeId ("ArapDelayChannel")
+		.SetParent<PointToPointChannel> ()
+		.AddConstructor<ArapDelayChannel> ();
+	return tid;
+}
+
+ArapDelayChannel::ArapDelayChannel(){
+}
+
+ArapDelayChannel::~ArapDelayChannel(){
+}
+
+void
+ArapDelayChannel::SetDelayProcess(Ptr<ArapDelayProcess> process){
+	m_process = process;
+}
+
+bool
+ArapDelayChannel::TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime){
+	NS_LOG_FUNCTION (this << p << src);
+	IsInitialized ();
+
+	uint32_t wire = src == GetSource (0) ? 0 : 1;
+	Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+	Time delay = (m_process==0) ? GetDelay () : m_process->GetDelay(Simulator::Now());
+	Simulator::ScheduleWithContext (dst->GetNode ()->GetId (), txTime + delay, &PointToPointNetDevice::Receive, dst, p);
+	TxRxPointToPoint (p, src, dst, txTime, txTime + delay);
+	return true;
+}
+
+} /* namespace ns3 */
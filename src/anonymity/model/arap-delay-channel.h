@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_DELAY_CHANNEL_H
+#define ARAP_DELAY_CHANNEL_H
+
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Proceso que define el delay de propagación de un enlace en el tiempo. Se evalúa solo cuando
+ * el enlace transmite, por lo que no requiere eventos propios. Cada enlace tiene su propio proceso.
+ *
+ * @see PARAM_LINK_DELAY_MODEL
+ */
+class ArapDelayProcess : public SimpleRefCount<ArapDelayProcess> {
+
+public:
+
+	virtual ~ArapDelayProcess();
+
+	/**
+	 * @param[in] now Instante actual de la simulación (No decrece entre llamadas)
+	 *
+	 * @return Delay de propagación del enlace en ese instante
+	 */
+	virtual Time GetDelay(const Time& now) = 0;
+};
+
+/**
+ * Delay escalonado: en cada intervalo el delay toma un valor de la distribución, igual que los
+ * cambios periódicos de ArapSimulator::ChangeLinkDelay(). El valor de un intervalo se obtiene en
+ * la primera transmisión dentro de él, los intervalos sin tráfico no piden valores.
+ */
+class ArapRandomDelayProcess : public ArapDelayProcess {
+
+public:
+
+	/**
+	 * @param[in] stream Distribución de los delays (Milisegundos), puede ser compartida entre enlaces
+	 *
+	 * @param[in] interval Duración de cada intervalo (0 = un valor por transmisión)
+	 */
+	ArapRandomDelayProcess(Ptr<RandomVariableStream> stream, const Time& interval);
+
+	virtual Time GetDelay(const Time& now);
+
+private:
+
+	Ptr<RandomVariableStream> m_stream; //!< Distribución de los delays (Milisegundos)
+	Time m_interval; //!< Duración de cada intervalo
+	Time m_nextChange; //!< Inicio del siguiente intervalo (Hasta entonces se usa m_delay)
+	Time m_delay; //!< Delay del intervalo actual
+};
+
+/**
+ * Delay definido por una traza: puntos (Instante, delay) con interpolación lineal entre ellos.
+ * Antes del primer punto se usa el delay del primero y después del último el del último.
+ */
+class ArapTraceDelayProcess : public ArapDelayProcess {
+
+public:
+
+	ArapTraceDelayProcess();
+
+	/**
+	 * Agrega un punto al final de la traza.
+	 *
+	 * @param[in] time Instante del punto (No menor al del punto anterior)
+	 *
+	 * @param[in] delay Delay en ese instante
+	 */
+	void AddPoint(const Time& time, const Time& delay);
+
+	/**
+	 * @return Cantidad de puntos de la traza
+	 */
+	uint32_t GetPointCount() const;
+
+	virtual Time GetDelay(const Time& now);
+
+	/**
+	 * Lee un archivo de trazas de delay, una línea por punto con el formato
+	 * "<enlace> <instante (s)> <delay (ms)>", donde enlace es el índice del enlace o "*" para
+	 * agregar el punto a todos, en cualquier orden. Las líneas vacías o que empiezan con "#" se ignoran.
+	 *
+	 * @param[in] filename Archivo de trazas
+	 *
+	 * @param[in] links Cantidad de enlaces (Cada uno debe tener al menos un punto)
+	 *
+	 * @return Proceso de cada enlace
+	 */
+	static std::vector<Ptr<ArapDelayProcess> > ReadFile(const std::string& filename, uint32_t links);
+
+private:
+
+	/**
+	 * Orden de los puntos por instante.
+	 */
+	static bool CompareTime(const std::pair<Time,Time>& a, const std::pair<Time,Time>& b);
+
+	std::vector<std::pair<Time,Time> > m_points; //!< Puntos (Instante, delay) en orden
+	uint32_t m_segment; //!< Último punto con instante menor o igual al de la última evaluación
+};
+
+/**
+ * Canal punto a punto cuyo delay de propagación lo define un ArapDelayProcess, evaluado al
+ * inicio de cada transmisión. Reemplaza los cambios periódicos del atributo "Delay" de todos
+ * los canales. Sin proceso se comporta como PointToPointChannel.
+ */
+class ArapDelayChannel : public PointToPointChannel {
+
+public:
+
+	/**
+	 * @return TypeId del canal
+	 */
+	static TypeId GetTypeId (void);
+
+	ArapDelayChannel();
+	virtual ~ArapDelayChannel();
+
+	/**
+	 * @param[in] process Proceso del delay de propagación del canal (Ambos sentidos)
+	 */
+	void SetDelayProcess(Ptr<ArapDelayProcess> process);
+
+	/**
+	 * Programa la recepción del paquete en el otro extremo con el delay actual del proceso, y
+	 * dispara la traza "TxRxPointToPoint" igual que PointToPointChannel.
+	 *
+	 * @param[in] p Paquete a transmitir
+	 *
+	 * @param[in] src Dispositivo que transmite
+	 *
+	 * @param[in] txTime Tiempo de serialización del paquete
+	 *
+	 * @return true
+	 */
+	virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
+
+private:
+
+	Ptr<ArapDelayProcess> m_process; //!< Proceso del delay de propagación
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_DELAY_CHANNEL_H */
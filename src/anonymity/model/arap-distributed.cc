@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-distributed.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/mpi-interface.h"
+#include <sstream>
+#include <vector>
+#include <cstdio>
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapDistributed");
+
+#ifdef NS3_MPI
+void
+ArapDistributed::Enable(Algorithm algorithm){
+	NS_ABORT_MSG_IF(MpiInterface::IsEnabled(),"ERROR: La simulacion distribuida ya fue habilitada en este proceso");
+	if(algorithm==ALGORITHM_NULL_MESSAGE)
+		GlobalValue::Bind("SimulatorImplementationType",StringValue("ns3::NullMessageSimulatorImpl"));
+	else
+		GlobalValue::Bind("SimulatorImplementationType",StringValue("ns3::DistributedSimulatorImpl"));
+	//MPI no necesita los argumentos del programa, los que deja mpirun se leen del entorno
+	static int argc = 0;
+	static char** argv = NULL;
+	MpiInterface::Enable(&argc,&argv);
+	NS_LOG_INFO("Rango "<<GetRank()<<" de "<<GetSize());
+}
+#else
+void
+ArapDistributed::Enable(Algorithm){
+	NS_ABORT_MSG("ERROR: NS3 se compilo sin MPI, configure con \"./waf configure --enable-mpi\" para usar la simulacion distribuida");
+}
+#endif
+
+void
+ArapDistributed::Disable(){
+	if(IsEnabled())
+		MpiInterface::Disable();
+}
+
+bool
+ArapDistributed::IsEnabled(){
+	return MpiInterface::IsEnabled();
+}
+
+uint32_t
+ArapDistributed::GetRank(){
+	return MpiInterface::GetSystemId();
+}
+
+uint32_t
+ArapDistributed::GetSize(){
+	return MpiInterface::GetSize();
+}
+
+bool
+ArapDistributed::IsRoot(){
+	return GetRank()==0;
+}
+
+bool
+ArapDistributed::IsLocal(Ptr<Node> node){
+	return node->GetSystemId()==GetRank();
+}
+
+uint64_t
+ArapDistributed::Sum(uint64_t value){
+#ifdef NS3_MPI
+	if(IsEnabled()){
+		unsigned long long local = value, total = 0;
+		MPI_Allreduce(&local,&total,1,MPI_UNSIGNED_LONG_LONG,MPI_SUM,MPI_COMM_WORLD);
+		return total;
+	}
+#endif
+	return value;
+}
+
+double
+ArapDistributed::Sum(double value){
+#ifdef NS3_MPI
+	if(IsEnabled()){
+		double total = 0;
+		MPI_Allreduce(&value,&total,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+		return total;
+	}
+#endif
+	return value;
+}
+
+double
+ArapDistributed::Max(double value){
+#ifdef NS3_MPI
+	if(IsEnabled()){
+		double max = 0;
+		MPI_Allreduce(&value,&max,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+		return max;
+	}
+#endif
+	return value;
+}
+
+std::string
+ArapDistributed::Gather(const std::string& data){
+#ifdef NS3_MPI
+	if(IsEnabled()){
+		int size = GetSize();
+		int length = data.size();
+		std::vector<int> lengths(size,0);
+		MPI_Gather(&length,1,MPI_INT,&lengths[0],1,MPI_INT,0,MPI_COMM_WORLD);
+		std::vector<int> offsets(size,0);
+		int total = 0;
+		for(int i=0;i<size;i++){
+			offsets[i] = total;
+			total += lengths[i];
+		}
+		std::vector<char> buffer(total+1);
+		MPI_Gatherv(const_cast<char*>(data.data()),length,MPI_CHAR,&buffer[0],&lengths[0],&offsets[0],MPI_CHAR,0,MPI_COMM_WORLD);
+		if(!IsRoot())
+			return std::string();
+		return std::string(&buffer[0],total);
+	}
+#endif
+	return data;
+}
+
+std::string
+ArapDistributed::GetRankFilename(const std::string& filename){
+	if(IsRoot())
+		return filename;
+	std::ostringstream oss;
+	oss<<filename<<".r"<<GetRank();
+	return oss.str();
+}
+
+#ifdef NS3_MPI
+void
+ArapDistributed::MergeRankFiles(const std::string& filename, MergeCallback merge){
+	if(!IsEnabled())
+		return;
+	MPI_Barrier(MPI_COMM_WORLD); //Todos los rangos cerraron sus archivos
+	if(IsRoot()){
+		std::vector<std::string> others;
+		for(uint32_t rank=1;rank<GetSize();rank++){
+			std::ostringstream oss;
+			oss<<filename<<".r"<<rank;
+			others.push_back(oss.str());
+		}
+		if(!merge(filename,others)){
+			NS_LOG_INFO("Fallo el combinar los archivos de los rangos en: "+filename);
+			return;
+		}
+		for(uint32_t i=0;i<others.size();i++)
+			std::remove(others[i].c_str());
+	}
+}
+#else
+void
+ArapDistributed::MergeRankFiles(const std::string&, MergeCallback){
+}
+#endif
+
+} /* namespace ns3 */
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_DISTRIBUTED_H
+#define ARAP_DISTRIBUTED_H
+
+#include "ns3/node.h"
+#include "ns3/callback.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Utilidades para ejecutar una simulación distribuida con MPI (Módulo mpi de NS3).
+ *
+ * Todos los procesos (Rangos) crean la topología completa y el directorio de nodos, pero cada
+ * nodo pertenece a un solo rango (Su SystemId) y solo ese rango instala y ejecuta su
+ * aplicación. Los enlaces entre nodos de distintos rangos son canales remotos
+ * (%PointToPointRemoteChannel), por los que las hormigas viajan serializadas entre procesos.
+ *
+ * Al finalizar, cada rango calcula las estadísticas de sus nodos y el rango 0 las combina
+ * (Gather(), Sum()) y escribe los archivos de salida.
+ *
+ * Si NS3 se compiló sin MPI (./waf configure sin --enable-mpi) o la simulación distribuida no
+ * está habilitada, hay un solo rango y todos los métodos equivalen a una ejecución en un
+ * solo proceso.
+ */
+class ArapDistributed {
+
+public:
+
+	/**
+	 * Algoritmos de sincronización entre rangos.
+	 */
+	enum Algorithm {
+		ALGORITHM_GRANTED_WINDOW, //!< Ventana de tiempo concedida (%DistributedSimulatorImpl)
+		ALGORITHM_NULL_MESSAGE //!< Mensajes nulos (%NullMessageSimulatorImpl)
+	};
+
+	/**
+	 * Inicializa MPI y selecciona la implementación distribuida del simulador. Se debe llamar
+	 * antes de crear la topología y de usar el simulador. Finaliza la simulación si NS3 se
+	 * compiló sin MPI.
+	 *
+	 * @param[in] algorithm Algoritmo de sincronización entre rangos
+	 */
+	static void Enable(Algorithm algorithm);
+
+	/**
+	 * Finaliza MPI (Luego de escribir todos los archivos de salida).
+	 */
+	static void Disable();
+
+	/**
+	 * @return true si la simulación distribuida está habilitada
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * @return Rango del proceso (0 si no está habilitada)
+	 */
+	static uint32_t GetRank();
+
+	/**
+	 * @return Cantidad de rangos (1 si no está habilitada)
+	 */
+	static uint32_t GetSize();
+
+	/**
+	 * @return true si el proceso es el rango 0, que escribe las salidas combinadas
+	 */
+	static bool IsRoot();
+
+	/**
+	 * @param[in] node Nodo de NS3
+	 *
+	 * @return true si el nodo pertenece a este rango
+	 */
+	static bool IsLocal(Ptr<Node> node);
+
+	/**
+	 * Suma un valor entre todos los rangos (Todos los rangos deben llamar a este método).
+	 *
+	 * @param[in] value Valor de este rango
+	 *
+	 * @return Suma de los valores de todos los rangos
+	 */
+	static uint64_t Sum(uint64_t value);
+
+	/**
+	 * @copydoc Sum(uint64_t)
+	 */
+	static double Sum(double value);
+
+	/**
+	 * Máximo de un valor entre todos los rangos (Todos los rangos deben llamar a este método).
+	 *
+	 * @param[in] value Valor de este rango
+	 *
+	 * @return Máximo de los valores de todos los rangos
+	 */
+	static double Max(double value);
+
+	/**
+	 * Concatena en el rango 0 los datos de todos los rangos, en orden de rango (Todos los
+	 * rangos deben llamar a este método). Como los nodos se reparten entre los rangos en
+	 * bloques contiguos de índices, concatenar filas por nodo conserva el orden de los nodos.
+	 *
+	 * @param[in] data Datos de este rango
+	 *
+	 * @return En el rango 0 los datos de todos los rangos, en los demás una cadena vacía
+	 */
+	static std::string Gather(const std::string& data);
+
+	/**
+	 * @param[in] filename Nombre del archivo de salida combinado
+	 *
+	 * @return Nombre del archivo que escribe este rango: el mismo en el rango 0, y con el
+	 * sufijo ".r<rango>" en los demás
+	 */
+	static std::string GetRankFilename(const std::string& filename);
+
+	/**
+	 * Combina en el rango 0: archivo combinado y archivos de los demás rangos en orden de rango.
+	 * Retorna false si no pudo combinarlos.
+	 */
+	typedef Callback<bool,const std::string&,const std::vector<std::string>&> MergeCallback;
+
+	/**
+	 * Combina en el archivo del rango 0 los archivos de los demás rangos (Ver GetRankFilename())
+	 * y los elimina. Todos los rangos deben llamar a este método luego de cerrar sus archivos.
+	 *
+	 * @param[in] filename Nombre del archivo de salida combinado
+	 *
+	 * @param[in] merge Combina los archivos según su formato (Por ejemplo ArapPathLogger::MergeFiles(),
+	 * que intercala los registros por tiempo)
+	 */
+	static void MergeRankFiles(const std::string& filename, MergeCallback merge);
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_DISTRIBUTED_H */
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-explorer-scheduler.h"
+#include "ns3/arap-node.h"
+#include "ns3/explorer-ants-statistics.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <cmath>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapExplorerScheduler");
+
+ArapExplorerScheduler::ArapExplorerScheduler()
+:m_node(NULL){
+}
+
+ArapExplorerScheduler::~ArapExplorerScheduler(){
+}
+
+void
+ArapExplorerScheduler::Stop(){
+	Simulator::Cancel(m_event);
+}
+
+ArapExplorerScheduler*
+FloodExplorerScheduler::GetCopy() const{
+	return new FloodExplorerScheduler();
+}
+
+std::string
+FloodExplorerScheduler::GetName() const{
+	return "inundacion";
+}
+
+void
+FloodExplorerScheduler::Start(ArapNode* node){
+	m_node = node;
+	Explore();
+}
+
+void
+FloodExplorerScheduler::Explore(){
+	const ArapNodeDirectory& directory=ArapSimulator::GetDirectory();
+	for(uint32_t i=0; i<directory.GetCount();i++){
+		//La IP se lee del directorio, ya que el nodo puede pertenecer a otro rango (Sin aplicacion en este proceso)
+		const Ipv4Address& target = directory.GetAddress(i);
+		if(target==m_node->GetLocalIP())
+			continue;
+		m_node->SendExplorerAnts(target);
+	}
+	m_event = Simulator::Schedule(ArapSimulator::GetExplorersDelta(),&FloodExplorerScheduler::Explore,this);
+}
+
+BudgetExplorerScheduler::BudgetExplorerScheduler(double budget, double jitter)
+:m_budget(budget), m_jitter(jitter), m_period(Seconds(1.0/budget)), m_localIndex(0){
+	NS_ABORT_MSG_IF(budget<=0,"ERROR: El presupuesto de exploradoras debe ser mayor a cero");
+	NS_ABORT_MSG_IF(jitter<0 || jitter>1,"ERROR: El jitter del presupuesto de exploradoras debe estar entre 0 y 1");
+}
+
+ArapExplorerScheduler*
+BudgetExplorerScheduler::GetCopy() const{
+	return new BudgetExplorerScheduler(m_budget,m_jitter);
+}
+
+std::string
+BudgetExplorerScheduler::GetName() const{
+	std::ostringstream oss;
+	oss<<"presupuesto("<<m_budget<<"/s, jitter "<<m_jitter<<")";
+	return oss.str();
+}
+
+void
+BudgetExplorerScheduler::Start(ArapNode* node){
+	m_node = node;
+	const ArapNodeDirectory& directory=ArapSimulator::GetDirectory();
+	uint32_t numNodes = directory.GetCount();
+	if(numNodes<3) //No hay caminos con intermedio
+		return;
+	m_localIndex = directory.GetIndex(node->GetLocalIP());
+	m_lastExplored.assign(numNodes,Simulator::Now());
+	m_nextMedium.assign(numNodes,0);
+	m_rng = CreateObject<UniformRandomVariable>();
+	//El primer envio se desfasa dentro de un periodo para que los nodos no inicien juntos
+	m_event = Simulator::Schedule(Seconds(m_rng->GetValue(0,m_period.GetSeconds())),&BudgetExplorerScheduler::Explore,this);
+}
+
+void
+BudgetExplorerScheduler::Explore(){
+	const ArapNodeDirectory& directory=ArapSimulator::GetDirectory();
+	uint32_t numNodes = directory.GetCount();
+	Time now = Simulator::Now();
+
+	/* Se recorre desde el nodo siguiente al local, asi los empates (Al inicio todos los
+	 * destinos tienen la misma prioridad) no llevan a todos los nodos al mismo destino
+	 */
+	uint32_t target = m_localIndex;
+	double bestPriority = -1;
+	for(uint32_t k=1;k<numNodes;k++){
+		uint32_t i = (m_localIndex+k)%numNodes;
+		double priority = (now-m_lastExplored[i]+m_period).GetSeconds()*(1+GetUncertainty(i));
+		if(priority>bestPriority){
+			bestPriority = priority;
+			target = i;
+		}
+	}
+
+	//El intermedio rota entre los que mantiene la tabla del nodo para ese destino
+	m_node->GetPathManager().GetExplorerMediums(target,m_mediums);
+	uint32_t medium = m_mediums[m_nextMedium[target]%m_mediums.size()];
+	m_nextMedium[target] = (m_nextMedium[target]+1)%m_mediums.size();
+	m_lastExplored[target] = now;
+
+	m_node->SendExplorerAnt(directory.GetAddress(target),directory.GetAddress(medium));
+	m_event = Simulator::Schedule(GetNextInterval(),&BudgetExplorerScheduler::Explore,this);
+}
+
+Time
+BudgetExplorerScheduler::GetNextInterval(){
+	return Seconds(m_period.GetSeconds()*(1+m_jitter*m_rng->GetValue(-1,1)));
+}
+
+double
+BudgetExplorerScheduler::GetUncertainty(uint32_t targetIndex) const{
+	const ExplorerAntsStatistics* stats = m_node->GetPathManager().GetExplorerStatistics(targetIndex);
+	if(stats==NULL || stats->GetMean()<=0)
+		return 1;
+	double cv = sqrt(stats->GetVariance())/stats->GetMean();
+	return (cv<1) ? cv : 1;
+}
+
+} /* namespace ns3 */
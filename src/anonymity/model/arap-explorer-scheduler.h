@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_EXPLORER_SCHEDULER_H
+#define ARAP_EXPLORER_SCHEDULER_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
+#include <string>
+#include <vector>
+
+#define DEFAULT_EXPLORER_JITTER 0.5 //!< Variación relativa por defecto del intervalo entre exploradoras del planificador presupuesto
+
+namespace ns3 {
+
+class ArapNode;
+
+/**
+ * Planificador del envío de hormigas exploradoras de un nodo. Decide cuándo y por cuál
+ * celda de la tabla de probabilidades (Destino, intermedio) se envía cada exploradora.
+ *
+ * ArapSimulator mantiene una instancia como prototipo (Ver PARAM_EXPLORER_SCHEDULER) y cada
+ * nodo recibe su propia copia (GetCopy()), ya que el planificador guarda el estado de la
+ * exploración de ese nodo.
+ *
+ * Para agregar un nuevo planificador se debe heredar de esta clase y agregar su caso en
+ * ExplorerSchedulerFactory::GetInstance().
+ */
+class ArapExplorerScheduler {
+
+public:
+
+	ArapExplorerScheduler();
+	virtual ~ArapExplorerScheduler();
+
+	/**
+	 * @return Puntero a una nueva copia de este objeto (Sin el estado de la exploración)
+	 */
+	virtual ArapExplorerScheduler* GetCopy() const = 0;
+
+	/**
+	 * @return Nombre del planificador (Para los mensajes de la simulación)
+	 */
+	virtual std::string GetName() const = 0;
+
+	/**
+	 * Inicia el envío periódico de exploradoras del nodo. Se llama al iniciar la aplicación.
+	 *
+	 * @param[in] node Nodo que envía las exploradoras (Debe existir mientras dure la simulación)
+	 */
+	virtual void Start(ArapNode* node) = 0;
+
+	/**
+	 * Cancela el próximo envío programado.
+	 */
+	void Stop();
+
+protected:
+
+	ArapNode* m_node; //!< Nodo al que pertenece el planificador
+	EventId m_event; //!< Próximo envío programado
+};
+
+/**
+ * Inundación: cada intervalo de exploradoras (PARAM_EXPLORER_INTERVAL) el nodo envía una
+ * exploradora por cada par (Destino, intermedio), (N-1)×(N-2) en el mismo instante. Es el
+ * planificador por defecto.
+ */
+class FloodExplorerScheduler : public ArapExplorerScheduler {
+public:
+	virtual ArapExplorerScheduler* GetCopy() const;
+	virtual std::string GetName() const;
+	virtual void Start(ArapNode* node);
+private:
+	/**
+	 * Envía las exploradoras a todos los destinos y programa la próxima inundación.
+	 */
+	void Explore();
+};
+
+/**
+ * Presupuesto: cada nodo envía a lo sumo una cantidad fija de exploradoras por segundo
+ * simulado, una a la vez y en instantes con ruido (Jitter), de manera que los nodos no
+ * exploran sincronizados.
+ *
+ * Cada envío se asigna al destino con mayor prioridad, definida como el tiempo desde la
+ * última exploradora enviada a ese destino multiplicado por 1 más la incertidumbre de su
+ * modelo estocástico (Coeficiente de variación, acotado a 1; 1 si el modelo no tiene
+ * muestras o el ArapPathManager no lo mantiene). El intermedio de cada destino rota entre
+ * los que mantiene la tabla (ArapPathManager::GetExplorerMediums()), por lo que todas las
+ * celdas de una fila se exploran por igual.
+ */
+class BudgetExplorerScheduler : public ArapExplorerScheduler {
+public:
+	/**
+	 * @param[in] budget Exploradoras por segundo simulado de cada nodo (> 0)
+	 *
+	 * @param[in] jitter Variación relativa del intervalo entre envíos ([0,1])
+	 */
+	BudgetExplorerScheduler(double budget, double jitter);
+	virtual ArapExplorerScheduler* GetCopy() const;
+	virtual std::string GetName() const;
+	virtual void Start(ArapNode* node);
+private:
+	/**
+	 * Envía una exploradora por la celda de mayor prioridad y programa el próximo envío.
+	 */
+	void Explore();
+
+	/**
+	 * @return Tiempo hasta el próximo envío: el período del presupuesto con ruido uniforme
+	 */
+	Time GetNextInterval();
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @return Incertidumbre del modelo estocástico del destino ([0,1])
+	 */
+	double GetUncertainty(uint32_t targetIndex) const;
+
+	double m_budget; //!< Exploradoras por segundo simulado
+	double m_jitter; //!< Variación relativa del intervalo entre envíos
+	Time m_period; //!< Intervalo medio entre envíos (1/m_budget)
+	uint32_t m_localIndex; //!< Índice del nodo local en ArapNodeDirectory
+	std::vector<Time> m_lastExplored; //!< Instante de la última exploradora enviada a cada destino
+	std::vector<uint32_t> m_nextMedium; //!< Posición del próximo intermedio de cada destino (Ver ArapPathManager::GetExplorerMediums())
+	std::vector<uint32_t> m_mediums; //!< Intermedios del destino seleccionado (Para no reservar memoria en cada envío)
+	Ptr<UniformRandomVariable> m_rng; //!< Flujo aleatorio para el ruido de los intervalos
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_EXPLORER_SCHEDULER_H */
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-node-directory.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapNodeDirectory");
+
+ArapNodeDirectory::ArapNodeDirectory(){
+}
+
+ArapNodeDirectory::~ArapNodeDirectory(){
+	Clear();
+}
+
+void
+ArapNodeDirectory::Build(const ArapTopology& topology){
+	Clear();
+	/* Se ordenan los pares (IP, nodo de la topologia) por IP para que el
+	 * indice de cada nodo respete el orden de las IP
+	 */
+	std::vector<std::pair<Ipv4Address,uint32_t> > nodes;
+	nodes.reserve(topology.GetNodeCount());
+	for(uint32_t i=0;i<topology.GetNodeCount();i++)
+		nodes.push_back(std::make_pair(topology.GetAddress(i),i));
+	std::sort(nodes.begin(),nodes.end());
+
+	m_addresses.reserve(nodes.size());
+	m_nodes.reserve(nodes.size());
+	for(std::vector<std::pair<Ipv4Address,uint32_t> >::iterator it = nodes.begin();it!=nodes.end();it++){
+		NS_ABORT_MSG_IF(!m_addresses.empty() && m_addresses.back()==it->first,"ERROR: La IP "<<it->first<<" esta repetida en la red");
+		m_addresses.push_back(it->first);
+		m_nodes.push_back(topology.GetNode(it->second));
+	}
+	NS_LOG_INFO("Directorio de nodos creado con "<<m_addresses.size()<<" nodos");
+}
+
+void
+ArapNodeDirectory::Build(const NodeContainer& nodes, const Ipv4Address& base){
+	Clear();
+	m_addresses.reserve(nodes.GetN());
+	m_nodes.reserve(nodes.GetN());
+	for(uint32_t i=0;i<nodes.GetN();i++){
+		m_addresses.push_back(Ipv4Address(base.Get()+i+1));
+		m_nodes.push_back(nodes.Get(i));
+	}
+	NS_LOG_INFO("Directorio de nodos creado con "<<m_addresses.size()<<" nodos");
+}
+
+void
+ArapNodeDirectory::Clear(){
+	m_addresses.clear();
+	m_nodes.clear();
+}
+
+uint32_t
+ArapNodeDirectory::GetCount() const{
+	return m_addresses.size();
+}
+
+uint32_t
+ArapNodeDirectory::FindIndex(const Ipv4Address& ip) const{
+	std::vector<Ipv4Address>::const_iterator it = std::lower_bound(m_addresses.begin(),m_addresses.end(),ip);
+	if(it==m_addresses.end() || !(*it==ip))
+		return INVALID_INDEX;
+	return it-m_addresses.begin();
+}
+
+uint32_t
+ArapNodeDirectory::GetIndex(const Ipv4Address& ip) const{
+	uint32_t index = FindIndex(ip);
+	NS_ABORT_MSG_IF(index==INVALID_INDEX,"ERROR: La IP "<<ip<<" no pertenece a la red");
+	return index;
+}
+
+const Ipv4Address&
+ArapNodeDirectory::GetAddress(uint32_t index) const{
+	return m_addresses[index];
+}
+
+Ptr<Node>
+ArapNodeDirectory::GetNode(uint32_t index) const{
+	return m_nodes[index];
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_NODE_DIRECTORY_H
+#define ARAP_NODE_DIRECTORY_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/arap-topology.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Directorio de los nodos de la red anónima, que asocia a la IP de cada nodo un
+ * índice compacto en el rango [0, cantidad de nodos-1].
+ *
+ * Los índices se asignan en orden creciente de IP, de modo que recorrer los índices
+ * en orden es equivalente a recorrer un std::map indexado por IP. Esto permite a las
+ * tablas densas (Ver ArapPathManager) conservar el mismo orden de recorrido (Y por lo
+ * tanto los mismos resultados) que las tablas originales basadas en mapas.
+ *
+ * El directorio se construye una sola vez luego de asignar las direcciones IP de la red.
+ */
+class ArapNodeDirectory {
+
+public:
+
+	/**
+	 * Valor retornado por FindIndex() cuando la IP no pertenece a la red.
+	 */
+	static const uint32_t INVALID_INDEX = 0xffffffff;
+
+	ArapNodeDirectory();
+	~ArapNodeDirectory();
+
+	/**
+	 * Construye el directorio con los nodos de la topología (Los enrutadores no forman parte
+	 * de la red anónima).
+	 *
+	 * @param[in] topology Topología con las direcciones IP ya asignadas
+	 */
+	void Build(const ArapTopology& topology);
+
+	/**
+	 * Construye el directorio con nodos que no tienen pila TCP/IP (Motor abstracto). Las IP
+	 * se asignan en el orden de los nodos a partir de la siguiente a la IP base.
+	 *
+	 * @param[in] nodes Nodos de la red anónima
+	 *
+	 * @param[in] base IP base de la red
+	 */
+	void Build(const NodeContainer& nodes, const Ipv4Address& base);
+
+	/**
+	 * Elimina todos los nodos del directorio.
+	 */
+	void Clear();
+
+	/**
+	 * @return Cantidad de nodos en el directorio
+	 */
+	uint32_t GetCount() const;
+
+	/**
+	 * Obtiene el índice de un nodo, finaliza la simulación si la IP no pertenece a la red.
+	 *
+	 * @param[in] ip IP del nodo
+	 *
+	 * @return Índice del nodo
+	 */
+	uint32_t GetIndex(const Ipv4Address& ip) const;
+
+	/**
+	 * Busca el índice de un nodo.
+	 *
+	 * @param[in] ip IP del nodo
+	 *
+	 * @return Índice del nodo, o INVALID_INDEX si la IP no pertenece a la red
+	 */
+	uint32_t FindIndex(const Ipv4Address& ip) const;
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return IP del nodo
+	 */
+	const Ipv4Address& GetAddress(uint32_t index) const;
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return Nodo de NS3 correspondiente al índice
+	 */
+	Ptr<Node> GetNode(uint32_t index) const;
+
+private:
+
+	std::vector<Ipv4Address> m_addresses; //!< IP de cada nodo, ordenadas de menor a mayor (Posición = índice)
+	std::vector<Ptr<Node> > m_nodes; //!< Nodo de NS3 de cada índice
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_NODE_DIRECTORY_H */
@@ -5,13 +5,14 @@
 #include "ns3/abort.h"
 #include "ns3/uinteger.h"
 #include "ns3/simulator.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/tcp-socket-factory.h"
-#include "ns3/rng-seed-manager.h"
+#include "ns3/udp-socket-factory.h"
 #include <string>
+#include <sstream>
 
-#define SEND_BUFFER_SIZE 104857600 //100 MB
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ArapNode");
@@ -24,7 +25,7 @@ ArapNode::GetTypeId (void) {
 }
 
 ArapNode::ArapNode()
-: m_socketServer(0), m_localIP("0.0.0.0"), m_computingDelayIncrement(0), m_pathManager(0) {
+: m_socketServer(0), m_localIP("0.0.0.0"), m_localIndex(0), m_lateResponses(0), m_antsSent(0), m_antsReceived(0), m_profiler(0), m_computingDelayIncrement(0), m_pathManager(0), m_explorerScheduler(0) {
 }
 
 ArapNode::~ArapNode (){
@@ -40,16 +41,32 @@ ArapNode::SetComputingDelayIncrement(const float computingDelayIncrement){
 	m_computingDelayIncrement = computingDelayIncrement;
 }
 
+void
+ArapNode::SetComputingServer(uint32_t workers, ArapComputingServer::Discipline discipline){
+	m_computingServer.Setup(workers,discipline,MakeCallback(&ArapNode::SendDelayedAnt,this));
+}
+
 void
 ArapNode::SetPathManager(const ArapPathManager& pathManager){
 	m_pathManager = pathManager.GetCopy();
 	m_pathManager->CreateProbTable(GetLocalIP());
 }
 
+void
+ArapNode::SetExplorerScheduler(const ArapExplorerScheduler& scheduler){
+	delete m_explorerScheduler;
+	m_explorerScheduler = scheduler.GetCopy();
+}
+
 void
 ArapNode::DoDispose (void) {
   m_socketServer =0;
-  m_socketClientMap.clear();
+  m_connections.Dispose();
+  m_computingServer.Dispose();
+  if(m_explorerScheduler!=0)
+    m_explorerScheduler->Stop();
+  delete m_explorerScheduler;
+  m_explorerScheduler = 0;
   delete m_pathManager;
   Application::DoDispose();
 }
@@ -57,6 +74,20 @@ ArapNode::DoDispose (void) {
 void
 ArapNode::ConfigureSockets(){
 	m_localIP =GetNode()->GetObject<Ipv4>()->GetAddress(1,0).GetLocal();
+	m_profiler = &ArapSimulator::GetProfiler();
+	if(ArapSimulator::GetTransport()==TRANSPORT_UDP){
+		/* Con UDP un solo socket por nodo recibe las hormigas y las envia a
+		 * cualquier otro nodo, sin conexiones
+		 */
+		if (m_socketServer == 0) {
+			m_socketServer = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId());
+			m_socketServer->Bind(InetSocketAddress (Ipv4Address::GetAny(), ArapSimulator::GetPort()));
+			m_socketServer->SetRecvCallback (MakeCallback (&ArapNode::ReceiveAnt,this));
+			NS_LOG_LOGIC ("El socket UDP en el nodo "<<m_localIP<<" esta escuchando");
+		}
+		return;
+	}
+
 	TypeId tid = ns3::TcpSocketFactory::GetTypeId();
 	if (m_socketServer == 0) {
 		m_socketServer = Socket::CreateSocket (GetNode (), tid);
@@ -71,42 +102,37 @@ ArapNode::ConfigureSockets(){
 		m_socketServer->SetAcceptCallback(MakeCallback(&ArapNode::ServerConnectRequestCallback,this),MakeCallback(&ArapNode::ServerConnectAcceptCallback,this));
 	}
 
-	if (m_socketClientMap.empty()){
-		const PointToPointStarHelper& star=ArapSimulator::GetStar();
-		for (uint32_t i = 0; i < star.SpokeCount (); ++i){
-			Ipv4Address IP = star.GetSpokeIpv4Address(i);
-			if(IP==m_localIP) //Para que no cree un Loop a mi mismo
-				continue;
-			Ptr<Socket> client = Socket::CreateSocket (GetNode(), tid);
-			client->SetAttribute("SegmentSize",UintegerValue(ArapSimulator::GetMaximumSegmentSize()));
-
-			/* Se asigna el valor de buffer de envio, un valor grande (Según la cantidad
-			 * de nodos y el tráfico a generar) para evitar que se llene y no se puedan
-			 * enviar hormigas.
-			 */
-			client->SetAttribute("SndBufSize",UintegerValue(SEND_BUFFER_SIZE));
+	/* Las conexiones a los demas nodos se abren al enviar la primera hormiga
+	 * a cada uno, y el callback de envio vacia las hormigas en espera cuando
+	 * se libera espacio en el buffer de cada socket
+	 */
+	m_connections.Setup(GetNode(),ArapSimulator::GetPort(),ArapSimulator::GetMaximumSegmentSize(),ArapSimulator::GetSendBufferSize(),
+			ArapSimulator::GetMaxConnections(),ArapSimulator::GetMaxPendingAnts(),ArapSimulator::GetConnectionIdleTimeout(),
+			MakeCallback(&ArapNode::ClientSendCallback,this));
+}
 
-			client->Bind(); //No se asigna a un puerto especifico ya que es cliente
-			client->ShutdownRecv(); //Este socket no recibe (Es cliente)
-			//client->SetSendCallback(MakeCallback(&ArapNode::ClientSendCallback,this));
-			client->Connect(InetSocketAddress(IP,ArapSimulator::GetPort()));
-			m_socketClientMap[IP]=client;
-		}
-	}
+void
+ArapNode::ConfigureAbstract(const Ipv4Address& ip, uint32_t index){
+	m_localIP = ip;
+	m_localIndex = index;
+	m_profiler = &ArapSimulator::GetProfiler();
 }
 
 void
 ArapNode::StartApplication (void) {
+	m_routingTable.SetRttMultiple(ArapSimulator::GetRoutingRttMultiple());
 	m_loadAntsDelayModel.InitializeTable();
 
 	/* Inicializar los envios de hormigas de carga, en esta version
 	 * el "mensaje" no es relevante, por lo que se manda una cadena cualquiera.
+	 * Al reproducir una traza de carga los envios los programa ArapWorkload
 	 */
-	ScheduleLoadAntSend("mensaje");
+	if(ArapSimulator::GetWorkload().GetMode()!=ArapWorkload::MODE_REPLAY)
+		ScheduleLoadAntSend("mensaje");
 
 	//Iniciar el envio de exploradoras, solo si están habilitadas
 	if(ArapSimulator::IsExplorerAntsEnabled())
-		ExplorePaths();
+		m_explorerScheduler->Start(this);
 }
 
 void
@@ -119,20 +145,7 @@ ArapNode::StopApplication (void) {
 	 */
   m_socketServer->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
   m_socketServer->Close();
-  for(std::map<Ipv4Address,Ptr<Socket> >::iterator it = m_socketClientMap.begin();it!=m_socketClientMap.end();it++)
-		it->second->Close();
-}
-
-void
-ArapNode::ExplorePaths(){
-	const PointToPointStarHelper& star=ArapSimulator::GetStar();
-	for(uint32_t i=0; i<star.SpokeCount();i++){
-		Ptr<ArapNode>app = DynamicCast<ArapNode>(star.GetSpokeNode(i)->GetApplication(0));
-		if(app->GetLocalIP()==GetLocalIP())
-			continue;
-		SendExplorerAnts(app->GetLocalIP());
-	}
-	Simulator::Schedule(ArapSimulator::GetExplorersDelta(),&ArapNode::ExplorePaths,this);
+  m_connections.CloseAll();
 }
 
 const Ipv4Address
@@ -148,34 +161,131 @@ ArapNode::GetLoadAntsDelayModel() const{
 	return m_loadAntsDelayModel;
 }
 
+void
+ArapNode::ResetLoadAntsStatistics(){
+	m_loadAntsDelayModel = LoadAntsStatistics();
+	m_loadAntsDelayModel.InitializeTable();
+}
+
+const ArapPathManager&
+ArapNode::GetPathManager() const{
+	return *m_pathManager;
+}
+
+const RoutingTable&
+ArapNode::GetRoutingTable() const{
+	return m_routingTable;
+}
+
+uint64_t
+ArapNode::GetLateResponses() const{
+	return m_lateResponses;
+}
+
+const ArapConnectionPool&
+ArapNode::GetConnectionPool() const{
+	return m_connections;
+}
+
+const ArapComputingServer&
+ArapNode::GetComputingServer() const{
+	return m_computingServer;
+}
+
+const ArapAnonymityMetrics&
+ArapNode::GetAnonymityMetrics() const{
+	return m_anonymityMetrics;
+}
+
+uint64_t
+ArapNode::GetAntsSent() const{
+	return m_antsSent;
+}
+
+uint64_t
+ArapNode::GetAntsReceived() const{
+	return m_antsReceived;
+}
+
 void
 ArapNode::PrintProbTable(){
 	m_pathManager->PrintProbTable(GetLocalIP());
 }
 
+void
+ArapNode::PrintAnonymityMetrics(){
+	std::ostringstream oss;
+	/*Mismo formato de nombre que las tablas: anonimato_<IP_LOCAL>_<tiempo de generacion (segundos)>_<Semilla>_<Run>.csv*/
+	oss<<"tablas/anonimato_"<<GetLocalIP()<<"_"<<Simulator::Now().GetSeconds()<<"_"<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	m_anonymityMetrics.Print(oss.str(),GetLocalIP(),ArapSimulator::GetDirectory());
+}
+
+void
+ArapNode::SaveState(std::ostream& out) const{
+	/* El estado del ArapPathManager depende de su especializacion, por lo que se
+	 * escribe precedido de su tamaño para poder validar que se leyo completo
+	 */
+	std::ostringstream pathManagerState;
+	m_pathManager->SaveState(pathManagerState);
+	std::string block = pathManagerState.str();
+	uint32_t size = block.size();
+	out.write((const char*)&size,sizeof(uint32_t));
+	out.write(block.data(),size);
+	m_loadAntsDelayModel.Serialize(out);
+}
+
+void
+ArapNode::LoadState(std::istream& in, bool loadStatistics){
+	uint32_t size = 0;
+	in.read((char*)&size,sizeof(uint32_t));
+	std::string block(size,'\0');
+	if(size>0)
+		in.read(&block[0],size);
+	NS_ABORT_MSG_IF(!in.good(),"ERROR: Estado guardado incompleto para el nodo "<<GetLocalIP());
+	std::istringstream pathManagerState(block);
+	m_pathManager->LoadState(pathManagerState);
+	NS_ABORT_MSG_IF(pathManagerState.fail() || pathManagerState.peek()!=std::istringstream::traits_type::eof(),
+			"ERROR: El estado guardado del nodo "<<GetLocalIP()<<" no corresponde al "<<PARAM_PATH_MANAGER<<" configurado");
+
+	LoadAntsStatistics loadAntsDelayModel;
+	loadAntsDelayModel.Deserialize(in);
+	NS_ABORT_MSG_IF(in.fail(),"ERROR: Estado guardado incompleto para el nodo "<<GetLocalIP());
+	if(loadStatistics)
+		m_loadAntsDelayModel = loadAntsDelayModel;
+}
+
 void
 ArapNode::SendExplorerAnts(const Ipv4Address& target){
-	const PointToPointStarHelper& star=ArapSimulator::GetStar();
-	for(uint32_t i=0; i< star.SpokeCount();i++){
-		Ptr<ArapNode> app = DynamicCast<ArapNode>(star.GetSpokeNode(i)->GetApplication(0));
-		if(app->GetLocalIP()==GetLocalIP() || app->GetLocalIP()==target)
-			continue;
-		uint64_t packetID = m_arapAnt.CreateExplorerAnt(target);
-		Ptr<Packet> packet = Create<Packet> (m_arapAnt.GetBuffer(),ArapSimulator::GetAntsSize());
-		Simulator::Schedule(MilliSeconds(GetComputingDelay()), &ArapNode::SendDelayedAnt, this,packet, GetLocalIP(),app->GetLocalIP(),packetID,true);
-	}
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_SEND_EXPLORERS);
+	const ArapNodeDirectory& directory=ArapSimulator::GetDirectory();
+	//Solo se exploran los intermedios que mantiene la tabla (Todos, salvo en tablas dispersas)
+	std::vector<uint32_t> mediums;
+	m_pathManager->GetExplorerMediums(directory.GetIndex(target),mediums);
+	for(uint32_t i=0; i< mediums.size();i++)
+		ScheduleExplorerAnt(target,directory.GetAddress(mediums[i]));
 }
 
-Ptr<RoutingTableRow>
-ArapNode::SearchRoutingTable(const uint64_t& antID){
-	if(m_routingTable.count(antID)==1)
-		return m_routingTable[antID];
-	else
-		return NULL;
+void
+ArapNode::SendExplorerAnt(const Ipv4Address& target, const Ipv4Address& medium){
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_SEND_EXPLORERS);
+	ScheduleExplorerAnt(target,medium);
+}
+
+void
+ArapNode::ScheduleExplorerAnt(const Ipv4Address& target, const Ipv4Address& medium){
+	uint64_t packetID;
+	Ptr<Packet> packet = ArapAnts::CreateExplorerAnt(target,packetID);
+	m_computingServer.Submit(packet,GetLocalIP(),medium,packetID,true,ArapComputingServer::PRIORITY_NEW,MilliSeconds(GetComputingDelay()));
+}
+
+const RoutingTableRow*
+ArapNode::SearchRoutingTable(const uint64_t& antID) const{
+	return m_routingTable.Find(antID);
 }
 
 void
 ArapNode::ReceiveAnt(Ptr<Socket> socket) {
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_RECEIVE);
 	Ptr<Packet> ant;
 	Address socketAddress;
 	Ipv4Address source;
@@ -183,103 +293,112 @@ ArapNode::ReceiveAnt(Ptr<Socket> socket) {
 	while ((ant = socket->RecvFrom (antSize, 0, socketAddress))){
 		ant->RemoveAllPacketTags ();
 		ant->RemoveAllByteTags ();
-		uint8_t* data = new uint8_t[antSize];
-		ant->CopyData(data,antSize);
-		uint64_t antID = ArapAnts::ReadAntID(data);
 		source =  InetSocketAddress::ConvertFrom(socketAddress).GetIpv4();
 		NS_LOG_LOGIC("RECEIVE_LOG -  En el tiempo "<<Simulator::Now().GetSeconds()<< "s el nodo "<<GetLocalIP()
-				<<" recibio una hormiga con ID "<<antID <<" y tamanio "<<ant->GetSize ()<<" bytes desde "
+				<<" recibio una hormiga de tamanio "<<ant->GetSize ()<<" bytes desde "
 				<<source<< " por el puerto: "<<InetSocketAddress::ConvertFrom(socketAddress).GetPort ());
+		HandleAnt(ant,source);
+	} //END WHILE
+}
 
-		/*Manejar los diferentes casos de las hormigas recibidas*/
-		Ptr<RoutingTableRow> routingRow = SearchRoutingTable(antID);
-		if(routingRow!=NULL){ //Si es verdadero es porque si existe: Casos Response
-			NS_ASSERT_MSG(routingRow->GetTargetIP()==source,"Hay un error en la tabla de rutas del nodo "<<GetLocalIP());
-			if(routingRow->GetSourceIP()==GetLocalIP()){
-				HandleRespFinal(data, source, antID);
-			}
-			else {
-				HandleRespMed(data,routingRow->GetSourceIP(),antID);
-			}
+void
+ArapNode::ReceiveAbstractAnt(Ptr<Packet> ant, Ipv4Address source) {
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_RECEIVE);
+	HandleAnt(ant,source);
+}
+
+void
+ArapNode::HandleAnt(Ptr<Packet> ant, const Ipv4Address& source) {
+	m_antsReceived++;
+	/* Solo se lee la cabecera de la capa, el paquete
+	 * recibido se reenvia sin copiarlo
+	 */
+	ArapAntHeader header;
+	ant->PeekHeader(header);
+	uint64_t antID = header.GetAntID();
+
+	/*Manejar los diferentes casos de las hormigas recibidas*/
+	const RoutingTableRow* routingRow = SearchRoutingTable(antID);
+	if(routingRow!=NULL){ //Si es verdadero es porque si existe: Casos Response
+		NS_ASSERT_MSG(routingRow->GetTargetIP()==source,"Hay un error en la tabla de rutas del nodo "<<GetLocalIP());
+		if(routingRow->GetSourceIP()==GetLocalIP()){
+			HandleRespFinal(header, source, antID);
 		}
-		else{ //Cuando no existe la entrada: Casos Request
-			std::string nodeType = ArapAnts::ReadNodeType(data);
-			if(nodeType==ArapAnts::NODE_TYPE_MEDIUM){
-				HandleReqMed(data,source,antID);
-			}else if(nodeType==ArapAnts::NODE_TYPE_FINAL){
-				HandleReqFinal(data,source,antID);
-			}
+		else {
+			HandleRespMed(ant,routingRow->GetSourceIP(),antID);
 		}
-		delete[] data;
-	} //END WHILE
+	}
+	else{ //Cuando no existe la entrada: Casos Request
+		if(header.IsMedium()){
+			HandleReqMed(ant,header,source,antID);
+		}else if(header.IsFinal() && header.GetTarget()==GetLocalIP()){
+			HandleReqFinal(ant,header,source,antID);
+		}else if(header.IsFinal()){
+			/* Una capa final dirigida a otro nodo es una respuesta cuya fila ya
+			 * expiro en la tabla de enrutamiento, por lo que no se puede reenviar
+			 */
+			NS_LOG_LOGIC("El nodo "<<GetLocalIP()<<" descarto la respuesta tardia de la hormiga con ID "<<antID);
+			m_lateResponses++;
+		}
+	}
 }
 
 void
-ArapNode::HandleReqMed(const uint8_t* data, const Ipv4Address& source, const uint64_t antID){
-	Ipv4Address target = ArapAnts::ReadNextJumpIP(data);
-	uint8_t* dataAux = new uint8_t[ArapSimulator::GetAntsSize()];
-	m_arapAnt.CreateMediumAnt(data,dataAux);
-	Ptr<Packet> ant = Create<Packet> (dataAux,ArapSimulator::GetAntsSize());
-	delete [] dataAux;
-	Simulator::Schedule(MilliSeconds(GetComputingDelay()), &ArapNode::SendDelayedAnt, this,ant, source,target,antID,true);
+ArapNode::HandleReqMed(Ptr<Packet> ant, const ArapAntHeader& header, const Ipv4Address& source, const uint64_t antID){
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_REQ_MED);
+	Ipv4Address target = header.GetNextHop();
+	ArapAnts::PeelMediumLayer(ant);
+	m_computingServer.Submit(ant,source,target,antID,true,ArapComputingServer::PRIORITY_FORWARD,MilliSeconds(GetComputingDelay()));
 }
 
 void
-ArapNode::HandleReqFinal(const uint8_t* data, const Ipv4Address& source, const uint64_t antID){
-	const ArapAnts::AntType antType = ArapAnts::ReadAntType(data);
-	Ptr<Packet> ant;
-	if(antType==ArapAnts::ANT_EXPLORER){
-		ant = Create<Packet> (data,ArapSimulator::GetAntsSize());
-	}
-	else if(antType==ArapAnts::ANT_LOAD){
-		uint64_t sendTime = ArapAnts::ReadSendTime(data);
-		const Ipv4Address target = ArapAnts::ReadTargetIP(data);
-		uint32_t msgSize = ArapAnts::ReadMessageSize(data);
-		std::string message = ArapAnts::ReadMessage(data,msgSize);
+ArapNode::HandleReqFinal(Ptr<Packet> ant, const ArapAntHeader& header, const Ipv4Address& source, const uint64_t antID){
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_REQ_FINAL);
+	if(header.GetAntType()==ArapAntHeader::ANT_LOAD){
+		uint64_t sendTime = header.GetSendTime();
+		const Ipv4Address& target = header.GetTarget();
 		std::ostringstream oss;
 		oss<<"Final del recorrido para la hormiga con ID "<<antID<<" enviado al NODO con IP "<<target;
 		std::string answer = oss.str();
-		uint8_t* answerData = new uint8_t[ArapSimulator::GetAntsSize()];
-		m_arapAnt.CreateAnswerAnt(answerData,sendTime,target,antID,answer);
-		ant = Create<Packet> (answerData,ArapSimulator::GetAntsSize());
-		delete[] answerData;
+		ant = ArapAnts::CreateAnswerAnt(sendTime,target,antID,answer);
 	}
-	/* En este caso ni se agregan ni eliminan filas a la tabla de enrutamiento,
+	/* Las exploradoras se devuelven tal como llegaron (Se reenvia el mismo paquete).
+	 *
+	 * En este caso ni se agregan ni eliminan filas a la tabla de enrutamiento,
 	 * pero como se debe pasar el parametro, se pasa como false, aunque en realidad
 	 * no se hace nigun cambio a la tabla.
 	 */
-	Simulator::Schedule(MilliSeconds(GetComputingDelay()), &ArapNode::SendDelayedAnt, this,ant, source,source,antID,false);
+	m_computingServer.Submit(ant,source,source,antID,false,ArapComputingServer::PRIORITY_RESPONSE,MilliSeconds(GetComputingDelay()));
 }
 
 void
-ArapNode::HandleRespMed(const uint8_t* data, const Ipv4Address& target, const uint64_t antID){
-	Ptr<Packet> ant = Create<Packet> (data,ArapSimulator::GetAntsSize());
-	Simulator::Schedule(MilliSeconds(GetComputingDelay()), &ArapNode::SendDelayedAnt, this,ant, target,target,antID,false);
+ArapNode::HandleRespMed(Ptr<Packet> ant, const Ipv4Address& target, const uint64_t antID){
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_RESP_MED);
+	m_computingServer.Submit(ant,target,target,antID,false,ArapComputingServer::PRIORITY_RESPONSE,MilliSeconds(GetComputingDelay()));
 }
 
 void
-ArapNode::HandleRespFinal(const uint8_t* data, const Ipv4Address& medium, const uint64_t antID){
-	const ArapAnts::AntType antType = ArapAnts::ReadAntType(data);
-	if(antType==ArapAnts::ANT_EXPLORER){
+ArapNode::HandleRespFinal(const ArapAntHeader& header, const Ipv4Address& medium, const uint64_t antID){
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_RESP_FINAL);
+	const ArapAntHeader::AntType antType = header.GetAntType();
+	if(antType==ArapAntHeader::ANT_EXPLORER){
 		NS_LOG_LOGIC("Se recibio una hormiga exploradora con ID "<<antID<<" de vuelta al nido "<<GetLocalIP());
-		const uint64_t time = ArapAnts::ReadSendTime(data);
-		const Ipv4Address target = ArapAnts::ReadTargetIP(data);
+		const uint64_t time = header.GetSendTime();
+		const Ipv4Address& target = header.GetTarget();
 		Time sendTime(time);
 		Time rtt = Simulator::Now()-sendTime; //Calculo del delta
 		m_pathManager->HandleExplorer(target,medium,rtt);
 	}
-	else if(antType==ArapAnts::ANT_LOAD){
+	else if(antType==ArapAntHeader::ANT_LOAD){
 		NS_LOG_LOGIC("Se recibio una hormiga de carga con ID "<<antID<<" de vuelta al nido "<<GetLocalIP());
-		const uint64_t time = ArapAnts::ReadSendTime(data);
-		const Ipv4Address target = ArapAnts::ReadTargetIP(data);
+		const uint64_t time = header.GetSendTime();
+		const Ipv4Address& target = header.GetTarget();
 		Time sendTime(time);
 		Time rtt = Simulator::Now()-sendTime; //Calculo del delta
-		uint32_t msgSize = ArapAnts::ReadMessageSize(data);
-		std::string message = ArapAnts::ReadMessage(data,msgSize);
 		m_loadAntsDelayModel.UpdateModel(rtt.GetSeconds(),target);
 	}
 	//Eliminar la fila de la tabla de enrutamiento
-	m_routingTable.erase(antID);
+	m_routingTable.Remove(antID);
 }
 
 void
@@ -288,15 +407,30 @@ ArapNode::ScheduleLoadAntSend(const std::string& message){
 	Ipv4Address target;
 	do{
 		uint32_t nodeIndex = m_LoadAntsTargetStream->GetInteger();
-		Ptr<ArapNode> nodeApp = DynamicCast<ArapNode>(ArapSimulator::GetStar().GetSpokeNode(nodeIndex)->GetApplication(0));
-		target = nodeApp->GetLocalIP();
+		target = ArapSimulator::GetDirectory().GetAddress(nodeIndex);
 	}while(target==GetLocalIP()); //Para evitar que se envie hormigas a si mismo
 
 	uint32_t quantity = m_LoadAntsQuantityStream->GetInteger();
-	for(uint32_t i=0;i<quantity;i++){
-		Simulator::Schedule (dt, &ArapNode::SendLoadAnt, this, target,message);
+	//Todas las hormigas del envio y la programacion del siguiente se realizan en un solo evento
+	Simulator::Schedule (dt, &ArapNode::SendLoadAntBurst, this, target,message,quantity);
+}
+
+void
+ArapNode::SendLoadAntBurst(Ipv4Address target, std::string message, uint32_t quantity){
+	ArapWorkload& workload = ArapSimulator::GetWorkload();
+	if(workload.GetMode()==ArapWorkload::MODE_RECORD){
+		const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+		workload.Record(directory.GetIndex(GetLocalIP()),directory.GetIndex(target),quantity);
 	}
-	Simulator::Schedule (dt, &ArapNode::ScheduleLoadAntSend, this,"mensaje");
+	for(uint32_t i=0;i<quantity;i++)
+		SendLoadAnt(target,message);
+	ScheduleLoadAntSend("mensaje");
+}
+
+void
+ArapNode::SendReplayedLoadAnts(const Ipv4Address& target, uint32_t quantity){
+	for(uint32_t i=0;i<quantity;i++)
+		SendLoadAnt(target,"mensaje");
 }
 
 bool
@@ -313,44 +447,32 @@ ArapNode::ServerConnectAcceptCallback(Ptr<Socket> socket, const Address& from){
 
 void
 ArapNode::ClientSendCallback(Ptr<Socket> socket, uint32_t size){
-  //TODO Definir
-	/* Es funcion se llama cuando se ha liberado espacio del buffer de envio
-	 * actualmente no se usa ya que no es posible indicarle que reintente el envio de
-	 * una misma hormiga, por lo cual se esta asignando un valor tamaño de buffer "grande"
-	 * para evitar que se llene.
- 	 */
+	/* Esta funcion se llama cuando se ha liberado espacio del buffer de envio,
+	 * se envian las hormigas que quedaron en espera en la conexion
+	 */
 	NS_LOG_FUNCTION(this<<socket<<size<<" IP "<<GetLocalIP());
+	m_connections.HandleSendSpace(socket);
 }
 
 void
 ArapNode::SendLoadAnt(const Ipv4Address& target, const std::string& message) {
-	std::list<Ipv4Address> path = m_pathManager->CreatePath(target);
-	uint64_t antID = m_arapAnt.CreateLoadAnt(path,message);
-	Ptr<Packet> ant = Create<Packet> (m_arapAnt.GetBuffer(),ArapSimulator::GetAntsSize());
-	Simulator::Schedule(MilliSeconds(GetComputingDelay()), &ArapNode::SendDelayedAnt, this,ant, GetLocalIP(),path.front(),antID,true);
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_SEND_LOAD);
+	std::list<Ipv4Address> path;
+	{
+		ArapProfiler::Scope createPathScope(*m_profiler,ArapProfiler::SECTION_CREATE_PATH);
+		path = m_pathManager->CreatePath(target);
+	}
+	uint64_t antID;
+	Ptr<Packet> ant = ArapAnts::CreateLoadAnt(path,message,antID);
+	m_computingServer.Submit(ant,GetLocalIP(),path.front(),antID,true,ArapComputingServer::PRIORITY_NEW,MilliSeconds(GetComputingDelay()));
 	PrintLoadAntPath(path);
 }
 
 void
 ArapNode::PrintLoadAntPath(std::list<Ipv4Address>& path){
-	std::fstream pathsFile;
-	std::ostringstream oss;
-	oss<<"load-ants-paths/"; //Carpeta donde se crearan los archivos de salida (dentro del Working Directory)
-	oss<<"paths_";
-	if(ArapSimulator::IsExplorerAntsEnabled())
-		oss<<"explorer-on_";
-	else
-		oss<<"explorer-off_";
-	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
-	pathsFile.open(oss.str().c_str(),std::ios_base::out | std::ios_base::app);
-	if(pathsFile.is_open()){
-		pathsFile<<Simulator::Now().GetSeconds();
-		pathsFile<<","<<GetLocalIP();
-		for(std::list<Ipv4Address>::iterator it = path.begin();it!=path.end();it++)
-			pathsFile<<","<<*it;
-		pathsFile<<"\n";
-		pathsFile.close();
-	}
+	ArapSimulator::GetPathLogger().Log(Simulator::Now().GetSeconds(),GetLocalIP(),path);
+	if(ArapSimulator::IsAnonymityMetricsEnabled())
+		m_anonymityMetrics.Record(path,ArapSimulator::GetDirectory());
 }
 
 void
@@ -375,17 +497,27 @@ ArapNode::GetComputingDelay() const {
 
 void
 ArapNode::SendDelayedAnt(Ptr<Packet> ant, const Ipv4Address& source, const Ipv4Address& target, const uint64_t& antID,bool isRequest){
-	int value = m_socketClientMap[target]->Send(ant);
-	if(value==-1){
-		NS_ABORT_MSG("FALLO EL ENVIO DEL PAQUETE. VALOR DE ERRNO: "<<m_socketClientMap[target]->GetErrno());
-		return; //No deberia llegar nunca a este punto
+	ArapProfiler::Scope scope(*m_profiler,ArapProfiler::SECTION_SEND);
+	if(ArapSimulator::GetEngine()==ENGINE_ABSTRACT){
+		const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+		uint32_t targetIndex = directory.GetIndex(target);
+		Time delay = ArapSimulator::GetAbstractNetwork().Transmit(m_localIndex,targetIndex,ant->GetSize());
+		Ptr<ArapNode> targetApp = DynamicCast<ArapNode>(directory.GetNode(targetIndex)->GetApplication(0));
+		Simulator::Schedule(delay,&ArapNode::ReceiveAbstractAnt,targetApp,ant,GetLocalIP());
+	}
+	else if(ArapSimulator::GetTransport()==TRANSPORT_UDP){
+		if(m_socketServer->SendTo(ant,0,InetSocketAddress(target,ArapSimulator::GetPort()))==-1)
+			NS_ABORT_MSG("FALLO EL ENVIO DEL PAQUETE. VALOR DE ERRNO: "<<m_socketServer->GetErrno());
 	}
+	else if(!m_connections.Send(target,ant))
+		NS_LOG_LOGIC("El nodo "<<GetLocalIP()<<" descarto la hormiga con ID "<<antID<<" hacia "<<target<<" por falta de espacio en sus conexiones");
+	m_antsSent++;
 
 	if(isRequest){ //Si es Request agrega la fila a la tabla de rutas
-		m_routingTable[antID]= Create<RoutingTableRow>(source,target,antID);
+		m_routingTable.Insert(source,target,antID);
 	}
 	else{ //Si NO es Request (es response) elimina la fila de la tabla de rutas
-		m_routingTable.erase(antID);
+		m_routingTable.Remove(antID);
 	}
 	NS_LOG_LOGIC("SEND_LOG - En el tiempo "<<Simulator::Now().GetSeconds()<<"s, el nodo "<<GetLocalIP()<<" envio una hormiga con ID "<<antID<<" y tamanio "<<ant->GetSize ()<<" bytes a "<<target);
 }
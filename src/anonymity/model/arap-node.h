@@ -5,12 +5,15 @@
 
 #include "ns3/application.h"
 #include "ns3/socket.h"
-#include "ns3/point-to-point-star.h"
-#include "ns3/routing-table-row.h"
+#include "ns3/routing-table.h"
+#include "ns3/arap-connection-pool.h"
+#include "ns3/arap-computing-server.h"
+#include "ns3/arap-anonymity-metrics.h"
 #include "ns3/arap-ants.h"
 #include "ns3/arap-simulator.h"
 #include "ns3/arap-path-manager.h"
 #include "ns3/load-ants-statistics.h"
+#include "ns3/arap-explorer-scheduler.h"
 #include <stdio.h>
 #include <map>
 
@@ -31,11 +34,21 @@ public:
 	virtual ~ArapNode ();
 
 	/**
-	 * Usado para configurar los sockets y realizar las conexiones a los
-	 * distintos nodos de la red a simular.
+	 * Usado para configurar el socket servidor y el conjunto de conexiones a los
+	 * distintos nodos de la red a simular (Las conexiones se abren al primer envio).
 	 */
 	void ConfigureSockets();
 
+	/**
+	 * Configura el nodo para el motor abstracto (En lugar de ConfigureSockets()): el nodo no
+	 * tiene pila TCP/IP y sus hormigas se envian a través de ArapAbstractNetwork.
+	 *
+	 * @param[in] ip IP del nodo
+	 *
+	 * @param[in] index Índice del nodo en ArapNodeDirectory
+	 */
+	void ConfigureAbstract(const Ipv4Address& ip, uint32_t index);
+
 	/**
 	 * Método heredado de la clase %ns3::Application, usado para asignar
 	 * atributos que puedan asignarse mediante el sistema de configuración %ns3::Config,
@@ -59,6 +72,17 @@ public:
 	 */
 	void SetComputingDelayStream(Ptr<RandomVariableStream> computingDelayStream);
 
+	/**
+	 * Configurar el servidor de cómputo del nodo (Debe llamarse antes de iniciar la aplicación).
+	 *
+	 * @param[in] workers Cantidad de hormigas que el nodo procesa a la vez (0 = sin límite)
+	 *
+	 * @param[in] discipline Orden de atención de las hormigas en espera
+	 *
+	 * @see ArapComputingServer
+	 */
+	void SetComputingServer(uint32_t workers, ArapComputingServer::Discipline discipline);
+
 	/**
 	 * Asignar la especialización de ArapPathManager que usará el nodo.
 	 *
@@ -69,6 +93,33 @@ public:
 	 */
 	void SetPathManager(const ArapPathManager& pathManager);
 
+	/**
+	 * Asignar el planificador de hormigas exploradoras que usará el nodo (Se guarda una copia).
+	 *
+	 * @param[in] scheduler Referencia a un objeto especialización de la clase ArapExplorerScheduler
+	 */
+	void SetExplorerScheduler(const ArapExplorerScheduler& scheduler);
+
+	/**
+	 * Envia hormigas a explorar todos los posibles caminos que llevan al destino indicado.
+	 *
+	 * @param[in] target IP del nodo destino para el cual se están explorando los caminos.
+	 *
+	 * @see FloodExplorerScheduler
+	 */
+	void SendExplorerAnts(const Ipv4Address& target);
+
+	/**
+	 * Envia una hormiga exploradora al destino indicado a través de un solo intermedio.
+	 *
+	 * @param[in] target IP del nodo destino (Fila de la tabla de probabilidades)
+	 *
+	 * @param[in] medium IP del nodo intermedio (Columna de la tabla de probabilidades)
+	 *
+	 * @see BudgetExplorerScheduler
+	 */
+	void SendExplorerAnt(const Ipv4Address& target, const Ipv4Address& medium);
+
 	/**
 	 * Programar el envio de una hormiga de carga
 	 *
@@ -92,12 +143,94 @@ public:
 	 */
 	void PrintProbTable();
 
+	/**
+	 * Imprime las métricas de anonimato de los caminos de este nodo (Carpeta "tablas").
+	 *
+	 * @see ArapAnonymityMetrics
+	 */
+	void PrintAnonymityMetrics();
+
+	/**
+	 * Crea las hormigas de carga de un envio de la traza de carga que se esta reproduciendo,
+	 * sin programar el siguiente (Lo programa ArapWorkload).
+	 *
+	 * @param[in] target IP del nodo destino al cual enviar las hormigas.
+	 *
+	 * @param[in] quantity Cantidad de hormigas a enviar
+	 */
+	void SendReplayedLoadAnts (const Ipv4Address& target, uint32_t quantity);
+
+	/**
+	 * Guarda en binario el estado aprendido del nodo: el de su ArapPathManager (Tabla de
+	 * probabilidades y modelos de las exploradoras) y sus estadísticas de hormigas de carga.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	void SaveState(std::ostream& out) const;
+
+	/**
+	 * Restaura el estado guardado con SaveState(). Debe llamarse luego de SetPathManager() y
+	 * antes de iniciar la aplicación.
+	 *
+	 * @param[in] in Flujo de entrada binario
+	 *
+	 * @param[in] loadStatistics Si es false, las estadísticas de hormigas de carga guardadas se
+	 * descartan y la medición comienza desde cero
+	 */
+	void LoadState(std::istream& in, bool loadStatistics);
+
 	/**
 	 * @return Una referencia a el modelo donde se almacenan los diferentes valores
 	 * de las distribucion de envio de hormigas de carga
 	 */
 	const LoadAntsStatistics& GetLoadAntsDelayModel() const;
 
+	/**
+	 * Descarta las estadísticas de las hormigas de carga (Inicio de la fase de medición).
+	 */
+	void ResetLoadAntsStatistics();
+
+	/**
+	 * @return Referencia a la especialización de ArapPathManager usada por el nodo.
+	 */
+	const ArapPathManager& GetPathManager() const;
+
+	/**
+	 * @return Referencia a la tabla de enrutamiento del nodo (Para consultar sus contadores).
+	 */
+	const RoutingTable& GetRoutingTable() const;
+
+	/**
+	 * @return Cantidad de respuestas recibidas luego de que su fila en la tabla de
+	 * enrutamiento expiró (Estas respuestas se descartan).
+	 */
+	uint64_t GetLateResponses() const;
+
+	/**
+	 * @return Referencia a las conexiones salientes del nodo (Para consultar sus contadores).
+	 */
+	const ArapConnectionPool& GetConnectionPool() const;
+
+	/**
+	 * @return Referencia al servidor de cómputo del nodo (Para consultar sus contadores).
+	 */
+	const ArapComputingServer& GetComputingServer() const;
+
+	/**
+	 * @return Referencia a las métricas de anonimato de los caminos del nodo.
+	 */
+	const ArapAnonymityMetrics& GetAnonymityMetrics() const;
+
+	/**
+	 * @return Cantidad de hormigas enviadas por el nodo (Propias y reenviadas)
+	 */
+	uint64_t GetAntsSent() const;
+
+	/**
+	 * @return Cantidad de hormigas recibidas por el nodo
+	 */
+	uint64_t GetAntsReceived() const;
+
 	/**
 	 * Asignar la distribución de probabilidad que indica la cantidad de hormigas
 	 * de carga a enviar en cada tiempo de envio.
@@ -137,7 +270,7 @@ private:
 	 * según el archivo de parametros, se encarga de iniciar el envio de las hormigas,
 	 * las cuales se enviarán periodicamente a partir de este momento.
 	 *
-	 * @see SendExplorerAnts
+	 * @see ArapExplorerScheduler
 	 */
 	virtual void StartApplication (void);
 
@@ -162,16 +295,30 @@ private:
 	void SendLoadAnt (const Ipv4Address& target, const std::string& message);
 
 	/**
-	 * Agrega el camino de una hormiga de carga a un archivo de salida.
+	 * Crea las hormigas de carga de un envio programado por ScheduleLoadAntSend() y programa el
+	 * siguiente envio.
 	 *
+	 * @param[in] target IP del nodo destino al cual enviar las hormigas.
+	 *
+	 * @param[in] message Mensaje a enviar al nodo destino
+	 *
+	 * @param[in] quantity Cantidad de hormigas a enviar
+	 */
+	void SendLoadAntBurst (Ipv4Address target, std::string message, uint32_t quantity);
+
+	/**
+	 * Agrega el camino de una hormiga de carga al registro de caminos de la simulación y
+	 * a las métricas de anonimato del nodo (Si están habilitadas).
+	 *
+	 * @see ArapPathLogger
 	 * @param[in] path La lista que posee el camino que recorrera la hormiga
 	 */
 	void PrintLoadAntPath(std::list<Ipv4Address>& path);
 
 	/**
 	 * Envia una hormiga luego de pasado el tiempo de computo al procesarlo, y actualiza
-	 * la tabla de enrutamiento del nodo. La ejecución de este método siempre se hace
-	 * mediante una llamada a ns3::Simulator::Schedule.
+	 * la tabla de enrutamiento del nodo. Este método siempre lo llama el servidor de
+	 * cómputo del nodo (ArapComputingServer) al terminar de procesar la hormiga.
 	 *
 	 * @param[in] ant Hormiga a enviar
 	 *
@@ -220,7 +367,7 @@ private:
   void ServerConnectAcceptCallback(Ptr<Socket> socket, const Address & from);
 
   /**
-   * Callback para el envio de data del socket.
+   * Callback para el envio de data del socket, envia las hormigas en espera de la conexión.
    *
    * @param[in] socket Socket del cual se llama el callback
    *
@@ -247,19 +394,39 @@ private:
    */
   void ReceiveAnt (Ptr<Socket> socket);
 
+  /**
+   * Recibe una hormiga enviada a través de ArapAbstractNetwork (Motor abstracto).
+   *
+   * @param[in] ant Hormiga recibida
+   *
+   * @param[in] source IP del nodo que envió la hormiga
+   */
+  void ReceiveAbstractAnt (Ptr<Packet> ant, Ipv4Address source);
+
+  /**
+   * Clasifica una hormiga recibida (Ver ReceiveAnt()) y la maneja según su caso.
+   *
+   * @param[in] ant Hormiga recibida
+   *
+   * @param[in] source IP del nodo que envió la hormiga
+   */
+  void HandleAnt (Ptr<Packet> ant, const Ipv4Address& source);
+
   /**
    * Maneja el caso en que la hormiga es del tipo: "Request en nodo Intermedio".
    *
    * En este caso se lee la capa correspondiente, la cual incluye la IP del próximo
-   * salto y se programa el envio a dicha IP.
+   * salto, se quita la capa del mismo paquete recibido y se programa su envio a dicha IP.
+   *
+   * @param[in] ant Hormiga recibida
    *
-   * @param[in] data arreglo de bytes que contiene la data de la hormiga recibida
+   * @param[in] header Cabecera de la capa recibida
    *
    * @param[in] source IP de donde fue enviada la hormiga recibido
    *
    * @param[in] antID ID de la hormiga recibida
    */
-  void HandleReqMed(const uint8_t* data, const Ipv4Address& source, const uint64_t antID);
+  void HandleReqMed(Ptr<Packet> ant, const ArapAntHeader& header, const Ipv4Address& source, const uint64_t antID);
 
   /**
    * Maneja el caso en que la hormiga es del tipo: "Request en nodo final".
@@ -268,13 +435,15 @@ private:
    * sea el tipo de esta realiza las acciones correspondientes. y luego envia la respuesta al
    * mismo nodo desde donde se envió la hormiga original.
    *
-   * @param[in] data arreglo de bytes que contiene la data de la hormiga recibida
+   * @param[in] ant Hormiga recibida
+   *
+   * @param[in] header Cabecera de la capa recibida
    *
    * @param[in] source IP de donde fue enviado el paquete recibido
    *
    * @param[in] antID ID de la hormiga recibida
    */
-  void HandleReqFinal(const uint8_t* data, const Ipv4Address& source, const uint64_t antID);
+  void HandleReqFinal(Ptr<Packet> ant, const ArapAntHeader& header, const Ipv4Address& source, const uint64_t antID);
 
   /**
    * Maneja el caso en que la hormiga es del tipo: "Response en nodo intermedio".
@@ -283,13 +452,13 @@ private:
    * desde que IP se genero el Request para esta respuesta, se envia la hormiga a dicho IP,
    * y se actualiza la tabla de enrutamiento
    *
-   * @param[in] data arreglo de bytes que contiene la data de la hormiga recibida
+   * @param[in] ant Hormiga recibida, que se reenvia sin modificarla
    *
    * @param[in] source IP de donde fue enviado la hormiga recibida
    *
    * @param[in] antID ID de la hormiga  recibida
    */
-  void HandleRespMed(const uint8_t* data, const Ipv4Address& target, const uint64_t antID);
+  void HandleRespMed(Ptr<Packet> ant, const Ipv4Address& target, const uint64_t antID);
 
   /**
    * Maneja el caso en que la hormiga es del tipo: "Response en nodo final".
@@ -297,30 +466,22 @@ private:
    * En este caso se lee y procesa la data enviada como respuesta y se actualiza
    * la tabla de enrutamiento.
    *
-   * @param[in] data arreglo de bytes que contiene la data de la hormiga recibida
+   * @param[in] header Cabecera de la capa recibida
    *
    * @param[in] medium IP del nodo desde donde fue enviada la hormiga recibida
    *
    * @param[in] antID ID de la hormiga recibida
    */
-  void HandleRespFinal(const uint8_t* data, const Ipv4Address& medium, const uint64_t antID);
-
-  /**
-   * Método usado en conjunto con SendExplorerAnts() para realizar el envio de un conjunto
-   * hormigas exploradoras a los demás nodos de la red. y configurar el envio periódico de las mismas
-   *
-   * @see SendExplorerAnts
-   */
-  void ExplorePaths();
+  void HandleRespFinal(const ArapAntHeader& header, const Ipv4Address& medium, const uint64_t antID);
 
   /**
-   * Envia hormigas a explorar todos los posibles caminos que llevan al destino indicado.
+   * Crea una hormiga exploradora y programa su envio al intermedio, luego del delay de computo.
    *
-   * @param[in] target IP del nodo destino para el cual se están explorando los caminos.
+   * @param[in] target IP del nodo destino
    *
-   * @see ExplorePaths
+   * @param[in] medium IP del nodo intermedio (Primer salto)
    */
-  void SendExplorerAnts(const Ipv4Address& target);
+  void ScheduleExplorerAnt(const Ipv4Address& target, const Ipv4Address& medium);
 
   /**
    * Busca una fila en la tabla de enrutamiento.
@@ -331,16 +492,23 @@ private:
    *
    * @return La fila que contiene el antID o NULL si no hay ninguna fila con ese ID.
    */
-  Ptr<RoutingTableRow> SearchRoutingTable(const uint64_t& antID);
+  const RoutingTableRow* SearchRoutingTable(const uint64_t& antID) const;
 
   Ptr<RandomVariableStream> m_computingDelayStream; //!< Distribución de probabilidad para el delay de computo
-  Ptr<Socket> m_socketServer;//!< Socket por el que se reciben los paquetes (hormigas)
-  std::map<Ipv4Address, Ptr<Socket> > m_socketClientMap;//!< Mapa de Sockets por los cuales se envian paquetes (hormigas) a los demás nodos
+  Ptr<Socket> m_socketServer;//!< Socket por el que se reciben los paquetes (hormigas), con UDP también se envian por este socket
+  ArapConnectionPool m_connections;//!< Conexiones por las cuales se envian paquetes (hormigas) a los demás nodos
+  ArapComputingServer m_computingServer; //!< Procesa las hormigas durante su delay de cómputo antes de enviarlas
+  ArapAnonymityMetrics m_anonymityMetrics; //!< Métricas de anonimato de los caminos creados por el nodo (Ver PARAM_ANONYMITY_METRICS)
   Ipv4Address m_localIP; //!< IP del nodo.
-  ArapAnts m_arapAnt; //!< Objeto encargado de manejar la estructura y creación de los distintos tipos de hormigas
-  std::map<uint64_t,Ptr<RoutingTableRow> > m_routingTable; //!< Tabla de enrutamiento
+  uint32_t m_localIndex; //!< Índice del nodo en ArapNodeDirectory (Solo en el motor abstracto)
+  RoutingTable m_routingTable; //!< Tabla de enrutamiento
+  uint64_t m_lateResponses; //!< Respuestas descartadas por llegar luego de expirar su fila
+  uint64_t m_antsSent; //!< Hormigas enviadas por el nodo (Propias y reenviadas)
+  uint64_t m_antsReceived; //!< Hormigas recibidas por el nodo
+  ArapProfiler* m_profiler; //!< Perfilador de la simulación en curso
   float m_computingDelayIncrement;//!< Incremento del delay de computo
   ArapPathManager* m_pathManager; //!< Maneja las tablas de probabilidad y la creación de caminos según la especialización
+  ArapExplorerScheduler* m_explorerScheduler; //!< Decide cuándo y hacia cuáles celdas de la tabla se envian las exploradoras
   LoadAntsStatistics m_loadAntsDelayModel; //!< Modelo para mantener los valores de la distribución generada por los delay de las hormigas de carga
 
   Ptr<RandomVariableStream> m_LoadAntsTimeStream; //!< Distribución de probabilidad para el tiempo de envio de hormigas de carga
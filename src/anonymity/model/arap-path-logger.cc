@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-path-logger.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string.h>
+
+#define PATH_LOG_WAIT_NS 10000000 //10 ms, espera maxima del hilo escritor entre revisiones
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapPathLogger");
+
+const char ArapPathLogger::BINARY_MAGIC[8] = {'A','R','A','P','P','T','H','1'};
+
+ArapPathLogger::ArapPathLogger()
+:m_file(NULL), m_format(FORMAT_CSV), m_bufferSize(DEFAULT_PATH_LOG_BUFFER_SIZE), m_start(0), m_active(NULL), m_stop(false), m_writer(0){
+}
+
+ArapPathLogger::~ArapPathLogger(){
+	Close();
+}
+
+bool
+ArapPathLogger::Open(const std::string& filename, Format format, uint32_t bufferSize){
+	NS_ABORT_MSG_IF(m_file!=NULL,"ERROR: El registro de caminos ya esta abierto");
+	m_format = format;
+	m_bufferSize = bufferSize;
+	if(m_format==FORMAT_CSV)
+		m_file = fopen(filename.c_str(),"a");
+	else
+		m_file = fopen(filename.c_str(),"wb");
+	if(m_file==NULL){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+filename);
+		return false;
+	}
+	if(m_format==FORMAT_BINARY)
+		fwrite(BINARY_MAGIC,1,sizeof(BINARY_MAGIC),m_file);
+	fseek(m_file,0,SEEK_END);
+	m_start = ftell(m_file);
+
+	m_active = new std::vector<char>();
+	m_active->reserve(m_bufferSize);
+	m_stop = false;
+	m_writer = Create<SystemThread>(MakeCallback(&ArapPathLogger::WriterLoop,this));
+	m_writer->Start();
+	return true;
+}
+
+bool
+ArapPathLogger::IsOpen() const{
+	return m_file!=NULL;
+}
+
+void
+ArapPathLogger::Append(const char* data, uint32_t size){
+	if(m_active->size()+size > m_bufferSize)
+		SubmitActiveBuffer();
+	m_active->insert(m_active->end(),data,data+size);
+}
+
+void
+ArapPathLogger::Log(double time, const Ipv4Address& source, const std::list<Ipv4Address>& path){
+	if(m_file==NULL)
+		return;
+	if(m_format==FORMAT_CSV){
+		m_line.str("");
+		m_line<<time<<","<<source;
+		for(std::list<Ipv4Address>::const_iterator it = path.begin();it!=path.end();it++)
+			m_line<<","<<*it;
+		m_line<<"\n";
+		const std::string& line = m_line.str();
+		Append(line.data(),line.size());
+	}
+	else{
+		/* Registro binario: <tiempo (double)> <IP origen (uint32)> <cantidad de saltos (uint8)> <IP de cada salto (uint32)> */
+		char record[sizeof(double)+sizeof(uint32_t)+sizeof(uint8_t)+255*sizeof(uint32_t)];
+		NS_ABORT_MSG_IF(path.size()>255,"ERROR: El camino excede la cantidad de saltos del formato binario");
+		uint32_t offset = 0;
+		uint32_t ip = source.Get();
+		uint8_t hops = path.size();
+		memcpy(record+offset,&time,sizeof(double));
+		offset+=sizeof(double);
+		memcpy(record+offset,&ip,sizeof(uint32_t));
+		offset+=sizeof(uint32_t);
+		memcpy(record+offset,&hops,sizeof(uint8_t));
+		offset+=sizeof(uint8_t);
+		for(std::list<Ipv4Address>::const_iterator it = path.begin();it!=path.end();it++){
+			ip = it->Get();
+			memcpy(record+offset,&ip,sizeof(uint32_t));
+			offset+=sizeof(uint32_t);
+		}
+		Append(record,offset);
+	}
+}
+
+void
+ArapPathLogger::SubmitActiveBuffer(){
+	if(m_active->empty())
+		return;
+	m_mutex.Lock();
+	/* Si el hilo escritor esta atrasado se espera a que libere algun buffer,
+	 * para mantener acotada la memoria usada por el registro
+	 */
+	while(m_pending.size()>=MAX_PENDING_PATH_LOG_BUFFERS){
+		/* TimedWait() retorna de inmediato mientras la condicion sea verdadera, se limpia con
+		 * m_mutex tomado para que un aviso del hilo escritor posterior a la revision no se pierda
+		 */
+		m_freeCondition.SetCondition(false);
+		m_mutex.Unlock();
+		m_pendingCondition.SetCondition(true);
+		m_pendingCondition.Signal();
+		m_freeCondition.TimedWait(PATH_LOG_WAIT_NS);
+		m_mutex.Lock();
+	}
+	m_pending.push_back(m_active);
+	if(m_free.empty()){
+		m_active = new std::vector<char>();
+		m_active->reserve(m_bufferSize);
+	}
+	else{
+		m_active = m_free.front();
+		m_free.pop_front();
+	}
+	m_mutex.Unlock();
+	m_pendingCondition.SetCondition(true);
+	m_pendingCondition.Signal();
+}
+
+void
+ArapPathLogger::WriterLoop(){
+	while(true){
+		m_mutex.Lock();
+		if(m_pending.empty()){
+			m_pendingCondition.SetCondition(false); //Igual que m_freeCondition en SubmitActiveBuffer()
+			bool stop = m_stop;
+			m_mutex.Unlock();
+			if(stop)
+				break;
+			m_pendingCondition.TimedWait(PATH_LOG_WAIT_NS);
+			continue;
+		}
+		std::vector<char>* buffer = m_pending.front();
+		m_pending.pop_front();
+		m_mutex.Unlock();
+
+		fwrite(&(*buffer)[0],1,buffer->size(),m_file);
+		buffer->clear();
+
+		m_mutex.Lock();
+		m_free.push_back(buffer);
+		m_mutex.Unlock();
+		m_freeCondition.SetCondition(true);
+		m_freeCondition.Signal();
+	}
+}
+
+void
+ArapPathLogger::Close(){
+	if(m_file==NULL)
+		return;
+	SubmitActiveBuffer();
+	m_mutex.Lock();
+	m_stop = true;
+	m_mutex.Unlock();
+	m_pendingCondition.SetCondition(true);
+	m_pendingCondition.Signal();
+	m_writer->Join();
+	m_writer = 0;
+
+	fclose(m_file);
+	m_file = NULL;
+	delete m_active;
+	m_active = NULL;
+	for(std::list<std::vector<char>*>::iterator it = m_free.begin();it!=m_free.end();it++)
+		delete *it;
+	m_free.clear();
+}
+
+bool
+ArapPathLogger::ConvertToCsv(const std::string& binaryFile, const std::string& csvFile){
+	std::ifstream in(binaryFile.c_str(),std::ios_base::in | std::ios_base::binary);
+	if(!in.is_open())
+		return false;
+	char magic[sizeof(BINARY_MAGIC)];
+	in.read(magic,sizeof(magic));
+	if(!in.good() || memcmp(magic,BINARY_MAGIC,sizeof(BINARY_MAGIC))!=0){
+		NS_LOG_INFO("El archivo "<<binaryFile<<" no es un registro de caminos binario");
+		return false;
+	}
+	std::ofstream out(csvFile.c_str());
+	if(!out.is_open())
+		return false;
+
+	double time;
+	uint32_t ip;
+	uint8_t hops;
+	while(in.read((char*)&time,sizeof(double))){
+		in.read((char*)&ip,sizeof(uint32_t));
+		in.read((char*)&hops,sizeof(uint8_t));
+		out<<time<<","<<Ipv4Address(ip);
+		for(uint8_t i=0;i<hops;i++){
+			in.read((char*)&ip,sizeof(uint32_t));
+			out<<","<<Ipv4Address(ip);
+		}
+		out<<"\n";
+		if(!in.good()){
+			NS_LOG_INFO("El archivo "<<binaryFile<<" termina con un registro incompleto");
+			return false;
+		}
+	}
+	out.close();
+	return true;
+}
+
+uint64_t
+ArapPathLogger::GetStart() const{
+	return m_start;
+}
+
+bool
+ArapPathLogger::ReadRecord(std::istream& in, Format format, std::string& record, double& time){
+	if(format==FORMAT_CSV){
+		if(!std::getline(in,record) || in.eof()) //Una línea sin fin de línea es un registro incompleto
+			return false;
+		record+="\n";
+		time = strtod(record.c_str(),NULL);
+		return true;
+	}
+	char header[sizeof(double)+sizeof(uint32_t)+sizeof(uint8_t)];
+	if(!in.read(header,sizeof(header)))
+		return false;
+	memcpy(&time,header,sizeof(double));
+	uint8_t hops = header[sizeof(double)+sizeof(uint32_t)];
+	record.assign(header,sizeof(header));
+	record.resize(sizeof(header)+hops*sizeof(uint32_t));
+	if(hops>0 && !in.read(&record[sizeof(header)],hops*sizeof(uint32_t)))
+		return false;
+	return true;
+}
+
+bool
+ArapPathLogger::MergeFiles(Format format, uint64_t start, const std::string& filename, const std::vector<std::string>& others){
+	uint32_t headerSize = (format==FORMAT_BINARY) ? sizeof(BINARY_MAGIC) : 0;
+	std::string mergedFile = filename+".merge";
+	std::ofstream out(mergedFile.c_str(),std::ios_base::out | std::ios_base::binary);
+	if(!out.is_open())
+		return false;
+
+	/* Un flujo por archivo, con su próximo registro leído */
+	std::vector<std::ifstream*> inputs;
+	inputs.push_back(new std::ifstream(filename.c_str(),std::ios_base::in | std::ios_base::binary));
+	for(uint32_t i=0;i<others.size();i++){
+		inputs.push_back(new std::ifstream(others[i].c_str(),std::ios_base::in | std::ios_base::binary));
+		inputs.back()->seekg(headerSize);
+	}
+	bool merged = inputs[0]->is_open();
+	std::vector<char> previous(DEFAULT_PATH_LOG_BUFFER_SIZE);
+	for(uint64_t left = start;merged && left>0;){ //Registros previos (Ejecuciones anteriores en CSV, o la cabecera binaria)
+		uint64_t size = std::min<uint64_t>(left,previous.size());
+		merged = (bool)inputs[0]->read(&previous[0],size);
+		out.write(&previous[0],size);
+		left-=size;
+	}
+	std::vector<std::string> records(inputs.size());
+	std::vector<double> times(inputs.size(),0);
+	std::vector<bool> pending(inputs.size(),false);
+	for(uint32_t i=0;i<inputs.size();i++)
+		pending[i] = inputs[i]->is_open() && ReadRecord(*inputs[i],format,records[i],times[i]);
+
+	while(merged){
+		int32_t next = -1;
+		for(uint32_t i=0;i<inputs.size();i++){
+			if(pending[i] && (next<0 || times[i]<times[next]))
+				next = i;
+		}
+		if(next<0)
+			break;
+		out.write(records[next].data(),records[next].size());
+		pending[next] = ReadRecord(*inputs[next],format,records[next],times[next]);
+	}
+	for(uint32_t i=0;i<inputs.size();i++)
+		delete inputs[i];
+	out.close();
+	if(!merged || !out.good() || std::rename(mergedFile.c_str(),filename.c_str())!=0){
+		std::remove(mergedFile.c_str());
+		return false;
+	}
+	return true;
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_PATH_LOGGER_H
+#define ARAP_PATH_LOGGER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#include <stdio.h>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <list>
+
+/**
+ * Tamaño en Bytes por defecto de cada buffer en memoria del registro de caminos.
+ */
+#define DEFAULT_PATH_LOG_BUFFER_SIZE 4194304 //4 MB
+
+/**
+ * Cantidad máxima de buffers llenos esperando a ser escritos a disco. Si se alcanza
+ * este valor, la simulación espera a que el hilo escritor libere alguno.
+ */
+#define MAX_PENDING_PATH_LOG_BUFFERS 4
+
+namespace ns3 {
+
+/**
+ * Registro compartido (Uno por simulación) de los caminos de las hormigas de carga.
+ *
+ * Los caminos se agregan a un buffer en memoria, y cuando este se llena se entrega a
+ * un hilo escritor que lo escribe a disco en segundo plano, de modo que la simulación
+ * no abre, escribe y cierra el archivo por cada hormiga.
+ *
+ * Existen dos formatos de salida:
+ * - CSV: Una línea por hormiga "<tiempo>,<IP origen>,<salto 1>,...,<IP destino>" (Formato original).
+ * - Binario: Registros compactos de tamaño variable que se pueden convertir al formato CSV con
+ * ConvertToCsv() (Ver el ejemplo "arap-paths-to-csv").
+ *
+ * FORMAT_NONE indica que no se registran caminos: el registro no se abre y Log() no hace
+ * nada (Por ejemplo en barridos que solo usan las métricas de ArapAnonymityMetrics).
+ */
+class ArapPathLogger {
+
+public:
+
+	/**
+	 * Formatos de salida del registro de caminos.
+	 */
+	enum Format{FORMAT_CSV, FORMAT_BINARY, FORMAT_NONE};
+
+	/**
+	 * Cabecera con la que inicia todo archivo en formato binario.
+	 */
+	static const char BINARY_MAGIC[8];
+
+	ArapPathLogger();
+	~ArapPathLogger();
+
+	/**
+	 * Abre el archivo de salida e inicia el hilo escritor.
+	 *
+	 * @param[in] filename Nombre del archivo de salida. En formato CSV se agrega al final
+	 * del archivo si este ya existe, en formato binario se sobreescribe.
+	 *
+	 * @param[in] format Formato de salida
+	 *
+	 * @param[in] bufferSize Tamaño en Bytes de cada buffer en memoria
+	 *
+	 * @return true si se pudo abrir el archivo
+	 */
+	bool Open(const std::string& filename, Format format, uint32_t bufferSize=DEFAULT_PATH_LOG_BUFFER_SIZE);
+
+	/**
+	 * Agrega el camino de una hormiga de carga al registro.
+	 *
+	 * @param[in] time Tiempo de simulación (Segundos) en que se envió la hormiga
+	 *
+	 * @param[in] source IP del nodo que envió la hormiga
+	 *
+	 * @param[in] path Camino que recorrerá la hormiga (El último elemento es el destino)
+	 */
+	void Log(double time, const Ipv4Address& source, const std::list<Ipv4Address>& path);
+
+	/**
+	 * Escribe los datos pendientes, detiene el hilo escritor y cierra el archivo.
+	 */
+	void Close();
+
+	/**
+	 * @return true si el registro esta abierto
+	 */
+	bool IsOpen() const;
+
+	/**
+	 * Convierte un archivo de caminos en formato binario al formato CSV.
+	 *
+	 * @param[in] binaryFile Nombre del archivo binario a leer
+	 *
+	 * @param[in] csvFile Nombre del archivo CSV a crear
+	 *
+	 * @return true si la conversión fue exitosa
+	 */
+	static bool ConvertToCsv(const std::string& binaryFile, const std::string& csvFile);
+
+	/**
+	 * @return Posición en el archivo de salida del primer registro de la última apertura (En
+	 * formato CSV el tamaño que tenía el archivo, ya que los registros se agregan al final)
+	 */
+	uint64_t GetStart() const;
+
+	/**
+	 * Intercala por tiempo los registros de varios archivos de caminos en el primero (Los
+	 * archivos de cada rango en una simulación distribuida). Cada archivo debe estar ordenado
+	 * por tiempo, lo que se cumple porque los caminos se registran al crearse. Con tiempos
+	 * iguales se mantiene el orden de los archivos.
+	 *
+	 * @param[in] format Formato de los archivos
+	 *
+	 * @param[in] start Posición del primer registro a intercalar en filename (Lo anterior se
+	 * copia sin cambios, ver GetStart())
+	 *
+	 * @param[in] filename Archivo combinado, que también aporta registros
+	 *
+	 * @param[in] others Archivos a intercalar (No se modifican; los que no existen se omiten)
+	 *
+	 * @return true si se pudieron combinar
+	 */
+	static bool MergeFiles(Format format, uint64_t start, const std::string& filename, const std::vector<std::string>& others);
+
+private:
+
+	/**
+	 * Entrega el buffer activo al hilo escritor y toma un buffer libre para seguir registrando.
+	 */
+	void SubmitActiveBuffer();
+
+	/**
+	 * Ciclo del hilo escritor: escribe a disco los buffers entregados hasta que se cierre el registro.
+	 */
+	void WriterLoop();
+
+	/**
+	 * Agrega bytes al buffer activo, entregandolo al hilo escritor si se llena.
+	 *
+	 * @param[in] data Bytes a agregar
+	 *
+	 * @param[in] size Cantidad de bytes
+	 */
+	void Append(const char* data, uint32_t size);
+
+	/**
+	 * Lee el próximo registro de un archivo de caminos.
+	 *
+	 * @param[in] in Archivo a leer
+	 *
+	 * @param[in] format Formato del archivo
+	 *
+	 * @param[out] record Bytes del registro (En CSV la línea con su fin de línea)
+	 *
+	 * @param[out] time Tiempo del registro
+	 *
+	 * @return false si no hay más registros completos
+	 */
+	static bool ReadRecord(std::istream& in, Format format, std::string& record, double& time);
+
+	FILE* m_file; //!< Archivo de salida
+	Format m_format; //!< Formato de salida
+	uint32_t m_bufferSize; //!< Tamaño en Bytes de cada buffer
+	uint64_t m_start; //!< Posición del primer registro de la última apertura
+	std::vector<char>* m_active; //!< Buffer donde se registran los caminos (Solo lo usa el hilo de la simulación)
+	std::list<std::vector<char>*> m_pending; //!< Buffers llenos esperando ser escritos
+	std::list<std::vector<char>*> m_free; //!< Buffers ya escritos que pueden reutilizarse
+	bool m_stop; //!< Indica al hilo escritor que debe terminar luego de vaciar m_pending
+	SystemMutex m_mutex; //!< Protege m_pending, m_free y m_stop
+	SystemCondition m_pendingCondition; //!< Avisa al hilo escritor que hay buffers pendientes
+	SystemCondition m_freeCondition; //!< Avisa a la simulación que hay buffers libres
+	Ptr<SystemThread> m_writer; //!< Hilo escritor
+	std::ostringstream m_line; //!< Flujo reutilizado para dar formato a las líneas CSV
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_PATH_LOGGER_H */
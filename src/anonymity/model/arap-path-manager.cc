@@ -2,14 +2,17 @@
 
 #include "arap-path-manager.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/rng-seed-manager.h"
 #include "arap-simulator.h"
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ArapPathManager");
 
-ArapPathManager::ArapPathManager() {
+ArapPathManager::ArapPathManager()
+:m_directory(NULL), m_numNodes(0), m_localIndex(0){
 	NS_LOG_INFO("Constructor de ArapPathManager");
 }
 
@@ -19,36 +22,43 @@ ArapPathManager::~ArapPathManager() {
 
 const double
 ArapPathManager::GetProbability(const Ipv4Address& target, const Ipv4Address& medium){
-	std::map<Ipv4Address,double>& targetMap = m_probTable[target];
-	return targetMap[medium];
+	return GetRow(m_directory->GetIndex(target))[m_directory->GetIndex(medium)];
 }
 
 void
 ArapPathManager::SetProbability(const double& prob, const Ipv4Address& target, const Ipv4Address& medium){
-	std::map<Ipv4Address,double>& targetMap = m_probTable[target];
-	targetMap[medium] = prob;
+	uint32_t targetIndex = m_directory->GetIndex(target);
+	GetRow(targetIndex)[m_directory->GetIndex(medium)] = prob;
+	InvalidateRow(targetIndex);
 }
 
 void
 ArapPathManager::CreateProbTable(const Ipv4Address& localIP){
-	const PointToPointStarHelper& star = ArapSimulator::GetStar();
-	const uint32_t nodes = star.SpokeCount();
-	for (uint32_t i = 0; i < star.SpokeCount (); ++i){
-		if(star.GetSpokeIpv4Address(i)==localIP)
+	AllocateTable(ArapSimulator::GetDirectory(),localIP);
+	for (uint32_t i = 0; i < m_numNodes; ++i){
+		if(i==m_localIndex)
 			continue;
-		m_probTable[star.GetSpokeIpv4Address(i)]= std::map<Ipv4Address,double>();
-		std::map<Ipv4Address,double>& targetMap = m_probTable[star.GetSpokeIpv4Address(i)];
-		for (uint32_t j = 0; j < star.SpokeCount (); ++j){
-			if(star.GetSpokeIpv4Address(j)==localIP)
+		double* row = GetRow(i);
+		for (uint32_t j = 0; j < m_numNodes; ++j){
+			if(j==m_localIndex || i==j)
 				continue;
-			if(i==j)
-				targetMap[star.GetSpokeIpv4Address(j)]= 0;
-			else
-				targetMap[star.GetSpokeIpv4Address(j)]= double(1)/(nodes-2);
+			row[j]= double(1)/(m_numNodes-2);
 		}
 	}
 }
 
+void
+ArapPathManager::AllocateTable(const ArapNodeDirectory& directory, const Ipv4Address& localIP){
+	m_directory = &directory;
+	m_numNodes = m_directory->GetCount();
+	m_localIndex = m_directory->GetIndex(localIP);
+	m_probTable.assign(m_numNodes*m_numNodes,0);
+	m_cumulative.assign(m_numNodes*m_numNodes,0);
+	ResetRowVersions();
+	m_cumulativeVersion.assign(m_numNodes,0);
+	m_rng = CreateObject<UniformRandomVariable>();
+}
+
 void
 ArapPathManager::PrintProbTable(const Ipv4Address& localIP){
 	std::string name;
@@ -63,19 +73,25 @@ ArapPathManager::PrintProbTable(const Ipv4Address& localIP){
   }
   //Imprimir en archivo la cabecera de la tabla
   file<<" ";
-  for (std::map<Ipv4Address,std::map<Ipv4Address,double> >::iterator it = m_probTable.begin();it!=m_probTable.end(); it++) {
-  	 file<<","<<it->first;
+  for (uint32_t i = 0; i < m_numNodes; i++) {
+  	if(i!=m_localIndex)
+  		file<<","<<m_directory->GetAddress(i);
 	}
   file<<",Suma";
   file<<std::endl;
 
   //Imrpimir fila por fila al archivo
-  for (std::map<Ipv4Address,std::map<Ipv4Address,double> >::iterator it = m_probTable.begin();it!=m_probTable.end(); it++) {
-  	file<<it->first;
+  for (uint32_t i = 0; i < m_numNodes; i++) {
+  	if(i==m_localIndex)
+  		continue;
+  	file<<m_directory->GetAddress(i);
+  	const double* row = GetRow(i);
   	double sumProb = 0;
-  	for (std::map<Ipv4Address,double>::iterator it2 = it->second.begin();it2!=it->second.end(); it2++) {
-  		file<<","<<std::fixed<<it2->second;
-  		sumProb = sumProb +it2->second;
+  	for (uint32_t j = 0; j < m_numNodes; j++) {
+  		if(j==m_localIndex)
+  			continue;
+  		file<<","<<std::fixed<<row[j];
+  		sumProb = sumProb +row[j];
   	}
   	file<<","<<sumProb;
   	file<<std::endl;
@@ -83,6 +99,177 @@ ArapPathManager::PrintProbTable(const Ipv4Address& localIP){
   file.close();
 }
 
+void
+ArapPathManager::ExportProbTable(std::map<Ipv4Address,std::map<Ipv4Address,double> >& table) const{
+	table.clear();
+	for (uint32_t i = 0; i < m_numNodes; i++) {
+		if(i==m_localIndex)
+			continue;
+		std::map<Ipv4Address,double>& targetMap = table[m_directory->GetAddress(i)];
+		for (uint32_t j = 0; j < m_numNodes; j++) {
+			if(j!=m_localIndex)
+				targetMap[m_directory->GetAddress(j)] = m_probTable[i*m_numNodes+j];
+		}
+	}
+}
+
+void
+ArapPathManager::ExportRow(uint32_t targetIndex, std::vector<std::pair<uint32_t,double> >& row) const{
+	row.clear();
+	const double* probs = &m_probTable[targetIndex*m_numNodes];
+	for (uint32_t j = 0; j < m_numNodes; j++) {
+		if(probs[j]!=0)
+			row.push_back(std::make_pair(j,probs[j]));
+	}
+}
+
+uint32_t
+ArapPathManager::GetRowVersion(uint32_t targetIndex) const{
+	return m_rowVersion[targetIndex];
+}
+
+void
+ArapPathManager::ImportProbTable(const std::map<Ipv4Address,std::map<Ipv4Address,double> >& table){
+	typedef std::map<Ipv4Address,std::map<Ipv4Address,double> > Table;
+	for(Table::const_iterator it = table.begin();it!=table.end();it++){
+		uint32_t targetIndex = m_directory->GetIndex(it->first);
+		double* row = GetRow(targetIndex);
+		std::fill(row,row+m_numNodes,0.0);
+		for(std::map<Ipv4Address,double>::const_iterator col = it->second.begin();col!=it->second.end();col++){
+			uint32_t mediumIndex = m_directory->GetIndex(col->first);
+			if(mediumIndex!=m_localIndex && mediumIndex!=targetIndex)
+				row[mediumIndex] = col->second;
+		}
+		InvalidateRow(targetIndex);
+	}
+}
+
+void
+ArapPathManager::SaveState(std::ostream& out) const{
+	/* Por cada fila: IP destino, cantidad de columnas distintas de cero y los
+	 * pares (IP intermedio, probabilidad). Las filas se recorren con ExportRow(),
+	 * por lo que una tabla dispersa de K candidatos ocupa y se recorre en O(N·K)
+	 */
+	uint32_t rows = m_numNodes-1;
+	out.write((const char*)&rows,sizeof(uint32_t));
+	std::vector<std::pair<uint32_t,double> > row;
+	for(uint32_t i=0;i<m_numNodes;i++){
+		if(i==m_localIndex)
+			continue;
+		ExportRow(i,row);
+		uint32_t target = m_directory->GetAddress(i).Get();
+		uint32_t columns = row.size();
+		out.write((const char*)&target,sizeof(uint32_t));
+		out.write((const char*)&columns,sizeof(uint32_t));
+		for(uint32_t j=0;j<row.size();j++){
+			uint32_t medium = m_directory->GetAddress(row[j].first).Get();
+			out.write((const char*)&medium,sizeof(uint32_t));
+			out.write((const char*)&row[j].second,sizeof(double));
+		}
+	}
+}
+
+void
+ArapPathManager::LoadState(std::istream& in){
+	std::map<Ipv4Address,std::map<Ipv4Address,double> > table;
+	uint32_t rows = 0;
+	in.read((char*)&rows,sizeof(uint32_t));
+	for(uint32_t r=0;r<rows && in.good();r++){
+		uint32_t target = 0, columns = 0;
+		in.read((char*)&target,sizeof(uint32_t));
+		in.read((char*)&columns,sizeof(uint32_t));
+		NS_ABORT_MSG_IF(m_directory->FindIndex(Ipv4Address(target))==ArapNodeDirectory::INVALID_INDEX,
+				"ERROR: El estado guardado tiene un destino que no existe en la red: "<<Ipv4Address(target));
+		std::map<Ipv4Address,double>& row = table[Ipv4Address(target)];
+		for(uint32_t c=0;c<columns && in.good();c++){
+			uint32_t medium = 0;
+			double prob = 0;
+			in.read((char*)&medium,sizeof(uint32_t));
+			in.read((char*)&prob,sizeof(double));
+			NS_ABORT_MSG_IF(m_directory->FindIndex(Ipv4Address(medium))==ArapNodeDirectory::INVALID_INDEX,
+					"ERROR: El estado guardado tiene un intermedio que no existe en la red: "<<Ipv4Address(medium));
+			row[Ipv4Address(medium)] = prob;
+		}
+	}
+	if(in.good())
+		ImportProbTable(table);
+}
+
+const double*
+ArapPathManager::GetCumulativeRow(uint32_t targetIndex){
+	double* cumulative = &m_cumulative[targetIndex*m_numNodes];
+	if(m_cumulativeVersion[targetIndex]!=m_rowVersion[targetIndex]){
+		/* La fila local y la diagonal valen cero, por lo que su intervalo
+		 * en el arreglo acumulado es vacio y nunca son seleccionadas
+		 */
+		const double* row = GetRow(targetIndex);
+		double acum = 0;
+		for(uint32_t i = 0; i < m_numNodes; i++){
+			if(i!=targetIndex && i!=m_localIndex && row[i]>0)
+				acum += row[i];
+			cumulative[i] = acum;
+		}
+		m_cumulativeVersion[targetIndex] = m_rowVersion[targetIndex];
+	}
+	return cumulative;
+}
+
+void
+ArapPathManager::SampleIntermediates(uint32_t targetIndex, uint32_t count, std::list<Ipv4Address>& path){
+	NS_ABORT_MSG_IF(count+2>m_numNodes,"ERROR: No hay suficientes nodos para crear un camino de "<<count<<" nodos intermedios");
+	const double* cumulative = GetCumulativeRow(targetIndex);
+	std::vector<uint32_t> chosen; //Indices ya seleccionados, ordenados de menor a mayor
+	chosen.reserve(count);
+	double chosenWeight = 0;
+	for(uint32_t hop = 0; hop < count; hop++){
+		double remaining = cumulative[m_numNodes-1]-chosenWeight;
+		uint32_t index = m_numNodes;
+		if(remaining>0){
+			/* Se sortea un valor en el espacio sin los nodos ya seleccionados, y se
+			 * traslada al arreglo acumulado completo sumando el peso de los nodos
+			 * seleccionados que quedan antes de él
+			 */
+			double x = m_rng->GetValue(0,remaining);
+			for(std::vector<uint32_t>::iterator it = chosen.begin(); it!=chosen.end(); it++){
+				double start = (*it==0) ? 0 : cumulative[*it-1];
+				if(x<start)
+					break;
+				x += cumulative[*it]-start;
+			}
+			uint32_t start = std::upper_bound(cumulative,cumulative+m_numNodes,x)-cumulative;
+			/* Por errores de redondeo el valor puede caer al final del arreglo, sobre un
+			 * nodo ya seleccionado o sobre uno sin peso: en ese caso se toma el siguiente
+			 * nodo no seleccionado con peso, volviendo al inicio del arreglo si hace falta
+			 */
+			for(uint32_t step = 0; step < m_numNodes; step++){
+				uint32_t next = (start+step)%m_numNodes;
+				if(cumulative[next]>((next==0) ? 0 : cumulative[next-1]) && !std::binary_search(chosen.begin(),chosen.end(),next)){
+					index = next;
+					break;
+				}
+			}
+		}
+		if(index==m_numNodes){
+			/* No queda peso disponible (Probabilidades nulas, o el peso restante era solo
+			 * error de redondeo), se selecciona de manera uniforme entre los nodos validos
+			 * que no estan en el camino
+			 */
+			uint32_t candidates = m_numNodes-2-chosen.size();
+			uint32_t pick = m_rng->GetInteger(0,candidates-1);
+			for(index = 0; index < m_numNodes; index++){
+				if(index==targetIndex || index==m_localIndex || std::binary_search(chosen.begin(),chosen.end(),index))
+					continue;
+				if(pick==0)
+					break;
+				pick--;
+			}
+		}
+		chosenWeight += cumulative[index]-((index==0) ? 0 : cumulative[index-1]);
+		chosen.insert(std::upper_bound(chosen.begin(),chosen.end(),index),index);
+		path.push_back(m_directory->GetAddress(index));
+	}
+}
+
 ArapPathManager* ArapPathManager::GetCopy() const{
 	return NULL; //Esta definicion del metodo nunca se llama ya que la clase es totalmente abstracta
 }
@@ -99,4 +286,23 @@ ArapPathManager::CreatePath(const Ipv4Address& target){
 	return returnValue;
 }
 
+void
+ArapPathManager::ResetRowVersions(){
+	m_rowVersion.assign(m_numNodes,1);
+}
+
+const ExplorerAntsStatistics*
+ArapPathManager::GetExplorerStatistics(uint32_t) const{
+	return NULL;
+}
+
+void
+ArapPathManager::GetExplorerMediums(uint32_t targetIndex, std::vector<uint32_t>& mediums) const{
+	mediums.clear();
+	for(uint32_t i=0;i<m_numNodes;i++){
+		if(i!=m_localIndex && i!=targetIndex)
+			mediums.push_back(i);
+	}
+}
+
 } /* namespace ns3 */
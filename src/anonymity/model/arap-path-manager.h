@@ -6,12 +6,17 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
 #include "ns3/application-container.h"
-#include "ns3/point-to-point-star.h"
+#include "ns3/arap-node-directory.h"
+#include "ns3/random-variable-stream.h"
 #include <map>
 #include <list>
+#include <vector>
+#include <iostream>
 
 namespace ns3 {
 
+class ExplorerAntsStatistics;
+
 /**
  * Clase encargada de mantener la tabla de probabilidades para los distintos
  * caminos hacia los distintos destinos, esta es una clase totalmente abstracta,
@@ -25,6 +30,11 @@ namespace ns3 {
  *
  * Si por ejemplo se pide una probabilidad P[i,j], es la probabilidad de ir al nodo
  * "i" a través del nodo "j".
+ *
+ * La tabla se guarda en memoria contigua (Fila por fila) de tamaño N×N, donde N es la
+ * cantidad de nodos y cada nodo se identifica por su índice en ArapNodeDirectory. La
+ * fila y la columna del nodo local existen en memoria pero no forman parte de la tabla
+ * (Siempre valen cero y no se imprimen).
  */
 class ArapPathManager {
 
@@ -41,7 +51,7 @@ public:
 	 *
 	 * @return La probabilidad correspondiente en la tabla
 	 */
-	const double GetProbability(const Ipv4Address& target, const Ipv4Address& medium);
+	virtual const double GetProbability(const Ipv4Address& target, const Ipv4Address& medium);
 
 	/**
 	 * Asigna una probabilidad en la tabla
@@ -52,7 +62,7 @@ public:
 	 *
 	 * @param[in] medium IP del nodo intermedio (Columna)
 	 */
-	void SetProbability(const double& prob, const Ipv4Address& target, const Ipv4Address& medium);
+	virtual void SetProbability(const double& prob, const Ipv4Address& target, const Ipv4Address& medium);
 
 	/**
 	 * Inicializa la tabla de probabilidades para el nodo cuya IP es localIP.
@@ -63,7 +73,7 @@ public:
 	 *
 	 * @param[in] localIP IP del nodo al que pertenece la tabla de probabilidad a crear.
 	 */
-	void CreateProbTable(const Ipv4Address& localIP);
+	virtual void CreateProbTable(const Ipv4Address& localIP);
 
 	/**
 	 * Imprime los valores de la tabla de probabilidades a un archivo.
@@ -73,7 +83,56 @@ public:
 	 *
 	 * @param[in] localIP IP del nodo al que pertenece la tabla a imprimir en archivo.
 	 */
-	void PrintProbTable(const Ipv4Address& localIP);
+	virtual void PrintProbTable(const Ipv4Address& localIP);
+
+	/**
+	 * Copia los valores de la tabla de probabilidades a un mapa indexado por IP.
+	 *
+	 * @param[out] table Mapa donde se copia la tabla (Fila: IP destino, Columna: IP intermedio)
+	 */
+	virtual void ExportProbTable(std::map<Ipv4Address,std::map<Ipv4Address,double> >& table) const;
+
+	/**
+	 * Copia las probabilidades distintas de cero de la fila de un destino. A diferencia de
+	 * ExportProbTable() solo recorre las columnas que guarda la especialización.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @param[out] row Pares (Índice del intermedio, probabilidad) en orden de índice (Se reemplaza su contenido)
+	 */
+	virtual void ExportRow(uint32_t targetIndex, std::vector<std::pair<uint32_t,double> >& row) const;
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @return Versión de la fila del destino, cambia cada vez que la fila se modifica (Ver InvalidateRow())
+	 */
+	uint32_t GetRowVersion(uint32_t targetIndex) const;
+
+	/**
+	 * Reemplaza las filas de la tabla de probabilidades presentes en un mapa indexado por IP
+	 * (Inverso de ExportProbTable()). Los intermedios que no aparecen en una fila quedan con
+	 * probabilidad cero.
+	 *
+	 * @param[in] table Mapa con las filas a copiar (Fila: IP destino, Columna: IP intermedio)
+	 */
+	virtual void ImportProbTable(const std::map<Ipv4Address,std::map<Ipv4Address,double> >& table);
+
+	/**
+	 * Guarda en binario el estado aprendido (Las probabilidades distintas de cero de la tabla),
+	 * para restaurarlo en otra simulación con LoadState(). Las especializaciones que aprenden
+	 * otros valores deben agregarlos a continuación.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	virtual void SaveState(std::ostream& out) const;
+
+	/**
+	 * Restaura el estado guardado con SaveState(). Debe llamarse luego de CreateProbTable().
+	 *
+	 * @param[in] in Flujo de entrada binario
+	 */
+	virtual void LoadState(std::istream& in);
 
 	/**
 	 * Método usado para procesar una hormiga exploradora una vez que esta vuelve al nido.
@@ -106,8 +165,102 @@ public:
 	 */
 	virtual std::list<Ipv4Address> CreatePath(const Ipv4Address& target);
 
+	/**
+	 * Modelo estocástico de los tiempos de las exploradoras hacia un destino, usado por
+	 * los planificadores de exploradoras (Ver ArapExplorerScheduler) para priorizar los destinos.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @return Modelo del destino, o NULL si esta especialización no mantiene modelos
+	 */
+	virtual const ExplorerAntsStatistics* GetExplorerStatistics(uint32_t targetIndex) const;
+
+	/**
+	 * Intermedios por los que se exploran los caminos hacia un destino (Columnas de la fila
+	 * que mantiene la tabla). Por defecto son todos los nodos excepto el local y el destino,
+	 * en orden de índice.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @param[out] mediums Índices de los intermedios (Se reemplaza su contenido)
+	 */
+	virtual void GetExplorerMediums(uint32_t targetIndex, std::vector<uint32_t>& mediums) const;
+
 protected:
-	std::map<Ipv4Address,std::map<Ipv4Address,double> > m_probTable; //!< Tabla de probabilidades
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino en ArapNodeDirectory
+	 *
+	 * @return Puntero al inicio de la fila del destino (Una columna por cada índice de nodo)
+	 */
+	double* GetRow(uint32_t targetIndex){
+		return &m_probTable[targetIndex*m_numNodes];
+	}
+
+	/**
+	 * Indica que la fila de un destino cambió, para que su arreglo acumulado se
+	 * vuelva a calcular en el próximo muestreo y ArapConvergenceMonitor la compare.
+	 * Debe llamarse luego de modificar la fila a través de GetRow().
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 */
+	void InvalidateRow(uint32_t targetIndex){
+		m_rowVersion[targetIndex]++;
+	}
+
+	/**
+	 * Crea la tabla con todas las probabilidades en cero, el arreglo acumulado y el flujo
+	 * aleatorio de los caminos. Lo llama CreateProbTable() con el directorio de la simulación.
+	 *
+	 * @param[in] directory Directorio de nodos usado para indexar la tabla
+	 *
+	 * @param[in] localIP IP del nodo al que pertenece la tabla
+	 */
+	void AllocateTable(const ArapNodeDirectory& directory, const Ipv4Address& localIP);
+
+	/**
+	 * Inicializa las versiones de las filas. Lo llama CreateProbTable(), las
+	 * especializaciones que lo redefinen deben llamarlo también.
+	 */
+	void ResetRowVersions();
+
+	/**
+	 * Selecciona nodos intermedios distintos (Sin reemplazo) hacia un destino, con
+	 * probabilidad proporcional a su valor en la fila del destino, y los agrega al final
+	 * del camino.
+	 *
+	 * Se usa el arreglo acumulado de la fila (Calculado solo si la fila cambió desde el
+	 * último muestreo) con búsqueda binaria, descontando los nodos ya seleccionados, por
+	 * lo que cada salto cuesta O(log N) y no es necesario repetir sorteos.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @param[in] count Cantidad de nodos intermedios a seleccionar (<= cantidad de nodos-2)
+	 *
+	 * @param[out] path Camino al que se agregan los nodos seleccionados
+	 */
+	void SampleIntermediates(uint32_t targetIndex, uint32_t count, std::list<Ipv4Address>& path);
+
+	const ArapNodeDirectory* m_directory; //!< Directorio de nodos usado para indexar la tabla
+	uint32_t m_numNodes; //!< Cantidad de filas y columnas de la tabla
+	uint32_t m_localIndex; //!< Índice del nodo al que pertenece la tabla
+	std::vector<double> m_probTable; //!< Tabla de probabilidades (Fila: índice destino, Columna: índice intermedio)
+
+private:
+
+	/**
+	 * Recalcula el arreglo acumulado de una fila si esta cambió desde el último cálculo.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @return Puntero al inicio del arreglo acumulado de la fila
+	 */
+	const double* GetCumulativeRow(uint32_t targetIndex);
+
+	std::vector<double> m_cumulative; //!< Suma acumulada de cada fila de la tabla (Misma disposición que m_probTable)
+	std::vector<uint32_t> m_rowVersion; //!< Versión de cada fila, se incrementa con cada cambio
+	std::vector<uint32_t> m_cumulativeVersion; //!< Versión de la fila con la que se calculó cada arreglo acumulado
+	Ptr<UniformRandomVariable> m_rng; //!< Flujo aleatorio propio de este ArapPathManager, usado para muestrear caminos
 };
 
 } /* namespace ns3 */
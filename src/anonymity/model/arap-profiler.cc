@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-profiler.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/arap-simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapProfiler");
+
+ArapProfiler::ArapProfiler()
+:m_enabled(false), m_seriesInterval(0), m_runStart(0), m_runNanoseconds(0), m_simulatedTime(0){
+	for(uint32_t i=0;i<SECTION_COUNT;i++){
+		m_calls[i] = 0;
+		m_nanoseconds[i] = 0;
+	}
+}
+
+ArapProfiler::~ArapProfiler(){
+	if(m_series.is_open())
+		m_series.close();
+}
+
+void
+ArapProfiler::Enable(const Time& seriesInterval){
+	m_enabled = true;
+	m_seriesInterval = seriesInterval;
+}
+
+bool
+ArapProfiler::IsEnabled() const{
+	return m_enabled;
+}
+
+const char*
+ArapProfiler::GetSectionName(Section section){
+	static const char* names[SECTION_COUNT] = {"ReceiveAnt","HandleReqMed","HandleReqFinal","HandleRespMed",
+			"HandleRespFinal","SendDelayedAnt","SendExplorerAnts","SendLoadAnt","CreatePath"};
+	return names[section];
+}
+
+bool
+ArapProfiler::IsNested(Section section){
+	return section==SECTION_REQ_MED || section==SECTION_REQ_FINAL || section==SECTION_RESP_MED
+			|| section==SECTION_RESP_FINAL || section==SECTION_CREATE_PATH;
+}
+
+void
+ArapProfiler::Start(const std::string& seriesFilename){
+	if(!m_enabled)
+		return;
+	if(m_seriesInterval.IsStrictlyPositive()){
+		m_series.open(seriesFilename.c_str());
+		if(!m_series.is_open())
+			NS_LOG_INFO("Fallo el crear el archivo de nombre: "+seriesFilename);
+		else{
+			m_series<<"\"Tiempo simulado (s)\",\"Tiempo real (s)\",\"Hormigas creadas\"";
+			for(uint32_t i=0;i<SECTION_COUNT;i++)
+				m_series<<","<<GetSectionName((Section)i);
+			m_series<<"\n";
+			m_sampleEvent = Simulator::Schedule(m_seriesInterval,&ArapProfiler::Sample,this);
+		}
+	}
+	m_runStart = GetWallTime();
+}
+
+void
+ArapProfiler::Stop(){
+	if(!m_enabled)
+		return;
+	m_runNanoseconds = GetWallTime()-m_runStart;
+	m_simulatedTime = Simulator::Now();
+	Simulator::Cancel(m_sampleEvent);
+	if(m_series.is_open())
+		m_series.close();
+}
+
+void
+ArapProfiler::Sample(){
+	m_series<<Simulator::Now().GetSeconds()<<","<<(GetWallTime()-m_runStart)/1e9<<","<<ArapSimulator::GetAntsCreated();
+	for(uint32_t i=0;i<SECTION_COUNT;i++)
+		m_series<<","<<m_calls[i];
+	m_series<<"\n";
+	m_sampleEvent = Simulator::Schedule(m_seriesInterval,&ArapProfiler::Sample,this);
+}
+
+void
+ArapProfiler::PrintSummary(const std::string& filename, uint64_t antsCreated) const{
+	if(!m_enabled)
+		return;
+	std::ofstream file (filename.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+filename);
+		return;
+	}
+	double runMs = m_runNanoseconds/1e6;
+	uint64_t topLevel = 0;
+	file<<"Seccion,Anidada,Llamadas,\"Tiempo real (ms)\",\"Tiempo medio (us)\",\"Fraccion del tiempo real\"\n";
+	for(uint32_t i=0;i<SECTION_COUNT;i++){
+		Section section = (Section)i;
+		double ms = m_nanoseconds[i]/1e6;
+		file<<GetSectionName(section)<<","<<IsNested(section)<<","<<m_calls[i]<<","<<ms<<","
+				<<((m_calls[i]>0) ? m_nanoseconds[i]/1e3/m_calls[i] : 0)<<","<<((runMs>0) ? ms/runMs : 0)<<"\n";
+		if(!IsNested(section))
+			topLevel += m_nanoseconds[i];
+	}
+	//Lo que no consumen las secciones de primer nivel lo consume la pila de red y el simulador
+	double restMs = (m_runNanoseconds>topLevel) ? (m_runNanoseconds-topLevel)/1e6 : 0;
+	file<<"\"Resto (Pila de red y simulador)\",0,,"<<restMs<<",,"<<((runMs>0) ? restMs/runMs : 0)<<"\n";
+
+	double simSeconds = m_simulatedTime.GetSeconds();
+	double antsPerSimSecond = (simSeconds>0) ? antsCreated/simSeconds : 0;
+	double antsPerWallSecond = (runMs>0) ? antsCreated/(runMs/1e3) : 0;
+	file<<"\n\"Tiempo real de Simulator::Run (ms)\","<<runMs<<"\n";
+	file<<"\"Tiempo simulado (s)\","<<simSeconds<<"\n";
+	file<<"\"Hormigas creadas\","<<antsCreated<<"\n";
+	file<<"\"Hormigas por segundo simulado\","<<antsPerSimSecond<<"\n";
+	file<<"\"Hormigas por segundo real\","<<antsPerWallSecond<<"\n";
+	file.close();
+
+	NS_LOG_UNCOND("Perfilado: "<<runMs<<" ms reales, "<<antsPerWallSecond<<" hormigas por segundo real, "
+			<<antsPerSimSecond<<" hormigas por segundo simulado, resto (pila de red y simulador) "<<restMs<<" ms");
+}
+
+} /* namespace ns3 */
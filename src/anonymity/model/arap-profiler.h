@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_PROFILER_H
+#define ARAP_PROFILER_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <fstream>
+
+namespace ns3 {
+
+/**
+ * Perfilador (Uno por simulación) del tiempo real que consumen los métodos de ArapNode.
+ *
+ * Para cada sección se cuenta la cantidad de llamadas y el tiempo real acumulado. Las
+ * secciones de primer nivel son las que el planificador de NS3 llama directamente, por
+ * lo que el tiempo real de Simulator::Run() que no consumen es el de la pila de red
+ * (TCP/UDP, IP, enlaces y colas) y el propio simulador. Las secciones anidadas se
+ * ejecutan dentro de una de primer nivel.
+ *
+ * Cuando está deshabilitado, Scope solo evalúa un booleano: no lee el reloj ni
+ * actualiza contadores.
+ */
+class ArapProfiler {
+
+public:
+
+	/**
+	 * Secciones medidas.
+	 */
+	enum Section {
+		SECTION_RECEIVE, //!< ArapNode::ReceiveAnt (Primer nivel)
+		SECTION_REQ_MED, //!< ArapNode::HandleReqMed (Dentro de ReceiveAnt)
+		SECTION_REQ_FINAL, //!< ArapNode::HandleReqFinal (Dentro de ReceiveAnt)
+		SECTION_RESP_MED, //!< ArapNode::HandleRespMed (Dentro de ReceiveAnt)
+		SECTION_RESP_FINAL, //!< ArapNode::HandleRespFinal (Dentro de ReceiveAnt)
+		SECTION_SEND, //!< ArapNode::SendDelayedAnt (Primer nivel)
+		SECTION_SEND_EXPLORERS, //!< ArapNode::SendExplorerAnts (Primer nivel)
+		SECTION_SEND_LOAD, //!< ArapNode::SendLoadAnt (Primer nivel)
+		SECTION_CREATE_PATH, //!< ArapPathManager::CreatePath (Dentro de SendLoadAnt)
+		SECTION_COUNT //!< Cantidad de secciones
+	};
+
+	/**
+	 * Mide el tiempo real de una sección desde su construcción hasta su destrucción.
+	 */
+	class Scope {
+	public:
+		/**
+		 * @param[in] profiler Perfilador de la simulación
+		 *
+		 * @param[in] section Sección a medir
+		 */
+		Scope(ArapProfiler& profiler, Section section)
+		:m_profiler(profiler.m_enabled ? &profiler : 0), m_section(section), m_start(0){
+			if(m_profiler)
+				m_start = GetWallTime();
+		}
+		~Scope(){
+			if(m_profiler)
+				m_profiler->Add(m_section,GetWallTime()-m_start);
+		}
+	private:
+		ArapProfiler* m_profiler; //!< Perfilador, o 0 si está deshabilitado
+		Section m_section; //!< Sección medida
+		uint64_t m_start; //!< Tiempo real de inicio en nanosegundos
+	};
+
+	ArapProfiler();
+	~ArapProfiler();
+
+	/**
+	 * Habilita el perfilado.
+	 *
+	 * @param[in] seriesInterval Intervalo (Tiempo simulado) de la serie de tiempo, cero para no generarla
+	 */
+	void Enable(const Time& seriesInterval);
+
+	/**
+	 * @return true si el perfilado está habilitado
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Inicia la medición del tiempo real de Simulator::Run(), y si corresponde abre el archivo
+	 * de la serie de tiempo y programa la primera muestra.
+	 *
+	 * @param[in] seriesFilename Nombre del archivo de la serie de tiempo
+	 */
+	void Start(const std::string& seriesFilename);
+
+	/**
+	 * Finaliza la medición del tiempo real de Simulator::Run() y cierra la serie de tiempo.
+	 */
+	void Stop();
+
+	/**
+	 * Escribe el resumen a un archivo, y las cifras principales a la salida estándar.
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[in] antsCreated Cantidad de hormigas creadas en la simulación
+	 */
+	void PrintSummary(const std::string& filename, uint64_t antsCreated) const;
+
+	/**
+	 * @param[in] section Sección
+	 *
+	 * @return Nombre de la sección
+	 */
+	static const char* GetSectionName(Section section);
+
+	/**
+	 * @param[in] section Sección
+	 *
+	 * @return true si la sección se ejecuta dentro de otra sección
+	 */
+	static bool IsNested(Section section);
+
+private:
+
+	/**
+	 * @return Tiempo real (Reloj monotónico) en nanosegundos
+	 */
+	static uint64_t GetWallTime(){
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return (uint64_t)ts.tv_sec*1000000000ULL+ts.tv_nsec;
+	}
+
+	/**
+	 * Acumula una llamada a una sección.
+	 *
+	 * @param[in] section Sección
+	 *
+	 * @param[in] nanoseconds Tiempo real de la llamada
+	 */
+	void Add(Section section, uint64_t nanoseconds){
+		m_calls[section]++;
+		m_nanoseconds[section] += nanoseconds;
+	}
+
+	/**
+	 * Escribe una fila de la serie de tiempo y programa la siguiente.
+	 */
+	void Sample();
+
+	bool m_enabled; //!< Perfilado habilitado
+	Time m_seriesInterval; //!< Intervalo de la serie de tiempo (Cero = sin serie)
+	uint64_t m_calls[SECTION_COUNT]; //!< Cantidad de llamadas de cada sección
+	uint64_t m_nanoseconds[SECTION_COUNT]; //!< Tiempo real acumulado de cada sección
+	uint64_t m_runStart; //!< Tiempo real de inicio de Simulator::Run()
+	uint64_t m_runNanoseconds; //!< Tiempo real total de Simulator::Run()
+	Time m_simulatedTime; //!< Tiempo simulado al finalizar Simulator::Run()
+	std::ofstream m_series; //!< Archivo de la serie de tiempo
+	EventId m_sampleEvent; //!< Evento de la próxima muestra de la serie
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_PROFILER_H */
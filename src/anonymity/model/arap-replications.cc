@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-replications.h"
+#include "arap-simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/rng-seed-manager.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapReplications");
+
+ArapReplications::ArapReplications(const std::string& filename, uint32_t replications, uint32_t workers)
+:m_filename(filename), m_replications(replications), m_workers(workers), m_baseRun(RngSeedManager::GetRun()), m_parentPid(getpid()){
+	NS_ABORT_MSG_IF(m_replications==0,"ERROR: La cantidad de replicas debe ser >=1");
+	if(m_workers==0)
+		m_workers=1;
+}
+
+ArapReplications::~ArapReplications(){
+	m_results.clear();
+}
+
+const std::vector<ArapReplicaResult>&
+ArapReplications::GetResults() const{
+	return m_results;
+}
+
+void
+ArapReplications::Run(){
+	m_results.clear();
+	m_results.resize(m_replications);
+	/* Aunque se use un solo proceso de trabajo, cada replica se ejecuta en un
+	 * proceso hijo para que parta del mismo estado que una ejecucion independiente
+	 * (El contador de flujos de RngSeedManager no se reinicia entre simulaciones)
+	 */
+	RunForked();
+	MergeLoadAntsModel();
+	MergeProbabilityTables();
+}
+
+void
+ArapReplications::RunReplica(uint32_t replica, ArapReplicaResult& result){
+	/* El numero de ejecucion se asigna antes de leer los parametros ya que las
+	 * distribuciones de probabilidad toman su flujo aleatorio al momento de crearse
+	 */
+	RngSeedManager::SetRun(m_baseRun+replica);
+	ArapSimulator::ConfigSimulator(m_filename,replica);
+	ArapSimulator::Run();
+	ArapSimulator::CollectReplicaResult(result);
+	ArapSimulator::Destroy();
+}
+
+void
+ArapReplications::RunForked(){
+	std::map<pid_t,uint32_t> running; //Procesos hijos en ejecucion y la replica que ejecuta cada uno
+	uint32_t next = 0;
+	while(next<m_replications || !running.empty()){
+		while(next<m_replications && running.size()<m_workers){
+			std::cout.flush(); //Para que el hijo no repita la salida pendiente del padre
+			pid_t pid = fork();
+			NS_ABORT_MSG_IF(pid<0,"ERROR: No se pudo crear el proceso para la replica "<<next);
+			if(pid==0){ //Proceso hijo
+				ArapReplicaResult result;
+				RunReplica(next,result);
+				bool written = WriteResult(GetResultFileName(next),result);
+				std::cout.flush();
+				_exit(written ? 0 : 1);
+			}
+			NS_LOG_UNCOND("Replica "<<next<<" de "<<m_replications<<" en el proceso "<<pid);
+			running[pid]=next++;
+		}
+
+		int status;
+		pid_t pid = waitpid(-1,&status,0);
+		if(pid<0)
+			NS_ABORT_MSG("ERROR: Fallo la espera de los procesos de las replicas");
+		std::map<pid_t,uint32_t>::iterator it = running.find(pid);
+		if(it==running.end())
+			continue;
+		uint32_t replica = it->second;
+		running.erase(it);
+		NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status)!=0,"ERROR: La replica "<<replica<<" finalizo con error");
+		std::string name = GetResultFileName(replica);
+		NS_ABORT_MSG_IF(!ReadResult(name,m_results[replica]),"ERROR: No se pudieron leer los resultados de la replica "<<replica);
+		std::remove(name.c_str());
+	}
+}
+
+std::string
+ArapReplications::GetResultFileName(uint32_t replica) const{
+	std::ostringstream oss;
+	oss<<"load-ants-model/.replica_"<<m_parentPid<<"_"<<replica<<".bin";
+	return oss.str();
+}
+
+bool
+ArapReplications::WriteResult(const std::string& filename, const ArapReplicaResult& result){
+	std::ofstream file(filename.c_str(),std::ios_base::out | std::ios_base::binary);
+	if(!file.is_open())
+		return false;
+	uint8_t explorerAnts = result.explorerAnts;
+	file.write((const char*)&result.seed,sizeof(uint64_t));
+	file.write((const char*)&result.run,sizeof(uint64_t));
+	file.write((const char*)&explorerAnts,sizeof(uint8_t));
+	file.write((const char*)&result.antsCreated,sizeof(uint64_t));
+	file.write((const char*)&result.totalSamples,sizeof(uint64_t));
+	file.write((const char*)&result.meanOfMeans,sizeof(double));
+	file.write((const char*)&result.varianceOfMeans,sizeof(double));
+
+	/* Cada tabla se escribe como: IP del nodo, cantidad de filas y por cada fila
+	 * IP destino, cantidad de columnas y los pares (IP intermedio, probabilidad)
+	 */
+	uint32_t nodes = result.tables.size();
+	file.write((const char*)&nodes,sizeof(uint32_t));
+	typedef std::map<Ipv4Address,std::map<Ipv4Address,double> > Table;
+	for(std::map<Ipv4Address,Table>::const_iterator it = result.tables.begin();it!=result.tables.end();it++){
+		uint32_t ip = it->first.Get();
+		uint32_t rows = it->second.size();
+		file.write((const char*)&ip,sizeof(uint32_t));
+		file.write((const char*)&rows,sizeof(uint32_t));
+		for(Table::const_iterator row = it->second.begin();row!=it->second.end();row++){
+			uint32_t target = row->first.Get();
+			uint32_t columns = row->second.size();
+			file.write((const char*)&target,sizeof(uint32_t));
+			file.write((const char*)&columns,sizeof(uint32_t));
+			for(std::map<Ipv4Address,double>::const_iterator col = row->second.begin();col!=row->second.end();col++){
+				uint32_t medium = col->first.Get();
+				file.write((const char*)&medium,sizeof(uint32_t));
+				file.write((const char*)&col->second,sizeof(double));
+			}
+		}
+	}
+	file.close();
+	return !file.fail();
+}
+
+bool
+ArapReplications::ReadResult(const std::string& filename, ArapReplicaResult& result){
+	std::ifstream file(filename.c_str(),std::ios_base::in | std::ios_base::binary);
+	if(!file.is_open())
+		return false;
+	uint8_t explorerAnts=0;
+	file.read((char*)&result.seed,sizeof(uint64_t));
+	file.read((char*)&result.run,sizeof(uint64_t));
+	file.read((char*)&explorerAnts,sizeof(uint8_t));
+	file.read((char*)&result.antsCreated,sizeof(uint64_t));
+	file.read((char*)&result.totalSamples,sizeof(uint64_t));
+	file.read((char*)&result.meanOfMeans,sizeof(double));
+	file.read((char*)&result.varianceOfMeans,sizeof(double));
+	result.explorerAnts = explorerAnts;
+
+	uint32_t nodes=0;
+	file.read((char*)&nodes,sizeof(uint32_t));
+	for(uint32_t n=0;n<nodes && file.good();n++){
+		uint32_t ip=0, rows=0;
+		file.read((char*)&ip,sizeof(uint32_t));
+		file.read((char*)&rows,sizeof(uint32_t));
+		std::map<Ipv4Address,std::map<Ipv4Address,double> >& table = result.tables[Ipv4Address(ip)];
+		for(uint32_t r=0;r<rows && file.good();r++){
+			uint32_t target=0, columns=0;
+			file.read((char*)&target,sizeof(uint32_t));
+			file.read((char*)&columns,sizeof(uint32_t));
+			std::map<Ipv4Address,double>& row = table[Ipv4Address(target)];
+			for(uint32_t c=0;c<columns && file.good();c++){
+				uint32_t medium=0;
+				double prob=0;
+				file.read((char*)&medium,sizeof(uint32_t));
+				file.read((char*)&prob,sizeof(double));
+				row[Ipv4Address(medium)]=prob;
+			}
+		}
+	}
+	return !file.fail();
+}
+
+std::string
+ArapReplications::GetMergedSuffix() const{
+	std::ostringstream oss;
+	oss<<m_results.front().seed<<"_"<<m_results.front().run<<"-"<<m_results.back().run;
+	return oss.str();
+}
+
+void
+ArapReplications::MergeLoadAntsModel() const{
+	std::ostringstream oss;
+	oss<<"load-ants-model/replicas_";
+	if(m_results.front().explorerAnts)
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<GetMergedSuffix()<<".csv";
+	std::string name = oss.str();
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Ejecucion,\"Hormigas creadas\",\"Total de hormigas enviadas\",\"Media de las medias de los tiempos\",\"Varianza de las medias de los tiempos\"\n";
+
+	double sum[4] = {0,0,0,0};
+	double sumSquare[4] = {0,0,0,0};
+	for(std::vector<ArapReplicaResult>::const_iterator it = m_results.begin();it!=m_results.end();it++){
+		file<<it->run<<","<<it->antsCreated<<","<<it->totalSamples<<","<<it->meanOfMeans<<","<<it->varianceOfMeans<<"\n";
+		double values[4] = {(double)it->antsCreated,(double)it->totalSamples,it->meanOfMeans,it->varianceOfMeans};
+		for(uint32_t i=0;i<4;i++){
+			sum[i] = sum[i]+values[i];
+			sumSquare[i] = sumSquare[i]+values[i]*values[i];
+		}
+	}
+
+	//Imprimir al final la media y la desviacion estandar de cada columna entre las replicas
+	uint32_t n = m_results.size();
+	file<<"\"Media entre replicas\"";
+	for(uint32_t i=0;i<4;i++)
+		file<<","<<sum[i]/n;
+	file<<"\n";
+	file<<"\"Desviacion estandar entre replicas\"";
+	for(uint32_t i=0;i<4;i++){
+		double mean = sum[i]/n;
+		double variance = (n>1) ? (sumSquare[i]-n*mean*mean)/(n-1) : 0;
+		file<<","<<std::sqrt(std::max(variance,0.0));
+	}
+	file<<"\n";
+	file.close();
+}
+
+void
+ArapReplications::MergeProbabilityTables() const{
+	typedef std::map<Ipv4Address,std::map<Ipv4Address,double> > Table;
+	const std::map<Ipv4Address,Table>& firstTables = m_results.front().tables;
+	uint32_t n = m_results.size();
+	for(std::map<Ipv4Address,Table>::const_iterator node = firstTables.begin();node!=firstTables.end();node++){
+		/* Se suman las tablas del nodo en todas las replicas y luego se divide entre
+		 * la cantidad de replicas para obtener el promedio de cada posicion
+		 */
+		Table average;
+		for(std::vector<ArapReplicaResult>::const_iterator it = m_results.begin();it!=m_results.end();it++){
+			std::map<Ipv4Address,Table>::const_iterator table = it->tables.find(node->first);
+			if(table==it->tables.end())
+				continue;
+			for(Table::const_iterator row = table->second.begin();row!=table->second.end();row++){
+				std::map<Ipv4Address,double>& averageRow = average[row->first];
+				for(std::map<Ipv4Address,double>::const_iterator col = row->second.begin();col!=row->second.end();col++)
+					averageRow[col->first] += col->second/n;
+			}
+		}
+
+		std::ostringstream oss;
+		oss<<"tablas/"<<node->first<<"_promedio_"<<GetMergedSuffix()<<".csv";
+		std::string name = oss.str();
+		std::ofstream file (name.c_str());
+		if (!file.is_open()){
+			NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+			continue;
+		}
+		//Mismo formato que ArapPathManager::PrintProbTable()
+		file<<" ";
+		for (Table::iterator it = average.begin();it!=average.end(); it++)
+			file<<","<<it->first;
+		file<<",Suma";
+		file<<std::endl;
+		//Las filas solo tienen las probabilidades distintas de cero, las columnas son todos los destinos
+		for (Table::iterator it = average.begin();it!=average.end(); it++) {
+			file<<it->first;
+			double sumProb = 0;
+			for (Table::iterator column = average.begin();column!=average.end(); column++) {
+				std::map<Ipv4Address,double>::const_iterator it2 = it->second.find(column->first);
+				double prob = (it2!=it->second.end()) ? it2->second : 0;
+				file<<","<<std::fixed<<prob;
+				sumProb = sumProb +prob;
+			}
+			file<<","<<sumProb;
+			file<<std::endl;
+		}
+		file.close();
+	}
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_REPLICATIONS_H
+#define ARAP_REPLICATIONS_H
+
+#include "ns3/ipv4-address.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <sys/types.h>
+
+namespace ns3 {
+
+/**
+ * Resultados finales de una réplica (Una ejecución completa de la simulación),
+ * usados por ArapReplications para combinar las salidas de varias réplicas.
+ */
+struct ArapReplicaResult {
+	uint64_t seed; //!< Semilla usada en la réplica
+	uint64_t run; //!< Número de ejecución usado en la réplica
+	bool explorerAnts; //!< Indica si las hormigas exploradoras estaban habilitadas
+	uint64_t antsCreated; //!< Cantidad de hormigas creadas
+	uint64_t totalSamples; //!< Total de hormigas de carga que volvieron al nido
+	double meanOfMeans; //!< Media de las medias de los tiempos de las hormigas de carga
+	double varianceOfMeans; //!< Varianza de las medias de los tiempos de las hormigas de carga
+	std::map<Ipv4Address,std::map<Ipv4Address,std::map<Ipv4Address,double> > > tables; //!< Tabla de probabilidad final de cada nodo (Nodo, Destino, Intermedio), solo los valores distintos de cero
+
+	ArapReplicaResult():seed(0),run(0),explorerAnts(false),antsCreated(0),totalSamples(0),meanOfMeans(0),varianceOfMeans(0){};
+};
+
+/**
+ * Ejecuta varias réplicas (Mismo archivo de parámetros, distinto número de ejecución)
+ * de la simulación dentro de un mismo proceso y combina sus salidas de "load-ants-model" y "tablas".
+ *
+ * El simulador de NS3 y el RngSeedManager son únicos por proceso, por lo que no es posible
+ * ejecutar réplicas simultaneas en hilos. Cada réplica se ejecuta en un proceso hijo creado con
+ * fork() a partir del proceso ya inicializado (Sin volver a pagar el costo de carga de NS3), con
+ * como máximo "workers" hijos a la vez, y el proceso padre recoge los resultados de cada hijo.
+ * Así cada réplica obtiene los mismos valores que una ejecución independiente con el mismo número de ejecución.
+ *
+ * Las salidas combinadas tienen los nombres:\n
+ * "load-ants-model/replicas_<exploradoras>_<Semilla>_<Run inicial>-<Run final>.csv"\n
+ * "tablas/<IP_LOCAL>_promedio_<Semilla>_<Run inicial>-<Run final>.csv"
+ */
+class ArapReplications {
+
+public:
+
+	/**
+	 * Constructor paramétrico.
+	 *
+	 * @param[in] filename Nombre del archivo de parámetros usado por todas las réplicas
+	 *
+	 * @param[in] replications Cantidad de réplicas a ejecutar (>=1)
+	 *
+	 * @param[in] workers Cantidad máxima de réplicas a ejecutar en paralelo (Normalmente, una por núcleo)
+	 */
+	ArapReplications(const std::string& filename, uint32_t replications, uint32_t workers);
+	~ArapReplications();
+
+	/**
+	 * Ejecuta todas las réplicas y escribe las salidas combinadas.
+	 */
+	void Run();
+
+	/**
+	 * @return Resultados de las réplicas ejecutadas, en orden de número de réplica.
+	 */
+	const std::vector<ArapReplicaResult>& GetResults() const;
+
+	/**
+	 * Guarda los resultados de una réplica en un archivo binario (También usado por ArapSweep).
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[in] result Resultados a guardar
+	 *
+	 * @return true si se pudo escribir el archivo
+	 */
+	static bool WriteResult(const std::string& filename, const ArapReplicaResult& result);
+
+	/**
+	 * Lee los resultados de una réplica desde un archivo binario creado por WriteResult().
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[out] result Resultados leidos
+	 *
+	 * @return true si se pudo leer el archivo
+	 */
+	static bool ReadResult(const std::string& filename, ArapReplicaResult& result);
+
+private:
+
+	/**
+	 * Ejecuta una réplica completa en el proceso actual (Proceso hijo).
+	 *
+	 * @param[in] replica Número de réplica a ejecutar
+	 *
+	 * @param[out] result Resultados de la réplica ejecutada
+	 */
+	void RunReplica(uint32_t replica, ArapReplicaResult& result);
+
+	/**
+	 * Ejecuta las réplicas en procesos hijos, manteniendo como máximo m_workers procesos a la vez.
+	 */
+	void RunForked();
+
+	/**
+	 * @param[in] replica Número de réplica
+	 *
+	 * @return Nombre del archivo temporal donde un proceso hijo guarda los resultados de su réplica.
+	 */
+	std::string GetResultFileName(uint32_t replica) const;
+
+	/**
+	 * Escribe el resumen de las estadísticas de las hormigas de carga de todas las réplicas.
+	 */
+	void MergeLoadAntsModel() const;
+
+	/**
+	 * Escribe para cada nodo la tabla de probabilidad promedio de todas las réplicas.
+	 */
+	void MergeProbabilityTables() const;
+
+	/**
+	 * @return Sufijo común de los archivos combinados: "<Semilla>_<Run inicial>-<Run final>"
+	 */
+	std::string GetMergedSuffix() const;
+
+	std::string m_filename; //!< Archivo de parámetros de las réplicas
+	uint32_t m_replications; //!< Cantidad de réplicas
+	uint32_t m_workers; //!< Cantidad máxima de réplicas ejecutandose en paralelo
+	uint64_t m_baseRun; //!< Número de ejecución de la primera réplica
+	pid_t m_parentPid; //!< Proceso que ejecuta las réplicas, usado para nombrar los archivos temporales
+	std::vector<ArapReplicaResult> m_results; //!< Resultados de cada réplica
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_REPLICATIONS_H */
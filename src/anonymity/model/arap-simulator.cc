@@ -7,8 +7,11 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/point-to-point-layout-module.h"
+#include "ns3/point-to-point-remote-channel.h"
+#include "arap-delay-channel.h"
 #include <cmath>
 #include <exception>
+#include <algorithm>
 
 #define HUB_DATA_RATE 524288000 //500 Mbps
 namespace ns3 {
@@ -19,29 +22,39 @@ NS_LOG_COMPONENT_DEFINE ("ArapSimulator");
 
 /*Definicion de las variables static*/
 std::map<std::string, int> ArapSimulator::s_mapStringValues;
-PointToPointStarHelper* ArapSimulator::m_star =NULL;
-uint32_t ArapSimulator::m_numNodes = 0;
-uint32_t ArapSimulator::m_numHops = 0;
-uint32_t ArapSimulator::m_antSize = 0;
-uint16_t ArapSimulator::m_port = DEFAULT_PORT;
-Time ArapSimulator::m_linkDelayInterval;
-Time ArapSimulator::m_explorerAntsInterval;
-Time ArapSimulator::m_printTablesInterval;
-Ptr<RandomVariableStream> ArapSimulator::m_linkDelayChange=NULL;
-std::list<OperationDelayFormat> ArapSimulator::m_computingDelayList;
-std::list<DataRateFormat> ArapSimulator::m_dataRateList;
-std::list<RandomStreamFormat> ArapSimulator::m_computingDistList;
-std::list<RandomStreamFormat> ArapSimulator::m_loadAntsTimeList;
-std::list<RandomStreamFormat> ArapSimulator::m_loadAntsQuantityList;
-std::list<RandomStreamFormat> ArapSimulator::m_loadAntsTargetList;
-std::list<AppTimeFormat> ArapSimulator::m_startTimeList;
-uint64_t ArapSimulator::m_maximumSegmentSize=0;
-uint64_t ArapSimulator::m_queueSize=0;
-double ArapSimulator::m_stopTime=0;
-bool ArapSimulator::m_enableTraces=DEFAULT_ENABLE_TRACING;
-bool ArapSimulator::m_enableExplorerAnts=false;
-PathManagerFactory ArapSimulator::m_pathManagerFactory;
-ArapPathManager* ArapSimulator::m_arapPathManager = NULL;
+ArapSimulator* ArapSimulator::s_current = NULL;
+
+ArapSimulator::ArapSimulator()
+: m_topology(NULL), m_numHops(0), m_port(DEFAULT_PORT), m_numNodes(0), m_antSize(0), m_linkDelayChange(NULL),
+  m_stopTime(0), m_enableTraces(DEFAULT_ENABLE_TRACING), m_enableExplorerAnts(false), m_maximumSegmentSize(0),
+  m_queueSize(0), m_explorerScheduler(new FloodExplorerScheduler()), m_arapPathManager(NULL), m_antID(0), m_replica(0),
+  m_pathsFormat(ArapPathLogger::FORMAT_CSV), m_routingRttMultiple(DEFAULT_ROUTING_TABLE_RTT_MULTIPLE),
+  m_sendBufferSize(DEFAULT_SEND_BUFFER_SIZE), m_maxConnections(DEFAULT_MAX_CONNECTIONS),
+  m_maxPendingAnts(DEFAULT_MAX_PENDING_ANTS), m_connectionIdleTimeout(0),
+  m_transport(TRANSPORT_TCP), m_distributed(false), m_distributedAlgorithm(ArapDistributed::ALGORITHM_GRANTED_WINDOW),
+  m_lookahead(0), m_saveStateTime(0), m_loadStateStatistics(true),
+  m_engine(ENGINE_PACKET), m_computingWorkers(0), m_computingDiscipline(ArapComputingServer::DISCIPLINE_FIFO),
+  m_linkDelayModel(LINK_DELAY_SWEEP), m_anonymityMetrics(false), m_workloadMode(ArapWorkload::MODE_NONE){
+}
+
+ArapSimulator::~ArapSimulator(){
+	delete m_arapPathManager;
+	delete m_topology;
+	delete m_explorerScheduler;
+	m_computingDelayList.clear();
+	m_computingDistList.clear();
+	m_dataRateList.clear();
+	m_startTimeList.clear();
+	m_loadAntsTimeList.clear();
+	m_loadAntsQuantityList.clear();
+	m_loadAntsTargetList.clear();
+}
+
+ArapSimulator&
+ArapSimulator::Current(){
+	NS_ABORT_MSG_IF(s_current==NULL,"ERROR: No hay una simulacion configurada, debe llamar primero a ArapSimulator::ConfigSimulator()");
+	return *s_current;
+}
 
 void
 ArapSimulator::InitializeValuesMap(){
@@ -68,6 +81,23 @@ ArapSimulator::InitializeValuesMap(){
 	s_mapStringValues[PARAM_LOAD_ANT_QUANTITY_DIST] = PARAM_LOAD_ANT_QUANTITY_DIST_V;
 	s_mapStringValues[PARAM_LOAD_ANT_TARGET_DIST] = PARAM_LOAD_ANT_TARGET_DIST_V;
 	s_mapStringValues[PARAM_PRINT_PROB_TABLES_INTERVAL] = PARAM_PRINT_PROB_TABLES_INTERVAL_V;
+	s_mapStringValues[PARAM_PATHS_FORMAT] = PARAM_PATHS_FORMAT_V;
+	s_mapStringValues[PARAM_ROUTING_RTT_MULTIPLE] = PARAM_ROUTING_RTT_MULTIPLE_V;
+	s_mapStringValues[PARAM_SEND_BUFFER_SIZE] = PARAM_SEND_BUFFER_SIZE_V;
+	s_mapStringValues[PARAM_MAX_CONNECTIONS] = PARAM_MAX_CONNECTIONS_V;
+	s_mapStringValues[PARAM_TRANSPORT] = PARAM_TRANSPORT_V;
+	s_mapStringValues[PARAM_PROFILING] = PARAM_PROFILING_V;
+	s_mapStringValues[PARAM_TOPOLOGY] = PARAM_TOPOLOGY_V;
+	s_mapStringValues[PARAM_DISTRIBUTED] = PARAM_DISTRIBUTED_V;
+	s_mapStringValues[PARAM_EXPLORER_SCHEDULER] = PARAM_EXPLORER_SCHEDULER_V;
+	s_mapStringValues[PARAM_SAVE_STATE] = PARAM_SAVE_STATE_V;
+	s_mapStringValues[PARAM_LOAD_STATE] = PARAM_LOAD_STATE_V;
+	s_mapStringValues[PARAM_CONVERGENCE] = PARAM_CONVERGENCE_V;
+	s_mapStringValues[PARAM_ENGINE] = PARAM_ENGINE_V;
+	s_mapStringValues[PARAM_COMPUTING_SERVER] = PARAM_COMPUTING_SERVER_V;
+	s_mapStringValues[PARAM_LINK_DELAY_MODEL] = PARAM_LINK_DELAY_MODEL_V;
+	s_mapStringValues[PARAM_ANONYMITY_METRICS] = PARAM_ANONYMITY_METRICS_V;
+	s_mapStringValues[PARAM_WORKLOAD] = PARAM_WORKLOAD_V;
 }
 
 Ptr<RandomVariableStream>
@@ -264,7 +294,10 @@ ArapSimulator::HandleParameter(const std::string& paramName, std::istringstream&
 			iss>>runNumber;
 			if(runNumber<0)
 				NS_ABORT_MSG("ERROR: Valor de ejecucion no valido");
-			RngSeedManager::SetRun(runNumber);
+			/* En el caso de réplicas, cada una usa un número de ejecución distinto
+			 * a partir del valor leido (Ver ArapReplications)
+			 */
+			RngSeedManager::SetRun(runNumber+m_replica);
 			break;
 		}
 		case PARAM_ENABLE_TRACING_V:{
@@ -332,6 +365,205 @@ ArapSimulator::HandleParameter(const std::string& paramName, std::istringstream&
 			m_loadAntsTargetList.push_back(RandomStreamFormat(loadAntTargetStream,targetMin,targetMax));
 			break;
 		}
+		case PARAM_PATHS_FORMAT_V:{
+			std::string format;
+			iss>>format;
+			if(format=="csv")
+				m_pathsFormat = ArapPathLogger::FORMAT_CSV;
+			else if(format=="binario")
+				m_pathsFormat = ArapPathLogger::FORMAT_BINARY;
+			else if(format=="ninguno")
+				m_pathsFormat = ArapPathLogger::FORMAT_NONE;
+			else
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_PATHS_FORMAT<<" no valido, debe ser \"csv\", \"binario\" o \"ninguno\"");
+			break;
+		}
+		case PARAM_ROUTING_RTT_MULTIPLE_V:{
+			double multiple=-1;
+			iss>>multiple;
+			if(multiple<0)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_ROUTING_RTT_MULTIPLE<<" no valido, debe ser >=0");
+			m_routingRttMultiple = multiple;
+			break;
+		}
+		case PARAM_SEND_BUFFER_SIZE_V:{
+			long int sendBufferSize=-1;
+			iss>>sendBufferSize;
+			if(sendBufferSize<=0)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_SEND_BUFFER_SIZE<<" no valido, debe ser >0");
+			m_sendBufferSize = (uint32_t)sendBufferSize;
+			break;
+		}
+		case PARAM_MAX_CONNECTIONS_V:{
+			long int maxConnections=-1;
+			iss>>maxConnections;
+			if(maxConnections<0)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_MAX_CONNECTIONS<<" no valido, debe ser >=0");
+			m_maxConnections = (uint32_t)maxConnections;
+			long int maxPending=-1;
+			if(iss>>maxPending){
+				if(maxPending<0)
+					NS_ABORT_MSG("ERROR: Cantidad de hormigas en espera de "<<PARAM_MAX_CONNECTIONS<<" no valida, debe ser >=0");
+				m_maxPendingAnts = (uint32_t)maxPending;
+				double idleTimeout=-1;
+				if(iss>>idleTimeout){
+					if(idleTimeout<0)
+						NS_ABORT_MSG("ERROR: Tiempo de inactividad de "<<PARAM_MAX_CONNECTIONS<<" no valido, debe ser >=0");
+					m_connectionIdleTimeout = Seconds(idleTimeout);
+				}
+			}
+			break;
+		}
+		case PARAM_TRANSPORT_V:{
+			std::string transport;
+			iss>>transport;
+			if(transport=="tcp")
+				m_transport = TRANSPORT_TCP;
+			else if(transport=="udp")
+				m_transport = TRANSPORT_UDP;
+			else
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_TRANSPORT<<" no valido, debe ser \"tcp\" o \"udp\"");
+			break;
+		}
+		case PARAM_PROFILING_V:{
+			bool enableProfiling;
+			double interval=0;
+			iss>>enableProfiling;
+			if(iss.fail())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_PROFILING<<" no valido");
+			if(!(iss>>interval))
+				interval = 0;
+			if(interval<0)
+				NS_ABORT_MSG("ERROR: El intervalo de "<<PARAM_PROFILING<<" debe ser >=0");
+			if(enableProfiling)
+				m_profiler.Enable(Seconds(interval));
+			break;
+		}
+		case PARAM_TOPOLOGY_V:{
+			std::string caseName;
+			iss>>caseName;
+			delete m_topology;
+			m_topology = m_topologyFactory.GetInstance(caseName,iss);
+			if (m_topology==NULL)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_TOPOLOGY<<" no valido");
+			break;
+		}
+		case PARAM_EXPLORER_SCHEDULER_V:{
+			std::string caseName;
+			iss>>caseName;
+			delete m_explorerScheduler;
+			m_explorerScheduler = m_explorerSchedulerFactory.GetInstance(caseName,iss);
+			if (m_explorerScheduler==NULL)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_EXPLORER_SCHEDULER<<" no valido");
+			break;
+		}
+		case PARAM_DISTRIBUTED_V:{
+			std::string algorithm;
+			iss>>m_distributed;
+			if(iss.fail())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_DISTRIBUTED<<" no valido");
+			if(!(iss>>algorithm) || algorithm=="ventana")
+				m_distributedAlgorithm = ArapDistributed::ALGORITHM_GRANTED_WINDOW;
+			else if(algorithm=="mensajes-nulos")
+				m_distributedAlgorithm = ArapDistributed::ALGORITHM_NULL_MESSAGE;
+			else
+				NS_ABORT_MSG("ERROR: Algoritmo de "<<PARAM_DISTRIBUTED<<" no valido, debe ser \"ventana\" o \"mensajes-nulos\"");
+			break;
+		}
+		case PARAM_SAVE_STATE_V:{
+			double time;
+			iss>>time>>m_saveStateFilename;
+			if(iss.fail() || time<0 || m_saveStateFilename.empty())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_SAVE_STATE<<" no valido");
+			m_saveStateTime = Seconds(time);
+			break;
+		}
+		case PARAM_LOAD_STATE_V:{
+			iss>>m_loadStateFilename;
+			if(iss.fail() || m_loadStateFilename.empty())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_LOAD_STATE<<" no valido");
+			if(!(iss>>m_loadStateStatistics))
+				m_loadStateStatistics = true;
+			break;
+		}
+		case PARAM_CONVERGENCE_V:{
+			double interval, tableThreshold, rttThreshold;
+			uint32_t windows;
+			std::string action;
+			iss>>interval>>tableThreshold>>rttThreshold>>windows;
+			if(iss.fail() || interval<=0 || tableThreshold<0 || rttThreshold<0 || windows==0)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_CONVERGENCE<<" no valido");
+			ArapConvergenceMonitor::Action convergenceAction = ArapConvergenceMonitor::ACTION_STOP;
+			if((iss>>action) && action=="medir")
+				convergenceAction = ArapConvergenceMonitor::ACTION_MEASURE;
+			else if(!action.empty() && action!="detener")
+				NS_ABORT_MSG("ERROR: Accion de "<<PARAM_CONVERGENCE<<" no valida, debe ser \"detener\" o \"medir\"");
+			m_convergenceMonitor.Enable(Seconds(interval),tableThreshold,rttThreshold,windows,convergenceAction);
+			break;
+		}
+		case PARAM_ENGINE_V:{
+			std::string engine;
+			iss>>engine;
+			if(engine=="paquetes")
+				m_engine = ENGINE_PACKET;
+			else if(engine=="abstracto")
+				m_engine = ENGINE_ABSTRACT;
+			else
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_ENGINE<<" no valido, debe ser \"paquetes\" o \"abstracto\"");
+			break;
+		}
+		case PARAM_COMPUTING_SERVER_V:{
+			int workers = -1;
+			std::string discipline;
+			iss>>workers;
+			if(iss.fail() || workers<0)
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_COMPUTING_SERVER<<" no valido");
+			m_computingWorkers = workers;
+			m_computingDiscipline = ArapComputingServer::DISCIPLINE_FIFO;
+			if((iss>>discipline) && discipline=="prioridad")
+				m_computingDiscipline = ArapComputingServer::DISCIPLINE_PRIORITY;
+			else if(!discipline.empty() && discipline!="fifo")
+				NS_ABORT_MSG("ERROR: Disciplina de "<<PARAM_COMPUTING_SERVER<<" no valida, debe ser \"fifo\" o \"prioridad\"");
+			break;
+		}
+		case PARAM_LINK_DELAY_MODEL_V:{
+			std::string model;
+			iss>>model;
+			if(model=="barrido")
+				m_linkDelayModel = LINK_DELAY_SWEEP;
+			else if(model=="canal")
+				m_linkDelayModel = LINK_DELAY_CHANNEL;
+			else if(model=="traza"){
+				m_linkDelayModel = LINK_DELAY_TRACE;
+				iss>>m_linkDelayTraceFilename;
+				if(iss.fail())
+					NS_ABORT_MSG("ERROR: Debe indicar el archivo de trazas de "<<PARAM_LINK_DELAY_MODEL);
+			}
+			else
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_LINK_DELAY_MODEL<<" no valido, debe ser \"barrido\", \"canal\" o \"traza\"");
+			break;
+		}
+		case PARAM_ANONYMITY_METRICS_V:{
+			bool anonymityMetrics;
+			iss>>anonymityMetrics;
+			if(iss.fail())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_ANONYMITY_METRICS<<" no valido, debe ser 0 o 1");
+			m_anonymityMetrics = anonymityMetrics;
+			break;
+		}
+		case PARAM_WORKLOAD_V:{
+			std::string mode;
+			iss>>mode>>m_workloadFilename;
+			if(iss.fail() || m_workloadFilename.empty())
+				NS_ABORT_MSG("ERROR: Valor de "<<PARAM_WORKLOAD<<" no valido");
+			if(mode=="grabar")
+				m_workloadMode = ArapWorkload::MODE_RECORD;
+			else if(mode=="reproducir")
+				m_workloadMode = ArapWorkload::MODE_REPLAY;
+			else
+				NS_ABORT_MSG("ERROR: Modo de "<<PARAM_WORKLOAD<<" no valido, debe ser \"grabar\" o \"reproducir\"");
+			break;
+		}
 		default:{
 			NS_ABORT_MSG("ERROR: Error en el formato del archivo, nombre de parametro desconocido");
 		}
@@ -377,32 +609,60 @@ ArapSimulator::ConfigNetwork(){
 	if(m_numNodes==0)
 		NS_ABORT_MSG("ERROR: Debe indicar un valor para el número de nodos");
 
-	m_star = new PointToPointStarHelper(m_numNodes, pointToPoint);
-  InternetStackHelper internet;
-  m_star->InstallStack(internet);
-  m_star->AssignIpv4Addresses (Ipv4AddressHelper (NETWORK_BASE_IP, NETWORK_SUBNET_MASK));
+	if(m_topology==NULL) //Si no se leyo este parametro se usa la estrella
+		m_topology = new ArapStarTopology();
+	if(m_linkDelayModel!=LINK_DELAY_SWEEP) //Cada canal evalua su delay al transmitir
+		pointToPoint.SetChannelType("ArapDelayChannel");
+	m_topology->Build(m_numNodes, pointToPoint, Ipv4AddressHelper (NETWORK_BASE_IP, NETWORK_SUBNET_MASK));
+	if(m_linkDelayModel!=LINK_DELAY_SWEEP){
+		const std::vector<Ptr<PointToPointChannel> >& channels = m_topology->GetChannels();
+		std::vector<Ptr<ArapDelayProcess> > processes = CreateDelayProcesses(channels.size());
+		for(uint32_t i=0;i<channels.size();i++)
+			DynamicCast<ArapDelayChannel>(channels[i])->SetDelayProcess(processes[i]);
+	}
+	m_directory.Build(*m_topology);
+	NS_LOG_INFO("Topologia de red: "<<m_topology->GetName());
 
-  /* Asignar un DataRate bastante grande a los dispositivos de nodo HUB, para
-   * que no genere cuellos de botella extra e innecesarios.
+  /* Asignar un DataRate bastante grande a los dispositivos de los enrutadores, para
+   * que no generen cuellos de botella extra e innecesarios.
    */
-  uint32_t hubDevCount = m_star->GetHub()->GetNDevices();
-  for(uint32_t i=0;i<hubDevCount-1;i++){
-  	Ptr<PointToPointNetDevice> p2pdev = DynamicCast<PointToPointNetDevice>(m_star->GetHub()->GetDevice(i));
+  const std::vector<Ptr<PointToPointNetDevice> >& routerDevices = m_topology->GetRouterDevices();
+  for(uint32_t i=0;i<routerDevices.size();i++){
   	DataRateValue dataRateSet(DataRate(HUB_DATA_RATE));
-  	p2pdev->SetAttribute("DataRate",dataRateSet);
+  	routerDevices[i]->SetAttribute("DataRate",dataRateSet);
   }
 
-  //Se activa el routeo global para poder usar el nodo central como router
+  //Se activa el routeo global para poder usar los enrutadores
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
   /*Habilitar tracing */
   if(m_enableTraces){
+  	//Para que las capas de las hormigas (ArapAntHeader) se muestren decodificadas en las trazas
+  	Packet::EnablePrinting();
   	AsciiTraceHelper ascii;
   	pointToPoint.EnableAsciiAll (ascii.CreateFileStream ("arap-trace.tr"));
   	pointToPoint.EnablePcapAll("arap-trace",false);
   }
 }
 
+void
+ArapSimulator::ConfigAbstractNetwork(){
+	if(m_numNodes==0)
+		NS_ABORT_MSG("ERROR: Debe indicar un valor para el número de nodos");
+	NS_ABORT_MSG_IF(m_topology!=NULL,"ERROR: El motor abstracto ("<<PARAM_ENGINE<<") no se puede usar con "<<PARAM_TOPOLOGY<<", su red es una estrella");
+
+	/* Los nodos no tienen dispositivos ni pila TCP/IP, solo la aplicacion. Las IP se
+	 * asignan en orden a partir de la red base, sin subredes por enlace
+	 */
+	NodeContainer nodes;
+	nodes.Create(m_numNodes);
+	m_directory.Build(nodes,Ipv4Address(NETWORK_BASE_IP));
+	m_abstractNetwork.Build(m_numNodes,HUB_DATA_RATE);
+	if(m_linkDelayModel!=LINK_DELAY_SWEEP)
+		m_abstractNetwork.SetDelayProcesses(CreateDelayProcesses(m_numNodes));
+	NS_LOG_INFO("Motor abstracto: red estrella de "<<m_numNodes<<" nodos");
+}
+
 void
 ArapSimulator::ReadParametersFile(const std::string& filename){
 	std::string line, paramName;
@@ -426,40 +686,201 @@ ArapSimulator::ReadParametersFile(const std::string& filename){
 }
 
 void
-ArapSimulator::ConfigSimulator(const std::string& filename){
+ArapSimulator::ConfigSimulator(const std::string& filename, uint32_t replica){
+	NS_ABORT_MSG_IF(s_current!=NULL,"ERROR: Ya existe una simulacion configurada, debe llamar a ArapSimulator::Destroy() antes de configurar otra");
 	InitializeValuesMap(); //Para que se asigne un valor numerico  a cada nombre de parametro
-	ReadParametersFile(filename);
+	s_current = new ArapSimulator();
+	s_current->m_replica = replica;
+	s_current->ReadParametersFile(filename);
+
+	/* La simulacion distribuida se habilita antes de crear la red, ya que el rango de
+	 * cada nodo y los canales remotos se definen al crear la topologia
+	 */
+	if(s_current->m_distributed){
+		NS_ABORT_MSG_IF(s_current->m_engine==ENGINE_ABSTRACT,"ERROR: El motor abstracto ("<<PARAM_ENGINE<<") no se puede usar con "<<PARAM_DISTRIBUTED);
+		//Los canales remotos no tienen proceso de delay y el lookahead requiere un delay minimo conocido
+		NS_ABORT_MSG_IF(s_current->m_linkDelayModel!=LINK_DELAY_SWEEP,"ERROR: "<<PARAM_LINK_DELAY_MODEL<<" solo puede ser \"barrido\" con "<<PARAM_DISTRIBUTED);
+		//Cada rango tiene solo sus nodos, la traza requiere un unico archivo ordenado por tiempo
+		NS_ABORT_MSG_IF(s_current->m_workloadMode!=ArapWorkload::MODE_NONE,"ERROR: "<<PARAM_WORKLOAD<<" no se puede usar con "<<PARAM_DISTRIBUTED);
+		NS_ABORT_MSG_IF(replica>0 || ArapDistributed::IsEnabled(),"ERROR: La simulacion distribuida ("<<PARAM_DISTRIBUTED<<") no se puede usar con replicas");
+		/* Los chequeos de convergencia combinan las medidas de todos los rangos dentro de un evento, lo
+		 * que con mensajes nulos puede bloquear a un rango que espera mensajes de otro
+		 */
+		NS_ABORT_MSG_IF(s_current->m_convergenceMonitor.IsEnabled() && s_current->m_distributedAlgorithm==ArapDistributed::ALGORITHM_NULL_MESSAGE,
+				"ERROR: "<<PARAM_CONVERGENCE<<" no se puede usar con el algoritmo de mensajes nulos de "<<PARAM_DISTRIBUTED);
+		ArapDistributed::Enable(s_current->m_distributedAlgorithm);
+	}
 
   /* Hasta este punto ya se han leido todos los parametros, los cuales ahora se usarán
    * para configurar la red y los nodos. En caso de no haber realizado una configuración
    * completa en el archivo, se detectará el error al momento de tratar de asignar
    * un parámetro faltante
    */
-  ConfigNetwork();
-  ConfigNodes();
+	if(s_current->m_engine==ENGINE_ABSTRACT)
+		s_current->ConfigAbstractNetwork();
+	else
+		s_current->ConfigNetwork();
+	s_current->ConfigNodes();
+	if(!s_current->m_loadStateFilename.empty())
+		s_current->LoadState();
+	s_current->OpenPathLogger();
+	s_current->OpenWorkload();
 }
 
-const PointToPointStarHelper&
-ArapSimulator::GetStar(){
-	return *m_star;
+void
+ArapSimulator::OpenPathLogger(){
+	if(m_pathsFormat==ArapPathLogger::FORMAT_NONE) //Sin registro de caminos, Log() no hace nada con el registro cerrado
+		return;
+	std::ostringstream oss;
+	oss<<"load-ants-paths/"; //Carpeta donde se crearan los archivos de salida (dentro del Working Directory)
+	oss<<"paths_";
+	if(m_enableExplorerAnts)
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun();
+	if(m_pathsFormat==ArapPathLogger::FORMAT_CSV)
+		oss<<".csv";
+	else
+		oss<<".bin";
+	m_pathsFilename = oss.str();
+	m_pathLogger.Open(ArapDistributed::GetRankFilename(m_pathsFilename),m_pathsFormat);
+}
+
+/**
+ * Identificador y versión del formato de los archivos de estado (Ver ArapSimulator::SaveState())
+ */
+static const char STATE_FILE_MAGIC[8] = {'A','R','A','P','E','S','T','1'};
+
+void
+ArapSimulator::SaveState(){
+	std::string name = ArapDistributed::GetRankFilename(m_saveStateFilename);
+	std::ofstream file(name.c_str(),std::ios_base::out | std::ios_base::binary);
+	if (!file.is_open()){
+		NS_LOG_UNCOND("No se pudo crear el archivo de estado: "<<name);
+		return;
+	}
+	uint32_t localNodes = 0;
+	for(uint32_t i=0;i<m_directory.GetCount();i++){
+		if(GetLocalApp(i)!=0)
+			localNodes++;
+	}
+	double time = Simulator::Now().GetSeconds();
+	file.write(STATE_FILE_MAGIC,sizeof(STATE_FILE_MAGIC));
+	file.write((const char*)&m_numNodes,sizeof(uint32_t));
+	file.write((const char*)&localNodes,sizeof(uint32_t));
+	file.write((const char*)&time,sizeof(double));
+	for(uint32_t i=0;i<m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		uint32_t ip = nodeApp->GetLocalIP().Get();
+		file.write((const char*)&ip,sizeof(uint32_t));
+		nodeApp->SaveState(file);
+	}
+	file.close();
+	if(file.fail())
+		NS_LOG_UNCOND("Fallo la escritura del archivo de estado: "<<name);
+	else
+		NS_LOG_UNCOND("Estado de "<<localNodes<<" nodos guardado en "<<name<<" (t="<<time<<"s)");
+}
+
+void
+ArapSimulator::LoadState(){
+	std::string name = ArapDistributed::GetRankFilename(m_loadStateFilename);
+	std::ifstream file(name.c_str(),std::ios_base::in | std::ios_base::binary);
+	NS_ABORT_MSG_IF(!file.is_open(),"ERROR: No se pudo leer el archivo de estado "<<name);
+	char magic[sizeof(STATE_FILE_MAGIC)];
+	uint32_t numNodes = 0, savedNodes = 0;
+	double time = 0;
+	file.read(magic,sizeof(magic));
+	file.read((char*)&numNodes,sizeof(uint32_t));
+	file.read((char*)&savedNodes,sizeof(uint32_t));
+	file.read((char*)&time,sizeof(double));
+	NS_ABORT_MSG_IF(!file.good() || !std::equal(magic,magic+sizeof(magic),STATE_FILE_MAGIC),"ERROR: "<<name<<" no es un archivo de estado valido");
+	NS_ABORT_MSG_IF(numNodes!=m_numNodes,"ERROR: El estado de "<<name<<" es de una red de "<<numNodes<<" nodos");
+	for(uint32_t n=0;n<savedNodes;n++){
+		uint32_t ip = 0;
+		file.read((char*)&ip,sizeof(uint32_t));
+		uint32_t index = m_directory.FindIndex(Ipv4Address(ip));
+		Ptr<ArapNode> nodeApp = (index==ArapNodeDirectory::INVALID_INDEX) ? 0 : GetLocalApp(index);
+		NS_ABORT_MSG_IF(!file.good() || nodeApp==0,"ERROR: El estado de "<<name<<" tiene el nodo "<<Ipv4Address(ip)<<" que no existe en este proceso");
+		nodeApp->LoadState(file,m_loadStateStatistics);
+	}
+	NS_LOG_UNCOND("Estado de "<<savedNodes<<" nodos cargado desde "<<name<<" (guardado en t="<<time<<"s)");
+}
+
+ArapPathLogger&
+ArapSimulator::GetPathLogger(){
+	return Current().m_pathLogger;
+}
+
+ArapWorkload&
+ArapSimulator::GetWorkload(){
+	return Current().m_workload;
+}
+
+void
+ArapSimulator::OpenWorkload(){
+	if(m_workloadMode==ArapWorkload::MODE_RECORD && m_replica==0)
+		m_workload.OpenRecord(m_workloadFilename,m_numNodes);
+	else if(m_workloadMode==ArapWorkload::MODE_REPLAY)
+		m_workload.OpenReplay(m_workloadFilename,m_numNodes,MakeCallback(&ArapSimulator::ReplayLoadAnts,this));
+}
+
+void
+ArapSimulator::ReplayLoadAnts(uint32_t source, uint32_t target, uint32_t quantity){
+	Ptr<ArapNode> nodeApp = GetLocalApp(source);
+	nodeApp->SendReplayedLoadAnts(m_directory.GetAddress(target),quantity);
+}
+
+ArapProfiler&
+ArapSimulator::GetProfiler(){
+	return Current().m_profiler;
+}
+
+Ptr<ArapNode>
+ArapSimulator::GetLocalApp(uint32_t index) const{
+	Ptr<Node> node = m_directory.GetNode(index);
+	if(!ArapDistributed::IsLocal(node))
+		return 0;
+	return DynamicCast<ArapNode>(node->GetApplication(0));
+}
+
+const ArapTopology&
+ArapSimulator::GetTopology(){
+	return *Current().m_topology;
+}
+
+const ArapNodeDirectory&
+ArapSimulator::GetDirectory(){
+	return Current().m_directory;
 }
 
 void
 ArapSimulator::ConfigNodes (){
-	/* Instalacion de las aplicaciones en las puntas de la estrella
-	 * (el nodo central (HUB) se usa solo como router) y configuracion
+	/* Instalacion de las aplicaciones en los nodos de la topologia
+	 * (los enrutadores se usan solo para reenviar paquetes) y configuracion
 	 * de los distintos parametros de cada nodo
 	 */
 	if(m_arapPathManager ==NULL){
 		NS_ABORT_MSG("NO SE ASIGNO UNA ESPECIFICACION DE ArapPathManager");
 	}
+	NS_ABORT_MSG_IF(m_sendBufferSize<m_antSize,"ERROR: El valor de "<<PARAM_SEND_BUFFER_SIZE<<" debe ser mayor o igual al tamanio de las hormigas");
 
 	ApplicationContainer applications;
-	for (uint32_t i = 0; i < m_star->SpokeCount (); ++i){
+	for (uint32_t i = 0; i < m_directory.GetCount (); ++i){
+		if(!ArapDistributed::IsLocal(m_directory.GetNode(i))) //El nodo se simula en otro rango
+			continue;
 		Ptr<ArapNode> app = CreateObject<ArapNode>();
-		m_star->GetSpokeNode(i)->AddApplication(app);
+		m_directory.GetNode(i)->AddApplication(app);
+		if(m_engine==ENGINE_ABSTRACT) //Sin pila TCP/IP, la IP del nodo se toma del directorio
+			app->ConfigureAbstract(m_directory.GetAddress(i),i);
 		app->SetPathManager(*m_arapPathManager);
-		app->ConfigureSockets();
+		app->SetExplorerScheduler(*m_explorerScheduler);
+		app->SetComputingServer(m_computingWorkers,m_computingDiscipline);
+		if(m_engine==ENGINE_PACKET)
+			app->ConfigureSockets();
 		applications.Add (app);
 	}
 
@@ -475,8 +896,9 @@ ArapSimulator::ConfigNodes (){
 		RandomStreamFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				Ptr<ArapNode> app = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-				app->SetComputingDelayStream(item.stream);
+				Ptr<ArapNode> app = GetLocalApp(i);
+				if(app!=0)
+					app->SetComputingDelayStream(item.stream);
 				assignCheckVector[i]=true;
 			}
 			else
@@ -501,7 +923,10 @@ ArapSimulator::ConfigNodes (){
 		DataRateFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				m_star->GetSpokeNode(i)->GetDevice(0)->SetAttribute("DataRate",DataRateValue(DataRate(item.value)));
+				if(m_engine==ENGINE_ABSTRACT)
+					m_abstractNetwork.SetDataRate(i,item.value);
+				else
+					m_topology->GetAccessDevice(i)->SetAttribute("DataRate",DataRateValue(DataRate(item.value)));
 				assignCheckVector[i]=true;
 			}
 			else
@@ -527,7 +952,9 @@ ArapSimulator::ConfigNodes (){
 		AppTimeFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				m_star->GetSpokeNode(i)->GetApplication(0)->SetStartTime(Seconds(item.appTime));
+				Ptr<ArapNode> app = GetLocalApp(i);
+				if(app!=0)
+					app->SetStartTime(Seconds(item.appTime));
 				assignCheckVector[i]=true;
 			}
 			else
@@ -555,8 +982,9 @@ ArapSimulator::ConfigNodes (){
 		OperationDelayFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				Ptr<ArapNode> aux = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-				aux->SetComputingDelayIncrement(item.factor);
+				Ptr<ArapNode> aux = GetLocalApp(i);
+				if(aux!=0)
+					aux->SetComputingDelayIncrement(item.factor);
 				assignCheckVector[i]=true;
 			}
 			else
@@ -582,8 +1010,9 @@ ArapSimulator::ConfigNodes (){
 		RandomStreamFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				Ptr<ArapNode> app = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-				app->setLoadAntsTimeStream(item.stream);
+				Ptr<ArapNode> app = GetLocalApp(i);
+				if(app!=0)
+					app->setLoadAntsTimeStream(item.stream);
 				assignCheckVector[i]=true;
 			}
 			else
@@ -608,8 +1037,9 @@ ArapSimulator::ConfigNodes (){
 		RandomStreamFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				Ptr<ArapNode> app = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-				app->setLoadAntsQuantityStream(item.stream);
+				Ptr<ArapNode> app = GetLocalApp(i);
+				if(app!=0)
+					app->setLoadAntsQuantityStream(item.stream);
 				assignCheckVector[i]=true;
 			}
 			else
@@ -634,8 +1064,9 @@ ArapSimulator::ConfigNodes (){
 		RandomStreamFormat item = *it;
 		for (int i = item.min; i <= item.max; ++i){
 			if(!assignCheckVector[i]){
-				Ptr<ArapNode> app = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-				app->setLoadAntsTargetStream(item.stream);
+				Ptr<ArapNode> app = GetLocalApp(i);
+				if(app!=0)
+					app->setLoadAntsTargetStream(item.stream);
 				assignCheckVector[i]=true;
 			}
 			else
@@ -652,7 +1083,7 @@ ArapSimulator::ConfigNodes (){
 	}
 
 /*Si no se leyo el parametro de cambio de delay de los enlaces finaliza la simulacion*/
-	if(m_linkDelayChange==NULL){
+	if(m_linkDelayChange==NULL && m_linkDelayModel!=LINK_DELAY_TRACE){
 		NS_ABORT_MSG("ERROR: NO SE ASIGNO UN VALOR PARA EL TIEMPO DE CAMBIO DE LOS ENLACES");
 	}
 
@@ -660,16 +1091,18 @@ ArapSimulator::ConfigNodes (){
 	if(m_queueSize==0)
 		NS_ABORT_MSG("ERROR: NO SE ASIGNO UN VALOR PARA EL Tamanio Maximo de Cola de Paquetes");
 
-  uint32_t hubDevCount = m_star->GetHub()->GetNDevices();
-  for(uint32_t i=0;i<hubDevCount-1;i++){
-  	Ptr<PointToPointNetDevice> p2pdev = DynamicCast<PointToPointNetDevice>(m_star->GetHub()->GetDevice(i));
-  	p2pdev->GetQueue()->SetAttribute("MaxPackets",UintegerValue(m_queueSize));
-  }
-
+  if(m_engine==ENGINE_ABSTRACT)
+  	m_abstractNetwork.SetQueueSize(m_queueSize);
+  else{
+  	const std::vector<Ptr<PointToPointNetDevice> >& routerDevices = m_topology->GetRouterDevices();
+  	for(uint32_t i=0;i<routerDevices.size();i++){
+  		routerDevices[i]->GetQueue()->SetAttribute("MaxPackets",UintegerValue(m_queueSize));
+  	}
 
-  for(uint32_t i=0;i<m_star->SpokeCount();i++){
-  	Ptr<PointToPointNetDevice> p2pdev = DynamicCast<PointToPointNetDevice>(m_star->GetSpokeNode(i)->GetDevice(0));
-    p2pdev->GetQueue()->SetAttribute("MaxPackets",UintegerValue(m_queueSize));
+  	for(uint32_t i=0;i<m_topology->GetNodeCount();i++){
+  		Ptr<PointToPointNetDevice> p2pdev = m_topology->GetAccessDevice(i);
+  		p2pdev->GetQueue()->SetAttribute("MaxPackets",UintegerValue(m_queueSize));
+  	}
   }
 
 
@@ -679,49 +1112,137 @@ ArapSimulator::ConfigNodes (){
 	Simulator::Stop(Seconds(m_stopTime));
 }
 
+const Engine
+ArapSimulator::GetEngine(){
+	return Current().m_engine;
+}
+
+ArapAbstractNetwork&
+ArapSimulator::GetAbstractNetwork(){
+	return Current().m_abstractNetwork;
+}
+
 const Time&
 ArapSimulator::GetExplorersDelta(){
-	return m_explorerAntsInterval;
+	return Current().m_explorerAntsInterval;
 }
 
 const uint32_t
 ArapSimulator::GetNumHops(){
-	return m_numHops;
+	return Current().m_numHops;
 }
 
 const uint32_t
 ArapSimulator::GetNumNodes(){
-	return m_numNodes;
+	return Current().m_numNodes;
 }
 
 const uint32_t
 ArapSimulator::GetAntsSize(){
-	return m_antSize;
+	return Current().m_antSize;
 }
 
 const uint16_t
 ArapSimulator::GetPort(){
-	return m_port;
+	return Current().m_port;
+}
+
+const double
+ArapSimulator::GetRoutingRttMultiple(){
+	return Current().m_routingRttMultiple;
+}
+
+const uint32_t
+ArapSimulator::GetSendBufferSize(){
+	return Current().m_sendBufferSize;
+}
+
+const uint32_t
+ArapSimulator::GetMaxConnections(){
+	return Current().m_maxConnections;
+}
+
+const uint32_t
+ArapSimulator::GetMaxPendingAnts(){
+	return Current().m_maxPendingAnts;
+}
+
+const Time
+ArapSimulator::GetConnectionIdleTimeout(){
+	return Current().m_connectionIdleTimeout;
+}
+
+const Transport
+ArapSimulator::GetTransport(){
+	return Current().m_transport;
 }
 
 bool
 ArapSimulator::IsExplorerAntsEnabled(){
-	return m_enableExplorerAnts;
+	return Current().m_enableExplorerAnts;
+}
+
+bool
+ArapSimulator::IsAnonymityMetricsEnabled(){
+	return Current().m_anonymityMetrics;
+}
+
+bool
+ArapSimulator::IsTracingEnabled(){
+	return Current().m_enableTraces;
 }
 const uint64_t
 ArapSimulator::GetMaximumSegmentSize(){
-	return m_maximumSegmentSize;
+	return Current().m_maximumSegmentSize;
+}
+
+const uint64_t
+ArapSimulator::NextAntID(){
+	ArapSimulator& sim = Current();
+	++sim.m_antID;
+	if(!sim.m_distributed)
+		return sim.m_antID;
+	return sim.m_antID*ArapDistributed::GetSize()+ArapDistributed::GetRank();
+}
+
+const uint64_t
+ArapSimulator::GetAntsCreated(){
+	return Current().m_antID;
 }
 
 void
 ArapSimulator::Run(){
-	ChangeLinkDelay();
-	PrintProbabilityTables();
+	ArapSimulator& sim = Current();
+	if(sim.m_linkDelayModel==LINK_DELAY_SWEEP)
+		sim.ChangeLinkDelay();
+	sim.PrintProbabilityTables();
+	if(!sim.m_saveStateFilename.empty() && sim.m_replica==0){
+		NS_ABORT_MSG_IF(sim.m_saveStateTime>Seconds(sim.m_stopTime),"ERROR: El tiempo de "<<PARAM_SAVE_STATE<<" es posterior al fin de la simulacion");
+		Simulator::Schedule(sim.m_saveStateTime,&ArapSimulator::SaveState,&sim);
+	}
+	std::ostringstream oss;
+	oss<<"load-ants-model/profile-series_";
+	if(sim.m_enableExplorerAnts)
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	sim.m_profiler.Start(ArapDistributed::GetRankFilename(oss.str()));
+	std::ostringstream convergenceName;
+	convergenceName<<"load-ants-model/convergence_";
+	if(sim.m_enableExplorerAnts)
+		convergenceName<<"explorer-on_";
+	else
+		convergenceName<<"explorer-off_";
+	convergenceName<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	sim.m_convergenceMonitor.Start(convergenceName.str());
 	Simulator::Run();
+	sim.m_profiler.Stop();
+	sim.m_convergenceMonitor.Stop();
 }
 
 bool
-ArapSimulator::IsRangeValid(const int min,const int max){
+ArapSimulator::IsRangeValid(const int min,const int max) const{
 	uint32_t  minAbs= abs(min);
 	uint32_t  maxAbs = abs(max);
 	if(minAbs>maxAbs || (minAbs<0 || minAbs>=m_numNodes) || (maxAbs<0 || maxAbs>=m_numNodes))
@@ -732,19 +1253,57 @@ ArapSimulator::IsRangeValid(const int min,const int max){
 
 void
 ArapSimulator::ChangeLinkDelay(){
-	for (uint32_t i = 0; i < m_star->SpokeCount (); ++i){
-		double newDelay=m_linkDelayChange->GetValue();
-		m_star->GetHub()->GetDevice(i)->GetChannel()->SetAttribute("Delay", TimeValue(MilliSeconds(newDelay)));
+	if(m_engine==ENGINE_ABSTRACT){
+		//Un enlace por nodo con el hub, en el mismo orden que los canales de la estrella
+		for(uint32_t i=0;i<m_numNodes;i++)
+			m_abstractNetwork.SetLinkDelay(i,MilliSeconds(m_linkDelayChange->GetValue()));
+		Simulator::Schedule(m_linkDelayInterval,&ArapSimulator::ChangeLinkDelay,this);
+		return;
 	}
-	Simulator::Schedule(m_linkDelayInterval,&ArapSimulator::ChangeLinkDelay);
+	const std::vector<Ptr<PointToPointChannel> >& channels = m_topology->GetChannels();
+	bool firstChange = m_distributed && m_lookahead.IsZero();
+	for (uint32_t i = 0; i < channels.size (); ++i){
+		Time newDelay=MilliSeconds(m_linkDelayChange->GetValue());
+		/* El simulador distribuido calcula su lookahead (Tiempo que cada rango avanza sin esperar a
+		 * los demas) con el delay de los enlaces remotos al iniciar, por lo que el delay de estos
+		 * enlaces no puede bajar luego del minimo inicial
+		 */
+		if(m_distributed && DynamicCast<PointToPointRemoteChannel>(channels[i])!=0){
+			if(firstChange){
+				if(m_lookahead.IsZero() || newDelay<m_lookahead)
+					m_lookahead = newDelay;
+			}
+			else if(newDelay<m_lookahead)
+				newDelay = m_lookahead;
+		}
+		channels[i]->SetAttribute("Delay", TimeValue(newDelay));
+	}
+	NS_ABORT_MSG_IF(firstChange && !m_lookahead.IsStrictlyPositive(),"ERROR: La simulacion distribuida requiere enlaces remotos con delay mayor a cero ("<<PARAM_LINK_DELAY_DIST<<")");
+	Simulator::Schedule(m_linkDelayInterval,&ArapSimulator::ChangeLinkDelay,this);
+}
+
+std::vector<Ptr<ArapDelayProcess> >
+ArapSimulator::CreateDelayProcesses(uint32_t links) const{
+	if(m_linkDelayModel==LINK_DELAY_TRACE)
+		return ArapTraceDelayProcess::ReadFile(m_linkDelayTraceFilename,links);
+	if(m_linkDelayChange==NULL)
+		NS_ABORT_MSG("ERROR: NO SE ASIGNO UN VALOR PARA EL TIEMPO DE CAMBIO DE LOS ENLACES");
+	std::vector<Ptr<ArapDelayProcess> > processes;
+	for(uint32_t i=0;i<links;i++)
+		processes.push_back(Create<ArapRandomDelayProcess>(m_linkDelayChange,m_linkDelayInterval));
+	return processes;
 }
 
 void ArapSimulator::PrintProbabilityTables(){
-	for(uint32_t i=0;i< m_star->SpokeCount();i++){
-		Ptr<ArapNode> nodeApp = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
 		nodeApp->PrintProbTable();
+		if(m_anonymityMetrics)
+			nodeApp->PrintAnonymityMetrics();
 	}
-	Simulator::Schedule(m_printTablesInterval,&ArapSimulator::PrintProbabilityTables);
+	Simulator::Schedule(m_printTablesInterval,&ArapSimulator::PrintProbabilityTables,this);
 }
 
 void
@@ -764,6 +1323,48 @@ ArapSimulator::PrintLoadAntsStatistics(){
 		oss<<"explorer-off_";
 	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
 	name = oss.str();
+
+	//Filas de los nodos de este rango (En una simulacion distribuida el rango 0 las combina)
+	std::ostringstream rows;
+	std::ostringstream quantileRows; //Filas nodo-destino del archivo de cuantiles
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		const LoadAntsStatistics& LoadAntsDelayModel = nodeApp->GetLoadAntsDelayModel();
+		const std::map<Ipv4Address,LoadAntsStatistics::TargetStatistics>& targetsMap = LoadAntsDelayModel.GetTargetsMap();
+		rows<<nodeApp->GetLocalIP();
+
+		for (std::map<Ipv4Address,LoadAntsStatistics::TargetStatistics>::const_iterator it = targetsMap.begin();it!=targetsMap.end(); it++) {
+			rows<<","<<it->second.numSamples;
+			if(it->second.numSamples>0){
+				quantileRows<<nodeApp->GetLocalIP()<<","<<it->first<<","<<it->second.numSamples<<","<<it->second.mean<<","<<it->second.GetVariance();
+				quantileRows<<","<<it->second.sketch.GetQuantile(0.5)<<","<<it->second.sketch.GetQuantile(0.95)<<","<<it->second.sketch.GetQuantile(0.99)<<"\n";
+			}
+		}
+		QuantileSketch nodeSketch; //Cuantiles del nodo, combinando los de cada destino
+		LoadAntsDelayModel.GetSketch(nodeSketch);
+		rows<<","<<LoadAntsDelayModel.GetNumSamples();
+		rows<<","<<LoadAntsDelayModel.GetMean();
+		rows<<","<<LoadAntsDelayModel.GetVariance();
+		rows<<","<<nodeSketch.GetQuantile(0.5);
+		rows<<","<<nodeSketch.GetQuantile(0.95);
+		rows<<","<<nodeSketch.GetQuantile(0.99);
+		rows<<"\n";
+
+		//Calculos de los valores totales para agregar al final del archivo
+		totalSamples = totalSamples + LoadAntsDelayModel.GetNumSamples();
+		sumMeans = sumMeans + LoadAntsDelayModel.GetMean();
+		sumSquareMeans = sumSquareMeans + (LoadAntsDelayModel.GetMean()*LoadAntsDelayModel.GetMean());
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	std::string allQuantileRows = ArapDistributed::Gather(quantileRows.str());
+	totalSamples = ArapDistributed::Sum(totalSamples);
+	sumMeans = ArapDistributed::Sum(sumMeans);
+	sumSquareMeans = ArapDistributed::Sum(sumSquareMeans);
+	if(!ArapDistributed::IsRoot())
+		return;
+
 	std::ofstream file (name.c_str());
 	if (!file.is_open()){
 		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
@@ -771,35 +1372,15 @@ ArapSimulator::PrintLoadAntsStatistics(){
 	}
 	//Imprimir la cabecera de la tabla
 	file<<" "; //EL primer espacio para separar las columnas de las filas
-	for(uint32_t i=0;i< m_star->SpokeCount();i++){
-		Ptr<ArapNode> nodeApp = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-		file<<","<<nodeApp->GetLocalIP();
-	}
+	for(uint32_t i=0;i< m_directory.GetCount();i++)
+		file<<","<<m_directory.GetAddress(i);
 	file<<",\"Hormigas enviadas\"";
 	file<<",Media";
 	file<<",Varianza";
+	file<<",p50,p95,p99";
 	file<<"\n";
+	file<<allRows;
 
-	//Impresion al archivo linea por linea
-	for(uint32_t i=0;i< m_star->SpokeCount();i++){
-		Ptr<ArapNode> nodeApp = DynamicCast<ArapNode>(m_star->GetSpokeNode(i)->GetApplication(0));
-		const LoadAntsStatistics& LoadAntsDelayModel = nodeApp->GetLoadAntsDelayModel();
-		const std::map<Ipv4Address,uint64_t>& samplesCountMap = LoadAntsDelayModel.GetSampleCountsMap();
-		file<<nodeApp->GetLocalIP();
-
-		for (std::map<Ipv4Address,uint64_t>::const_iterator it = samplesCountMap.begin();it!=samplesCountMap.end(); it++) {
-			file<<","<<it->second;
-		}
-		file<<","<<LoadAntsDelayModel.GetNumSamples();
-		file<<","<<LoadAntsDelayModel.GetMean();
-		file<<","<<LoadAntsDelayModel.GetVariance();
-		file<<"\n";
-
-		//Calculos de los valores totales para agregar al final del archivo
-		totalSamples = totalSamples + LoadAntsDelayModel.GetNumSamples();
-		sumMeans = sumMeans + LoadAntsDelayModel.GetMean();
-		sumSquareMeans = sumSquareMeans + (LoadAntsDelayModel.GetMean()*LoadAntsDelayModel.GetMean());
-	}
 	//Imprimir al final los valores de interes
 	file<<"\"Total de hormigas enviadas\","<<totalSamples<<"\n";
 	file<<"\"Suma de las medias de los tiempos\","<<sumMeans<<"\n";
@@ -809,20 +1390,332 @@ ArapSimulator::PrintLoadAntsStatistics(){
 	double xHopeSquare = mean*mean; //Esperanza al cuadrado de X([E(X)]²)
 	file<<"\"Varianza de las medias de los tiempos\","<<(squareXHope - xHopeSquare);
 	file.close();
+
+	/* Cuantiles por destino: <Carpeta>/latency-quantiles_<exploradoras habilitadas>_<Semilla>_<RunNumber>.csv */
+	std::ostringstream quantileName;
+	quantileName<<"load-ants-model/latency-quantiles_";
+	if(IsExplorerAntsEnabled())
+		quantileName<<"explorer-on_";
+	else
+		quantileName<<"explorer-off_";
+	quantileName<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	name = quantileName.str();
+	std::ofstream quantileFile (name.c_str());
+	if (!quantileFile.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	quantileFile<<"Nodo,Destino,Muestras,Media,Varianza,p50,p95,p99\n";
+	quantileFile<<allQuantileRows;
+	quantileFile.close();
+}
+
+void
+ArapSimulator::PrintRoutingTableStatistics(){
+	std::ostringstream oss;
+	oss<<"load-ants-model/routing-table_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ostringstream rows;
+	uint64_t totals[4] = {0,0,0,0};
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		const RoutingTable& table = nodeApp->GetRoutingTable();
+		rows<<nodeApp->GetLocalIP()<<","<<table.GetSize()<<","<<table.GetExpiredCount()<<","<<nodeApp->GetLateResponses()
+				<<","<<table.GetMaxSize()<<","<<table.GetSmoothedRtt().GetMilliSeconds()<<"\n";
+		totals[0] += table.GetSize();
+		totals[1] += table.GetExpiredCount();
+		totals[2] += nodeApp->GetLateResponses();
+		totals[3] += table.GetMaxSize();
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	for(uint32_t i=0;i<4;i++)
+		totals[i] = ArapDistributed::Sum(totals[i]);
+	if(!ArapDistributed::IsRoot())
+		return;
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Nodo,\"Filas sin respuesta\",\"Filas expiradas\",\"Respuestas tardias\",\"Maximo de filas\",\"RTT observado (ms)\"\n";
+	file<<allRows;
+	file<<"Total,"<<totals[0]<<","<<totals[1]<<","<<totals[2]<<","<<totals[3]<<",\n";
+	file.close();
+	NS_LOG_UNCOND("Filas de enrutamiento sin respuesta: "<<totals[0]<<", expiradas: "<<totals[1]<<", respuestas tardias: "<<totals[2]);
+}
+
+void
+ArapSimulator::PrintConnectionStatistics(){
+	std::ostringstream oss;
+	oss<<"load-ants-model/connections_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ostringstream rows;
+	uint64_t totals[6] = {0,0,0,0,0,0};
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		const ArapConnectionPool& pool = nodeApp->GetConnectionPool();
+		rows<<nodeApp->GetLocalIP()<<","<<pool.GetOpenedCount()<<","<<pool.GetPeakOpenCount()<<","<<pool.GetEvictedCount()
+				<<","<<pool.GetIdleClosedCount()<<","<<pool.GetQueuedCount()<<","<<pool.GetMaxPending()<<","<<pool.GetDroppedCount()<<"\n";
+		totals[0] += pool.GetOpenedCount();
+		totals[1] += pool.GetPeakOpenCount();
+		totals[2] += pool.GetEvictedCount();
+		totals[3] += pool.GetIdleClosedCount();
+		totals[4] += pool.GetQueuedCount();
+		totals[5] += pool.GetDroppedCount();
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	for(uint32_t i=0;i<6;i++)
+		totals[i] = ArapDistributed::Sum(totals[i]);
+	if(!ArapDistributed::IsRoot())
+		return;
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Nodo,\"Conexiones abiertas\",\"Maximo de conexiones simultaneas\",\"Conexiones cerradas por limite\",\"Conexiones cerradas por inactividad\",\"Hormigas en espera\",\"Maximo en espera\",\"Hormigas descartadas\"\n";
+	file<<allRows;
+	file<<"Total,"<<totals[0]<<","<<totals[1]<<","<<totals[2]<<","<<totals[3]<<","<<totals[4]<<",,"<<totals[5]<<"\n";
+	file.close();
+	NS_LOG_UNCOND("Conexiones abiertas: "<<totals[0]<<", cerradas por limite: "<<totals[2]<<", cerradas por inactividad: "<<totals[3]
+			<<", hormigas en espera de buffer: "<<totals[4]<<", descartadas: "<<totals[5]);
+}
+
+void
+ArapSimulator::PrintComputingServerStatistics(){
+	std::ostringstream oss;
+	oss<<"load-ants-model/computing-server_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ostringstream rows;
+	uint64_t served = 0, queued = 0;
+	double totalWait = 0, maxWait = 0;
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		const ArapComputingServer& server = nodeApp->GetComputingServer();
+		double wait = server.GetTotalWait().GetMilliSeconds();
+		rows<<nodeApp->GetLocalIP()<<","<<server.GetServedCount()<<","<<server.GetQueuedCount()<<","
+				<<((server.GetServedCount()>0) ? wait/server.GetServedCount() : 0)<<","<<server.GetMaxWait().GetMilliSeconds()
+				<<","<<server.GetMaxQueueLength()<<"\n";
+		served += server.GetServedCount();
+		queued += server.GetQueuedCount();
+		totalWait += wait;
+		maxWait = std::max(maxWait,(double)server.GetMaxWait().GetMilliSeconds());
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	served = ArapDistributed::Sum(served);
+	queued = ArapDistributed::Sum(queued);
+	totalWait = ArapDistributed::Sum(totalWait);
+	maxWait = ArapDistributed::Max(maxWait);
+	if(!ArapDistributed::IsRoot())
+		return;
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	double meanWait = (served>0) ? totalWait/served : 0;
+	file<<"Nodo,\"Hormigas procesadas\",\"Hormigas en espera\",\"Espera media (ms)\",\"Espera maxima (ms)\",\"Maximo en cola\"\n";
+	file<<allRows;
+	file<<"Total,"<<served<<","<<queued<<","<<meanWait<<","<<maxWait<<",\n";
+	file.close();
+	NS_LOG_UNCOND("Servidor de computo ("<<m_computingWorkers<<" trabajadores): hormigas en espera: "<<queued<<", espera media: "<<meanWait<<" ms");
+}
+
+void
+ArapSimulator::PrintAnonymityStatistics(){
+	std::ostringstream oss;
+	oss<<"load-ants-model/anonymity_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ostringstream rows;
+	std::vector<uint64_t> usage(m_directory.GetCount(),0);
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		const ArapAnonymityMetrics& metrics = nodeApp->GetAnonymityMetrics();
+		//Medias entre los destinos que recibieron al menos un camino
+		uint64_t distinct = 0;
+		uint32_t targets = 0;
+		double entropy = 0, minEntropy = 0;
+		for(uint32_t j=0;j< m_directory.GetCount();j++){
+			usage[j] += metrics.GetIntermediateUsage(j);
+			if(metrics.GetPathCount(j)==0)
+				continue;
+			targets++;
+			distinct += metrics.GetDistinctPathCount(j);
+			entropy += metrics.GetEntropy(j);
+			minEntropy += metrics.GetMinEntropy(j);
+		}
+		rows<<nodeApp->GetLocalIP()<<","<<metrics.GetTotalPaths()<<","<<distinct<<","<<targets<<","
+				<<((targets>0) ? entropy/targets : 0)<<","<<((targets>0) ? minEntropy/targets : 0)<<"\n";
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	uint64_t totalUsage = 0;
+	for(uint32_t j=0;j<usage.size();j++){
+		usage[j] = ArapDistributed::Sum(usage[j]);
+		totalUsage += usage[j];
+	}
+	if(!ArapDistributed::IsRoot())
+		return;
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Nodo,Caminos,\"Caminos distintos\",Destinos,\"Entropia media\",\"Min-entropia media\"\n";
+	file<<allRows;
+	file<<"\n";
+	file<<"Nodo,\"Veces como intermedio\",Frecuencia\n";
+	for(uint32_t j=0;j<usage.size();j++)
+		file<<m_directory.GetAddress(j)<<","<<usage[j]<<","<<((totalUsage>0) ? (double)usage[j]/totalUsage : 0)<<"\n";
+	file.close();
+}
+
+void
+ArapSimulator::PrintTransportStatistics(){
+	std::ostringstream oss;
+	oss<<"load-ants-model/transport_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ostringstream rows;
+	uint64_t sent = 0, received = 0;
+	for(uint32_t i=0;i< m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = GetLocalApp(i);
+		if(nodeApp==0)
+			continue;
+		rows<<nodeApp->GetLocalIP()<<","<<nodeApp->GetAntsSent()<<","<<nodeApp->GetAntsReceived()<<"\n";
+		sent += nodeApp->GetAntsSent();
+		received += nodeApp->GetAntsReceived();
+	}
+	std::string allRows = ArapDistributed::Gather(rows.str());
+	sent = ArapDistributed::Sum(sent);
+	received = ArapDistributed::Sum(received);
+	if(!ArapDistributed::IsRoot())
+		return;
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Nodo,\"Hormigas enviadas\",\"Hormigas recibidas\"\n";
+	file<<allRows;
+	file<<"Total,"<<sent<<","<<received<<"\n";
+	file.close();
+	NS_LOG_UNCOND("Hormigas enviadas (Por salto): "<<sent<<", recibidas: "<<received<<", perdidas o en transito: "<<(sent-received));
+}
+
+void
+ArapSimulator::PrintProfile(){
+	if(!m_profiler.IsEnabled())
+		return;
+	std::ostringstream oss;
+	oss<<"load-ants-model/profile_";
+	if(IsExplorerAntsEnabled())
+		oss<<"explorer-on_";
+	else
+		oss<<"explorer-off_";
+	oss<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	m_profiler.PrintSummary(ArapDistributed::GetRankFilename(oss.str()),m_antID);
+}
+
+void
+ArapSimulator::CollectReplicaResult(ArapReplicaResult& result){
+	ArapSimulator& sim = Current();
+	result.run = RngSeedManager::GetRun();
+	result.seed = RngSeedManager::GetSeed();
+	result.explorerAnts = sim.m_enableExplorerAnts;
+	result.antsCreated = sim.m_antID;
+	result.totalSamples = 0;
+	double sumMeans = 0;
+	double sumSquareMeans = 0;
+	std::vector<std::pair<uint32_t,double> > row;
+	for(uint32_t i=0;i< sim.m_directory.GetCount();i++){
+		Ptr<ArapNode> nodeApp = DynamicCast<ArapNode>(sim.m_directory.GetNode(i)->GetApplication(0));
+		const LoadAntsStatistics& loadAntsDelayModel = nodeApp->GetLoadAntsDelayModel();
+		result.totalSamples = result.totalSamples + loadAntsDelayModel.GetNumSamples();
+		sumMeans = sumMeans + loadAntsDelayModel.GetMean();
+		sumSquareMeans = sumSquareMeans + (loadAntsDelayModel.GetMean()*loadAntsDelayModel.GetMean());
+		/* Solo las probabilidades distintas de cero de cada fila: con SparsePathManager
+		 * ExportProbTable() armaría un mapa denso de N·N entradas por nodo
+		 */
+		std::map<Ipv4Address,std::map<Ipv4Address,double> >& table = result.tables[nodeApp->GetLocalIP()];
+		for(uint32_t j=0;j< sim.m_directory.GetCount();j++){
+			if(j==i)
+				continue;
+			std::map<Ipv4Address,double>& targetMap = table[sim.m_directory.GetAddress(j)];
+			nodeApp->GetPathManager().ExportRow(j,row);
+			for(uint32_t k=0;k<row.size();k++)
+				targetMap[sim.m_directory.GetAddress(row[k].first)] = row[k].second;
+		}
+	}
+	result.meanOfMeans = sumMeans/sim.m_numNodes;
+	result.varianceOfMeans = sumSquareMeans/sim.m_numNodes - result.meanOfMeans*result.meanOfMeans;
 }
 
 void
 ArapSimulator::Destroy(){
-	delete m_arapPathManager;
-	NS_LOG_UNCOND("Cantidad total de Hormigas creadas: "<<ArapAnts::GetAntID());
-	PrintProbabilityTables();
-	PrintLoadAntsStatistics();
-	delete m_star;
-	m_computingDelayList.clear();
-	m_computingDistList.clear();
-	m_dataRateList.clear();
-	m_startTimeList.clear();
+	ArapSimulator& sim = Current();
+	uint64_t antsCreated = ArapDistributed::Sum(sim.m_antID);
+	if(ArapDistributed::IsRoot())
+		NS_LOG_UNCOND("Cantidad total de Hormigas creadas: "<<antsCreated);
+	sim.PrintProbabilityTables();
+	sim.PrintLoadAntsStatistics();
+	sim.PrintRoutingTableStatistics();
+	if(sim.m_transport==TRANSPORT_TCP && sim.m_engine==ENGINE_PACKET) //El motor abstracto no tiene conexiones
+		sim.PrintConnectionStatistics();
+	if(sim.m_computingWorkers>0)
+		sim.PrintComputingServerStatistics();
+	if(sim.m_anonymityMetrics)
+		sim.PrintAnonymityStatistics();
+	sim.PrintTransportStatistics();
+	sim.PrintProfile();
+	sim.m_pathLogger.Close();
+	if(sim.m_workload.GetMode()!=ArapWorkload::MODE_NONE){
+		NS_LOG_UNCOND("Traza de carga "<<sim.m_workloadFilename<<": "<<sim.m_workload.GetCount()<<" envios "
+				<<((sim.m_workload.GetMode()==ArapWorkload::MODE_RECORD) ? "grabados" : "reproducidos"));
+		sim.m_workload.Close();
+	}
+	if(!sim.m_pathsFilename.empty())
+		ArapDistributed::MergeRankFiles(sim.m_pathsFilename,MakeBoundCallback(&ArapPathLogger::MergeFiles,sim.m_pathsFormat,sim.m_pathLogger.GetStart()));
 	Simulator::Destroy();
+	ArapDistributed::Disable();
+
+	/* Reiniciar el generador de direcciones, para que una nueva simulación
+	 * en el mismo proceso (Réplicas) pueda volver a asignar las mismas IP
+	 */
+	Ipv4AddressGenerator::Reset();
+	delete s_current;
+	s_current = NULL;
 }
 
 } // namespace ns3
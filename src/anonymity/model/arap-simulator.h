@@ -4,16 +4,33 @@
 
 #include "arap-definitions.h"
 #include "path-manager-factory.h"
+#include "topology-factory.h"
+#include "explorer-scheduler-factory.h"
 #include "arap-path-manager.h"
+#include "arap-replications.h"
+#include "arap-path-logger.h"
+#include "arap-node-directory.h"
+#include "arap-profiler.h"
+#include "arap-convergence-monitor.h"
+#include "arap-abstract-network.h"
+#include "arap-computing-server.h"
+#include "arap-workload.h"
+#include "arap-distributed.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
 
 namespace ns3 {
 
+class ArapNode;
+
 /**
  * Clase de utilidades usada como nucleo del simulador, donde se crea y configura la red,
  *  se leen los parámetros y los envios de data de archivo, y se encarga de mantener los
  *  diferentes parametros de la simulación.
+ *
+ * El estado de la simulación se guarda en una instancia (contexto) creada por ConfigSimulator()
+ * y liberada por Destroy(), los métodos estáticos acceden siempre al contexto activo. De esta
+ * manera un mismo proceso puede ejecutar varias réplicas una detrás de otra (Ver ArapReplications).
  */
 class ArapSimulator {
 
@@ -24,8 +41,11 @@ public:
 	 * leen los parámetros, se crea y configura la red.
 	 *
 	 * @param[in] filename Nombre del archivo donde se encuentran los parámetros de la simulación a correr.
+	 *
+	 * @param[in] replica Número de réplica a configurar, se suma al número de ejecución leido del
+	 * archivo de parámetros para que cada réplica use valores aleatorios distintos.
 	 */
-	static void ConfigSimulator(const std::string& filename="parametros.txt");
+	static void ConfigSimulator(const std::string& filename="parametros.txt", uint32_t replica=0);
 
 	/**
 	 * Iniciar la ejecución del simulador luego que se haya creado y configurado la red.
@@ -38,9 +58,24 @@ public:
 	static void Destroy();
 
 	/**
-	 * @return Referencia constante a la estrella que mantiene la topología de red.
+	 * @return Referencia constante a la topología de red.
+	 */
+	static const ArapTopology& GetTopology();
+
+	/**
+	 * @return Referencia constante al directorio que asocia la IP de cada nodo con su índice.
+	 */
+	static const ArapNodeDirectory& GetDirectory();
+
+	/**
+	 * @return Motor de la simulación (Ver PARAM_ENGINE)
+	 */
+	static const Engine GetEngine();
+
+	/**
+	 * @return Red del motor abstracto (Solo se usa si GetEngine() es ENGINE_ABSTRACT)
 	 */
-	static const PointToPointStarHelper& GetStar();
+	static ArapAbstractNetwork& GetAbstractNetwork();
 
 	/**
 	 * @return Referencia constante al intervalo de envio de exploradoras
@@ -67,18 +102,105 @@ public:
 	 */
 	static const uint16_t GetPort();
 
+	/**
+	 * @return Múltiplo del RTT luego del cual expiran las filas de las tablas de enrutamiento
+	 */
+	static const double GetRoutingRttMultiple();
+
+	/**
+	 * @return Tamaño en Bytes del buffer de envio de cada socket cliente
+	 */
+	static const uint32_t GetSendBufferSize();
+
+	/**
+	 * @return Cantidad máxima de conexiones salientes abiertas en cada nodo (0 = sin límite)
+	 */
+	static const uint32_t GetMaxConnections();
+
+	/**
+	 * @return Cantidad máxima de hormigas en espera en cada conexión saliente (0 = sin límite)
+	 */
+	static const uint32_t GetMaxPendingAnts();
+
+	/**
+	 * @return Tiempo sin envios luego del cual se cierra una conexión saliente (0 = no se cierran)
+	 */
+	static const Time GetConnectionIdleTimeout();
+
+	/**
+	 * @return Protocolo de transporte usado para enviar las hormigas
+	 */
+	static const Transport GetTransport();
+
 	/**
 	 * @return Booleano que indica si esta habilitado o no  el envio de hormigas exploradoras
 	 */
 	static bool IsExplorerAntsEnabled();
 
+	/**
+	 * @return Booleano que indica si los nodos calculan las métricas de anonimato de sus caminos
+	 */
+	static bool IsAnonymityMetricsEnabled();
+
+	/**
+	 * @return Booleano que indica si se crean los archivos ".pcap" y ".tr" (Los paquetes llevan metadatos)
+	 */
+	static bool IsTracingEnabled();
+
 	/**
 	 * @return Tamaño Máximo de Segmento en Bytes que enviarán los socket cliente
 	 */
 	static const uint64_t GetMaximumSegmentSize();
 
+	/**
+	 * @return Registro compartido de los caminos de las hormigas de carga de la simulación en curso.
+	 */
+	static ArapPathLogger& GetPathLogger();
+
+	/**
+	 * @return Referencia a la traza de carga de la simulación (Ver PARAM_WORKLOAD)
+	 */
+	static ArapWorkload& GetWorkload();
+
+	/**
+	 * @return Perfilador de la simulación en curso.
+	 */
+	static ArapProfiler& GetProfiler();
+
+	/**
+	 * Obtiene un nuevo ID de hormiga para la simulación en curso. El contador pertenece
+	 * a la instancia de ArapSimulator activa, por lo que cada réplica inicia desde cero.
+	 * En una simulación distribuida los ID se intercalan entre los rangos
+	 * (contador*rangos+rango), para que no se repitan entre procesos.
+	 *
+	 * @return ID de hormiga nuevo (Valor del contador luego de incrementarlo)
+	 */
+	static const uint64_t NextAntID();
+
+	/**
+	 * @return Cantidad de hormigas creadas en la simulación en curso (En este rango).
+	 */
+	static const uint64_t GetAntsCreated();
+
+	/**
+	 * Agrega al resultado de réplica indicado los valores finales de la simulación en curso
+	 * (Estadísticas de las hormigas de carga y tablas de probabilidad de cada nodo). Debe llamarse
+	 * luego de Run() y antes de Destroy().
+	 *
+	 * @param[out] result Estructura donde se guardan los resultados de la réplica.
+	 *
+	 * @see ArapReplications
+	 */
+	static void CollectReplicaResult(ArapReplicaResult& result);
+
 private:
-	ArapSimulator (); //!<Constructor por defecto, se hace privado para no crear instancias de esta clase
+	ArapSimulator (); //!<Constructor por defecto, las instancias solo se crean desde ConfigSimulator()
+	~ArapSimulator ();
+
+	/**
+	 * @return Referencia a la instancia (contexto de simulación) activa.
+	 */
+	static ArapSimulator& Current();
 
 	/**
 	 * Método para inicializar los valores del mapa que "traduce" los nombres de los
@@ -98,7 +220,7 @@ private:
 	 *
 	 * @return true si el rango es valido, false en otro caso
 	 */
-	static bool IsRangeValid(const int min,const int max);
+	bool IsRangeValid(const int min,const int max) const;
 
 	/**
 	 * Lee los parámetros de una distribución de probabilidad específica.
@@ -116,7 +238,7 @@ private:
 	 *
 	 * @param[in] filename Nombre del archivo de donde se leerán los parámetros
 	 */
-	static void ReadParametersFile(const std::string& filename);
+	void ReadParametersFile(const std::string& filename);
 
 	/**
 	 * Leer parámetros de la simulación de archivo.
@@ -125,35 +247,135 @@ private:
 	 *
 	 * @param[in] iss Flujo de datos de donde se leerán los parámetros.
 	 */
-	static void HandleParameter(const std::string& paramName, std::istringstream& iss);
+	void HandleParameter(const std::string& paramName, std::istringstream& iss);
 
 	/**
 	 * Crear y configurar la red a simular.
 	 */
-	static void ConfigNetwork();
+	void ConfigNetwork();
+
+	/**
+	 * Crear los nodos y la red del motor abstracto (Reemplaza a ConfigNetwork()).
+	 *
+	 * @see ArapAbstractNetwork
+	 */
+	void ConfigAbstractNetwork();
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return Aplicación del nodo, o 0 si el nodo pertenece a otro rango (Simulación distribuida)
+	 */
+	Ptr<ArapNode> GetLocalApp(uint32_t index) const;
 
 	/**
 	 * Cambiar el delay de los enlaces y programar el próximo cambio.
 	 */
-	static void ChangeLinkDelay();
+	void ChangeLinkDelay();
+
+	/**
+	 * Crea los procesos de delay de los enlaces según PARAM_LINK_DELAY_MODEL ("canal" o "traza").
+	 *
+	 * @param[in] links Cantidad de enlaces
+	 *
+	 * @return Proceso de cada enlace
+	 */
+	std::vector<Ptr<ArapDelayProcess> > CreateDelayProcesses(uint32_t links) const;
 
 	/**
 	 * Imprime a un archivo los valores de las distribuciones del delay de las
 	 * hormigas de carga de cada nodo, así como la suma de dichos valores.
 	 */
-	static void PrintLoadAntsStatistics();
+	void PrintLoadAntsStatistics();
+
+	/**
+	 * Imprime a un archivo los contadores de la tabla de enrutamiento de cada nodo: filas
+	 * que quedaron sin respuesta al finalizar, filas expiradas, respuestas tardias y máximo de filas.
+	 */
+	void PrintRoutingTableStatistics();
+
+	/**
+	 * Imprime a un archivo los contadores de las conexiones salientes de cada nodo: conexiones
+	 * abiertas, máximo de conexiones simultaneas, conexiones cerradas por límite y hormigas que
+	 * esperaron espacio en el buffer de envio.
+	 */
+	void PrintConnectionStatistics();
+
+	/**
+	 * Imprime a un archivo los contadores del servidor de cómputo de cada nodo: hormigas
+	 * procesadas, hormigas que esperaron en cola, espera media y máxima (ms) y máximo de
+	 * hormigas en cola (Solo si el servidor tiene trabajadores limitados).
+	 */
+	void PrintComputingServerStatistics();
+
+	/**
+	 * Imprime a un archivo el resumen de las métricas de anonimato: por nodo origen los caminos,
+	 * caminos distintos y las medias (Entre destinos) de la entropía y min-entropía, y por nodo
+	 * la cantidad y frecuencia de veces que fue elegido como intermedio por todos los orígenes.
+	 */
+	void PrintAnonymityStatistics();
+
+	/**
+	 * Imprime a un archivo la cantidad de hormigas enviadas y recibidas por cada nodo (En cada
+	 * salto). La diferencia entre el total enviado y el recibido son las hormigas perdidas en la
+	 * red (Más las que estaban en tránsito al finalizar la simulación).
+	 */
+	void PrintTransportStatistics();
+
+	/**
+	 * Imprime a un archivo el resumen del perfilado (Si está habilitado).
+	 *
+	 * @see ArapProfiler
+	 */
+	void PrintProfile();
 
 	/**
 	 * Imprime a diferentes archivos la tabla de probabilidad de cada uno de los nodos
 	 * (Una tabla por archivo).
 	 */
-	static void PrintProbabilityTables();
+	void PrintProbabilityTables();
 
 	/**
 	 * Crear y configurar las aplicaciones en los nodos que enviarán y recibirán las hormigas
 	 *
 	 */
-	static void ConfigNodes();
+	void ConfigNodes();
+
+	/**
+	 * Abre el registro de caminos de las hormigas de carga, con nombre:\n
+	 * "load-ants-paths/paths_<exploradoras>_<Semilla>_<Run>.<csv|bin>"
+	 * (No se abre con el formato "ninguno")
+	 */
+	void OpenPathLogger();
+
+	/**
+	 * Abre la traza de carga para grabar (Solo en la primera réplica) o reproducir, según PARAM_WORKLOAD.
+	 */
+	void OpenWorkload();
+
+	/**
+	 * Realiza un envío de la traza de carga que se está reproduciendo.
+	 *
+	 * @param[in] source Índice del nodo origen
+	 *
+	 * @param[in] target Índice del nodo destino
+	 *
+	 * @param[in] quantity Cantidad de hormigas
+	 */
+	void ReplayLoadAnts(uint32_t source, uint32_t target, uint32_t quantity);
+
+	/**
+	 * Guarda el estado aprendido de los nodos de este rango en el archivo indicado en
+	 * PARAM_SAVE_STATE. El archivo tiene una cabecera (Identificador y versión del formato,
+	 * cantidad de nodos de la red, cantidad de nodos guardados y tiempo de simulación) y
+	 * luego la IP y el estado (ArapNode::SaveState()) de cada nodo.
+	 */
+	void SaveState();
+
+	/**
+	 * Carga en los nodos el estado guardado en el archivo indicado en PARAM_LOAD_STATE.
+	 */
+	void LoadState();
 
 	/**
 	 * Validar que el rango de la distribucion de destinos para hormigas
@@ -163,32 +385,68 @@ private:
 	 * @param[in] loadAntTargetStream Referencia a la distribución que se desea  validar
 	 *
 	 */
-	static void ValidateLoadAntTargetStream(Ptr<RandomVariableStream>& loadAntTargetStream, int& targetMin,int& targetMax);
+	void ValidateLoadAntTargetStream(Ptr<RandomVariableStream>& loadAntTargetStream, int& targetMin,int& targetMax);
 
 	static std::map<std::string, int> s_mapStringValues;//!< Mapa para asociar los nombres de parametros a enteros
-	static PointToPointStarHelper* m_star; //!< Puntero a la estrella que mantiene la topologia
-	static uint32_t m_numHops; //!< Numero de saltos que hace un paquete de carga desde el origen hasta el destino
-	static uint16_t m_port; //!< Puerto en el que se reciben las hormigas
-	static uint32_t m_numNodes; //!< Número de nodos en la red
-	static Time m_explorerAntsInterval; //!< Invertalo de tiempo para enviar las hormigas exploradoras
-	static Time m_linkDelayInterval; //!< Intervalo de tiempo para cambiar el delay de los enlaces
-	static Time m_printTablesInterval; //!< Intervalo de tiempo para imprimir las tablas de probabilidad de los nodos
-	static uint32_t m_antSize; //!< Tamaño en Bytes de las hormigas a enviar a través de la red anónima
-	static Ptr<RandomVariableStream> m_linkDelayChange; //!< Distribución de probabilidad que provee los valores para el delay de los enlaces
-	static std::list<OperationDelayFormat> m_computingDelayList; //!< Distribución de probabilidad que provee los valores para el delay de computo
-	static std::list<DataRateFormat> m_dataRateList; //!< Lista que guarda los distintos rangos de valores de DataRate
-	static std::list<AppTimeFormat> m_startTimeList; //!< Lista que guarda los distintos rangos de tiempo de inicio de envio de las hormigas
-	static double m_stopTime; //!<Tiempo de finalización de la simulación
-	static bool m_enableTraces; //!< Habilitar creación de archivos ".pcap" y ".tr"
-	static std::list<RandomStreamFormat> m_computingDistList; //!< Lista que guarda los distintos rangos de valores de las distribuciones de probabilidad para el delay de computo
-	static bool m_enableExplorerAnts; //!< Habilitar el envio de hormigas exploradoras
-	static uint64_t m_maximumSegmentSize; //!< Tamaño máximo de segmento
-	static uint64_t m_queueSize; //!< Tamaño máximo (En paquetes) de las colas en los nodos
-	static PathManagerFactory m_pathManagerFactory; //!< Creador de instancias de especializaciones de ArapPathManager
-	static ArapPathManager * m_arapPathManager; //!< Puntero a objetos de las especializaciones de ArapPathManager
-	static std::list<RandomStreamFormat> m_loadAntsTimeList; //!< Lista que guarda las distribuciones para los tiempos de envio de las hormigas de carga en cada nodo
-	static std::list<RandomStreamFormat> m_loadAntsQuantityList; //!< Lista que guarda las distribuciones para la cantidad de hormigas de carga a enviar en cada tiempo en cada nodo
-	static std::list<RandomStreamFormat> m_loadAntsTargetList; //!< Lista que guarda las distribuciones para seleccionar los destinos de las hormigas de carga en cada nodo
+	static ArapSimulator* s_current; //!< Instancia (contexto de simulación) activa, creada en ConfigSimulator() y liberada en Destroy()
+
+	ArapTopology* m_topology; //!< Topología de la red (Ver PARAM_TOPOLOGY)
+	ArapNodeDirectory m_directory; //!< Directorio de los nodos de la red (IP <-> índice)
+	uint32_t m_numHops; //!< Numero de saltos que hace un paquete de carga desde el origen hasta el destino
+	uint16_t m_port; //!< Puerto en el que se reciben las hormigas
+	uint32_t m_numNodes; //!< Número de nodos en la red
+	Time m_explorerAntsInterval; //!< Invertalo de tiempo para enviar las hormigas exploradoras
+	Time m_linkDelayInterval; //!< Intervalo de tiempo para cambiar el delay de los enlaces
+	Time m_printTablesInterval; //!< Intervalo de tiempo para imprimir las tablas de probabilidad de los nodos
+	uint32_t m_antSize; //!< Tamaño en Bytes de las hormigas a enviar a través de la red anónima
+	Ptr<RandomVariableStream> m_linkDelayChange; //!< Distribución de probabilidad que provee los valores para el delay de los enlaces
+	std::list<OperationDelayFormat> m_computingDelayList; //!< Distribución de probabilidad que provee los valores para el delay de computo
+	std::list<DataRateFormat> m_dataRateList; //!< Lista que guarda los distintos rangos de valores de DataRate
+	std::list<AppTimeFormat> m_startTimeList; //!< Lista que guarda los distintos rangos de tiempo de inicio de envio de las hormigas
+	double m_stopTime; //!<Tiempo de finalización de la simulación
+	bool m_enableTraces; //!< Habilitar creación de archivos ".pcap" y ".tr"
+	std::list<RandomStreamFormat> m_computingDistList; //!< Lista que guarda los distintos rangos de valores de las distribuciones de probabilidad para el delay de computo
+	bool m_enableExplorerAnts; //!< Habilitar el envio de hormigas exploradoras
+	uint64_t m_maximumSegmentSize; //!< Tamaño máximo de segmento
+	uint64_t m_queueSize; //!< Tamaño máximo (En paquetes) de las colas en los nodos
+	PathManagerFactory m_pathManagerFactory; //!< Creador de instancias de especializaciones de ArapPathManager
+	TopologyFactory m_topologyFactory; //!< Creador de instancias de especializaciones de ArapTopology
+	ArapExplorerScheduler* m_explorerScheduler; //!< Prototipo del planificador de exploradoras de los nodos (Ver PARAM_EXPLORER_SCHEDULER)
+	ExplorerSchedulerFactory m_explorerSchedulerFactory; //!< Creador de instancias de especializaciones de ArapExplorerScheduler
+	ArapPathManager * m_arapPathManager; //!< Puntero a objetos de las especializaciones de ArapPathManager
+	std::list<RandomStreamFormat> m_loadAntsTimeList; //!< Lista que guarda las distribuciones para los tiempos de envio de las hormigas de carga en cada nodo
+	std::list<RandomStreamFormat> m_loadAntsQuantityList; //!< Lista que guarda las distribuciones para la cantidad de hormigas de carga a enviar en cada tiempo en cada nodo
+	std::list<RandomStreamFormat> m_loadAntsTargetList; //!< Lista que guarda las distribuciones para seleccionar los destinos de las hormigas de carga en cada nodo
+	uint64_t m_antID; //!< Contador de hormigas creadas en esta simulación
+	uint32_t m_replica; //!< Número de réplica de esta simulación (Desplazamiento del número de ejecución)
+	ArapPathLogger::Format m_pathsFormat; //!< Formato del registro de caminos de las hormigas de carga
+	ArapPathLogger m_pathLogger; //!< Registro de caminos de las hormigas de carga, compartido por todos los nodos
+	double m_routingRttMultiple; //!< Múltiplo del RTT luego del cual expiran las filas de las tablas de enrutamiento
+	uint32_t m_sendBufferSize; //!< Tamaño en Bytes del buffer de envio de cada socket cliente
+	uint32_t m_maxConnections; //!< Cantidad máxima de conexiones salientes abiertas en cada nodo
+	uint32_t m_maxPendingAnts; //!< Cantidad máxima de hormigas en espera en cada conexión saliente
+	Time m_connectionIdleTimeout; //!< Tiempo sin envios luego del cual se cierra una conexión saliente
+	Transport m_transport; //!< Protocolo de transporte usado para enviar las hormigas
+	ArapProfiler m_profiler; //!< Perfilador del tiempo real que consumen los métodos de los nodos
+	ArapConvergenceMonitor m_convergenceMonitor; //!< Monitor de convergencia (Ver PARAM_CONVERGENCE)
+	bool m_distributed; //!< Simulación distribuida con MPI habilitada (Ver PARAM_DISTRIBUTED)
+	ArapDistributed::Algorithm m_distributedAlgorithm; //!< Algoritmo de sincronización entre rangos
+	Time m_lookahead; //!< Delay mínimo de los enlaces remotos, fijado en el primer cambio de delay (Simulación distribuida)
+	std::string m_pathsFilename; //!< Nombre del registro de caminos combinado
+	Time m_saveStateTime; //!< Tiempo de simulación en el que se guarda el estado de los nodos (Ver PARAM_SAVE_STATE)
+	std::string m_saveStateFilename; //!< Archivo donde se guarda el estado de los nodos (Vacío = no se guarda)
+	std::string m_loadStateFilename; //!< Archivo del que se carga el estado inicial de los nodos (Vacío = tablas uniformes)
+	bool m_loadStateStatistics; //!< Restaurar también las estadísticas de las hormigas de carga al cargar el estado
+	Engine m_engine; //!< Motor de la simulación (Ver PARAM_ENGINE)
+	uint32_t m_computingWorkers; //!< Hormigas que procesa a la vez cada nodo, 0 = sin límite (Ver PARAM_COMPUTING_SERVER)
+	ArapComputingServer::Discipline m_computingDiscipline; //!< Orden de atención de los servidores de cómputo
+	ArapAbstractNetwork m_abstractNetwork; //!< Red del motor abstracto
+	LinkDelayModel m_linkDelayModel; //!< Modelo del delay de los enlaces (Ver PARAM_LINK_DELAY_MODEL)
+	std::string m_linkDelayTraceFilename; //!< Archivo de trazas de delay del modelo "traza"
+	bool m_anonymityMetrics; //!< Los nodos calculan las métricas de anonimato de sus caminos (Ver PARAM_ANONYMITY_METRICS)
+	ArapWorkload::Mode m_workloadMode; //!< Uso de la traza de carga (Ver PARAM_WORKLOAD)
+	std::string m_workloadFilename; //!< Archivo de la traza de carga
+	ArapWorkload m_workload; //!< Traza de carga
 
 };
 
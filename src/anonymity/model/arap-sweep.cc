@@ -0,0 +1,404 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-sweep.h"
+#include "arap-simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/rng-seed-manager.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapSweep");
+
+/**
+ * Crea una carpeta si no existe.
+ *
+ * @param[in] path Ruta de la carpeta
+ */
+static void
+CreateDirectory(const std::string& path){
+	if(mkdir(path.c_str(),0755)!=0 && errno!=EEXIST)
+		NS_ABORT_MSG("ERROR: No se pudo crear la carpeta "<<path);
+}
+
+/**
+ * @param[in] value Texto a escribir en una celda CSV
+ *
+ * @return Texto entre comillas, con las comillas internas duplicadas
+ */
+static std::string
+QuoteCsv(const std::string& value){
+	std::string quoted = "\"";
+	for(uint32_t i=0;i<value.size();i++){
+		if(value[i]=='"')
+			quoted += '"';
+		quoted += value[i];
+	}
+	return quoted+"\"";
+}
+
+/**
+ * @param[in] value Texto
+ *
+ * @return Texto sin espacios al inicio ni al final
+ */
+static std::string
+Trim(const std::string& value){
+	size_t first = value.find_first_not_of(" \t\r");
+	if(first==std::string::npos)
+		return "";
+	size_t last = value.find_last_not_of(" \t\r");
+	return value.substr(first,last-first+1);
+}
+
+ArapSweep::ArapSweep(const std::string& baseFilename, const std::string& sweepFilename, uint32_t replications, uint32_t workers)
+:m_baseFilename(baseFilename), m_directory(DEFAULT_SWEEP_DIRECTORY), m_replications(replications), m_workers(workers), m_baseRun(RngSeedManager::GetRun()){
+	char cwd[PATH_MAX];
+	NS_ABORT_MSG_IF(getcwd(cwd,sizeof(cwd))==NULL,"ERROR: No se pudo obtener la carpeta actual");
+	m_workingDirectory = cwd;
+	ReadSweepFile(sweepFilename);
+	NS_ABORT_MSG_IF(m_replications==0,"ERROR: La cantidad de replicas del barrido debe ser >=1");
+	if(m_workers==0){
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		m_workers = (cores>0) ? cores : 1;
+	}
+	CreatePoints();
+}
+
+ArapSweep::~ArapSweep(){
+	m_results.clear();
+}
+
+void
+ArapSweep::ReadSweepFile(const std::string& filename){
+	std::string line, name;
+	std::ifstream file (filename.c_str());
+	if (!file.is_open())
+		NS_ABORT_MSG("ERROR: No se pudo leer el archivo de barrido "<<filename);
+
+	NS_LOG_UNCOND("Leyendo barrido desde archivo: \""<<filename<<"\"");
+	while (std::getline (file,line)) {
+		std::istringstream iss(line);
+		if(!(iss>>name) || name[0]=='#') //Linea vacia o comentario
+			continue;
+		if(name=="replicas"){
+			uint32_t replications = 0;
+			iss>>replications;
+			NS_ABORT_MSG_IF(iss.fail() || replications==0,"ERROR: Valor de replicas no valido en el archivo de barrido, debe ser >=1");
+			//La cantidad de la linea de comandos (Si se indico) debe coincidir con la del archivo
+			NS_ABORT_MSG_IF(m_replications>0 && replications!=m_replications,"ERROR: El archivo de barrido indica "<<replications
+					<<" replicas y la linea de comandos "<<m_replications<<", indique la misma cantidad o 0 en la linea de comandos");
+			m_replications = replications;
+		}
+		else if(name=="carpeta"){
+			iss>>m_directory;
+		}
+		else if(name=="valores"){
+			std::string param, rest;
+			iss>>param;
+			std::getline(iss,rest);
+			std::vector<std::string> values;
+			std::istringstream valuesStream(rest);
+			std::string value;
+			while(std::getline(valuesStream,value,'|')){
+				value = Trim(value);
+				NS_ABORT_MSG_IF(value.empty(),"ERROR: Valor vacio en el barrido del parametro "<<param);
+				values.push_back(value);
+			}
+			NS_ABORT_MSG_IF(param.empty() || values.empty(),"ERROR: Linea de valores no valida en el archivo de barrido: "<<line);
+			m_values.push_back(std::make_pair(param,values));
+		}
+		else
+			NS_ABORT_MSG("ERROR: Linea no valida en el archivo de barrido: "<<line);
+	}
+	file.close();
+}
+
+void
+ArapSweep::CreatePoints(){
+	/* Se enumeran las combinaciones como un contador donde el ultimo parametro
+	 * barrido cambia mas rapido
+	 */
+	std::vector<uint32_t> indexes(m_values.size(),0);
+	while(true){
+		m_points.push_back(indexes);
+		int32_t i = (int32_t)m_values.size()-1;
+		for(;i>=0;i--){
+			if(++indexes[i]<m_values[i].second.size())
+				break;
+			indexes[i]=0;
+		}
+		if(i<0)
+			break;
+	}
+	m_results.assign(m_points.size(),std::vector<ArapReplicaResult>(m_replications));
+	m_done.assign(m_points.size(),std::vector<bool>(m_replications,false));
+}
+
+std::string
+ArapSweep::GetPointDirectory(uint32_t point) const{
+	std::ostringstream oss;
+	oss<<m_directory<<"/punto_"<<point;
+	return oss.str();
+}
+
+std::string
+ArapSweep::GetResultFileName(uint32_t replica) const{
+	std::ostringstream oss;
+	oss<<"resultado_"<<m_baseRun+replica<<".bin";
+	return oss.str();
+}
+
+void
+ArapSweep::PreparePoint(uint32_t point, const std::vector<std::string>& baseLines){
+	std::string directory = GetPointDirectory(point);
+	CreateDirectory(directory);
+	CreateDirectory(directory+"/load-ants-model");
+	CreateDirectory(directory+"/load-ants-paths");
+	CreateDirectory(directory+"/tablas");
+
+	/* Cada parametro barrido toma el lugar de su primera linea en el archivo base (Algunos
+	 * parametros deben leerse en orden) y sus demas lineas se eliminan
+	 */
+	std::ostringstream content;
+	std::vector<bool> written(m_values.size(),false);
+	for(uint32_t l=0;l<baseLines.size();l++){
+		std::istringstream iss(baseLines[l]);
+		std::string name;
+		iss>>name;
+		uint32_t v=0;
+		while(v<m_values.size() && m_values[v].first!=name)
+			v++;
+		if(v==m_values.size()){
+			content<<ResolvePaths(baseLines[l])<<"\n";
+			continue;
+		}
+		if(!written[v])
+			content<<ResolvePaths(name+" "+m_values[v].second[m_points[point][v]])<<"\n";
+		written[v]=true;
+	}
+	for(uint32_t v=0;v<m_values.size();v++){
+		if(!written[v])
+			content<<ResolvePaths(m_values[v].first+" "+m_values[v].second[m_points[point][v]])<<"\n";
+	}
+
+	std::string filename = directory+"/parametros.txt";
+	std::ifstream previousFile(filename.c_str());
+	if(previousFile.is_open()){
+		std::ostringstream previous;
+		previous<<previousFile.rdbuf();
+		previousFile.close();
+		if(previous.str()!=content.str()){
+			//Los resultados guardados corresponden a otros parametros
+			NS_LOG_UNCOND("Punto "<<point<<": el archivo de parametros cambio, se descartan sus resultados anteriores");
+			DIR* dir = opendir(directory.c_str());
+			if(dir!=NULL){
+				struct dirent* entry;
+				while((entry=readdir(dir))!=NULL){
+					std::string entryName = entry->d_name;
+					if(entryName.compare(0,10,"resultado_")==0)
+						std::remove((directory+"/"+entryName).c_str());
+				}
+				closedir(dir);
+			}
+		}
+	}
+	std::ofstream file(filename.c_str());
+	NS_ABORT_MSG_IF(!file.is_open(),"ERROR: No se pudo crear el archivo "<<filename);
+	file<<content.str();
+	file.close();
+}
+
+std::string
+ArapSweep::ResolvePaths(const std::string& line) const{
+	std::istringstream iss(line);
+	std::vector<std::string> words;
+	std::string word;
+	while(iss>>word)
+		words.push_back(word);
+	if(words.empty())
+		return line;
+
+	//Posición de la ruta en la línea, según el formato de cada parámetro
+	uint32_t position = 0;
+	if(words[0]==PARAM_TOPOLOGY && words.size()>1 && words[1]=="archivo")
+		position = 3;
+	else if(words[0]==PARAM_LOAD_STATE)
+		position = 1;
+	else if(words[0]==PARAM_LINK_DELAY_MODEL && words.size()>1 && words[1]=="traza")
+		position = 2;
+	else if(words[0]==PARAM_WORKLOAD && words.size()>1 && words[1]=="reproducir")
+		position = 2;
+	if(position==0 || position>=words.size() || words[position][0]=='/')
+		return line;
+
+	words[position] = m_workingDirectory+"/"+words[position];
+	std::string resolved = words[0];
+	for(uint32_t i=1;i<words.size();i++)
+		resolved += " "+words[i];
+	return resolved;
+}
+
+void
+ArapSweep::Run(){
+	std::vector<std::string> baseLines;
+	std::string line;
+	std::ifstream baseFile(m_baseFilename.c_str());
+	NS_ABORT_MSG_IF(!baseFile.is_open(),"ERROR: No se pudo leer el archivo de parametros "<<m_baseFilename);
+	while(std::getline(baseFile,line))
+		baseLines.push_back(line);
+	baseFile.close();
+
+	CreateDirectory(m_directory);
+	std::vector<Job> pending;
+	for(uint32_t point=0;point<m_points.size();point++){
+		PreparePoint(point,baseLines);
+		for(uint32_t replica=0;replica<m_replications;replica++){
+			//Las replicas con resultado de una ejecucion anterior no se vuelven a ejecutar
+			std::string name = GetPointDirectory(point)+"/"+GetResultFileName(replica);
+			m_done[point][replica] = ArapReplications::ReadResult(name,m_results[point][replica]);
+			if(!m_done[point][replica]){
+				Job job = {point,replica};
+				pending.push_back(job);
+			}
+		}
+	}
+	NS_LOG_UNCOND("Barrido de "<<m_points.size()<<" puntos con "<<m_replications<<" replicas: "
+			<<pending.size()<<" pendientes, "<<m_workers<<" procesos");
+	RunForked(pending);
+	WriteResults();
+}
+
+bool
+ArapSweep::RunJob(const Job& job){
+	if(chdir(GetPointDirectory(job.point).c_str())!=0)
+		return false;
+	/* Igual que en ArapReplications, el numero de ejecucion se asigna antes de leer los parametros */
+	RngSeedManager::SetRun(m_baseRun+job.replica);
+	ArapSimulator::ConfigSimulator("parametros.txt",job.replica);
+	ArapSimulator::Run();
+	ArapReplicaResult result;
+	ArapSimulator::CollectReplicaResult(result);
+	ArapSimulator::Destroy();
+
+	//El resultado se renombra al final para que una replica interrumpida no quede como completa
+	std::string name = GetResultFileName(job.replica);
+	std::string temporary = name+".tmp";
+	return ArapReplications::WriteResult(temporary,result) && std::rename(temporary.c_str(),name.c_str())==0;
+}
+
+void
+ArapSweep::RunForked(const std::vector<Job>& jobs){
+	std::map<pid_t,Job> running; //Procesos hijos en ejecucion y la replica que ejecuta cada uno
+	uint32_t next = 0;
+	while(next<jobs.size() || !running.empty()){
+		while(next<jobs.size() && running.size()<m_workers){
+			std::cout.flush(); //Para que el hijo no repita la salida pendiente del padre
+			pid_t pid = fork();
+			NS_ABORT_MSG_IF(pid<0,"ERROR: No se pudo crear el proceso para el punto "<<jobs[next].point<<", replica "<<jobs[next].replica);
+			if(pid==0){ //Proceso hijo
+				bool written = RunJob(jobs[next]);
+				std::cout.flush();
+				_exit(written ? 0 : 1);
+			}
+			NS_LOG_UNCOND("Punto "<<jobs[next].point<<", replica "<<jobs[next].replica<<" en el proceso "<<pid);
+			running[pid]=jobs[next++];
+		}
+
+		int status;
+		pid_t pid = waitpid(-1,&status,0);
+		if(pid<0)
+			NS_ABORT_MSG("ERROR: Fallo la espera de los procesos del barrido");
+		std::map<pid_t,Job>::iterator it = running.find(pid);
+		if(it==running.end())
+			continue;
+		Job job = it->second;
+		running.erase(it);
+		NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status)!=0,"ERROR: El punto "<<job.point<<", replica "<<job.replica<<" finalizo con error");
+		std::string name = GetPointDirectory(job.point)+"/"+GetResultFileName(job.replica);
+		m_done[job.point][job.replica] = ArapReplications::ReadResult(name,m_results[job.point][job.replica]);
+		NS_ABORT_MSG_IF(!m_done[job.point][job.replica],"ERROR: No se pudieron leer los resultados de "<<name);
+	}
+}
+
+double
+ArapSweep::GetStudentT(uint32_t degrees){
+	static const double table[30] = {12.706,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228,
+			2.201,2.179,2.160,2.145,2.131,2.120,2.110,2.101,2.093,2.086,
+			2.080,2.074,2.069,2.064,2.060,2.056,2.052,2.048,2.045,2.042};
+	if(degrees==0)
+		return 0;
+	if(degrees<=30)
+		return table[degrees-1];
+	if(degrees<=60)
+		return 2.000;
+	if(degrees<=120)
+		return 1.980;
+	return 1.960;
+}
+
+void
+ArapSweep::WriteResults() const{
+	std::string name = m_directory+"/resultados.csv";
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	//Mismas columnas que el resumen de ArapReplications, con la media y la mitad del intervalo de confianza
+	static const char* metrics[4] = {"Hormigas creadas","Total de hormigas enviadas","Media de las medias de los tiempos","Varianza de las medias de los tiempos"};
+	file<<"Punto";
+	for(uint32_t v=0;v<m_values.size();v++)
+		file<<","<<QuoteCsv(m_values[v].first);
+	file<<",Replicas";
+	for(uint32_t i=0;i<4;i++)
+		file<<","<<QuoteCsv(metrics[i])<<","<<QuoteCsv(std::string("IC95 ")+metrics[i]);
+	file<<"\n";
+
+	for(uint32_t point=0;point<m_points.size();point++){
+		double sum[4] = {0,0,0,0};
+		double sumSquare[4] = {0,0,0,0};
+		uint32_t n = 0;
+		for(uint32_t replica=0;replica<m_replications;replica++){
+			if(!m_done[point][replica])
+				continue;
+			const ArapReplicaResult& result = m_results[point][replica];
+			double values[4] = {(double)result.antsCreated,(double)result.totalSamples,result.meanOfMeans,result.varianceOfMeans};
+			for(uint32_t i=0;i<4;i++){
+				sum[i] = sum[i]+values[i];
+				sumSquare[i] = sumSquare[i]+values[i]*values[i];
+			}
+			n++;
+		}
+
+		file<<point;
+		for(uint32_t v=0;v<m_values.size();v++)
+			file<<","<<QuoteCsv(m_values[v].second[m_points[point][v]]);
+		file<<","<<n;
+		for(uint32_t i=0;i<4;i++){
+			double mean = (n>0) ? sum[i]/n : 0;
+			double variance = (n>1) ? (sumSquare[i]-n*mean*mean)/(n-1) : 0;
+			double halfWidth = (n>1) ? GetStudentT(n-1)*std::sqrt(std::max(variance,0.0)/n) : 0;
+			file<<","<<mean<<","<<halfWidth;
+		}
+		file<<"\n";
+	}
+	file.close();
+	NS_LOG_UNCOND("Resultados del barrido en "<<name);
+}
+
+} /* namespace ns3 */
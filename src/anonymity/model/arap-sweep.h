@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_SWEEP_H
+#define ARAP_SWEEP_H
+
+#include "ns3/arap-replications.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+#define DEFAULT_SWEEP_DIRECTORY "barrido" //!<Carpeta por defecto donde se guardan las salidas de un barrido de parámetros
+
+namespace ns3 {
+
+/**
+ * Barrido de parámetros: ejecuta las réplicas de todas las combinaciones (Puntos) de los valores
+ * indicados para algunos parámetros de un archivo de parámetros base, y escribe una tabla con la
+ * media y el intervalo de confianza (95%, t de Student) de los resultados de cada punto.
+ *
+ * El archivo de barrido tiene el mismo formato de líneas que el archivo de parámetros:\n
+ * "replicas <cantidad>" Réplicas de cada punto (Opcional, por defecto las indicadas al ejecutar. Si
+ * también se indican al ejecutar, con un valor distinto de 0, ambas cantidades deben coincidir)\n
+ * "carpeta <ruta>" Carpeta de salida (Opcional, por defecto DEFAULT_SWEEP_DIRECTORY)\n
+ * "valores <parametro> <valor 1> | <valor 2> | ..." Valores a probar de un parámetro
+ *
+ * Cada punto tiene su carpeta "<carpeta>/punto_<N>" con su archivo de parámetros (El archivo base
+ * donde todas las líneas de cada parámetro barrido se reemplazan por el valor del punto) y las
+ * carpetas de salida de la simulación, por lo que las réplicas de todos los puntos usan los mismos
+ * números de ejecución sin que se mezclen sus archivos. Como las réplicas se ejecutan dentro de la
+ * carpeta del punto, las rutas relativas de los archivos que se leen (Topología "archivo", traza de
+ * delay, PARAM_LOAD_STATE y PARAM_WORKLOAD al reproducir) se reescriben como rutas absolutas desde
+ * la carpeta donde se ejecuta el barrido. Las de los archivos que se crean (PARAM_SAVE_STATE y
+ * PARAM_WORKLOAD al grabar) quedan relativas, para que cada punto escriba el suyo.
+ *
+ * Las réplicas de todos los puntos se reparten en un mismo conjunto de procesos hijos, igual que
+ * ArapReplications (Como máximo "workers" a la vez, uno por núcleo si es 0). El resultado de cada
+ * réplica se guarda en "<carpeta>/punto_<N>/resultado_<Run>.bin", y al volver a ejecutar el barrido
+ * se omiten las réplicas que ya tienen resultado, salvo que el archivo de parámetros del punto haya
+ * cambiado. La tabla combinada es "<carpeta>/resultados.csv".
+ */
+class ArapSweep {
+
+public:
+
+	/**
+	 * Constructor paramétrico.
+	 *
+	 * @param[in] baseFilename Nombre del archivo de parámetros base
+	 *
+	 * @param[in] sweepFilename Nombre del archivo de barrido
+	 *
+	 * @param[in] replications Cantidad de réplicas de cada punto si el archivo de barrido no la indica (0 = solo la del
+	 * archivo; si ambos la indican deben coincidir)
+	 *
+	 * @param[in] workers Cantidad máxima de réplicas a ejecutar en paralelo (0 = una por núcleo)
+	 */
+	ArapSweep(const std::string& baseFilename, const std::string& sweepFilename, uint32_t replications, uint32_t workers);
+	~ArapSweep();
+
+	/**
+	 * Ejecuta las réplicas pendientes de todos los puntos y escribe la tabla de resultados.
+	 */
+	void Run();
+
+private:
+
+	/**
+	 * Una réplica de un punto del barrido.
+	 */
+	struct Job {
+		uint32_t point; //!< Número de punto
+		uint32_t replica; //!< Número de réplica dentro del punto
+	};
+
+	/**
+	 * Lee el archivo de barrido.
+	 *
+	 * @param[in] filename Nombre del archivo de barrido
+	 */
+	void ReadSweepFile(const std::string& filename);
+
+	/**
+	 * Crea las combinaciones de valores de los parámetros barridos (Producto cartesiano).
+	 */
+	void CreatePoints();
+
+	/**
+	 * Crea la carpeta y el archivo de parámetros de un punto. Si el archivo ya existía con otro
+	 * contenido, se eliminan los resultados anteriores del punto.
+	 *
+	 * @param[in] point Número de punto
+	 *
+	 * @param[in] baseLines Líneas del archivo de parámetros base
+	 */
+	void PreparePoint(uint32_t point, const std::vector<std::string>& baseLines);
+
+	/**
+	 * @param[in] line Línea del archivo de parámetros
+	 *
+	 * @return La línea con la ruta del archivo que lee el parámetro convertida en absoluta (Desde
+	 * m_workingDirectory), o la misma línea si el parámetro no lee archivos o la ruta ya es absoluta
+	 */
+	std::string ResolvePaths(const std::string& line) const;
+
+	/**
+	 * Ejecuta una réplica en el proceso actual (Proceso hijo), dentro de la carpeta del punto.
+	 *
+	 * @param[in] job Réplica a ejecutar
+	 *
+	 * @return true si se pudo guardar el resultado
+	 */
+	bool RunJob(const Job& job);
+
+	/**
+	 * Ejecuta las réplicas indicadas en procesos hijos, manteniendo como máximo m_workers procesos a la vez.
+	 *
+	 * @param[in] jobs Réplicas pendientes
+	 */
+	void RunForked(const std::vector<Job>& jobs);
+
+	/**
+	 * Escribe la tabla de resultados con la media y el intervalo de confianza de cada punto.
+	 */
+	void WriteResults() const;
+
+	/**
+	 * @param[in] point Número de punto
+	 *
+	 * @return Carpeta del punto
+	 */
+	std::string GetPointDirectory(uint32_t point) const;
+
+	/**
+	 * @param[in] replica Número de réplica
+	 *
+	 * @return Nombre del archivo de resultado de la réplica, relativo a la carpeta del punto
+	 */
+	std::string GetResultFileName(uint32_t replica) const;
+
+	/**
+	 * @param[in] degrees Grados de libertad (>=1)
+	 *
+	 * @return Valor de la distribución t de Student para un intervalo de confianza de 95% (Dos colas)
+	 */
+	static double GetStudentT(uint32_t degrees);
+
+	std::string m_baseFilename; //!< Archivo de parámetros base
+	std::string m_directory; //!< Carpeta de salida del barrido
+	std::string m_workingDirectory; //!< Carpeta donde se ejecuta el barrido, base de las rutas relativas
+	uint32_t m_replications; //!< Cantidad de réplicas de cada punto
+	uint32_t m_workers; //!< Cantidad máxima de réplicas ejecutandose en paralelo
+	uint64_t m_baseRun; //!< Número de ejecución de la primera réplica de cada punto
+	std::vector<std::pair<std::string,std::vector<std::string> > > m_values; //!< Parámetros barridos y sus valores, en el orden del archivo
+	std::vector<std::vector<uint32_t> > m_points; //!< Índice del valor de cada parámetro barrido en cada punto
+	std::vector<std::vector<ArapReplicaResult> > m_results; //!< Resultados de las réplicas de cada punto
+	std::vector<std::vector<bool> > m_done; //!< Indica las réplicas de cada punto que tienen resultado
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_SWEEP_H */
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-topology.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/point-to-point-grid.h"
+#include "ns3/topology-reader-helper.h"
+#include "arap-distributed.h"
+#include <set>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapTopology");
+
+ArapTopology::ArapTopology(){
+}
+
+ArapTopology::~ArapTopology(){
+}
+
+void
+ArapTopology::Build(uint32_t numNodes, PointToPointHelper& pointToPoint, Ipv4AddressHelper address){
+	CreateRouters(m_routers,pointToPoint);
+	NS_ABORT_MSG_IF(m_routers.GetN()==0,"ERROR: La topologia "<<GetName()<<" no tiene enrutadores");
+
+	/* Los unicos dispositivos de los enrutadores hasta ahora son los de los enlaces
+	 * troncales, se guardan sus canales (Una vez cada uno) para asignarles IP al final
+	 */
+	std::vector<Ptr<PointToPointChannel> > backbone;
+	std::set<Ptr<PointToPointChannel> > seen;
+	for(uint32_t i=0;i<m_routers.GetN();i++){
+		Ptr<Node> router = m_routers.Get(i);
+		for(uint32_t j=0;j<router->GetNDevices();j++){
+			Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel>(router->GetDevice(j)->GetChannel());
+			if(channel!=0 && seen.insert(channel).second)
+				backbone.push_back(channel);
+		}
+	}
+
+	//En una simulacion distribuida los nodos se reparten en bloques contiguos entre los rangos
+	uint32_t ranks = ArapDistributed::GetSize();
+	for(uint32_t i=0;i<numNodes;i++)
+		m_nodes.Create(1,(uint64_t)i*ranks/numNodes);
+	std::vector<NetDeviceContainer> accessLinks;
+	accessLinks.reserve(numNodes);
+	for(uint32_t i=0;i<numNodes;i++){
+		uint32_t router = GetRouterIndex(i,numNodes,m_routers.GetN());
+		NS_ABORT_MSG_IF(router>=m_routers.GetN(),"ERROR: El nodo "<<i<<" no tiene un enrutador valido en la topologia "<<GetName());
+		NetDeviceContainer link = pointToPoint.Install(m_routers.Get(router),m_nodes.Get(i));
+		accessLinks.push_back(link);
+		m_accessDevices.push_back(DynamicCast<PointToPointNetDevice>(link.Get(1)));
+		m_channels.push_back(DynamicCast<PointToPointChannel>(link.Get(1)->GetChannel()));
+	}
+
+	InternetStackHelper internet;
+	internet.Install(m_routers);
+	internet.Install(m_nodes);
+
+	//Primero las redes de acceso, para que la IP de los nodos crezca con su indice
+	for(uint32_t i=0;i<numNodes;i++){
+		address.Assign(accessLinks[i].Get(0));
+		m_addresses.push_back(address.Assign(accessLinks[i].Get(1)).GetAddress(0));
+		address.NewNetwork();
+	}
+	for(std::vector<Ptr<PointToPointChannel> >::iterator it = backbone.begin();it!=backbone.end();it++){
+		address.Assign((*it)->GetDevice(0));
+		address.Assign((*it)->GetDevice(1));
+		address.NewNetwork();
+		m_channels.push_back(*it);
+	}
+
+	for(uint32_t i=0;i<m_routers.GetN();i++){
+		Ptr<Node> router = m_routers.Get(i);
+		for(uint32_t j=0;j<router->GetNDevices();j++){
+			Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>(router->GetDevice(j));
+			if(device!=0)
+				m_routerDevices.push_back(device);
+		}
+	}
+	NS_LOG_INFO("Topologia "<<GetName()<<" creada con "<<m_routers.GetN()<<" enrutadores, "<<numNodes
+			<<" nodos y "<<backbone.size()<<" enlaces troncales");
+}
+
+uint32_t
+ArapTopology::GetRouterIndex(uint32_t index, uint32_t numNodes, uint32_t numRouters) const{
+	return (uint64_t)index*numRouters/numNodes;
+}
+
+uint32_t
+ArapTopology::GetNodeCount() const{
+	return m_nodes.GetN();
+}
+
+Ptr<Node>
+ArapTopology::GetNode(uint32_t index) const{
+	return m_nodes.Get(index);
+}
+
+const Ipv4Address&
+ArapTopology::GetAddress(uint32_t index) const{
+	return m_addresses[index];
+}
+
+Ptr<PointToPointNetDevice>
+ArapTopology::GetAccessDevice(uint32_t index) const{
+	return m_accessDevices[index];
+}
+
+const NodeContainer&
+ArapTopology::GetRouters() const{
+	return m_routers;
+}
+
+const std::vector<Ptr<PointToPointNetDevice> >&
+ArapTopology::GetRouterDevices() const{
+	return m_routerDevices;
+}
+
+const std::vector<Ptr<PointToPointChannel> >&
+ArapTopology::GetChannels() const{
+	return m_channels;
+}
+
+std::string
+ArapStarTopology::GetName() const{
+	return "estrella";
+}
+
+void
+ArapStarTopology::CreateRouters(NodeContainer& routers, PointToPointHelper&){
+	routers.Create(1);
+}
+
+ArapMultiHubTopology::ArapMultiHubTopology(uint32_t numHubs)
+:m_numHubs(numHubs){
+	NS_ABORT_MSG_IF(numHubs<2,"ERROR: La topologia multi-hub debe tener al menos 2 HUB");
+}
+
+std::string
+ArapMultiHubTopology::GetName() const{
+	std::ostringstream oss;
+	oss<<"multi-hub("<<m_numHubs<<")";
+	return oss.str();
+}
+
+void
+ArapMultiHubTopology::CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint){
+	//Cada HUB pertenece al rango de los nodos conectados a el (En una simulacion distribuida)
+	uint32_t ranks = ArapDistributed::GetSize();
+	for(uint32_t i=0;i<m_numHubs;i++)
+		routers.Create(1,(uint64_t)i*ranks/m_numHubs);
+	//Con 2 HUB el anillo se reduce a un solo enlace
+	uint32_t links = (m_numHubs==2) ? 1 : m_numHubs;
+	for(uint32_t i=0;i<links;i++)
+		pointToPoint.Install(routers.Get(i),routers.Get((i+1)%m_numHubs));
+}
+
+ArapGridTopology::ArapGridTopology(uint32_t rows, uint32_t cols)
+:m_rows(rows), m_cols(cols){
+	NS_ABORT_MSG_IF(rows<1 || cols<1 || rows*cols<2,"ERROR: La grilla debe tener al menos 2 enrutadores");
+}
+
+std::string
+ArapGridTopology::GetName() const{
+	std::ostringstream oss;
+	oss<<"grilla("<<m_rows<<"x"<<m_cols<<")";
+	return oss.str();
+}
+
+void
+ArapGridTopology::CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint){
+	PointToPointGridHelper grid(m_rows,m_cols,pointToPoint);
+	for(uint32_t row=0;row<m_rows;row++)
+		for(uint32_t col=0;col<m_cols;col++)
+			routers.Add(grid.GetNode(row,col));
+}
+
+ArapFileTopology::ArapFileTopology(const std::string& format, const std::string& filename)
+:m_format(format), m_filename(filename){
+}
+
+std::string
+ArapFileTopology::GetName() const{
+	return m_format+":"+m_filename;
+}
+
+void
+ArapFileTopology::CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint){
+	TopologyReaderHelper helper;
+	helper.SetFileName(m_filename);
+	helper.SetFileType(m_format);
+	Ptr<TopologyReader> reader = helper.GetTopologyReader();
+	if(reader==0)
+		NS_ABORT_MSG("ERROR: Formato de topologia \""<<m_format<<"\" no valido, debe ser Inet, Orbis o Rocketfuel");
+	routers.Add(reader->Read());
+	if(routers.GetN()==0)
+		NS_ABORT_MSG("ERROR: No se pudo leer la topologia del archivo "<<m_filename);
+	for(TopologyReader::ConstLinksIterator it = reader->LinksBegin();it!=reader->LinksEnd();it++)
+		pointToPoint.Install(it->GetFromNode(),it->GetToNode());
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_TOPOLOGY_H
+#define ARAP_TOPOLOGY_H
+
+#include "ns3/node-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Topología de la red sobre la que se ejecuta la red anónima.
+ *
+ * Toda topología está formada por un conjunto de enrutadores (Que solo reenvian paquetes)
+ * unidos por enlaces troncales, y por los nodos de la red anónima, cada uno conectado a un
+ * enrutador por su propio enlace de acceso. Las especializaciones solo definen los
+ * enrutadores y los enlaces troncales (CreateRouters()) y a cuál enrutador se conecta cada
+ * nodo (GetRouterIndex()); la creación de los nodos, la pila de red y las direcciones IP son
+ * comunes a todas.
+ *
+ * Las direcciones IP se asignan primero a los enlaces de acceso, en orden de nodo y una red
+ * por enlace, y luego a los enlaces troncales. De esta manera la IP de los nodos crece con
+ * su índice, y el índice de un nodo en la topología coincide con su índice en el directorio
+ * (Ver ArapNodeDirectory) y con los rangos de nodos del archivo de parámetros.
+ *
+ * En una simulación distribuida (Ver ArapDistributed) los nodos se reparten entre los rangos
+ * en bloques contiguos de índices. Los enrutadores pertenecen al rango 0, salvo en
+ * ArapMultiHubTopology donde cada HUB pertenece al rango de sus nodos; los enlaces entre
+ * nodos de distintos rangos son canales remotos.
+ *
+ * Para agregar una nueva topología se debe heredar de esta clase y agregar su caso en
+ * TopologyFactory::GetInstance().
+ */
+class ArapTopology {
+
+public:
+
+	ArapTopology();
+	virtual ~ArapTopology();
+
+	/**
+	 * Crea la red: los enrutadores y sus enlaces troncales, los nodos de la red anónima y
+	 * sus enlaces de acceso, instala la pila de red y asigna las direcciones IP.
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red anónima
+	 *
+	 * @param[in] pointToPoint Helper usado para crear todos los enlaces
+	 *
+	 * @param[in] address Helper con la red base a partir de la cual se asignan las direcciones
+	 */
+	void Build(uint32_t numNodes, PointToPointHelper& pointToPoint, Ipv4AddressHelper address);
+
+	/**
+	 * @return Nombre de la topología (Para los mensajes de la simulación)
+	 */
+	virtual std::string GetName() const = 0;
+
+	/**
+	 * @return Cantidad de nodos de la red anónima
+	 */
+	uint32_t GetNodeCount() const;
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return Nodo de la red anónima
+	 */
+	Ptr<Node> GetNode(uint32_t index) const;
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return IP del nodo en su enlace de acceso
+	 */
+	const Ipv4Address& GetAddress(uint32_t index) const;
+
+	/**
+	 * @param[in] index Índice del nodo
+	 *
+	 * @return Dispositivo del nodo en su enlace de acceso
+	 */
+	Ptr<PointToPointNetDevice> GetAccessDevice(uint32_t index) const;
+
+	/**
+	 * @return Enrutadores de la red
+	 */
+	const NodeContainer& GetRouters() const;
+
+	/**
+	 * @return Dispositivos de todos los enrutadores (Enlaces de acceso y troncales)
+	 */
+	const std::vector<Ptr<PointToPointNetDevice> >& GetRouterDevices() const;
+
+	/**
+	 * @return Canales de todos los enlaces, primero los de acceso (En orden de nodo) y luego los troncales
+	 */
+	const std::vector<Ptr<PointToPointChannel> >& GetChannels() const;
+
+protected:
+
+	/**
+	 * Crea los enrutadores de la red y los enlaces troncales entre ellos.
+	 *
+	 * @param[out] routers Contenedor donde se deben crear los enrutadores
+	 *
+	 * @param[in] pointToPoint Helper con el que se deben crear los enlaces troncales
+	 */
+	virtual void CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint) = 0;
+
+	/**
+	 * Indica a cuál enrutador se conecta cada nodo. Por defecto los nodos se reparten en
+	 * bloques contiguos del mismo tamaño entre los enrutadores.
+	 *
+	 * @param[in] index Índice del nodo
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red anónima
+	 *
+	 * @param[in] numRouters Cantidad de enrutadores
+	 *
+	 * @return Índice del enrutador
+	 */
+	virtual uint32_t GetRouterIndex(uint32_t index, uint32_t numNodes, uint32_t numRouters) const;
+
+private:
+
+	NodeContainer m_routers; //!< Enrutadores
+	NodeContainer m_nodes; //!< Nodos de la red anónima
+	std::vector<Ipv4Address> m_addresses; //!< IP de cada nodo
+	std::vector<Ptr<PointToPointNetDevice> > m_accessDevices; //!< Dispositivo de acceso de cada nodo
+	std::vector<Ptr<PointToPointNetDevice> > m_routerDevices; //!< Dispositivos de los enrutadores
+	std::vector<Ptr<PointToPointChannel> > m_channels; //!< Canales de acceso (En orden de nodo) y troncales
+};
+
+/**
+ * Estrella: un único enrutador (HUB) al que se conectan todos los nodos. Es la topología
+ * por defecto y equivale a PointToPointStarHelper.
+ */
+class ArapStarTopology : public ArapTopology {
+public:
+	virtual std::string GetName() const;
+protected:
+	virtual void CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint);
+};
+
+/**
+ * Varias estrellas cuyos HUB forman un anillo (Dos HUB se unen con un solo enlace, lo que
+ * equivale a una topología dumbbell con el enlace troncal como cuello de botella).
+ */
+class ArapMultiHubTopology : public ArapTopology {
+public:
+	/**
+	 * @param[in] numHubs Cantidad de HUB (>= 2)
+	 */
+	ArapMultiHubTopology(uint32_t numHubs);
+	virtual std::string GetName() const;
+protected:
+	virtual void CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint);
+private:
+	uint32_t m_numHubs; //!< Cantidad de HUB
+};
+
+/**
+ * Grilla de enrutadores (PointToPointGridHelper) con los nodos repartidos entre ellos
+ * recorriendo la grilla por filas.
+ */
+class ArapGridTopology : public ArapTopology {
+public:
+	/**
+	 * @param[in] rows Cantidad de filas
+	 *
+	 * @param[in] cols Cantidad de columnas
+	 */
+	ArapGridTopology(uint32_t rows, uint32_t cols);
+	virtual std::string GetName() const;
+protected:
+	virtual void CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint);
+private:
+	uint32_t m_rows; //!< Cantidad de filas
+	uint32_t m_cols; //!< Cantidad de columnas
+};
+
+/**
+ * Red de enrutadores leida de un archivo con el módulo topology-read (Formatos Inet, Orbis
+ * y Rocketfuel). Cada enlace del archivo se crea como un enlace troncal punto a punto.
+ */
+class ArapFileTopology : public ArapTopology {
+public:
+	/**
+	 * @param[in] format Formato del archivo ("Inet", "Orbis" o "Rocketfuel")
+	 *
+	 * @param[in] filename Ruta del archivo
+	 */
+	ArapFileTopology(const std::string& format, const std::string& filename);
+	virtual std::string GetName() const;
+protected:
+	virtual void CreateRouters(NodeContainer& routers, PointToPointHelper& pointToPoint);
+private:
+	std::string m_format; //!< Formato del archivo
+	std::string m_filename; //!< Ruta del archivo
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_TOPOLOGY_H */
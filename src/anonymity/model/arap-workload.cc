@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "arap-workload.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <string.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ArapWorkload");
+
+const char ArapWorkload::WORKLOAD_MAGIC[8] = {'A','R','A','P','W','R','K','1'};
+
+/**
+ * Tamaño en Bytes de cada registro de la traza.
+ */
+static const uint32_t WORKLOAD_RECORD_SIZE = sizeof(int64_t)+3*sizeof(uint32_t);
+
+ArapWorkload::ArapWorkload()
+:m_file(NULL), m_mode(MODE_NONE), m_numNodes(0), m_count(0){
+	m_next.source = 0;
+	m_next.target = 0;
+	m_next.quantity = 0;
+}
+
+ArapWorkload::~ArapWorkload(){
+	Close();
+}
+
+void
+ArapWorkload::OpenRecord(const std::string& filename, uint32_t numNodes){
+	NS_ABORT_MSG_IF(m_file!=NULL,"ERROR: La traza de carga ya esta abierta");
+	m_file = fopen(filename.c_str(),"wb");
+	NS_ABORT_MSG_IF(m_file==NULL,"ERROR: No se pudo crear el archivo de traza de carga "<<filename);
+	setvbuf(m_file,NULL,_IOFBF,WORKLOAD_BUFFER_SIZE);
+	fwrite(WORKLOAD_MAGIC,1,sizeof(WORKLOAD_MAGIC),m_file);
+	fwrite(&numNodes,sizeof(uint32_t),1,m_file);
+	m_mode = MODE_RECORD;
+	m_numNodes = numNodes;
+	m_count = 0;
+}
+
+void
+ArapWorkload::OpenReplay(const std::string& filename, uint32_t numNodes, DispatchCallback dispatch){
+	NS_ABORT_MSG_IF(m_file!=NULL,"ERROR: La traza de carga ya esta abierta");
+	uint64_t records = 0;
+	switch(Check(filename,numNodes,records)){
+	case STATUS_NO_FILE:
+		NS_ABORT_MSG("ERROR: No se pudo leer el archivo de traza de carga "<<filename);
+		break;
+	case STATUS_BAD_HEADER:
+		NS_ABORT_MSG("ERROR: "<<filename<<" no es un archivo de traza de carga");
+		break;
+	case STATUS_NODES:
+		NS_ABORT_MSG("ERROR: La traza de carga "<<filename<<" no es de una red de "<<numNodes<<" nodos");
+		break;
+	case STATUS_UNORDERED:
+		NS_ABORT_MSG("ERROR: La traza de carga no esta ordenada por tiempo (Registro "<<records<<")");
+		break;
+	case STATUS_OUT_OF_RANGE:
+		NS_ABORT_MSG("ERROR: Registro "<<records<<" de la traza de carga con un nodo fuera de rango");
+		break;
+	default:
+		break;
+	}
+	m_file = fopen(filename.c_str(),"rb");
+	NS_ABORT_MSG_IF(m_file==NULL,"ERROR: No se pudo leer el archivo de traza de carga "<<filename);
+	setvbuf(m_file,NULL,_IOFBF,WORKLOAD_BUFFER_SIZE);
+	ReadHeader(m_file,numNodes);
+	NS_LOG_INFO("Traza de carga "<<filename<<" con "<<records<<" envios");
+	m_mode = MODE_REPLAY;
+	m_numNodes = numNodes;
+	m_dispatch = dispatch;
+	m_next.time = Simulator::Now();
+	m_count = 0;
+	ScheduleNext();
+}
+
+ArapWorkload::Status
+ArapWorkload::Check(const std::string& filename, uint32_t numNodes, uint64_t& records){
+	records = 0;
+	FILE* file = fopen(filename.c_str(),"rb");
+	if(file==NULL)
+		return STATUS_NO_FILE;
+	setvbuf(file,NULL,_IOFBF,WORKLOAD_BUFFER_SIZE);
+	Status status = ReadHeader(file,numNodes);
+	Entry entry;
+	entry.time = Time(0);
+	while(status==STATUS_OK){
+		status = ReadEntry(file,numNodes,entry.time,entry);
+		if(status==STATUS_OK)
+			records++;
+	}
+	fclose(file);
+	return (status==STATUS_END) ? STATUS_OK : status;
+}
+
+ArapWorkload::Status
+ArapWorkload::ReadHeader(FILE* file, uint32_t numNodes){
+	char magic[sizeof(WORKLOAD_MAGIC)];
+	uint32_t savedNodes = 0;
+	if(fread(magic,1,sizeof(magic),file)!=sizeof(magic) || memcmp(magic,WORKLOAD_MAGIC,sizeof(WORKLOAD_MAGIC))!=0
+			|| fread(&savedNodes,sizeof(uint32_t),1,file)!=1)
+		return STATUS_BAD_HEADER;
+	return (savedNodes==numNodes) ? STATUS_OK : STATUS_NODES;
+}
+
+ArapWorkload::Status
+ArapWorkload::ReadEntry(FILE* file, uint32_t numNodes, const Time& previous, Entry& entry){
+	char record[WORKLOAD_RECORD_SIZE];
+	if(fread(record,1,WORKLOAD_RECORD_SIZE,file)!=WORKLOAD_RECORD_SIZE)
+		return STATUS_END;
+	int64_t time;
+	uint32_t offset = 0;
+	memcpy(&time,record+offset,sizeof(int64_t));
+	offset+=sizeof(int64_t);
+	memcpy(&entry.source,record+offset,sizeof(uint32_t));
+	offset+=sizeof(uint32_t);
+	memcpy(&entry.target,record+offset,sizeof(uint32_t));
+	offset+=sizeof(uint32_t);
+	memcpy(&entry.quantity,record+offset,sizeof(uint32_t));
+	if(Time(time)<previous)
+		return STATUS_UNORDERED;
+	if(entry.source>=numNodes || entry.target>=numNodes)
+		return STATUS_OUT_OF_RANGE;
+	entry.time = Time(time);
+	return STATUS_OK;
+}
+
+void
+ArapWorkload::Record(uint32_t source, uint32_t target, uint32_t quantity){
+	if(m_mode!=MODE_RECORD)
+		return;
+	char record[WORKLOAD_RECORD_SIZE];
+	int64_t time = Simulator::Now().GetTimeStep();
+	uint32_t offset = 0;
+	memcpy(record+offset,&time,sizeof(int64_t));
+	offset+=sizeof(int64_t);
+	memcpy(record+offset,&source,sizeof(uint32_t));
+	offset+=sizeof(uint32_t);
+	memcpy(record+offset,&target,sizeof(uint32_t));
+	offset+=sizeof(uint32_t);
+	memcpy(record+offset,&quantity,sizeof(uint32_t));
+	fwrite(record,1,WORKLOAD_RECORD_SIZE,m_file);
+	m_count++;
+}
+
+bool
+ArapWorkload::ScheduleNext(){
+	Status status = ReadEntry(m_file,m_numNodes,m_next.time,m_next);
+	if(status==STATUS_END){
+		NS_LOG_INFO("Fin de la traza de carga, "<<m_count<<" envios reproducidos");
+		return false;
+	}
+	//OpenReplay() ya verificó la traza completa, solo falla si el archivo cambió
+	NS_ABORT_MSG_IF(status!=STATUS_OK,"ERROR: Registro invalido en la traza de carga");
+	m_event = Simulator::Schedule(m_next.time-Simulator::Now(),&ArapWorkload::Dispatch,this);
+	return true;
+}
+
+void
+ArapWorkload::Dispatch(){
+	m_count++;
+	m_dispatch(m_next.source,m_next.target,m_next.quantity);
+	ScheduleNext();
+}
+
+void
+ArapWorkload::Close(){
+	if(m_file==NULL)
+		return;
+	Simulator::Cancel(m_event);
+	fclose(m_file);
+	m_file = NULL;
+	m_dispatch = DispatchCallback();
+}
+
+ArapWorkload::Mode
+ArapWorkload::GetMode() const{
+	return m_mode;
+}
+
+uint64_t
+ArapWorkload::GetCount() const{
+	return m_count;
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ARAP_WORKLOAD_H
+#define ARAP_WORKLOAD_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * Tamaño en Bytes del buffer de lectura y escritura del archivo de la traza de carga.
+ */
+#define WORKLOAD_BUFFER_SIZE 65536
+
+namespace ns3 {
+
+/**
+ * Traza de la carga de la simulación: los envíos de hormigas de carga de todos los nodos
+ * (Instante, origen, destino, cantidad), para repetir exactamente el mismo tráfico en
+ * simulaciones con otra configuración (Por ejemplo otro ArapPathManager, que consume los
+ * valores aleatorios en otro orden).
+ *
+ * Al grabar se agrega un registro por cada envío en el instante en que se realiza, por lo que
+ * el archivo queda ordenado por tiempo. Al reproducir los envíos se leen de a uno: siempre hay
+ * un solo evento programado (El del próximo envío), de modo que la memoria usada no depende de
+ * la duración de la traza, y los nodos no piden valores a sus distribuciones de carga.
+ *
+ * Formato del archivo: cabecera WORKLOAD_MAGIC, cantidad de nodos (uint32) y un registro de
+ * 20 Bytes por envío: <instante (int64, pasos de Time)> <índice del origen (uint32)>
+ * <índice del destino (uint32)> <cantidad (uint32)>. Los números se escriben en el orden de
+ * Bytes del host (Igual que el formato binario de ArapPathLogger), por lo que una traza solo se
+ * puede reproducir en una arquitectura con el mismo orden de Bytes que la que la grabó.
+ *
+ * @see PARAM_WORKLOAD
+ */
+class ArapWorkload {
+
+public:
+
+	/**
+	 * Uso de la traza en la simulación.
+	 */
+	enum Mode{MODE_NONE, MODE_RECORD, MODE_REPLAY};
+
+	/**
+	 * Resultado de la verificación de una traza.
+	 */
+	enum Status{STATUS_OK, STATUS_END, STATUS_NO_FILE, STATUS_BAD_HEADER, STATUS_NODES, STATUS_UNORDERED, STATUS_OUT_OF_RANGE};
+
+	/**
+	 * Cabecera con la que inicia todo archivo de traza de carga.
+	 */
+	static const char WORKLOAD_MAGIC[8];
+
+	/**
+	 * Callback que realiza un envío reproducido: origen, destino y cantidad de hormigas.
+	 */
+	typedef Callback<void,uint32_t,uint32_t,uint32_t> DispatchCallback;
+
+	ArapWorkload();
+	~ArapWorkload();
+
+	/**
+	 * Crea el archivo de la traza para grabar los envíos.
+	 *
+	 * @param[in] filename Nombre del archivo (Se sobreescribe)
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red
+	 */
+	void OpenRecord(const std::string& filename, uint32_t numNodes);
+
+	/**
+	 * Abre una traza y programa su primer envío.
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red (Debe ser la de la traza)
+	 *
+	 * @param[in] dispatch Callback que realiza cada envío
+	 */
+	void OpenReplay(const std::string& filename, uint32_t numNodes, DispatchCallback dispatch);
+
+	/**
+	 * Verifica una traza completa sin reproducirla: la cabecera, la cantidad de nodos y que los
+	 * registros estén ordenados por tiempo y tengan nodos dentro de la red. OpenReplay() la usa
+	 * para rechazar una traza inválida antes de iniciar la simulación.
+	 *
+	 * @param[in] filename Nombre del archivo
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red
+	 *
+	 * @param[out] records Cantidad de registros válidos leídos
+	 *
+	 * @return STATUS_OK si la traza se puede reproducir, o el primer error encontrado
+	 */
+	static Status Check(const std::string& filename, uint32_t numNodes, uint64_t& records);
+
+	/**
+	 * Graba un envío en el instante actual (Solo en MODE_RECORD).
+	 *
+	 * @param[in] source Índice del nodo origen
+	 *
+	 * @param[in] target Índice del nodo destino
+	 *
+	 * @param[in] quantity Cantidad de hormigas
+	 */
+	void Record(uint32_t source, uint32_t target, uint32_t quantity);
+
+	/**
+	 * Cancela el próximo envío y cierra el archivo.
+	 */
+	void Close();
+
+	/**
+	 * @return Uso de la traza en la simulación
+	 */
+	Mode GetMode() const;
+
+	/**
+	 * @return Cantidad de envíos grabados o reproducidos
+	 */
+	uint64_t GetCount() const;
+
+private:
+
+	/**
+	 * Registro de un envío.
+	 */
+	struct Entry {
+		Time time; //!< Instante del envío
+		uint32_t source; //!< Índice del nodo origen
+		uint32_t target; //!< Índice del nodo destino
+		uint32_t quantity; //!< Cantidad de hormigas
+	};
+
+	/**
+	 * Lee la cabecera de una traza.
+	 *
+	 * @param[in] file Archivo de la traza, al inicio
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red
+	 *
+	 * @return STATUS_OK, STATUS_BAD_HEADER o STATUS_NODES
+	 */
+	static Status ReadHeader(FILE* file, uint32_t numNodes);
+
+	/**
+	 * Lee un registro de la traza.
+	 *
+	 * @param[in] file Archivo de la traza
+	 *
+	 * @param[in] numNodes Cantidad de nodos de la red
+	 *
+	 * @param[in] previous Instante del registro anterior
+	 *
+	 * @param[out] entry Registro leído
+	 *
+	 * @return STATUS_OK, STATUS_UNORDERED, STATUS_OUT_OF_RANGE, o STATUS_END si la traza terminó
+	 */
+	static Status ReadEntry(FILE* file, uint32_t numNodes, const Time& previous, Entry& entry);
+
+	/**
+	 * Lee el próximo registro y programa su envío.
+	 *
+	 * @return false si la traza terminó
+	 */
+	bool ScheduleNext();
+
+	/**
+	 * Realiza el envío leído y programa el siguiente.
+	 */
+	void Dispatch();
+
+	FILE* m_file; //!< Archivo de la traza
+	Mode m_mode; //!< Uso de la traza
+	uint32_t m_numNodes; //!< Cantidad de nodos de la red
+	DispatchCallback m_dispatch; //!< Realiza los envíos reproducidos
+	Entry m_next; //!< Envío programado
+	EventId m_event; //!< Evento del envío programado
+	uint64_t m_count; //!< Envíos grabados o reproducidos
+};
+
+} /* namespace ns3 */
+
+#endif /* ARAP_WORKLOAD_H */
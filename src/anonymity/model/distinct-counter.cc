@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "distinct-counter.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DistinctCounter");
+
+/**
+ * Mezcla los bits de un valor (Finalizador de SplitMix64), para que los registros reciban
+ * bits uniformes aunque el valor venga de un hash de calidad pobre.
+ *
+ * @param[in] value Valor
+ *
+ * @return Valor mezclado
+ */
+static uint64_t
+Mix(uint64_t value){
+	value = (value^(value>>30))*0xbf58476d1ce4e5b9ULL;
+	value = (value^(value>>27))*0x94d049bb133111ebULL;
+	return value^(value>>31);
+}
+
+DistinctCounter::DistinctCounter(){
+}
+
+DistinctCounter::~DistinctCounter(){
+}
+
+void
+DistinctCounter::Add(uint64_t value){
+	if(!m_registers.empty()){
+		AddToRegisters(value);
+		return;
+	}
+	std::vector<uint64_t>::iterator it = std::lower_bound(m_values.begin(),m_values.end(),value);
+	if(it!=m_values.end() && *it==value)
+		return;
+	m_values.insert(it,value);
+	if(m_values.size()>DISTINCT_EXACT_LIMIT)
+		ConvertToRegisters();
+}
+
+void
+DistinctCounter::ConvertToRegisters(){
+	m_registers.assign(1<<DISTINCT_PRECISION,0);
+	for(uint32_t i=0;i<m_values.size();i++)
+		AddToRegisters(m_values[i]);
+	std::vector<uint64_t>().swap(m_values); //Libera la memoria de los valores exactos
+}
+
+void
+DistinctCounter::AddToRegisters(uint64_t value){
+	uint64_t hash = Mix(value);
+	uint32_t index = hash>>(64-DISTINCT_PRECISION);
+	uint64_t rest = hash<<DISTINCT_PRECISION;
+	uint8_t rank = 1; //Posición del primer bit en 1 de los restantes (64-DISTINCT_PRECISION)
+	while(rank<=64-DISTINCT_PRECISION && (rest & (1ULL<<63))==0){
+		rest <<= 1;
+		rank++;
+	}
+	if(rank>m_registers[index])
+		m_registers[index] = rank;
+}
+
+uint64_t
+DistinctCounter::GetCount() const{
+	if(m_registers.empty())
+		return m_values.size();
+	double m = m_registers.size();
+	double sum = 0;
+	uint32_t zeros = 0;
+	for(uint32_t i=0;i<m_registers.size();i++){
+		sum += std::ldexp(1.0,-m_registers[i]);
+		if(m_registers[i]==0)
+			zeros++;
+	}
+	double estimate = 0.7213/(1+1.079/m)*m*m/sum;
+	if(estimate<=2.5*m && zeros>0) //Pocos valores: conteo lineal
+		estimate = m*std::log(m/zeros);
+	return (uint64_t)(estimate+0.5);
+}
+
+bool
+DistinctCounter::IsExact() const{
+	return m_registers.empty();
+}
+
+} /* namespace ns3 */
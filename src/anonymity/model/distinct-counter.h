@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef DISTINCT_COUNTER_H
+#define DISTINCT_COUNTER_H
+
+#include <stdint.h>
+#include <vector>
+
+#define DISTINCT_PRECISION 10 //!< Bits del hash que eligen el registro de un DistinctCounter (2^10 registros, error estándar ~3.3%)
+#define DISTINCT_EXACT_LIMIT 128 //!< Valores distintos que un DistinctCounter guarda exactos antes de pasar a la estimación
+
+namespace ns3 {
+
+/**
+ * Cuenta la cantidad de valores distintos de una secuencia con memoria acotada (HyperLogLog).
+ *
+ * Mientras hay a lo sumo DISTINCT_EXACT_LIMIT valores distintos se guardan ordenados y el conteo
+ * es exacto. Al superarse, se pasa a 2^DISTINCT_PRECISION registros de un byte: los primeros
+ * DISTINCT_PRECISION bits del hash mezclado eligen el registro, que guarda la máxima posición
+ * del primer bit en 1 del resto. El conteo se estima con la media armónica de los registros
+ * (Con la corrección por conteo lineal para pocos valores), con un error estándar de
+ * 1.04/sqrt(2^DISTINCT_PRECISION). En ambos casos la memoria no supera 1 KB.
+ */
+class DistinctCounter {
+public:
+	DistinctCounter();
+	~DistinctCounter();
+
+	/**
+	 * Agrega un valor.
+	 *
+	 * @param[in] value Valor (Por ejemplo el hash de un camino)
+	 */
+	void Add(uint64_t value);
+
+	/**
+	 * @return Cantidad de valores distintos agregados (Exacta hasta DISTINCT_EXACT_LIMIT,
+	 * estimada a partir de ahí)
+	 */
+	uint64_t GetCount() const;
+
+	/**
+	 * @return true si el conteo es exacto, false si es una estimación
+	 */
+	bool IsExact() const;
+
+private:
+
+	/**
+	 * Pasa de los valores exactos a los registros.
+	 */
+	void ConvertToRegisters();
+
+	/**
+	 * Cuenta un valor en los registros.
+	 *
+	 * @param[in] value Valor
+	 */
+	void AddToRegisters(uint64_t value);
+
+	std::vector<uint64_t> m_values; //!< Valores distintos ordenados (Solo en modo exacto)
+	std::vector<uint8_t> m_registers; //!< Registros de HyperLogLog (Vacío en modo exacto)
+};
+
+} /* namespace ns3 */
+
+#endif /* DISTINCT_COUNTER_H */
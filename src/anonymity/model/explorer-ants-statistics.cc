@@ -34,6 +34,24 @@ ExplorerAntsStatistics::UpdateModel(const int64_t rtt){
 	}
 }
 
+void
+ExplorerAntsStatistics::Serialize(std::ostream& out) const{
+	out.write((const char*)&m_mean,sizeof(double));
+	out.write((const char*)&m_variance,sizeof(double));
+	out.write((const char*)&m_WBest,sizeof(int64_t));
+	out.write((const char*)&m_WCount,sizeof(uint32_t));
+}
+
+void
+ExplorerAntsStatistics::Deserialize(std::istream& in){
+	in.read((char*)&m_mean,sizeof(double));
+	in.read((char*)&m_variance,sizeof(double));
+	in.read((char*)&m_WBest,sizeof(int64_t));
+	in.read((char*)&m_WCount,sizeof(uint32_t));
+	if(m_WCount>m_WMax) //Estado guardado con una ventana mayor
+		m_WCount = m_WMax;
+}
+
 const double
 ExplorerAntsStatistics::GetMean() const{
 	return m_mean;
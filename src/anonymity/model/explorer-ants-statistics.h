@@ -4,6 +4,7 @@
 #define EXPLORER_ANTS_STATISTICS_H
 
 #include"ns3/nstime.h"
+#include <iostream>
 
 #define DEFAULT_WBEST 10000000 //!< Valor ṕor defecto de WBest (Debe ser un valor muy grande)
 
@@ -61,6 +62,21 @@ public:
 	 */
 	void UpdateModel(const int64_t rtt);
 
+	/**
+	 * Guarda el estado aprendido del modelo (Media, varianza y ventana de observación) en binario.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	void Serialize(std::ostream& out) const;
+
+	/**
+	 * Restaura el estado guardado con Serialize(). Los parámetros del modelo (wMax y varsigma)
+	 * no se modifican.
+	 *
+	 * @param[in] in Flujo de entrada binario
+	 */
+	void Deserialize(std::istream& in);
+
 private:
 
 	double m_mean; //!< Media de la distribución
@@ -0,0 +1,38 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "explorer-scheduler-factory.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ExplorerSchedulerFactory");
+
+ExplorerSchedulerFactory::ExplorerSchedulerFactory(){
+}
+
+ExplorerSchedulerFactory::~ExplorerSchedulerFactory(){
+}
+
+ArapExplorerScheduler*
+ExplorerSchedulerFactory::GetInstance(const std::string& caseName, std::istringstream& iss){
+	if(caseName=="inundacion"){
+		return new FloodExplorerScheduler();
+	}
+	else if(caseName=="presupuesto"){
+		double budget;
+		double jitter = DEFAULT_EXPLORER_JITTER;
+		if(!(iss>>budget))
+			NS_ABORT_MSG("ERROR: Debe indicar la cantidad de exploradoras por segundo del planificador presupuesto");
+		if(!(iss>>jitter))
+			jitter = DEFAULT_EXPLORER_JITTER;
+		return new BudgetExplorerScheduler(budget,jitter);
+	}
+	/*Aqui se agrega otro caso cuando se desee extender ArapExplorerScheduler
+	else if(caseName==<Identificador de caso nuevo>){
+		... <Definicion del caso>
+	}*/
+	else
+		return NULL;
+}
+} /* namespace ns3 */
@@ -0,0 +1,38 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef EXPLORER_SCHEDULER_FACTORY_H
+#define EXPLORER_SCHEDULER_FACTORY_H
+
+#include "arap-explorer-scheduler.h"
+#include <sstream>
+
+namespace ns3 {
+
+/**
+ * Fábrica de objetos que heredan de ArapExplorerScheduler, permite seleccionar el planificador
+ * de hormigas exploradoras y leer sus parámetros desde el archivo de parámetros (Ver
+ * PARAM_EXPLORER_SCHEDULER).
+ *
+ * Para agregar un nuevo planificador solo se debe crear una nueva clase que herede de
+ * ArapExplorerScheduler y definir su caso en el método ExplorerSchedulerFactory::GetInstance(),
+ * con el orden de lectura de sus parámetros.
+ */
+class ExplorerSchedulerFactory {
+
+public:
+	ExplorerSchedulerFactory();
+	~ExplorerSchedulerFactory();
+
+	/**
+	 * Crea las instancias de las especializaciones de ArapExplorerScheduler
+	 * @param[in] caseName Identificador del caso para el cual se creará el planificador
+	 * @param[in] iss Flujo de datos de donde se leeran los parámetros del caso (De tenerlos)
+	 *
+	 * @return Puntero a un nuevo objeto creado según el caso indicado, o NULL si el caso no
+	 * existe. La memoria debe ser liberada por ArapSimulator
+	 */
+	ArapExplorerScheduler* GetInstance(const std::string& caseName, std::istringstream& iss);
+};
+} /* namespace ns3 */
+
+#endif /* EXPLORER_SCHEDULER_FACTORY_H */
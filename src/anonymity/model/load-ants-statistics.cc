@@ -9,55 +9,104 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LoadAntsStatistics");
 
+LoadAntsStatistics::TargetStatistics::TargetStatistics()
+:numSamples(0), mean(0), m2(0){
+}
+
+double
+LoadAntsStatistics::TargetStatistics::GetVariance() const{
+	return (numSamples==0) ? 0 : m2/numSamples;
+}
+
 LoadAntsStatistics::LoadAntsStatistics()
-:m_sumDelay(0), m_sumDelaySquare(0), m_numSamples(0){
+:m_mean(0), m_m2(0), m_numSamples(0){
 }
 
 LoadAntsStatistics::~LoadAntsStatistics(){
 }
 
+void
+LoadAntsStatistics::UpdateMoments(uint64_t& numSamples, double& mean, double& m2, const double value){
+	numSamples++;
+	double delta = value-mean;
+	mean = mean+delta/numSamples;
+	m2 = m2+delta*(value-mean);
+}
+
 void
 LoadAntsStatistics::UpdateModel(const double rtt, const Ipv4Address& target){
-	m_numSamples++;
-	m_sumDelay = m_sumDelay + rtt;
-	m_sumDelaySquare = m_sumDelaySquare + (rtt*rtt);
-	uint64_t sampleCount = m_samplesCount[target];
-	m_samplesCount[target] =++sampleCount;
+	UpdateMoments(m_numSamples,m_mean,m_m2,rtt);
+	TargetStatistics& targetStats = m_targets[target];
+	UpdateMoments(targetStats.numSamples,targetStats.mean,targetStats.m2,rtt);
+	targetStats.sketch.Add(rtt);
 }
 
 void
 LoadAntsStatistics::InitializeTable(){
-	const PointToPointStarHelper& star = ArapSimulator::GetStar();
-	for(uint32_t i=0; i<star.SpokeCount();i++){
-		Ptr<ArapNode> app = DynamicCast<ArapNode>(star.GetSpokeNode(i)->GetApplication(0));
-		m_samplesCount.insert(std::pair<Ipv4Address,uint64_t>(app->GetLocalIP(),0)); //Inicializar todos los valores en 0
+	const ArapNodeDirectory& directory = ArapSimulator::GetDirectory();
+	for(uint32_t i=0; i<directory.GetCount();i++){
+		m_targets.insert(std::pair<Ipv4Address,TargetStatistics>(directory.GetAddress(i),TargetStatistics())); //Inicializar todos los valores en 0
+	}
+}
+
+const std::map<Ipv4Address,LoadAntsStatistics::TargetStatistics>&
+LoadAntsStatistics::GetTargetsMap() const{
+	return m_targets;
+}
+
+void
+LoadAntsStatistics::Serialize(std::ostream& out) const{
+	uint32_t targets = m_targets.size();
+	out.write((const char*)&m_numSamples,sizeof(uint64_t));
+	out.write((const char*)&m_mean,sizeof(double));
+	out.write((const char*)&m_m2,sizeof(double));
+	out.write((const char*)&targets,sizeof(uint32_t));
+	for (std::map<Ipv4Address,TargetStatistics>::const_iterator it = m_targets.begin();it!=m_targets.end(); it++){
+		uint32_t ip = it->first.Get();
+		out.write((const char*)&ip,sizeof(uint32_t));
+		out.write((const char*)&it->second.numSamples,sizeof(uint64_t));
+		out.write((const char*)&it->second.mean,sizeof(double));
+		out.write((const char*)&it->second.m2,sizeof(double));
+		it->second.sketch.Serialize(out);
+	}
+}
+
+void
+LoadAntsStatistics::Deserialize(std::istream& in){
+	uint32_t targets = 0;
+	in.read((char*)&m_numSamples,sizeof(uint64_t));
+	in.read((char*)&m_mean,sizeof(double));
+	in.read((char*)&m_m2,sizeof(double));
+	in.read((char*)&targets,sizeof(uint32_t));
+	m_targets.clear();
+	for(uint32_t i=0;i<targets && in.good();i++){
+		uint32_t ip = 0;
+		in.read((char*)&ip,sizeof(uint32_t));
+		TargetStatistics& targetStats = m_targets[Ipv4Address(ip)];
+		in.read((char*)&targetStats.numSamples,sizeof(uint64_t));
+		in.read((char*)&targetStats.mean,sizeof(double));
+		in.read((char*)&targetStats.m2,sizeof(double));
+		targetStats.sketch.Deserialize(in);
 	}
 }
 
-const std::map<Ipv4Address,uint64_t>&
-LoadAntsStatistics::GetSampleCountsMap() const{
-	return m_samplesCount;
+void
+LoadAntsStatistics::GetSketch(QuantileSketch& sketch) const{
+	for (std::map<Ipv4Address,TargetStatistics>::const_iterator it = m_targets.begin();it!=m_targets.end(); it++)
+		sketch.Merge(it->second.sketch);
 }
 
 const double
 LoadAntsStatistics::GetMean() const{
-	if(m_numSamples==0)
-		return 0;
-	else
-		return m_sumDelay/m_numSamples;
+	return m_mean;
 }
 
 const double
 LoadAntsStatistics::GetVariance() const{
 	if(m_numSamples==0)
 		return 0;
-	else{
-		double squareXHope = m_sumDelaySquare/m_numSamples; //Esperanza de X^2 (E(X²))
-		double mean = GetMean();
-		double xHopeSquare = mean*mean; //Esperanza al cuadrado de X([E(X)]²)
-
-		return squareXHope - xHopeSquare;
-	}
+	else
+		return m_m2/m_numSamples; //Varianza poblacional, igual que E(X²)-[E(X)]²
 }
 
 const uint64_t
@@ -5,17 +5,40 @@
 
 #include <stdint.h>
 #include <map>
+#include <iostream>
 #include "ns3/ipv4-address.h"
+#include "ns3/quantile-sketch.h"
 
 namespace ns3 {
 
 /**
  * Modelo estocástico usado por los nodos para mantener
- * la media y la varianza de los delay generados por las
- * hormigas de carga.
+ * la media, la varianza y los cuantiles de los delay generados
+ * por las hormigas de carga, en total y por cada nodo destino.
+ *
+ * La media y la varianza se actualizan con el método de Welford (Numéricamente estable
+ * aunque la cantidad de muestras sea muy grande), y los cuantiles se estiman con un
+ * QuantileSketch por destino, de memoria acotada.
  */
 class LoadAntsStatistics {
 public:
+
+	/**
+	 * Estadísticas de los delay hacia un nodo destino.
+	 */
+	struct TargetStatistics {
+		TargetStatistics();
+		uint64_t numSamples; //!< Cantidad de hormigas de carga enviadas al destino
+		double mean; //!< Media de los delay (Welford)
+		double m2; //!< Suma de los cuadrados de las diferencias con la media (Welford)
+		QuantileSketch sketch; //!< Resumen para estimar los cuantiles de los delay
+
+		/**
+		 * @return La varianza de los delay hacia el destino.
+		 */
+		double GetVariance() const;
+	};
+
 	LoadAntsStatistics();
 	~LoadAntsStatistics();
 
@@ -34,12 +57,19 @@ public:
 	 */
 	const uint64_t GetNumSamples() const;
 
+	/**
+	 * Combina los resúmenes de todos los destinos.
+	 *
+	 * @param[out] sketch Resumen donde se agregan los delay hacia todos los destinos
+	 */
+	void GetSketch(QuantileSketch& sketch) const;
+
 	/**
 	 * Actualizar modelo estocástico.
 	 *
 	 * Se recibe un nuevo valor (Una muestra) y con este se actualizan las variables del modelo
 	 *
-	 * @param[in] rtt Tiempo de ida y vuelta de la hormiga de carga (En milisegundos)
+	 * @param[in] rtt Tiempo de ida y vuelta de la hormiga de carga (En segundos)
 	 *
 	 * @param[in] target IP del nodo final al que fue enviado la hormiga.
 	 */
@@ -52,16 +82,43 @@ public:
 	void InitializeTable();
 
 	/**
-	 * @return Referencia a el mapa que contiene los valores de las hormigas de carga enviadas a cada nodo
+	 * @return Referencia a el mapa que contiene las estadísticas de las hormigas de carga enviadas a cada nodo
+	 */
+	const std::map<Ipv4Address,TargetStatistics>& GetTargetsMap() const;
+
+	/**
+	 * Guarda en binario las estadísticas totales y las de cada destino.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	void Serialize(std::ostream& out) const;
+
+	/**
+	 * Reemplaza las estadísticas por las guardadas con Serialize().
+	 *
+	 * @param[in] in Flujo de entrada binario
 	 */
-	const std::map<Ipv4Address,uint64_t>& GetSampleCountsMap() const;
+	void Deserialize(std::istream& in);
 
 private:
 
-	double m_sumDelay; //!< Suma de los delays obtenidos
-	double m_sumDelaySquare; //!< Suma de los cuadrados de los delays obtenidos
+	/**
+	 * Agrega una muestra a la media y la varianza con el método de Welford.
+	 *
+	 * @param[in,out] numSamples Cantidad de muestras
+	 *
+	 * @param[in,out] mean Media
+	 *
+	 * @param[in,out] m2 Suma de los cuadrados de las diferencias con la media
+	 *
+	 * @param[in] value Nueva muestra
+	 */
+	static void UpdateMoments(uint64_t& numSamples, double& mean, double& m2, const double value);
+
+	double m_mean; //!< Media de los delays obtenidos (Welford)
+	double m_m2; //!< Suma de los cuadrados de las diferencias con la media (Welford)
 	uint64_t m_numSamples; //!< Contador de la cantidad de muestras (delays) obtenidas
-	std::map<Ipv4Address,uint64_t>  m_samplesCount; //!< Mapa de cantidad de hormigas enviadas a cada nodo
+	std::map<Ipv4Address,TargetStatistics>  m_targets; //!< Mapa de estadísticas de las hormigas enviadas a cada nodo
 
 };
 
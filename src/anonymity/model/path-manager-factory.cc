@@ -2,6 +2,7 @@
 
 #include "path-manager-factory.h"
 #include "smart-path-manager.h"
+#include "sparse-path-manager.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -32,6 +33,24 @@ PathManagerFactory::GetInstance(const std::string& caseName, std::istringstream&
 		 */
 			return new SmartPathManager();
 		}
+	else if(caseName=="SparsePathManager"){
+		/* Tabla dispersa: cantidad de candidatos y periodo de rotacion, seguidos de
+		 * los parametros de SmartPathManager en el mismo orden
+		 */
+		double c1, c2, zeta,varsigma;
+		uint32_t candidates, rotation, wMax;
+		iss>>candidates>>rotation>>c1>>c2>>zeta>>wMax>>varsigma;
+		return new SparsePathManager(candidates,rotation,c1,c2,zeta,wMax,varsigma);
+	}
+	else if(caseName=="SparsePathManagerDefault"){
+		//Tabla dispersa con los valores por defecto de SmartPathManager
+		uint32_t candidates = DEFAULT_SPARSE_CANDIDATES, rotation = DEFAULT_SPARSE_ROTATION;
+		if(iss>>candidates)
+			iss>>rotation;
+		if(iss.fail())
+			rotation = DEFAULT_SPARSE_ROTATION;
+		return new SparsePathManager(candidates,rotation,DEFAULT_C1,DEFAULT_C2,DEFAULT_ZETA,DEFAULT_WMAX,DEFAULT_VARSIGMA);
+	}
 	/*Aqui se agrega otro caso cuando se desee extender esta clase especializando una nueva de ArapPathManager
 	else if(className==<Identificador de caso nuevo>){
 		... <Definicion del caso>
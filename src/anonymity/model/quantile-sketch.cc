@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "quantile-sketch.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuantileSketch");
+
+QuantileSketch::QuantileSketch()
+:m_count(0), m_zeroCount(0), m_offset(0){
+}
+
+QuantileSketch::~QuantileSketch(){
+}
+
+double
+QuantileSketch::GetLogGamma(){
+	static const double logGamma = std::log((1+SKETCH_RELATIVE_ACCURACY)/(1-SKETCH_RELATIVE_ACCURACY));
+	return logGamma;
+}
+
+void
+QuantileSketch::Add(double value){
+	m_count++;
+	if(value<=SKETCH_MIN_VALUE){
+		m_zeroCount++;
+		return;
+	}
+	int32_t index = (int32_t)std::ceil(std::log(value)/GetLogGamma());
+	m_buckets[Reserve(index)]++;
+}
+
+uint32_t
+QuantileSketch::Reserve(int32_t index){
+	if(m_buckets.empty()){
+		m_offset = index;
+		m_buckets.assign(1,0);
+		return 0;
+	}
+	int32_t high = m_offset+(int32_t)m_buckets.size()-1;
+	if(index>=m_offset && index<=high)
+		return index-m_offset;
+
+	/* El rango cambia: se copian las cubetas al nuevo arreglo, y si este supera
+	 * el maximo las cubetas por debajo del nuevo limite inferior se suman a él
+	 */
+	int32_t newLow = std::min(index,m_offset);
+	int32_t newHigh = std::max(index,high);
+	if(newHigh-newLow+1>SKETCH_MAX_BUCKETS)
+		newLow = newHigh-SKETCH_MAX_BUCKETS+1;
+	std::vector<uint32_t> buckets(newHigh-newLow+1,0);
+	for(uint32_t i=0;i<m_buckets.size();i++)
+		buckets[std::max(m_offset+(int32_t)i,newLow)-newLow] += m_buckets[i];
+	m_buckets.swap(buckets);
+	m_offset = newLow;
+	return std::max(index,newLow)-newLow;
+}
+
+void
+QuantileSketch::Merge(const QuantileSketch& other){
+	m_count += other.m_count;
+	m_zeroCount += other.m_zeroCount;
+	if(other.m_buckets.empty())
+		return;
+	//Primero se amplia el rango a los extremos del otro resumen, asi el arreglo se copia a lo sumo dos veces
+	Reserve(other.m_offset+(int32_t)other.m_buckets.size()-1);
+	Reserve(other.m_offset);
+	for(uint32_t i=0;i<other.m_buckets.size();i++){
+		if(other.m_buckets[i]>0)
+			m_buckets[Reserve(other.m_offset+(int32_t)i)] += other.m_buckets[i];
+	}
+}
+
+double
+QuantileSketch::GetQuantile(double q) const{
+	if(m_count==0)
+		return 0;
+	double rank = q*(m_count-1);
+	uint64_t cumulative = m_zeroCount;
+	if(rank<cumulative)
+		return 0;
+	double gamma = std::exp(GetLogGamma());
+	for(uint32_t i=0;i<m_buckets.size();i++){
+		cumulative += m_buckets[i];
+		if(cumulative>rank || i+1==m_buckets.size()){
+			//Punto de la cubeta con el mismo error relativo hacia ambos extremos
+			return 2*std::pow(gamma,m_offset+(int32_t)i)/(gamma+1);
+		}
+	}
+	return 0;
+}
+
+uint64_t
+QuantileSketch::GetCount() const{
+	return m_count;
+}
+
+void
+QuantileSketch::Serialize(std::ostream& out) const{
+	uint32_t size = m_buckets.size();
+	out.write((const char*)&m_count,sizeof(uint64_t));
+	out.write((const char*)&m_zeroCount,sizeof(uint64_t));
+	out.write((const char*)&m_offset,sizeof(int32_t));
+	out.write((const char*)&size,sizeof(uint32_t));
+	if(size>0)
+		out.write((const char*)&m_buckets[0],size*sizeof(uint32_t));
+}
+
+void
+QuantileSketch::Deserialize(std::istream& in){
+	uint32_t size = 0;
+	in.read((char*)&m_count,sizeof(uint64_t));
+	in.read((char*)&m_zeroCount,sizeof(uint64_t));
+	in.read((char*)&m_offset,sizeof(int32_t));
+	in.read((char*)&size,sizeof(uint32_t));
+	if(!in.good() || size>SKETCH_MAX_BUCKETS){
+		in.setstate(std::ios_base::failbit);
+		return;
+	}
+	m_buckets.assign(size,0);
+	if(size>0)
+		in.read((char*)&m_buckets[0],size*sizeof(uint32_t));
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+
+#define SKETCH_RELATIVE_ACCURACY 0.01 //!< Error relativo máximo de los cuantiles estimados por QuantileSketch
+#define SKETCH_MAX_BUCKETS 1024 //!< Cantidad máxima de cubetas de un QuantileSketch (Memoria constante)
+#define SKETCH_MIN_VALUE 1e-9 //!< Los valores menores o iguales a este se cuentan en la cubeta de ceros
+
+namespace ns3 {
+
+/**
+ * Resumen de una distribución que permite estimar sus cuantiles con memoria acotada, sin
+ * guardar las muestras (Histograma logarítmico, como DDSketch).
+ *
+ * Cada muestra x > 0 se cuenta en la cubeta k = ceil(log(x)/log(γ)), con
+ * γ = (1+α)/(1-α) y α = SKETCH_RELATIVE_ACCURACY, por lo que el valor estimado de cualquier
+ * cuantil tiene un error relativo de a lo sumo α. Las cubetas se guardan en un arreglo
+ * contiguo entre la menor y la mayor usada; si el rango supera SKETCH_MAX_BUCKETS, las
+ * cubetas menores se unen en una sola (Se pierde precisión solo en los cuantiles más bajos).
+ *
+ * Dos resúmenes se pueden combinar (Merge()) sin perder precisión, por ejemplo para obtener
+ * los cuantiles de un nodo a partir de los de cada destino.
+ */
+class QuantileSketch {
+public:
+	QuantileSketch();
+	~QuantileSketch();
+
+	/**
+	 * Agrega una muestra.
+	 *
+	 * @param[in] value Valor de la muestra (>= 0)
+	 */
+	void Add(double value);
+
+	/**
+	 * Agrega todas las muestras de otro resumen.
+	 *
+	 * @param[in] other Resumen a combinar con este
+	 */
+	void Merge(const QuantileSketch& other);
+
+	/**
+	 * @param[in] q Cuantil a estimar ([0,1], 0.5 = mediana)
+	 *
+	 * @return Valor estimado del cuantil, o 0 si no hay muestras
+	 */
+	double GetQuantile(double q) const;
+
+	/**
+	 * @return Cantidad de muestras agregadas
+	 */
+	uint64_t GetCount() const;
+
+	/**
+	 * Guarda el resumen en binario.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	void Serialize(std::ostream& out) const;
+
+	/**
+	 * Reemplaza el resumen por uno guardado con Serialize().
+	 *
+	 * @param[in] in Flujo de entrada binario
+	 */
+	void Deserialize(std::istream& in);
+
+private:
+
+	/**
+	 * Amplía el arreglo de cubetas para que incluya la cubeta indicada, uniendo las menores si
+	 * se supera SKETCH_MAX_BUCKETS.
+	 *
+	 * @param[in] index Índice de la cubeta
+	 *
+	 * @return Posición de la cubeta en m_buckets
+	 */
+	uint32_t Reserve(int32_t index);
+
+	/**
+	 * @return log(γ), común a todos los resúmenes
+	 */
+	static double GetLogGamma();
+
+	uint64_t m_count; //!< Cantidad de muestras
+	uint64_t m_zeroCount; //!< Muestras menores o iguales a SKETCH_MIN_VALUE
+	int32_t m_offset; //!< Índice de la cubeta en la posición 0 de m_buckets
+	std::vector<uint32_t> m_buckets; //!< Cantidad de muestras de cada cubeta, desde m_offset
+};
+
+} /* namespace ns3 */
+
+#endif /* QUANTILE_SKETCH_H */
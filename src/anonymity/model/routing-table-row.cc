@@ -5,10 +5,11 @@
 namespace ns3 {
 
 RoutingTableRow::RoutingTableRow()
-:m_sourceIP(), m_targetIP(), m_antID() {
+:m_sourceIP(), m_targetIP(), m_antID(), m_insertTime(0), m_expireTick(0), m_next(0), m_prev(0) {
 }
 
-RoutingTableRow::RoutingTableRow(const Ipv4Address& source, const Ipv4Address& target, const uint64_t antID){
+RoutingTableRow::RoutingTableRow(const Ipv4Address& source, const Ipv4Address& target, const uint64_t antID)
+:m_insertTime(0), m_expireTick(0), m_next(0), m_prev(0) {
 	m_sourceIP=source;
 	m_targetIP=target;
 	m_antID=antID;
@@ -3,6 +3,7 @@
 #define ROUTING_TABLE_ROW_H
 
 #include "ns3/ipv4-address.h"
+#include <stdint.h>
 namespace ns3 {
 
 /**
@@ -12,10 +13,15 @@ namespace ns3 {
  * - IP Origen
  * - IP Destino
  * - ID de paquete
+ *
+ * Las filas son valores simples (Sin conteo de referencias) que viven en los bloques
+ * de memoria de RoutingTable, junto con los campos que esta usa para su expiración.
  */
-class RoutingTableRow: public SimpleRefCount<RoutingTableRow>
+class RoutingTableRow
 {
 
+	friend class RoutingTable;
+
 public:
 	RoutingTableRow();
 
@@ -86,6 +92,10 @@ private:
 	Ipv4Address m_sourceIP; //!< Campo IP Origen
 	Ipv4Address m_targetIP; //!< Campo IP Destino
 	uint64_t m_antID; //!< Campo ID de hormiga
+	int64_t m_insertTime; //!< Tiempo de simulación (En pasos de tiempo de NS3) en que se agregó la fila
+	uint64_t m_expireTick; //!< Tick de la rueda de expiración en que vence la fila
+	uint32_t m_next; //!< Siguiente fila en la lista de la rueda de expiración (O en la lista de filas libres)
+	uint32_t m_prev; //!< Fila anterior en la lista de la rueda de expiración
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "routing-table.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <cmath>
+
+#define ROUTING_TABLE_INITIAL_BITS 6 //64 posiciones iniciales en la tabla hash
+#define ROUTING_TABLE_RTT_GAIN 0.125 //Peso de cada muestra nueva en el RTT observado (Igual que TCP)
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RoutingTable");
+
+RoutingTable::RoutingTable()
+:m_bits(ROUTING_TABLE_INITIAL_BITS), m_freeRow(NULL_ROW), m_size(0), m_maxSize(0), m_expired(0),
+ m_rttMultiple(DEFAULT_ROUTING_TABLE_RTT_MULTIPLE), m_srtt(ROUTING_TABLE_INITIAL_RTT), m_wheelTick(0){
+	Slot empty = {0,NULL_ROW};
+	m_slots.assign(1<<m_bits,empty);
+	m_wheel.assign(ROUTING_TABLE_WHEEL_SLOTS,NULL_ROW);
+}
+
+RoutingTable::~RoutingTable(){
+	Simulator::Cancel(m_wheelEvent);
+	for(std::vector<RoutingTableRow*>::iterator it = m_slabs.begin();it!=m_slabs.end();it++)
+		delete[] *it;
+	m_slabs.clear();
+}
+
+void
+RoutingTable::SetRttMultiple(double multiple){
+	m_rttMultiple = multiple;
+}
+
+uint32_t
+RoutingTable::Hash(uint64_t antID) const{
+	//Hash multiplicativo, los ID de hormiga son consecutivos
+	return (antID*0x9E3779B97F4A7C15ULL)>>(64-m_bits);
+}
+
+uint32_t
+RoutingTable::FindSlot(uint64_t antID) const{
+	uint32_t mask = m_slots.size()-1;
+	uint32_t slot = Hash(antID);
+	while(m_slots[slot].row!=NULL_ROW && m_slots[slot].antID!=antID)
+		slot = (slot+1)&mask;
+	return slot;
+}
+
+void
+RoutingTable::EraseSlot(uint32_t slot){
+	uint32_t mask = m_slots.size()-1;
+	uint32_t next = slot;
+	while(true){
+		next = (next+1)&mask;
+		if(m_slots[next].row==NULL_ROW)
+			break;
+		/* Si la posicion inicial de la fila siguiente esta ciclicamente en (slot, next],
+		 * la fila sigue siendo alcanzable y no se mueve
+		 */
+		uint32_t home = Hash(m_slots[next].antID);
+		bool reachable = (slot<=next) ? (slot<home && home<=next) : (slot<home || home<=next);
+		if(reachable)
+			continue;
+		m_slots[slot] = m_slots[next];
+		slot = next;
+	}
+	m_slots[slot].row = NULL_ROW;
+}
+
+void
+RoutingTable::Grow(){
+	std::vector<Slot> old;
+	old.swap(m_slots);
+	m_bits++;
+	Slot empty = {0,NULL_ROW};
+	m_slots.assign(1<<m_bits,empty);
+	for(std::vector<Slot>::iterator it = old.begin();it!=old.end();it++){
+		if(it->row!=NULL_ROW)
+			m_slots[FindSlot(it->antID)] = *it;
+	}
+	NS_LOG_LOGIC("Tabla de enrutamiento ampliada a "<<m_slots.size()<<" posiciones");
+}
+
+RoutingTableRow&
+RoutingTable::GetRow(uint32_t index) const{
+	return m_slabs[index/ROUTING_TABLE_SLAB_ROWS][index%ROUTING_TABLE_SLAB_ROWS];
+}
+
+uint32_t
+RoutingTable::AllocateRow(){
+	if(m_freeRow==NULL_ROW){
+		uint32_t base = m_slabs.size()*ROUTING_TABLE_SLAB_ROWS;
+		RoutingTableRow* slab = new RoutingTableRow[ROUTING_TABLE_SLAB_ROWS];
+		for(uint32_t i=0;i<ROUTING_TABLE_SLAB_ROWS;i++)
+			slab[i].m_next = (i+1<ROUTING_TABLE_SLAB_ROWS) ? base+i+1 : NULL_ROW;
+		m_slabs.push_back(slab);
+		m_freeRow = base;
+	}
+	uint32_t index = m_freeRow;
+	m_freeRow = GetRow(index).m_next;
+	return index;
+}
+
+void
+RoutingTable::ReleaseSlot(uint32_t slot){
+	uint32_t index = m_slots[slot].row;
+	if(m_rttMultiple>0)
+		WheelUnlink(index);
+	EraseSlot(slot);
+	GetRow(index).m_next = m_freeRow;
+	m_freeRow = index;
+	m_size--;
+}
+
+const RoutingTableRow*
+RoutingTable::Find(uint64_t antID) const{
+	uint32_t slot = FindSlot(antID);
+	if(m_slots[slot].row==NULL_ROW)
+		return NULL;
+	return &GetRow(m_slots[slot].row);
+}
+
+void
+RoutingTable::Insert(const Ipv4Address& source, const Ipv4Address& target, uint64_t antID){
+	uint32_t slot = FindSlot(antID);
+	if(m_slots[slot].row!=NULL_ROW)
+		ReleaseSlot(slot);
+	if((m_size+1)*2>m_slots.size())
+		Grow();
+	slot = FindSlot(antID);
+
+	uint32_t index = AllocateRow();
+	RoutingTableRow& row = GetRow(index);
+	row.m_sourceIP = source;
+	row.m_targetIP = target;
+	row.m_antID = antID;
+	row.m_insertTime = Simulator::Now().GetTimeStep();
+	m_slots[slot].antID = antID;
+	m_slots[slot].row = index;
+	m_size++;
+	if(m_size>m_maxSize)
+		m_maxSize = m_size;
+
+	if(m_rttMultiple>0){
+		if(!m_wheelEvent.IsRunning()){
+			m_wheelTick = GetCurrentTick();
+			m_wheelEvent = Simulator::Schedule(MilliSeconds(ROUTING_TABLE_WHEEL_TICK),&RoutingTable::AdvanceWheel,this);
+		}
+		uint64_t ticks = std::ceil(m_rttMultiple*m_srtt/ROUTING_TABLE_WHEEL_TICK);
+		row.m_expireTick = GetCurrentTick()+std::max<uint64_t>(ticks,1);
+		WheelLink(index);
+	}
+}
+
+bool
+RoutingTable::Remove(uint64_t antID){
+	uint32_t slot = FindSlot(antID);
+	if(m_slots[slot].row==NULL_ROW)
+		return false;
+	double sample = (Simulator::Now()-TimeStep(GetRow(m_slots[slot].row).m_insertTime)).GetMilliSeconds();
+	m_srtt = (1-ROUTING_TABLE_RTT_GAIN)*m_srtt+ROUTING_TABLE_RTT_GAIN*sample;
+	ReleaseSlot(slot);
+	return true;
+}
+
+uint64_t
+RoutingTable::GetCurrentTick() const{
+	return Simulator::Now().GetMilliSeconds()/ROUTING_TABLE_WHEEL_TICK;
+}
+
+void
+RoutingTable::WheelLink(uint32_t index){
+	RoutingTableRow& row = GetRow(index);
+	uint32_t& head = m_wheel[row.m_expireTick%ROUTING_TABLE_WHEEL_SLOTS];
+	row.m_prev = NULL_ROW;
+	row.m_next = head;
+	if(head!=NULL_ROW)
+		GetRow(head).m_prev = index;
+	head = index;
+}
+
+void
+RoutingTable::WheelUnlink(uint32_t index){
+	RoutingTableRow& row = GetRow(index);
+	if(row.m_prev!=NULL_ROW)
+		GetRow(row.m_prev).m_next = row.m_next;
+	else
+		m_wheel[row.m_expireTick%ROUTING_TABLE_WHEEL_SLOTS] = row.m_next;
+	if(row.m_next!=NULL_ROW)
+		GetRow(row.m_next).m_prev = row.m_prev;
+}
+
+void
+RoutingTable::AdvanceWheel(){
+	uint64_t now = GetCurrentTick();
+	/* Si pasaron mas ticks que posiciones en la rueda basta con recorrerla
+	 * una vez, ya que cada posicion agrupa todos los ticks congruentes
+	 */
+	uint64_t first = m_wheelTick+1;
+	if(now-m_wheelTick>ROUTING_TABLE_WHEEL_SLOTS)
+		first = now-ROUTING_TABLE_WHEEL_SLOTS+1;
+	for(uint64_t tick = first;tick<=now;tick++){
+		uint32_t index = m_wheel[tick%ROUTING_TABLE_WHEEL_SLOTS];
+		while(index!=NULL_ROW){
+			RoutingTableRow& row = GetRow(index);
+			uint32_t next = row.m_next;
+			if(row.m_expireTick<=now){ //Las filas con un vencimiento mayor esperan la siguiente vuelta
+				NS_LOG_LOGIC("Expiro la fila de la hormiga con ID "<<row.m_antID);
+				ReleaseSlot(FindSlot(row.m_antID));
+				m_expired++;
+			}
+			index = next;
+		}
+	}
+	m_wheelTick = now;
+	if(m_size>0)
+		m_wheelEvent = Simulator::Schedule(MilliSeconds(ROUTING_TABLE_WHEEL_TICK),&RoutingTable::AdvanceWheel,this);
+}
+
+uint32_t
+RoutingTable::GetSize() const{
+	return m_size;
+}
+
+uint32_t
+RoutingTable::GetMaxSize() const{
+	return m_maxSize;
+}
+
+uint64_t
+RoutingTable::GetExpiredCount() const{
+	return m_expired;
+}
+
+Time
+RoutingTable::GetSmoothedRtt() const{
+	return MilliSeconds(m_srtt);
+}
+
+} /* namespace ns3 */
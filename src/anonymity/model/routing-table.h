@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef ROUTING_TABLE_H
+#define ROUTING_TABLE_H
+
+#include "ns3/routing-table-row.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include <vector>
+
+/**
+ * Cantidad de filas de cada bloque de memoria de la tabla de enrutamiento.
+ */
+#define ROUTING_TABLE_SLAB_ROWS 1024
+
+/**
+ * Cantidad de posiciones de la rueda de expiración de la tabla de enrutamiento (Potencia de 2).
+ */
+#define ROUTING_TABLE_WHEEL_SLOTS 256
+
+/**
+ * Duración (En milisegundos) de cada tick de la rueda de expiración.
+ */
+#define ROUTING_TABLE_WHEEL_TICK 100
+
+/**
+ * RTT (En milisegundos) que se asume antes de observar la primera respuesta.
+ */
+#define ROUTING_TABLE_INITIAL_RTT 10000
+
+/**
+ * Múltiplo por defecto del RTT observado luego del cual expira una fila sin respuesta.
+ */
+#define DEFAULT_ROUTING_TABLE_RTT_MULTIPLE 10
+
+namespace ns3 {
+
+/**
+ * Tabla de enrutamiento de un nodo, indexada por ID de hormiga.
+ *
+ * Las filas se guardan en bloques de memoria de ROUTING_TABLE_SLAB_ROWS filas que
+ * se reutilizan a través de una lista de filas libres, y se ubican con una tabla hash
+ * de direccionamiento abierto (Sondeo lineal), por lo que agregar o eliminar una fila
+ * no reserva memoria en el heap.
+ *
+ * Las hormigas descartadas en las colas de la red nunca reciben respuesta, por lo que
+ * sus filas nunca se eliminan. Para acotar la memoria, cada fila expira luego de un
+ * múltiplo del RTT observado por el nodo (Promedio exponencial del tiempo que tardan
+ * las filas en recibir su respuesta). Las expiraciones se manejan con una rueda de
+ * tiempo (Timer wheel) que solo programa eventos mientras la tabla no está vacía.
+ */
+class RoutingTable {
+
+public:
+
+	/**
+	 * Valor usado como fila nula en los índices internos.
+	 */
+	static const uint32_t NULL_ROW = 0xffffffff;
+
+	RoutingTable();
+	~RoutingTable();
+
+	/**
+	 * Asigna el múltiplo del RTT observado luego del cual expiran las filas sin respuesta.
+	 *
+	 * @param[in] multiple Múltiplo del RTT (0 deshabilita la expiración de filas)
+	 */
+	void SetRttMultiple(double multiple);
+
+	/**
+	 * Busca una fila en la tabla.
+	 *
+	 * @param[in] antID ID de hormiga que identifica la fila
+	 *
+	 * @return Puntero a la fila, o NULL si no hay ninguna fila con ese ID. El puntero es
+	 * válido hasta que se elimine la fila.
+	 */
+	const RoutingTableRow* Find(uint64_t antID) const;
+
+	/**
+	 * Agrega una fila a la tabla, reemplazando la fila anterior con el mismo ID si existe.
+	 *
+	 * @param[in] source IP de nodo origen
+	 *
+	 * @param[in] target IP de nodo destino
+	 *
+	 * @param[in] antID ID de la hormiga
+	 */
+	void Insert(const Ipv4Address& source, const Ipv4Address& target, uint64_t antID);
+
+	/**
+	 * Elimina una fila al recibir la respuesta de la hormiga, y usa el tiempo que
+	 * estuvo la fila en la tabla como muestra del RTT observado.
+	 *
+	 * @param[in] antID ID de la hormiga
+	 *
+	 * @return true si la fila existía
+	 */
+	bool Remove(uint64_t antID);
+
+	/**
+	 * @return Cantidad de filas en la tabla
+	 */
+	uint32_t GetSize() const;
+
+	/**
+	 * @return Cantidad máxima de filas que llegó a tener la tabla
+	 */
+	uint32_t GetMaxSize() const;
+
+	/**
+	 * @return Cantidad de filas eliminadas por expiración
+	 */
+	uint64_t GetExpiredCount() const;
+
+	/**
+	 * @return RTT observado (Promedio exponencial) usado para calcular la expiración
+	 */
+	Time GetSmoothedRtt() const;
+
+private:
+
+	/**
+	 * Posición de la tabla hash.
+	 */
+	struct Slot {
+		uint64_t antID; //!< ID de hormiga de la fila
+		uint32_t row; //!< Índice de la fila en los bloques de memoria, o NULL_ROW si la posición está vacía
+	};
+
+	/**
+	 * @param[in] antID ID de hormiga
+	 *
+	 * @return Posición inicial de búsqueda del ID en la tabla hash
+	 */
+	uint32_t Hash(uint64_t antID) const;
+
+	/**
+	 * @param[in] antID ID de hormiga
+	 *
+	 * @return Posición de la tabla hash que contiene el ID, o la posición vacía donde debería insertarse
+	 */
+	uint32_t FindSlot(uint64_t antID) const;
+
+	/**
+	 * Vacía una posición de la tabla hash, desplazando hacia atrás las posiciones siguientes
+	 * para no romper las secuencias de sondeo (Sin marcas de eliminado).
+	 *
+	 * @param[in] slot Posición a vaciar
+	 */
+	void EraseSlot(uint32_t slot);
+
+	/**
+	 * Duplica la capacidad de la tabla hash y reubica todas las filas.
+	 */
+	void Grow();
+
+	/**
+	 * @param[in] index Índice de la fila
+	 *
+	 * @return Referencia a la fila en su bloque de memoria
+	 */
+	RoutingTableRow& GetRow(uint32_t index) const;
+
+	/**
+	 * Toma una fila de la lista de filas libres, creando un nuevo bloque si está vacía.
+	 *
+	 * @return Índice de la fila
+	 */
+	uint32_t AllocateRow();
+
+	/**
+	 * Elimina una fila de la tabla hash y de la rueda, y la devuelve a la lista de filas libres.
+	 *
+	 * @param[in] slot Posición de la tabla hash que contiene la fila
+	 */
+	void ReleaseSlot(uint32_t slot);
+
+	/**
+	 * @return Tick actual de la rueda de expiración
+	 */
+	uint64_t GetCurrentTick() const;
+
+	/**
+	 * Agrega una fila a la posición de la rueda que corresponde a su tick de expiración.
+	 *
+	 * @param[in] index Índice de la fila
+	 */
+	void WheelLink(uint32_t index);
+
+	/**
+	 * Quita una fila de su posición en la rueda.
+	 *
+	 * @param[in] index Índice de la fila
+	 */
+	void WheelUnlink(uint32_t index);
+
+	/**
+	 * Procesa las posiciones de la rueda hasta el tick actual, eliminando las filas
+	 * vencidas, y programa el próximo tick si la tabla no quedó vacía.
+	 */
+	void AdvanceWheel();
+
+	std::vector<Slot> m_slots; //!< Tabla hash (Capacidad potencia de 2)
+	uint32_t m_bits; //!< Logaritmo en base 2 de la capacidad de la tabla hash
+	std::vector<RoutingTableRow*> m_slabs; //!< Bloques de memoria de ROUTING_TABLE_SLAB_ROWS filas
+	uint32_t m_freeRow; //!< Primera fila de la lista de filas libres
+	uint32_t m_size; //!< Cantidad de filas en la tabla
+	uint32_t m_maxSize; //!< Cantidad máxima de filas alcanzada
+	uint64_t m_expired; //!< Cantidad de filas expiradas
+	double m_rttMultiple; //!< Múltiplo del RTT para la expiración (0 = sin expiración)
+	double m_srtt; //!< RTT observado en milisegundos (Promedio exponencial)
+	std::vector<uint32_t> m_wheel; //!< Primera fila de cada posición de la rueda de expiración
+	uint64_t m_wheelTick; //!< Último tick procesado de la rueda
+	EventId m_wheelEvent; //!< Evento del próximo tick de la rueda
+};
+
+} /* namespace ns3 */
+
+#endif /* ROUTING_TABLE_H */
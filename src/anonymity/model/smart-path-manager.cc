@@ -4,7 +4,7 @@
 #include "ns3/arap-simulator.h"
 #include "ns3/log.h"
 #include "ns3/abort.h"
-#include <algorithm>
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -21,6 +21,7 @@ SmartPathManager::SmartPathManager(double c1, double c2, double zeta, uint32_t w
 }
 
 SmartPathManager::~SmartPathManager() {
+	Simulator::Cancel(m_flushEvent);
 	m_stochasticModel.clear();
 }
 
@@ -49,92 +50,152 @@ SmartPathManager::GetR(const int64_t& rtt,const double& mean, const double& vari
 
 void
 SmartPathManager::HandleExplorer(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt){
-	std::map<Ipv4Address, ExplorerAntsStatistics>::iterator it;
-	it = m_stochasticModel.find(target);
-	if(it==m_stochasticModel.end()) //Esta condicion siempre deberia ser false (Si debe existir el modelo)
+	uint32_t targetIndex = m_directory->FindIndex(target);
+	if(targetIndex==ArapNodeDirectory::INVALID_INDEX || targetIndex>=m_stochasticModel.size()) //Esta condicion siempre deberia ser false (Si debe existir el modelo)
 		NS_ABORT_MSG("No se ha encontrado un modelo estocastico para el nodo con IP "<<target);
 
-	ExplorerAntsStatistics& stats = it->second;
+	ExplorerAntsStatistics& stats = m_stochasticModel[targetIndex];
 	stats.UpdateModel(rtt.GetMilliSeconds());
-	double r = GetR(rtt.GetMilliSeconds(), stats.GetMean(), stats.GetVariance(),stats.GetWBest(), stats.GetWCount());
-	const double prob = PheromoneIncrease(target,medium,rtt,r);
-	PheromoneDecrease(target,medium,rtt,r);
+	PendingReward pending;
+	pending.medium = m_directory->GetIndex(medium);
+	pending.reward = GetR(rtt.GetMilliSeconds(), stats.GetMean(), stats.GetVariance(),stats.GetWBest(), stats.GetWCount());
 
+	/* La tabla no se actualiza ahora: las hormigas que vuelven en el mismo instante hacia el
+	 * mismo destino se acumulan y se aplican juntas en un solo recorrido de la fila
+	 */
+	if(m_pendingRewards.size()<=targetIndex)
+		m_pendingRewards.resize(m_stochasticModel.size());
+	if(m_pendingRewards[targetIndex].empty())
+		m_pendingTargets.push_back(targetIndex);
+	m_pendingRewards[targetIndex].push_back(pending);
+	if(!m_flushEvent.IsRunning())
+		m_flushEvent = Simulator::ScheduleNow(&SmartPathManager::FlushRewards,this);
+}
+
+void
+SmartPathManager::FlushRewards(){
+	for(uint32_t i=0;i<m_pendingTargets.size();i++){
+		std::vector<PendingReward>& rewards = m_pendingRewards[m_pendingTargets[i]];
+		ApplyRewards(m_pendingTargets[i],rewards);
+		rewards.clear();
+	}
+	m_pendingTargets.clear();
+}
 
-	/* Aplicar la correccion a la probabilidad si esta excede el valor maximo.
-	 * En este caso se esta asignando el valor maximo al nodo que corresponde (El que excedio
-	 * la probabilidad), y el excedente se divide entre los demas nodos de manera uniforme.
+void
+SmartPathManager::ApplyRewards(uint32_t targetIndex, const std::vector<PendingReward>& rewards){
+	uint32_t count = rewards.size();
+	double* row = GetRow(targetIndex);
+
+	/* Valores de los nodos intermedios recompensados y excedente repartido por cada recompensa.
+	 * Se aplica la correccion a la probabilidad si esta excede el valor maximo: se asigna el
+	 * valor maximo al nodo que corresponde (El que excedio la probabilidad), y el excedente se
+	 * divide entre los demas nodos de manera uniforme.
 	 */
+	std::vector<double> mediums(count);
+	std::vector<double> gains(count,0);
+	for(uint32_t k=0;k<count;k++){
+		//Valor actual del nodo intermedio: el ultimo calculado, o el de la fila con las recompensas anteriores aplicadas
+		double prob = -1;
+		for(uint32_t j=0;j<k;j++){
+			if(rewards[j].medium==rewards[k].medium)
+				prob = mediums[j];
+		}
+		if(prob<0){
+			prob = row[rewards[k].medium];
+			for(uint32_t j=0;j<k;j++)
+				prob = prob-rewards[j].reward*prob+gains[j];
+		}
+		for(uint32_t j=0;j<k;j++){
+			if(rewards[j].medium==rewards[k].medium)
+				mediums[j] = -1; //Solo se conserva el valor mas reciente de cada nodo intermedio
+			else if(mediums[j]>=0)
+				mediums[j] = mediums[j]-rewards[k].reward*mediums[j];
+		}
+		prob = prob+rewards[k].reward*(1-prob);
+		if(prob> MAX_PROB){
+			gains[k] = (prob-MAX_PROB)/(m_numNodes-2-1);
+			prob = MAX_PROB;
+		}
+		mediums[k] = prob;
+		/* El excedente de esta recompensa se suma a los nodos intermedios anteriores despues de la reduccion */
+		for(uint32_t j=0;j<k;j++){
+			if(mediums[j]>=0 && rewards[j].medium!=rewards[k].medium)
+				mediums[j] = mediums[j]+gains[k];
+		}
+	}
 
-	if(prob> MAX_PROB){
-		double diff = prob - MAX_PROB;
-		m_probTable[target][medium] = MAX_PROB;
-		std::map<Ipv4Address,double>& targetMap = m_probTable[target];
-		for(std::map<Ipv4Address,double>::iterator it = targetMap.begin(); it!= targetMap.end();it++){
-			if(it->first==medium || it->first==target)
-				continue;
-			double& p_IT =it->second;
-			double probGain = diff/(ArapSimulator::GetNumNodes()-2-1);
-			p_IT = p_IT+probGain;
+	//Reduccion (Y excedente) de todas las posiciones en un solo recorrido
+	if(count==1){
+		const double reward = rewards[0].reward;
+		const double gain = gains[0];
+		for(uint32_t i = 0; i < m_numNodes; i++)
+			row[i] = row[i]-reward*row[i]+gain;
+	}
+	else{
+		for(uint32_t i = 0; i < m_numNodes; i++){
+			double value = row[i];
+			for(uint32_t k=0;k<count;k++)
+				value = value-rewards[k].reward*value+gains[k];
+			row[i] = value;
 		}
 	}
+	for(uint32_t k=0;k<count;k++){
+		if(mediums[k]>=0)
+			row[rewards[k].medium] = mediums[k];
+	}
+	row[targetIndex] = 0;
+	row[m_localIndex] = 0;
+	InvalidateRow(targetIndex);
 }
 
 ArapPathManager* SmartPathManager::GetCopy() const {
 	SmartPathManager* aux = new SmartPathManager(*this);
-	aux->InitModels();
+	aux->InitModels(ArapSimulator::GetDirectory());
 	return aux;
 }
 
 void
-SmartPathManager::InitModels(){
-	const PointToPointStarHelper& star = ArapSimulator::GetStar();
-	for (uint32_t i = 0; i < star.SpokeCount (); ++i){
-		m_stochasticModel.insert(std::pair<Ipv4Address,ExplorerAntsStatistics>(star.GetSpokeIpv4Address(i),ExplorerAntsStatistics(m_WMax, m_varsigma)));
-	}
+SmartPathManager::InitModels(const ArapNodeDirectory& directory){
+	m_stochasticModel.assign(directory.GetCount(),ExplorerAntsStatistics(m_WMax, m_varsigma));
 }
 
 std::list<Ipv4Address>
 SmartPathManager::CreatePath(const Ipv4Address& target) {
-	std::map<Ipv4Address,double> targetProb = m_probTable[target];
 	std::list<Ipv4Address> path;
-	Ptr<UniformRandomVariable>  rng = CreateObject<UniformRandomVariable>();
-	while(path.size()<ArapSimulator::GetNumHops()-1){
-		double x = rng->GetValue();
-		double acum = 0;
-		for(std::map<Ipv4Address,double>::iterator it =  targetProb.begin();it!=targetProb.end();it++){
-			if(it->first == target)
-				continue;
-			if(x>=acum && x<acum+it->second){
-				if(std::find(path.begin(), path.end(), it->first) == path.end()) //Si el nodo NO esta en el camino
-					path.push_back(it->first);
-				break;
-			}else{
-				acum+=it->second;
-			}
-		}
-	}
+	SampleIntermediates(m_directory->GetIndex(target),ArapSimulator::GetNumHops()-1,path);
 	/* Se agrega el nodo destino como elemento final del camino */
 	path.push_back(target);
 	return path;
 }
 
-const double
-SmartPathManager::PheromoneIncrease(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt, const double& reward){
-	double& p_TM =m_probTable[target][medium];
-	p_TM = p_TM+reward*(1-p_TM);
-	return p_TM;
+const ExplorerAntsStatistics*
+SmartPathManager::GetExplorerStatistics(uint32_t targetIndex) const{
+	if(targetIndex>=m_stochasticModel.size())
+		return NULL;
+	return &m_stochasticModel[targetIndex];
 }
 
 void
-SmartPathManager::PheromoneDecrease(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt, const double& reward){
-	std::map<Ipv4Address,double>& targetMap = m_probTable[target];
-	for(std::map<Ipv4Address,double>::iterator it = targetMap.begin(); it!= targetMap.end();it++){
-		if(it->first==medium || it->first==target)
-			continue;
-		double& p_TI =it->second;
-		p_TI = p_TI-reward*p_TI;
-	}
+SmartPathManager::SaveState(std::ostream& out) const{
+	ArapPathManager::SaveState(out);
+	uint32_t models = m_stochasticModel.size();
+	out.write((const char*)&models,sizeof(uint32_t));
+	for(uint32_t i=0;i<models;i++)
+		m_stochasticModel[i].Serialize(out);
+}
+
+void
+SmartPathManager::LoadState(std::istream& in){
+	ArapPathManager::LoadState(in);
+	uint32_t models = 0;
+	in.read((char*)&models,sizeof(uint32_t));
+	if(!in.good())
+		return;
+	NS_ABORT_MSG_IF(models!=m_stochasticModel.size(),"ERROR: El estado guardado tiene "<<models<<" modelos estocasticos y la red "
+			<<m_stochasticModel.size()<<" nodos");
+	for(uint32_t i=0;i<models;i++)
+		m_stochasticModel[i].Deserialize(in);
 }
 
 } /* namespace ns3 */
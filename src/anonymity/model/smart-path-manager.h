@@ -5,7 +5,8 @@
 
 #include "ns3/arap-path-manager.h"
 #include "ns3/explorer-ants-statistics.h"
-#include <map>
+#include "ns3/event-id.h"
+#include <vector>
 
 #define DEFAULT_C1 0.7 //!<Valor por defecto de C1 para el cálculo de R
 #define DEFAULT_C2 0.3 //!<Valor por defecto de C2 para el cálculo de R
@@ -45,36 +46,48 @@ public:
 	virtual void HandleExplorer(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt);
 	virtual ArapPathManager* GetCopy() const;
 	virtual std::list<Ipv4Address> CreatePath(const Ipv4Address& target);
+	virtual const ExplorerAntsStatistics* GetExplorerStatistics(uint32_t targetIndex) const;
+
+	/**
+	 * Guarda la tabla de probabilidades (ArapPathManager::SaveState()) y a continuación el
+	 * modelo estocástico de cada destino.
+	 *
+	 * @param[in] out Flujo de salida binario
+	 */
+	virtual void SaveState(std::ostream& out) const;
+	virtual void LoadState(std::istream& in);
 
 protected:
 
 	/**
-	 * Incrementar el valor de la probabilidad (feromona) para un camino (posición en la tabla) indicado.
-	 *
-	 * @param[in] target IP del nodo destino (Fila)
-	 *
-	 * @param[in] medium IP del nodo intermedio (Columna)
-	 *
-	 * @param[in] rtt Tiempo de ida y vuelta de la hormiga exploradora
-	 *
-	 * @param[in] reward Recompensa, valor calculado que indica que tan buena es la nueva probabilidad
-	 *
-	 * @return valor de la probabilidad nueva asignada
+	 * Recompensa pendiente de una hormiga exploradora que volvió.
 	 */
-	virtual const double PheromoneIncrease(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt, const double& reward);
+	struct PendingReward {
+		uint32_t medium; //!< Índice del nodo intermedio (Columna)
+		double reward; //!< Recompensa (R) calculada al volver la hormiga
+	};
 
 	/**
-	 * Reducir el valor de la probabilidad (feromona) para todos los caminos excepto el indicado.
+	 * Aplica en la fila de un destino las recompensas de las hormigas exploradoras que volvieron en el
+	 * mismo instante, en el orden en que volvieron, con el mismo resultado que aplicarlas una a una:
+	 * cada recompensa incrementa la probabilidad (feromona) de su nodo intermedio, reduce las demás en la
+	 * misma proporción, y si la probabilidad incrementada excede MAX_PROB el excedente se reparte entre los demás.
 	 *
-	 * @param[in] target IP del nodo destino (Fila)
+	 * Primero se calculan solo los valores de los nodos intermedios recompensados y el excedente de cada
+	 * recompensa, y luego se recorre la fila completa una única vez aplicando todas las reducciones sin
+	 * condiciones (Las posiciones del destino y del nodo local valen 0 y se restablecen al final), lo que
+	 * permite que el compilador vectorice el recorrido.
 	 *
-	 * @param[in] medium IP del nodo intermedio (Columna)
+	 * @param[in] targetIndex Índice del nodo destino (Fila)
 	 *
-	 * @param[in] rtt Tiempo de ida y vuelta de la hormiga exploradora
-	 *
-	 * @param[in] reward Recompensa, valor calculado que indica que tan buena es la nueva probabilidad
+	 * @param[in] rewards Recompensas, en el orden en que volvieron las hormigas
 	 */
-	virtual void PheromoneDecrease(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt, const double& reward);
+	virtual void ApplyRewards(uint32_t targetIndex, const std::vector<PendingReward>& rewards);
+
+	/**
+	 * Aplica las recompensas pendientes de todos los destinos (Se ejecuta al final del instante en que volvieron).
+	 */
+	void FlushRewards();
 
 	/**
 	 * Calcula el valor de R (reward).
@@ -93,19 +106,25 @@ protected:
 	 */
 	virtual const double GetR(const int64_t& rtt,const double& mean, const double& variance, const double& wBest, const uint32_t& wCount);
 
+	/**
+	 * Inicializa los modelos estocásticos para los nodos de la simulación
+	 *
+	 * @param[in] directory Directorio de nodos (Un modelo por nodo)
+	 */
+	void InitModels(const ArapNodeDirectory& directory);
+
+	std::vector<ExplorerAntsStatistics> m_stochasticModel; //!< Modelos estocásticos de los nodos destino (Posición: índice en ArapNodeDirectory)
+
 private:
 
-	std::map<Ipv4Address,ExplorerAntsStatistics > m_stochasticModel; //!< Mapa de modelos estocásticos de los nodos destino
 	double m_c1; //!< Valor C1 usado en el cálculo de R
 	double m_c2; //!< Valor C2 usado en el cálculo de R
 	double m_zeta; //!< Valor Z usado en el cálculo de R
 	uint32_t m_WMax; //!< Valor de la ventana máxima de observación
 	double m_varsigma; //!< Valor de varsigma
-
-	/**
-	 * Inicializa los modelos estocásticos para los nodos de la simulación
-	 */
-	void InitModels();
+	std::vector<std::vector<PendingReward> > m_pendingRewards; //!< Recompensas pendientes de cada destino (Posición: índice en ArapNodeDirectory)
+	std::vector<uint32_t> m_pendingTargets; //!< Destinos con recompensas pendientes, en el orden de la primera hormiga que volvió
+	EventId m_flushEvent; //!< Evento que aplica las recompensas pendientes
 };
 
 } /* namespace ns3 */
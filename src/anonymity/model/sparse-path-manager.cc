@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "sparse-path-manager.h"
+#include "ns3/arap-simulator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SparsePathManager");
+
+SparsePathManager::SparsePathManager()
+:m_maxCandidates(DEFAULT_SPARSE_CANDIDATES), m_rotation(DEFAULT_SPARSE_ROTATION), m_candidates(0){
+	NS_LOG_FUNCTION("CONSTRUCTOR POR DEFECTO DE SparsePathManager");
+}
+
+SparsePathManager::SparsePathManager(uint32_t candidates, uint32_t rotation, double c1, double c2, double zeta, uint32_t wMax, double varsigma)
+:SmartPathManager(c1,c2,zeta,wMax,varsigma), m_maxCandidates(candidates), m_rotation(rotation), m_candidates(0){
+	NS_LOG_FUNCTION("CONSTRUCTOR PARAMETRICO DE SparsePathManager: "<<candidates<<rotation);
+	NS_ABORT_MSG_IF(candidates==0,"ERROR: La cantidad de candidatos de SparsePathManager debe ser mayor a cero");
+}
+
+SparsePathManager::~SparsePathManager(){
+	m_table.clear();
+}
+
+ArapPathManager*
+SparsePathManager::GetCopy() const{
+	SparsePathManager* aux = new SparsePathManager(*this);
+	aux->InitModels(ArapSimulator::GetDirectory());
+	return aux;
+}
+
+void
+SparsePathManager::CreateProbTable(const Ipv4Address& localIP){
+	AllocateCandidates(ArapSimulator::GetDirectory(),localIP,ArapSimulator::GetNumHops());
+}
+
+void
+SparsePathManager::AllocateCandidates(const ArapNodeDirectory& directory, const Ipv4Address& localIP, uint32_t numHops){
+	m_directory = &directory;
+	m_numNodes = m_directory->GetCount();
+	m_localIndex = m_directory->GetIndex(localIP);
+	m_candidates = (m_numNodes>2 && m_maxCandidates>m_numNodes-2) ? m_numNodes-2 : m_maxCandidates;
+	NS_ABORT_MSG_IF(m_candidates+1<numHops,"ERROR: SparsePathManager necesita al menos "
+			<<numHops-1<<" candidatos para crear caminos de "<<numHops<<" saltos");
+	m_candidateRng = CreateObject<UniformRandomVariable>();
+	Candidate empty = {m_numNodes,0};
+	m_table.assign(m_numNodes*m_candidates,empty);
+	m_updates.assign(m_numNodes,0);
+	ResetRowVersions();
+
+	for(uint32_t i=0;i<m_numNodes;i++){
+		if(i==m_localIndex)
+			continue;
+		Candidate* row = GetCandidates(i);
+		uint32_t next = 0;
+		for(uint32_t j=0;j<m_candidates;j++){
+			if(m_candidates==m_numNodes-2){
+				//Todos los intermedios son candidatos, se toman en orden sin sorteo
+				while(next==m_localIndex || next==i)
+					next++;
+				row[j].index = next++;
+			}
+			else
+				row[j].index = SampleOutsider(i);
+			row[j].prob = 1.0f/m_candidates;
+		}
+	}
+}
+
+uint32_t
+SparsePathManager::FindCandidate(uint32_t targetIndex, uint32_t mediumIndex) const{
+	const Candidate* row = GetCandidates(targetIndex);
+	for(uint32_t j=0;j<m_candidates;j++){
+		if(row[j].index==mediumIndex)
+			return j;
+	}
+	return m_candidates;
+}
+
+uint32_t
+SparsePathManager::FindWeakest(uint32_t targetIndex) const{
+	const Candidate* row = GetCandidates(targetIndex);
+	uint32_t weakest = 0;
+	for(uint32_t j=1;j<m_candidates;j++){
+		if(row[j].prob<row[weakest].prob)
+			weakest = j;
+	}
+	return weakest;
+}
+
+uint32_t
+SparsePathManager::SampleOutsider(uint32_t targetIndex){
+	if(m_candidates>=m_numNodes-2)
+		return m_numNodes; //La fila tiene todos los intermedios
+	/* Como K es pequeño frente a N, sortear hasta encontrar un intermedio
+	 * valido es mas barato que construir la lista de los que no son candidatos
+	 */
+	while(true){
+		uint32_t index = m_candidateRng->GetInteger(0,m_numNodes-1);
+		if(index!=m_localIndex && index!=targetIndex && FindCandidate(targetIndex,index)==m_candidates)
+			return index;
+	}
+}
+
+void
+SparsePathManager::RotateCandidates(uint32_t targetIndex){
+	uint32_t outsider = SampleOutsider(targetIndex);
+	if(outsider==m_numNodes)
+		return;
+	Candidate& weakest = GetCandidates(targetIndex)[FindWeakest(targetIndex)];
+	NS_LOG_LOGIC("Rotacion de candidatos hacia "<<m_directory->GetAddress(targetIndex)<<": sale "
+			<<m_directory->GetAddress(weakest.index)<<", entra "<<m_directory->GetAddress(outsider));
+	weakest.index = outsider;
+	weakest.prob = 1.0f/m_candidates;
+	Renormalize(targetIndex);
+}
+
+void
+SparsePathManager::Renormalize(uint32_t targetIndex){
+	Candidate* row = GetCandidates(targetIndex);
+	double sum = 0;
+	for(uint32_t j=0;j<m_candidates;j++)
+		sum += row[j].prob;
+	for(uint32_t j=0;j<m_candidates;j++)
+		row[j].prob = (sum>0) ? row[j].prob/sum : 1.0f/m_candidates;
+	InvalidateRow(targetIndex);
+}
+
+const double
+SparsePathManager::GetProbability(const Ipv4Address& target, const Ipv4Address& medium){
+	uint32_t targetIndex = m_directory->GetIndex(target);
+	uint32_t position = FindCandidate(targetIndex,m_directory->GetIndex(medium));
+	return (position==m_candidates) ? 0 : GetCandidates(targetIndex)[position].prob;
+}
+
+void
+SparsePathManager::SetProbability(const double& prob, const Ipv4Address& target, const Ipv4Address& medium){
+	uint32_t targetIndex = m_directory->GetIndex(target);
+	uint32_t mediumIndex = m_directory->GetIndex(medium);
+	uint32_t position = FindCandidate(targetIndex,mediumIndex);
+	if(position==m_candidates){
+		if(prob<=0)
+			return;
+		//Un intermedio fuera de la fila entra en lugar del candidato mas debil
+		position = FindWeakest(targetIndex);
+		GetCandidates(targetIndex)[position].index = mediumIndex;
+	}
+	GetCandidates(targetIndex)[position].prob = prob;
+	InvalidateRow(targetIndex);
+}
+
+void
+SparsePathManager::HandleExplorer(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt){
+	uint32_t targetIndex = m_directory->FindIndex(target);
+	if(targetIndex==ArapNodeDirectory::INVALID_INDEX || targetIndex>=m_stochasticModel.size()) //Esta condicion siempre deberia ser false (Si debe existir el modelo)
+		NS_ABORT_MSG("No se ha encontrado un modelo estocastico para el nodo con IP "<<target);
+
+	ExplorerAntsStatistics& stats = m_stochasticModel[targetIndex];
+	stats.UpdateModel(rtt.GetMilliSeconds());
+	uint32_t position = FindCandidate(targetIndex,m_directory->GetIndex(medium));
+	if(position==m_candidates){
+		//El intermedio salio de la fila mientras la exploradora estaba en viaje, solo se actualiza el modelo
+		return;
+	}
+
+	//Misma actualizacion de SmartPathManager, restringida a los candidatos
+	double r = GetR(rtt.GetMilliSeconds(), stats.GetMean(), stats.GetVariance(),stats.GetWBest(), stats.GetWCount());
+	Candidate* row = GetCandidates(targetIndex);
+	for(uint32_t j=0;j<m_candidates;j++){
+		if(j==position)
+			row[j].prob = row[j].prob+r*(1-row[j].prob);
+		else
+			row[j].prob = row[j].prob-r*row[j].prob;
+	}
+	if(row[position].prob>MAX_PROB && m_candidates>1){
+		double probGain = (row[position].prob-MAX_PROB)/(m_candidates-1);
+		row[position].prob = MAX_PROB;
+		for(uint32_t j=0;j<m_candidates;j++){
+			if(j!=position)
+				row[j].prob = row[j].prob+probGain;
+		}
+	}
+
+	if(m_rotation>0 && ++m_updates[targetIndex]>=m_rotation){
+		m_updates[targetIndex] = 0;
+		RotateCandidates(targetIndex);
+	}
+	else
+		Renormalize(targetIndex);
+}
+
+std::list<Ipv4Address>
+SparsePathManager::CreatePath(const Ipv4Address& target){
+	std::list<Ipv4Address> path;
+	SampleCandidates(m_directory->GetIndex(target),ArapSimulator::GetNumHops()-1,path);
+	/* Se agrega el nodo destino como elemento final del camino */
+	path.push_back(target);
+	return path;
+}
+
+void
+SparsePathManager::SampleCandidates(uint32_t targetIndex, uint32_t count, std::list<Ipv4Address>& path){
+	const Candidate* row = GetCandidates(targetIndex);
+
+	/* Muestreo sin reemplazo entre los candidatos: cada seleccionado
+	 * se descuenta del peso restante
+	 */
+	std::vector<double> weights(m_candidates);
+	double remaining = 0;
+	for(uint32_t j=0;j<m_candidates;j++){
+		weights[j] = row[j].prob;
+		remaining += weights[j];
+	}
+	std::vector<bool> chosen(m_candidates,false);
+	for(uint32_t hop=0;hop<count;hop++){
+		uint32_t pick = m_candidates;
+		if(remaining>0){
+			double x = m_candidateRng->GetValue(0,remaining);
+			for(uint32_t j=0;j<m_candidates;j++){
+				if(chosen[j] || weights[j]<=0)
+					continue;
+				pick = j;
+				if(x<weights[j])
+					break;
+				x -= weights[j];
+			}
+		}
+		if(pick==m_candidates){
+			//Sin peso disponible se elige de manera uniforme entre los candidatos restantes
+			uint32_t skip = m_candidateRng->GetInteger(0,m_candidates-hop-1);
+			for(pick=0;pick<m_candidates;pick++){
+				if(chosen[pick])
+					continue;
+				if(skip==0)
+					break;
+				skip--;
+			}
+		}
+		chosen[pick] = true;
+		remaining -= weights[pick];
+		path.push_back(m_directory->GetAddress(row[pick].index));
+	}
+}
+
+void
+SparsePathManager::GetExplorerMediums(uint32_t targetIndex, std::vector<uint32_t>& mediums) const{
+	mediums.clear();
+	const Candidate* row = GetCandidates(targetIndex);
+	for(uint32_t j=0;j<m_candidates;j++)
+		mediums.push_back(row[j].index);
+}
+
+void
+SparsePathManager::PrintProbTable(const Ipv4Address& localIP){
+	std::ostringstream oss;
+	/*Mismo nombre de archivo que ArapPathManager::PrintProbTable(), con formato disperso*/
+	oss<<"tablas/"<<localIP<<"_"<<Simulator::Now().GetSeconds()<<"_"<<RngSeedManager::GetSeed()<<"_"<<RngSeedManager::GetRun()<<".csv";
+	std::string name = oss.str();
+	std::ofstream file (name.c_str());
+	if (!file.is_open()){
+		NS_LOG_INFO("Fallo el crear el archivo de nombre: "+name);
+		return;
+	}
+	file<<"Destino,Intermedio,Probabilidad\n";
+	for(uint32_t i=0;i<m_numNodes;i++){
+		if(i==m_localIndex)
+			continue;
+		const Candidate* row = GetCandidates(i);
+		for(uint32_t j=0;j<m_candidates;j++)
+			file<<m_directory->GetAddress(i)<<","<<m_directory->GetAddress(row[j].index)<<","<<std::fixed<<row[j].prob<<"\n";
+	}
+	file.close();
+}
+
+void
+SparsePathManager::ImportProbTable(const std::map<Ipv4Address,std::map<Ipv4Address,double> >& table){
+	typedef std::map<Ipv4Address,std::map<Ipv4Address,double> > Table;
+	for(Table::const_iterator it = table.begin();it!=table.end();it++){
+		uint32_t targetIndex = m_directory->GetIndex(it->first);
+		std::vector<std::pair<double,uint32_t> > entries;
+		for(std::map<Ipv4Address,double>::const_iterator col = it->second.begin();col!=it->second.end();col++){
+			uint32_t mediumIndex = m_directory->GetIndex(col->first);
+			if(col->second>0 && mediumIndex!=m_localIndex && mediumIndex!=targetIndex)
+				entries.push_back(std::make_pair(col->second,mediumIndex));
+		}
+		std::sort(entries.rbegin(),entries.rend()); //Mayor probabilidad primero
+
+		Candidate* row = GetCandidates(targetIndex);
+		for(uint32_t j=0;j<m_candidates;j++)
+			row[j].index = m_numNodes; //Fila vacia, para que SampleOutsider() no descarte los candidatos anteriores
+		uint32_t j=0;
+		for(;j<m_candidates && j<entries.size();j++){
+			row[j].index = entries[j].second;
+			row[j].prob = entries[j].first;
+		}
+		for(;j<m_candidates;j++){
+			uint32_t outsider = SampleOutsider(targetIndex);
+			if(outsider==m_numNodes){
+				//Todos los intermedios son candidatos, se toma el primero que falta en la fila
+				outsider = 0;
+				while(outsider==m_localIndex || outsider==targetIndex || FindCandidate(targetIndex,outsider)!=m_candidates)
+					outsider++;
+			}
+			row[j].index = outsider;
+			row[j].prob = 0;
+		}
+		m_updates[targetIndex] = 0;
+		Renormalize(targetIndex);
+	}
+}
+
+void
+SparsePathManager::ExportProbTable(std::map<Ipv4Address,std::map<Ipv4Address,double> >& table) const{
+	/* Se exporta la tabla completa (Cero fuera de los candidatos) para que
+	 * las réplicas se puedan promediar igual que las tablas densas
+	 */
+	table.clear();
+	for(uint32_t i=0;i<m_numNodes;i++){
+		if(i==m_localIndex)
+			continue;
+		std::map<Ipv4Address,double>& targetMap = table[m_directory->GetAddress(i)];
+		for(uint32_t j=0;j<m_numNodes;j++){
+			if(j!=m_localIndex)
+				targetMap[m_directory->GetAddress(j)] = 0;
+		}
+		const Candidate* row = GetCandidates(i);
+		for(uint32_t j=0;j<m_candidates;j++)
+			targetMap[m_directory->GetAddress(row[j].index)] = row[j].prob;
+	}
+}
+
+void
+SparsePathManager::ExportRow(uint32_t targetIndex, std::vector<std::pair<uint32_t,double> >& row) const{
+	row.clear();
+	const Candidate* candidates = GetCandidates(targetIndex);
+	for(uint32_t j=0;j<m_candidates;j++){
+		if(candidates[j].index<m_numNodes && candidates[j].prob!=0)
+			row.push_back(std::make_pair(candidates[j].index,(double)candidates[j].prob));
+	}
+	std::sort(row.begin(),row.end());
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef SPARSE_PATH_MANAGER_H
+#define SPARSE_PATH_MANAGER_H
+
+#include "ns3/smart-path-manager.h"
+#include <vector>
+
+#define DEFAULT_SPARSE_CANDIDATES 8 //!<Valor por defecto de la cantidad de intermedios candidatos por destino
+#define DEFAULT_SPARSE_ROTATION 32 //!<Valor por defecto de las respuestas de exploradoras por fila entre rotaciones de candidatos
+
+namespace ns3 {
+
+/**
+ * Variante de SmartPathManager para redes grandes, donde cada fila de la tabla de
+ * probabilidades solo guarda K intermedios candidatos (Índice y probabilidad en float) en
+ * lugar de las N columnas, por lo que la memoria de cada nodo es O(N·K) y no O(N²).
+ *
+ * - Al crear la tabla los K candidatos de cada destino se eligen al azar, con probabilidad
+ *   uniforme 1/K. Los demás intermedios tienen probabilidad cero.
+ * - Las exploradoras solo se envian por los candidatos (GetExplorerMediums()), y las
+ *   respuestas actualizan la fila igual que SmartPathManager pero solo entre los candidatos.
+ * - Cada cierta cantidad de respuestas de exploradoras de una fila, el candidato de menor
+ *   probabilidad se reemplaza por un intermedio al azar fuera de la fila, que entra con
+ *   probabilidad 1/K. Así la fila recorre con el tiempo toda la red.
+ * - Luego de cada cambio la fila se renormaliza (Sus probabilidades se escalan para que sumen
+ *   1), lo que también evita que se acumule el error de redondeo de float.
+ *
+ * La tabla se imprime en formato disperso: una línea "Destino,Intermedio,Probabilidad" por
+ * candidato.
+ */
+class SparsePathManager: public SmartPathManager {
+public:
+
+	SparsePathManager();
+
+	/**
+	 * Constructor paramétrico.
+	 *
+	 * @param[in] candidates Cantidad máxima de intermedios candidatos por destino (K)
+	 *
+	 * @param[in] rotation Respuestas de exploradoras de una fila entre rotaciones de candidatos (0 = sin rotación)
+	 *
+	 * @param[in] c1 Valor de C1
+	 *
+	 * @param[in] c2 Valor de C2
+	 *
+	 * @param[in] zeta Valor de Z
+	 *
+	 * @param[in] wMax Tamaño máximo de la ventana de observación
+	 *
+	 * @param[in] varsigma Varsigma. Valor usado en el modelo estocástico
+	 */
+	SparsePathManager(uint32_t candidates, uint32_t rotation, double c1, double c2, double zeta, uint32_t wMax, double varsigma);
+	virtual ~SparsePathManager();
+
+	virtual const double GetProbability(const Ipv4Address& target, const Ipv4Address& medium);
+	virtual void SetProbability(const double& prob, const Ipv4Address& target, const Ipv4Address& medium);
+	virtual void CreateProbTable(const Ipv4Address& localIP);
+	virtual void PrintProbTable(const Ipv4Address& localIP);
+	virtual void ExportProbTable(std::map<Ipv4Address,std::map<Ipv4Address,double> >& table) const;
+	virtual void ExportRow(uint32_t targetIndex, std::vector<std::pair<uint32_t,double> >& row) const;
+
+	/**
+	 * Cada fila del mapa se reduce a sus K intermedios de mayor probabilidad (Completando con
+	 * intermedios al azar si tiene menos de K distintos de cero) y se renormaliza.
+	 *
+	 * @param[in] table Mapa con las filas a copiar (Fila: IP destino, Columna: IP intermedio)
+	 */
+	virtual void ImportProbTable(const std::map<Ipv4Address,std::map<Ipv4Address,double> >& table);
+	virtual void HandleExplorer(const Ipv4Address& target, const Ipv4Address& medium, const Time& rtt);
+	virtual ArapPathManager* GetCopy() const;
+	virtual std::list<Ipv4Address> CreatePath(const Ipv4Address& target);
+	virtual void GetExplorerMediums(uint32_t targetIndex, std::vector<uint32_t>& mediums) const;
+
+protected:
+
+	/**
+	 * Crea la tabla con K candidatos al azar por destino, cada uno con probabilidad 1/K. Lo
+	 * llama CreateProbTable() con el directorio y los saltos de la simulación.
+	 *
+	 * @param[in] directory Directorio de nodos usado para indexar la tabla
+	 *
+	 * @param[in] localIP IP del nodo al que pertenece la tabla
+	 *
+	 * @param[in] numHops Saltos de los caminos (Se necesitan al menos numHops-1 candidatos)
+	 */
+	void AllocateCandidates(const ArapNodeDirectory& directory, const Ipv4Address& localIP, uint32_t numHops);
+
+	/**
+	 * Selecciona intermedios distintos entre los candidatos de un destino (Sin reemplazo), con
+	 * probabilidad proporcional a la de cada candidato, y los agrega al final del camino.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @param[in] count Cantidad de intermedios a seleccionar (<= K)
+	 *
+	 * @param[out] path Camino al que se agregan los intermedios seleccionados
+	 */
+	void SampleCandidates(uint32_t targetIndex, uint32_t count, std::list<Ipv4Address>& path);
+
+private:
+
+	/**
+	 * Intermedio candidato de una fila.
+	 */
+	struct Candidate {
+		uint32_t index; //!< Índice del intermedio en ArapNodeDirectory
+		float prob; //!< Probabilidad de ir al destino a través del intermedio
+	};
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @return Puntero al primer candidato de la fila del destino (m_candidates elementos)
+	 */
+	Candidate* GetCandidates(uint32_t targetIndex){
+		return &m_table[targetIndex*m_candidates];
+	}
+
+	/**
+	 * @copydoc GetCandidates(uint32_t)
+	 */
+	const Candidate* GetCandidates(uint32_t targetIndex) const{
+		return &m_table[targetIndex*m_candidates];
+	}
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @param[in] mediumIndex Índice del intermedio
+	 *
+	 * @return Posición del intermedio en la fila, o m_candidates si no es candidato
+	 */
+	uint32_t FindCandidate(uint32_t targetIndex, uint32_t mediumIndex) const;
+
+	/**
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @return Posición del candidato de menor probabilidad de la fila
+	 */
+	uint32_t FindWeakest(uint32_t targetIndex) const;
+
+	/**
+	 * Sortea un intermedio que no sea candidato de la fila (Ni el nodo local ni el destino).
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 *
+	 * @return Índice del intermedio, o m_numNodes si todos los intermedios son candidatos
+	 */
+	uint32_t SampleOutsider(uint32_t targetIndex);
+
+	/**
+	 * Reemplaza el candidato de menor probabilidad de la fila por un intermedio al azar.
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 */
+	void RotateCandidates(uint32_t targetIndex);
+
+	/**
+	 * Escala las probabilidades de la fila para que sumen 1 (Uniforme si todas son cero).
+	 *
+	 * @param[in] targetIndex Índice del nodo destino
+	 */
+	void Renormalize(uint32_t targetIndex);
+
+	uint32_t m_maxCandidates; //!< Cantidad de candidatos por fila indicada en el archivo de parámetros (K)
+	uint32_t m_rotation; //!< Respuestas de exploradoras de una fila entre rotaciones (0 = sin rotación)
+	uint32_t m_candidates; //!< Candidatos por fila usados en la simulación (K acotado a la cantidad de nodos-2)
+	std::vector<Candidate> m_table; //!< Tabla dispersa, m_candidates elementos por fila (Fila: índice destino)
+	std::vector<uint32_t> m_updates; //!< Respuestas de exploradoras de cada fila desde la última rotación
+	Ptr<UniformRandomVariable> m_candidateRng; //!< Flujo aleatorio para elegir candidatos y muestrear caminos
+};
+
+} /* namespace ns3 */
+
+#endif /* SPARSE_PATH_MANAGER_H */
@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "topology-factory.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TopologyFactory");
+
+TopologyFactory::TopologyFactory(){
+}
+
+TopologyFactory::~TopologyFactory(){
+}
+
+ArapTopology*
+TopologyFactory::GetInstance(const std::string& caseName, std::istringstream& iss){
+	if(caseName=="estrella"){
+		return new ArapStarTopology();
+	}
+	else if(caseName=="multi-hub"){
+		uint32_t numHubs;
+		if(!(iss>>numHubs))
+			NS_ABORT_MSG("ERROR: Debe indicar la cantidad de HUB de la topologia multi-hub");
+		return new ArapMultiHubTopology(numHubs);
+	}
+	else if(caseName=="dumbbell"){
+		//Dos HUB unidos por un solo enlace troncal
+		return new ArapMultiHubTopology(2);
+	}
+	else if(caseName=="grilla"){
+		uint32_t rows,cols;
+		if(!(iss>>rows>>cols))
+			NS_ABORT_MSG("ERROR: Debe indicar las filas y columnas de la topologia grilla");
+		return new ArapGridTopology(rows,cols);
+	}
+	else if(caseName=="archivo"){
+		std::string format,filename;
+		if(!(iss>>format>>filename))
+			NS_ABORT_MSG("ERROR: Debe indicar el formato y la ruta del archivo de topologia");
+		return new ArapFileTopology(format,filename);
+	}
+	/*Aqui se agrega otro caso cuando se desee extender ArapTopology
+	else if(caseName==<Identificador de caso nuevo>){
+		... <Definicion del caso>
+	}*/
+	else
+		return NULL;
+}
+} /* namespace ns3 */
@@ -0,0 +1,37 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/** @file */
+#ifndef TOPOLOGY_FACTORY_H
+#define TOPOLOGY_FACTORY_H
+
+#include "arap-topology.h"
+#include <sstream>
+
+namespace ns3 {
+
+/**
+ * Fábrica de objetos que heredan de ArapTopology, permite seleccionar la topología de red
+ * y leer sus parámetros desde el archivo de parámetros (Ver PARAM_TOPOLOGY).
+ *
+ * Para agregar una nueva topología solo se debe crear una nueva clase que herede de
+ * ArapTopology y definir su caso en el método TopologyFactory::GetInstance(), con el orden
+ * de lectura de sus parámetros.
+ */
+class TopologyFactory {
+
+public:
+	TopologyFactory();
+	~TopologyFactory();
+
+	/**
+	 * Crea las instancias de las especializaciones de ArapTopology
+	 * @param[in] caseName Identificador del caso para el cual se creará la topología
+	 * @param[in] iss Flujo de datos de donde se leeran los parámetros del caso (De tenerlos)
+	 *
+	 * @return Puntero a un nuevo objeto creado según el caso indicado, o NULL si el caso no
+	 * existe. La memoria debe ser liberada por ArapSimulator
+	 */
+	ArapTopology* GetInstance(const std::string& caseName, std::istringstream& iss);
+};
+} /* namespace ns3 */
+
+#endif /* TOPOLOGY_FACTORY_H */
@@ -2,10 +2,39 @@
 
 // Include a header file from your module to test.
 #include "ns3/arap-node.h"
+#include "ns3/quantile-sketch.h"
+#include "ns3/distinct-counter.h"
+#include "ns3/arap-anonymity-metrics.h"
+#include "ns3/routing-table.h"
+#include "ns3/load-ants-statistics.h"
+#include "ns3/arap-path-manager.h"
+#include "ns3/smart-path-manager.h"
+#include "ns3/sparse-path-manager.h"
+#include "ns3/arap-ant-header.h"
+#include "ns3/arap-workload.h"
+#include "ns3/arap-delay-channel.h"
+#include "ns3/arap-abstract-network.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/packet.h"
+#include "ns3/arap-node-directory.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include "ns3/data-rate.h"
+#include "ns3/rng-seed-manager.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
@@ -46,6 +75,1596 @@ AnonymityTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * @param[in] sorted Muestras en orden
+ *
+ * @param[in] q Cuantil
+ *
+ * @return Muestra del cuantil con el mismo rango que usa QuantileSketch::GetQuantile()
+ */
+static double
+ExactQuantile (const std::vector<double>& sorted, double q)
+{
+  return sorted[(uint32_t)std::floor (q * (sorted.size () - 1))];
+}
+
+/**
+ * Los cuantiles de QuantileSketch tienen a lo sumo el error relativo SKETCH_RELATIVE_ACCURACY.
+ */
+class QuantileSketchAccuracyTestCase : public TestCase
+{
+public:
+  QuantileSketchAccuracyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchAccuracyTestCase::QuantileSketchAccuracyTestCase ()
+  : TestCase ("QuantileSketch: relative error bound of the quantiles")
+{
+}
+
+void
+QuantileSketchAccuracyTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<ExponentialRandomVariable> rtt = CreateObject<ExponentialRandomVariable> ();
+  rtt->SetAttribute ("Mean", DoubleValue (0.25));
+  rtt->SetStream (1);
+
+  QuantileSketch sketch;
+  std::vector<double> samples;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      double value = 0.001 + rtt->GetValue ();
+      samples.push_back (value);
+      sketch.Add (value);
+    }
+  std::sort (samples.begin (), samples.end ());
+
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), samples.size (), "Wrong sample count");
+  for (double q = 0; q <= 1; q += 0.01)
+    {
+      double exact = ExactQuantile (samples, q);
+      NS_TEST_ASSERT_MSG_EQ_TOL (sketch.GetQuantile (q), exact, exact * SKETCH_RELATIVE_ACCURACY * (1 + 1e-9),
+                                 "Quantile " << q << " outside the relative error bound");
+    }
+  NS_TEST_ASSERT_MSG_EQ (QuantileSketch ().GetQuantile (0.5), 0, "An empty sketch must return 0");
+}
+
+/**
+ * Con un rango de valores mayor a SKETCH_MAX_BUCKETS cubetas, las menores se unen: la
+ * memoria queda acotada y los cuantiles altos mantienen su precisión.
+ */
+class QuantileSketchCollapseTestCase : public TestCase
+{
+public:
+  QuantileSketchCollapseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchCollapseTestCase::QuantileSketchCollapseTestCase ()
+  : TestCase ("QuantileSketch: lowest buckets collapse at SKETCH_MAX_BUCKETS")
+{
+}
+
+void
+QuantileSketchCollapseTestCase::DoRun (void)
+{
+  //Valores de 1e-6 a 1e6: unas 1380 cubetas con la precision por defecto
+  QuantileSketch sketch;
+  std::vector<double> samples;
+  for (int32_t exponent = -60; exponent <= 60; exponent++)
+    {
+      double value = std::pow (10.0, exponent / 10.0);
+      samples.push_back (value);
+      sketch.Add (value);
+    }
+  std::sort (samples.begin (), samples.end ());
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), samples.size (), "Collapsing buckets must not lose samples");
+
+  std::ostringstream out;
+  sketch.Serialize (out);
+  uint32_t header = 2 * sizeof (uint64_t) + sizeof (int32_t) + sizeof (uint32_t);
+  NS_TEST_ASSERT_MSG_EQ ((out.str ().size () - header <= SKETCH_MAX_BUCKETS * sizeof (uint32_t)), true,
+                         "The sketch holds more than SKETCH_MAX_BUCKETS buckets");
+
+  //Los cuantiles por encima de las cubetas unidas conservan el error relativo
+  for (double q = 0.5; q <= 1; q += 0.05)
+    {
+      double exact = ExactQuantile (samples, q);
+      NS_TEST_ASSERT_MSG_EQ_TOL (sketch.GetQuantile (q), exact, exact * SKETCH_RELATIVE_ACCURACY * (1 + 1e-9),
+                                 "Quantile " << q << " lost precision after collapsing");
+    }
+  //Las muestras de las cubetas unidas se cuentan en la menor cubeta que queda
+  NS_TEST_ASSERT_MSG_GT (sketch.GetQuantile (0), samples.front (), "The minimum must be in the collapsed bucket");
+  NS_TEST_ASSERT_MSG_LT (sketch.GetQuantile (0), samples.back (), "The collapsed bucket must be the lowest one");
+}
+
+/**
+ * Combinar resúmenes equivale a agregar todas las muestras a uno solo.
+ */
+class QuantileSketchMergeTestCase : public TestCase
+{
+public:
+  QuantileSketchMergeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchMergeTestCase::QuantileSketchMergeTestCase ()
+  : TestCase ("QuantileSketch: Merge equals adding all the samples")
+{
+}
+
+void
+QuantileSketchMergeTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (2);
+  Ptr<UniformRandomVariable> value = CreateObject<UniformRandomVariable> ();
+  value->SetStream (1);
+
+  //Rangos distintos y superpuestos, con ceros y un resumen vacio
+  QuantileSketch all, low, high, empty;
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      double x = value->GetValue (0.01, 2);
+      low.Add (x);
+      all.Add (x);
+      double y = value->GetValue (1, 500);
+      high.Add (y);
+      all.Add (y);
+    }
+  low.Add (0);
+  all.Add (0);
+
+  QuantileSketch merged;
+  merged.Merge (high);
+  merged.Merge (empty);
+  merged.Merge (low);
+  NS_TEST_ASSERT_MSG_EQ (merged.GetCount (), all.GetCount (), "Merged count differs");
+  for (double q = 0; q <= 1; q += 0.01)
+    {
+      NS_TEST_ASSERT_MSG_EQ (merged.GetQuantile (q), all.GetQuantile (q), "Merged quantile " << q << " differs");
+    }
+  std::ostringstream mergedOut, allOut;
+  merged.Serialize (mergedOut);
+  all.Serialize (allOut);
+  NS_TEST_ASSERT_MSG_EQ ((mergedOut.str () == allOut.str ()), true, "Merged buckets differ");
+}
+
+/**
+ * La media y la varianza de Welford coinciden con el cálculo en dos pasadas, también con
+ * valores de gran magnitud y poca dispersión.
+ */
+class LoadAntsStatisticsMomentsTestCase : public TestCase
+{
+public:
+  LoadAntsStatisticsMomentsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LoadAntsStatisticsMomentsTestCase::LoadAntsStatisticsMomentsTestCase ()
+  : TestCase ("LoadAntsStatistics: Welford mean and variance against a two-pass reference")
+{
+}
+
+void
+LoadAntsStatisticsMomentsTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (3);
+  Ptr<NormalRandomVariable> noise = CreateObject<NormalRandomVariable> ();
+  noise->SetAttribute ("Mean", DoubleValue (0));
+  noise->SetAttribute ("Variance", DoubleValue (1));
+  noise->SetStream (1);
+
+  LoadAntsStatistics statistics;
+  Ipv4Address targets[2] = {Ipv4Address ("10.1.1.2"), Ipv4Address ("10.1.2.2")};
+  std::vector<double> samples[2];
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      uint32_t target = i % 2;
+      double rtt = 1e6 + target + noise->GetValue ();
+      samples[target].push_back (rtt);
+      statistics.UpdateModel (rtt, targets[target]);
+    }
+
+  std::vector<double> all (samples[0]);
+  all.insert (all.end (), samples[1].begin (), samples[1].end ());
+  double sum = 0;
+  for (uint32_t i = 0; i < all.size (); i++)
+    sum += all[i];
+  double mean = sum / all.size ();
+  double squares = 0;
+  for (uint32_t i = 0; i < all.size (); i++)
+    squares += (all[i] - mean) * (all[i] - mean);
+  double variance = squares / all.size ();
+
+  NS_TEST_ASSERT_MSG_EQ (statistics.GetNumSamples (), all.size (), "Wrong sample count");
+  NS_TEST_ASSERT_MSG_EQ_TOL (statistics.GetMean (), mean, mean * 1e-12, "Mean differs from the two-pass reference");
+  NS_TEST_ASSERT_MSG_EQ_TOL (statistics.GetVariance (), variance, variance * 1e-6, "Variance differs from the two-pass reference");
+
+  for (uint32_t target = 0; target < 2; target++)
+    {
+      const LoadAntsStatistics::TargetStatistics& targetStats = statistics.GetTargetsMap ().find (targets[target])->second;
+      double targetSum = 0, targetSquares = 0;
+      for (uint32_t i = 0; i < samples[target].size (); i++)
+        targetSum += samples[target][i];
+      double targetMean = targetSum / samples[target].size ();
+      for (uint32_t i = 0; i < samples[target].size (); i++)
+        targetSquares += (samples[target][i] - targetMean) * (samples[target][i] - targetMean);
+      double targetVariance = targetSquares / samples[target].size ();
+      NS_TEST_ASSERT_MSG_EQ (targetStats.numSamples, samples[target].size (), "Wrong target sample count");
+      NS_TEST_ASSERT_MSG_EQ_TOL (targetStats.mean, targetMean, targetMean * 1e-12, "Target mean differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (targetStats.GetVariance (), targetVariance, targetVariance * 1e-6, "Target variance differs");
+    }
+}
+
+/**
+ * Serialize() y Deserialize() de LoadAntsStatistics (Y de sus QuantileSketch) restauran el mismo estado.
+ */
+class LoadAntsStatisticsSerializeTestCase : public TestCase
+{
+public:
+  LoadAntsStatisticsSerializeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LoadAntsStatisticsSerializeTestCase::LoadAntsStatisticsSerializeTestCase ()
+  : TestCase ("LoadAntsStatistics: Serialize and Deserialize round trip")
+{
+}
+
+void
+LoadAntsStatisticsSerializeTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (4);
+  Ptr<ExponentialRandomVariable> rtt = CreateObject<ExponentialRandomVariable> ();
+  rtt->SetStream (1);
+
+  LoadAntsStatistics statistics;
+  Ipv4Address targets[3] = {Ipv4Address ("10.1.1.2"), Ipv4Address ("10.1.2.2"), Ipv4Address ("10.1.3.2")};
+  for (uint32_t i = 0; i < 3000; i++)
+    statistics.UpdateModel (rtt->GetValue (), targets[i % 3]);
+
+  std::stringstream stream;
+  statistics.Serialize (stream);
+  LoadAntsStatistics restored;
+  restored.UpdateModel (5, Ipv4Address ("10.1.9.2")); //El estado anterior se reemplaza
+  restored.Deserialize (stream);
+  NS_TEST_ASSERT_MSG_EQ (stream.fail (), false, "Deserialize failed");
+
+  NS_TEST_ASSERT_MSG_EQ (restored.GetNumSamples (), statistics.GetNumSamples (), "Sample count differs");
+  NS_TEST_ASSERT_MSG_EQ (restored.GetMean (), statistics.GetMean (), "Mean differs");
+  NS_TEST_ASSERT_MSG_EQ (restored.GetVariance (), statistics.GetVariance (), "Variance differs");
+  NS_TEST_ASSERT_MSG_EQ (restored.GetTargetsMap ().size (), statistics.GetTargetsMap ().size (), "Target count differs");
+  for (uint32_t target = 0; target < 3; target++)
+    {
+      const LoadAntsStatistics::TargetStatistics& original = statistics.GetTargetsMap ().find (targets[target])->second;
+      const LoadAntsStatistics::TargetStatistics& copy = restored.GetTargetsMap ().find (targets[target])->second;
+      NS_TEST_ASSERT_MSG_EQ (copy.numSamples, original.numSamples, "Target sample count differs");
+      NS_TEST_ASSERT_MSG_EQ (copy.mean, original.mean, "Target mean differs");
+      NS_TEST_ASSERT_MSG_EQ (copy.m2, original.m2, "Target m2 differs");
+      for (double q = 0; q <= 1; q += 0.05)
+        {
+          NS_TEST_ASSERT_MSG_EQ (copy.sketch.GetQuantile (q), original.sketch.GetQuantile (q), "Target quantile " << q << " differs");
+        }
+    }
+
+  //Un flujo truncado marca el error en lugar de leer fuera del buffer
+  std::string bytes = stream.str ();
+  std::istringstream truncated (bytes.substr (0, bytes.size () / 2));
+  LoadAntsStatistics partial;
+  partial.Deserialize (truncated);
+  NS_TEST_ASSERT_MSG_EQ (truncated.fail (), true, "A truncated stream must fail");
+}
+
+/**
+ * ArapPathManager con una fila fija, para probar el muestreo de intermedios sin la simulación.
+ */
+class FixedRowPathManager : public ArapPathManager
+{
+public:
+  FixedRowPathManager (const ArapNodeDirectory& directory, const Ipv4Address& localIP)
+  {
+    AllocateTable (directory, localIP);
+  }
+
+  virtual ArapPathManager* GetCopy () const
+  {
+    return new FixedRowPathManager (*this);
+  }
+
+  void SetRow (uint32_t targetIndex, const std::vector<double>& row)
+  {
+    std::copy (row.begin (), row.end (), GetRow (targetIndex));
+    InvalidateRow (targetIndex);
+  }
+
+  std::vector<uint32_t> Sample (uint32_t targetIndex, uint32_t count)
+  {
+    std::list<Ipv4Address> path;
+    SampleIntermediates (targetIndex, count, path);
+    std::vector<uint32_t> indexes;
+    for (std::list<Ipv4Address>::iterator it = path.begin (); it != path.end (); it++)
+      indexes.push_back (m_directory->GetIndex (*it));
+    return indexes;
+  }
+};
+
+/**
+ * SampleIntermediates() elige intermedios distintos, nunca el destino ni el nodo local, y la
+ * frecuencia de cada elección coincide con el muestreo sin reemplazo proporcional a la fila.
+ */
+class SampleIntermediatesTestCase : public TestCase
+{
+public:
+  SampleIntermediatesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Muestrea caminos y verifica que no repitan nodos ni incluyan al destino o al nodo local.
+   *
+   * @return Cantidad de veces que se eligió cada nodo en cada salto
+   */
+  std::vector<std::vector<uint32_t> > CountHops (FixedRowPathManager& manager, uint32_t localIndex,
+                                                 uint32_t targetIndex, uint32_t hops, uint32_t paths);
+};
+
+SampleIntermediatesTestCase::SampleIntermediatesTestCase ()
+  : TestCase ("ArapPathManager: SampleIntermediates draws without replacement in proportion to the row")
+{
+}
+
+std::vector<std::vector<uint32_t> >
+SampleIntermediatesTestCase::CountHops (FixedRowPathManager& manager, uint32_t localIndex,
+                                        uint32_t targetIndex, uint32_t hops, uint32_t paths)
+{
+  std::vector<std::vector<uint32_t> > counts (hops, std::vector<uint32_t> (8, 0));
+  for (uint32_t i = 0; i < paths; i++)
+    {
+      std::vector<uint32_t> path = manager.Sample (targetIndex, hops);
+      NS_TEST_EXPECT_MSG_EQ (path.size (), hops, "Wrong number of intermediates");
+      for (uint32_t hop = 0; hop < path.size (); hop++)
+        {
+          NS_TEST_EXPECT_MSG_NE (path[hop], targetIndex, "The target was chosen as intermediate");
+          NS_TEST_EXPECT_MSG_NE (path[hop], localIndex, "The local node was chosen as intermediate");
+          NS_TEST_EXPECT_MSG_EQ ((std::count (path.begin (), path.end (), path[hop]) == 1), true, "Repeated intermediate");
+          counts[hop][path[hop]]++;
+        }
+    }
+  return counts;
+}
+
+void
+SampleIntermediatesTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (5);
+  NodeContainer nodes;
+  nodes.Create (8);
+  ArapNodeDirectory directory;
+  directory.Build (nodes, Ipv4Address ("10.0.0.0"));
+  uint32_t localIndex = 2;
+  uint32_t targetIndex = 5;
+  FixedRowPathManager manager (directory, directory.GetAddress (localIndex));
+
+  /* Fila con valores en el nodo local y el destino (Que se deben ignorar), un intermedio
+   * con probabilidad nula y pesos que no suman 1
+   */
+  double weights[8] = {0.1, 0.3, 0.7, 0.2, 0.15, 0.9, 0, 0.35};
+  std::vector<double> row (weights, weights + 8);
+  manager.SetRow (targetIndex, row);
+  row[localIndex] = 0;
+  row[targetIndex] = 0;
+  double total = 0;
+  for (uint32_t i = 0; i < 8; i++)
+    total += row[i];
+  for (uint32_t i = 0; i < 8; i++)
+    row[i] /= total;
+
+  uint32_t paths = 200000;
+  std::vector<std::vector<uint32_t> > counts = CountHops (manager, localIndex, targetIndex, 3, paths);
+
+  /* Primer salto: p(i). Segundo salto: suma sobre el primero k de p(k)·p(i)/(1-p(k)).
+   * Con 200000 caminos el desvío de cada frecuencia es menor a 0.0011
+   */
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      double second = 0;
+      for (uint32_t k = 0; k < 8; k++)
+        {
+          if (k != i && row[k] > 0)
+            second += row[k] * row[i] / (1 - row[k]);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (counts[0][i] / (double)paths, row[i], 0.006, "First hop frequency of node " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (counts[1][i] / (double)paths, second, 0.006, "Second hop frequency of node " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (counts[0][6] + counts[1][6] + counts[2][6], 0, "A node with probability 0 was chosen while weight remained");
+
+  /* Fila sin peso: se elige de manera uniforme entre los intermedios validos */
+  manager.SetRow (targetIndex, std::vector<double> (8, 0));
+  paths = 60000;
+  counts = CountHops (manager, localIndex, targetIndex, 4, paths);
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      if (i != localIndex && i != targetIndex)
+        NS_TEST_EXPECT_MSG_EQ_TOL (counts[0][i] / (double)paths, 1.0 / 6, 0.01, "Uniform fallback frequency of node " << i);
+    }
+
+  /* Caminos con todos los intermedios posibles */
+  manager.SetRow (targetIndex, std::vector<double> (weights, weights + 8));
+  CountHops (manager, localIndex, targetIndex, 6, 1000);
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Cada tipo de capa de ArapAntHeader se recupera igual luego de Serialize() y Deserialize(),
+ * con el tamaño fijo de su tipo y los campos en orden de red.
+ */
+class ArapAntHeaderRoundTripTestCase : public TestCase
+{
+public:
+  ArapAntHeaderRoundTripTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ArapAntHeaderRoundTripTestCase::ArapAntHeaderRoundTripTestCase ()
+  : TestCase ("ArapAntHeader: Serialize and Deserialize round trip of every layer type")
+{
+}
+
+void
+ArapAntHeaderRoundTripTestCase::DoRun (void)
+{
+  uint64_t antID = 0x0102030405060708ULL;
+  uint64_t sendTime = 0xF0E0D0C0B0A09080ULL;
+  Ipv4Address nextHop ("10.1.2.3");
+  Ipv4Address target ("192.168.255.254");
+  uint32_t messageSize = 37;
+
+  /* Hormiga con dos capas intermedias sobre una final y el mensaje, como la arma ArapNode */
+  ArapAntHeader finalLayer;
+  finalLayer.SetFinalLayer (antID, ArapAntHeader::ANT_LOAD, sendTime, target, messageSize);
+  NS_TEST_EXPECT_MSG_EQ (finalLayer.GetSerializedSize (), ArapAntHeader::FINAL_LAYER_SIZE, "Wrong final layer size");
+  Ptr<Packet> packet = Create<Packet> (messageSize);
+  packet->AddHeader (finalLayer);
+  ArapAntHeader inner;
+  inner.SetMediumLayer (antID, target, packet->GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (inner.GetSerializedSize (), ArapAntHeader::MEDIUM_LAYER_SIZE, "Wrong medium layer size");
+  packet->AddHeader (inner);
+  ArapAntHeader outer;
+  outer.SetMediumLayer (antID, nextHop, packet->GetSize ());
+  packet->AddHeader (outer);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 2 * ArapAntHeader::MEDIUM_LAYER_SIZE + ArapAntHeader::FINAL_LAYER_SIZE + messageSize,
+                         "Wrong ant size");
+
+  /* Orden de red: el primer Byte es el más significativo del ID y le sigue el tipo de capa */
+  uint8_t bytes[ArapAntHeader::MEDIUM_LAYER_SIZE];
+  packet->CopyData (bytes, sizeof(bytes));
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)bytes[0], 0x01, "The ant ID is not in network order");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)bytes[7], 0x08, "The ant ID is not in network order");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)bytes[8], (uint32_t)ArapAntHeader::LAYER_MEDIUM, "Wrong layer type byte");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)bytes[9], 10, "The next hop is not in network order");
+
+  ArapAntHeader header;
+  NS_TEST_EXPECT_MSG_EQ (packet->RemoveHeader (header), ArapAntHeader::MEDIUM_LAYER_SIZE, "Wrong medium layer read size");
+  NS_TEST_EXPECT_MSG_EQ (header.IsMedium (), true, "Outer layer is not a medium layer");
+  NS_TEST_EXPECT_MSG_EQ (header.GetAntID (), antID, "Wrong ant ID");
+  NS_TEST_EXPECT_MSG_EQ (header.GetNextHop (), nextHop, "Wrong next hop");
+  NS_TEST_EXPECT_MSG_EQ (header.GetLayerSize (), packet->GetSize (), "Wrong size of the remaining layers");
+
+  NS_TEST_EXPECT_MSG_EQ (packet->RemoveHeader (header), ArapAntHeader::MEDIUM_LAYER_SIZE, "Wrong medium layer read size");
+  NS_TEST_EXPECT_MSG_EQ (header.IsMedium (), true, "Inner layer is not a medium layer");
+  NS_TEST_EXPECT_MSG_EQ (header.GetNextHop (), target, "Wrong next hop");
+  NS_TEST_EXPECT_MSG_EQ (header.GetLayerSize (), packet->GetSize (), "Wrong size of the remaining layers");
+
+  NS_TEST_EXPECT_MSG_EQ (packet->RemoveHeader (header), ArapAntHeader::FINAL_LAYER_SIZE, "Wrong final layer read size");
+  NS_TEST_EXPECT_MSG_EQ (header.IsFinal (), true, "Last layer is not a final layer");
+  NS_TEST_EXPECT_MSG_EQ (header.GetAntID (), antID, "Wrong ant ID");
+  NS_TEST_EXPECT_MSG_EQ (header.GetAntType (), ArapAntHeader::ANT_LOAD, "Wrong ant type");
+  NS_TEST_EXPECT_MSG_EQ (header.GetSendTime (), sendTime, "Wrong send time");
+  NS_TEST_EXPECT_MSG_EQ (header.GetTarget (), target, "Wrong target");
+  NS_TEST_EXPECT_MSG_EQ (header.GetMessageSize (), messageSize, "Wrong message size");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), messageSize, "The message does not follow the final layer");
+
+  /* Capa final de exploradora reusando una cabecera que fue intermedia */
+  ArapAntHeader explorer;
+  explorer.SetFinalLayer (0, ArapAntHeader::ANT_EXPLORER, 0, Ipv4Address ("0.0.0.1"), 0);
+  packet = Create<Packet> ();
+  packet->AddHeader (explorer);
+  ArapAntHeader reused;
+  reused.SetMediumLayer (1, nextHop, 1);
+  NS_TEST_EXPECT_MSG_EQ (packet->RemoveHeader (reused), ArapAntHeader::FINAL_LAYER_SIZE, "Wrong final layer read size");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetLayerType (), ArapAntHeader::LAYER_FINAL, "Wrong layer type");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetAntID (), 0, "Wrong ant ID");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetAntType (), ArapAntHeader::ANT_EXPLORER, "Wrong ant type");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetSendTime (), 0, "Wrong send time");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetTarget (), Ipv4Address ("0.0.0.1"), "Wrong target");
+  NS_TEST_EXPECT_MSG_EQ (reused.GetMessageSize (), 0, "Wrong message size");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 0, "Bytes left after the final layer");
+}
+
+/**
+ * Los envíos grabados con ArapWorkload se reproducen en los mismos instantes y con los mismos
+ * valores, y ArapWorkload::Check() rechaza trazas desordenadas, con nodos fuera de rango o de
+ * otra red.
+ */
+class ArapWorkloadRoundTripTestCase : public TestCase
+{
+public:
+  ArapWorkloadRoundTripTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Envío grabado o reproducido.
+   */
+  struct Send
+  {
+    int64_t time;
+    uint32_t source;
+    uint32_t target;
+    uint32_t quantity;
+  };
+
+  /**
+   * Graba un envío en la traza en el instante actual.
+   */
+  void DoRecord (ArapWorkload* workload, uint32_t source, uint32_t target, uint32_t quantity);
+
+  /**
+   * Callback de la reproducción.
+   */
+  void DoDispatch (uint32_t source, uint32_t target, uint32_t quantity);
+
+  /**
+   * Escribe una traza con los envíos dados, sin verificarlos.
+   */
+  void WriteTrace (const std::string& filename, uint32_t numNodes, const std::vector<Send>& sends);
+
+  std::vector<Send> m_recorded; //!< Envíos grabados
+  std::vector<Send> m_replayed; //!< Envíos reproducidos
+};
+
+ArapWorkloadRoundTripTestCase::ArapWorkloadRoundTripTestCase ()
+  : TestCase ("ArapWorkload: record and replay round trip, invalid traces are rejected")
+{
+}
+
+void
+ArapWorkloadRoundTripTestCase::DoRecord (ArapWorkload* workload, uint32_t source, uint32_t target, uint32_t quantity)
+{
+  Send send = {Simulator::Now ().GetTimeStep (), source, target, quantity};
+  m_recorded.push_back (send);
+  workload->Record (source, target, quantity);
+}
+
+void
+ArapWorkloadRoundTripTestCase::DoDispatch (uint32_t source, uint32_t target, uint32_t quantity)
+{
+  Send send = {Simulator::Now ().GetTimeStep (), source, target, quantity};
+  m_replayed.push_back (send);
+}
+
+void
+ArapWorkloadRoundTripTestCase::WriteTrace (const std::string& filename, uint32_t numNodes, const std::vector<Send>& sends)
+{
+  FILE* file = fopen (filename.c_str (), "wb");
+  NS_TEST_ASSERT_MSG_NE ((file == NULL), true, "Could not create " << filename);
+  fwrite (ArapWorkload::WORKLOAD_MAGIC, 1, sizeof(ArapWorkload::WORKLOAD_MAGIC), file);
+  fwrite (&numNodes, sizeof(uint32_t), 1, file);
+  for (uint32_t i = 0; i < sends.size (); i++)
+    {
+      fwrite (&sends[i].time, sizeof(int64_t), 1, file);
+      fwrite (&sends[i].source, sizeof(uint32_t), 1, file);
+      fwrite (&sends[i].target, sizeof(uint32_t), 1, file);
+      fwrite (&sends[i].quantity, sizeof(uint32_t), 1, file);
+    }
+  fclose (file);
+}
+
+void
+ArapWorkloadRoundTripTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("arap-workload-test.bin");
+  uint32_t numNodes = 6;
+
+  /* Grabación, con envíos simultáneos y valores extremos */
+  ArapWorkload recorder;
+  recorder.OpenRecord (filename, numNodes);
+  NS_TEST_EXPECT_MSG_EQ (recorder.GetMode (), ArapWorkload::MODE_RECORD, "Wrong mode");
+  Simulator::Schedule (MilliSeconds (0), &ArapWorkloadRoundTripTestCase::DoRecord, this, &recorder, 0, 5, 1);
+  Simulator::Schedule (MilliSeconds (150), &ArapWorkloadRoundTripTestCase::DoRecord, this, &recorder, 3, 1, 4);
+  Simulator::Schedule (MilliSeconds (150), &ArapWorkloadRoundTripTestCase::DoRecord, this, &recorder, 1, 3, 0xFFFFFFFF);
+  Simulator::Schedule (NanoSeconds (2000000001), &ArapWorkloadRoundTripTestCase::DoRecord, this, &recorder, 5, 0, 7);
+  Simulator::Schedule (Seconds (30), &ArapWorkloadRoundTripTestCase::DoRecord, this, &recorder, 2, 4, 2);
+  Simulator::Run ();
+  recorder.Close ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (recorder.GetCount (), m_recorded.size (), "Wrong number of recorded sends");
+
+  uint64_t records = 0;
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_OK, "Recorded trace rejected");
+  NS_TEST_EXPECT_MSG_EQ (records, m_recorded.size (), "Wrong number of records");
+
+  /* Reproducción */
+  ArapWorkload player;
+  player.OpenReplay (filename, numNodes, MakeCallback (&ArapWorkloadRoundTripTestCase::DoDispatch, this));
+  Simulator::Run ();
+  player.Close ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (player.GetCount (), m_recorded.size (), "Wrong number of replayed sends");
+  NS_TEST_ASSERT_MSG_EQ (m_replayed.size (), m_recorded.size (), "Wrong number of dispatched sends");
+  for (uint32_t i = 0; i < m_recorded.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_replayed[i].time, m_recorded[i].time, "Wrong time of send " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_replayed[i].source, m_recorded[i].source, "Wrong source of send " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_replayed[i].target, m_recorded[i].target, "Wrong target of send " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_replayed[i].quantity, m_recorded[i].quantity, "Wrong quantity of send " << i);
+    }
+
+  /* Trazas inválidas: se informa el error y la cantidad de registros válidos anteriores */
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes + 1, records), ArapWorkload::STATUS_NODES,
+                         "Trace of another network accepted");
+  std::vector<Send> sends (m_recorded);
+  sends[3].time = sends[1].time - 1;
+  WriteTrace (filename, numNodes, sends);
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_UNORDERED,
+                         "Unordered trace accepted");
+  NS_TEST_EXPECT_MSG_EQ (records, 3, "Wrong number of records before the unordered one");
+  sends = m_recorded;
+  sends[2].target = numNodes;
+  WriteTrace (filename, numNodes, sends);
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_OUT_OF_RANGE,
+                         "Target out of range accepted");
+  NS_TEST_EXPECT_MSG_EQ (records, 2, "Wrong number of records before the out of range one");
+  sends = m_recorded;
+  sends[4].source = 0xFFFFFFFF;
+  WriteTrace (filename, numNodes, sends);
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_OUT_OF_RANGE,
+                         "Source out of range accepted");
+  FILE* file = fopen (filename.c_str (), "wb");
+  fputs ("ARAPWRK", file);
+  fclose (file);
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_BAD_HEADER,
+                         "Truncated header accepted");
+  remove (filename.c_str ());
+  NS_TEST_EXPECT_MSG_EQ (ArapWorkload::Check (filename, numNodes, records), ArapWorkload::STATUS_NO_FILE,
+                         "Missing trace accepted");
+}
+
+/**
+ * ArapDelayChannel entrega los paquetes con el delay de su proceso y dispara la traza
+ * "TxRxPointToPoint" con ese mismo delay, como PointToPointChannel.
+ */
+class ArapDelayChannelTraceTestCase : public TestCase
+{
+public:
+  ArapDelayChannelTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Sumidero de la traza "TxRxPointToPoint".
+   */
+  void TxRx (Ptr<const Packet> packet, Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice, Time duration, Time lastBitTime);
+
+  /**
+   * Callback de recepción del dispositivo destino.
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address& from);
+
+  std::vector<Time> m_lastBitTimes; //!< Fin de la recepción informado por la traza (Relativo al envío)
+  std::vector<Time> m_sendTimes; //!< Instante de cada envío informado por la traza
+  std::vector<Time> m_receiveTimes; //!< Instante de cada recepción
+  Ptr<NetDevice> m_rxDevice; //!< Dispositivo destino
+};
+
+ArapDelayChannelTraceTestCase::ArapDelayChannelTraceTestCase ()
+  : TestCase ("ArapDelayChannel: delay of the process and TxRxPointToPoint trace")
+{
+}
+
+void
+ArapDelayChannelTraceTestCase::TxRx (Ptr<const Packet> packet, Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice, Time duration, Time lastBitTime)
+{
+  NS_TEST_EXPECT_MSG_EQ (rxDevice, m_rxDevice, "Wrong receiving device in the trace");
+  m_sendTimes.push_back (Simulator::Now ());
+  m_lastBitTimes.push_back (lastBitTime);
+}
+
+bool
+ArapDelayChannelTraceTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address& from)
+{
+  m_receiveTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+ArapDelayChannelTraceTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetChannelType ("ArapDelayChannel");
+  pointToPoint.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  m_rxDevice = devices.Get (1);
+  m_rxDevice->SetReceiveCallback (MakeCallback (&ArapDelayChannelTraceTestCase::Receive, this));
+
+  /* Delay de 5 ms que sube a 25 ms entre 1 s y 2 s */
+  Ptr<ArapTraceDelayProcess> process = Create<ArapTraceDelayProcess> ();
+  process->AddPoint (Seconds (1), MilliSeconds (5));
+  process->AddPoint (Seconds (2), MilliSeconds (25));
+  Ptr<ArapDelayChannel> channel = DynamicCast<ArapDelayChannel> (devices.Get (0)->GetChannel ());
+  NS_TEST_ASSERT_MSG_NE (channel, 0, "The helper did not create an ArapDelayChannel");
+  channel->SetDelayProcess (process);
+  channel->TraceConnectWithoutContext ("TxRxPointToPoint", MakeCallback (&ArapDelayChannelTraceTestCase::TxRx, this));
+
+  /* 998 Bytes y la cabecera PPP de 2 Bytes: 1 ms de transmisión */
+  Time sendTimes[] = {Seconds (0.5), Seconds (1.5), Seconds (3)};
+  Time delays[] = {MilliSeconds (5), MilliSeconds (15), MilliSeconds (25)};
+  for (uint32_t i = 0; i < 3; i++)
+    Simulator::Schedule (sendTimes[i], &NetDevice::Send, devices.Get (0), Create<Packet> (998), m_rxDevice->GetAddress (), 0x0800);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sendTimes.size (), 3, "The channel did not fire TxRxPointToPoint for every packet");
+  NS_TEST_ASSERT_MSG_EQ (m_receiveTimes.size (), 3, "Packets were not received");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_sendTimes[i], sendTimes[i], "Wrong transmission start of packet " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_lastBitTimes[i], MilliSeconds (1) + delays[i], "Wrong last bit time in the trace for packet " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_receiveTimes[i], sendTimes[i] + MilliSeconds (1) + delays[i], "Wrong reception time of packet " << i);
+    }
+  m_rxDevice = 0;
+}
+
+/**
+ * DistinctCounter cuenta exacto hasta DISTINCT_EXACT_LIMIT valores distintos y luego estima
+ * con el error esperado de HyperLogLog.
+ */
+class DistinctCounterTestCase : public TestCase
+{
+public:
+  DistinctCounterTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DistinctCounterTestCase::DistinctCounterTestCase ()
+  : TestCase ("DistinctCounter: exact count up to the limit, bounded error beyond it")
+{
+}
+
+void
+DistinctCounterTestCase::DoRun (void)
+{
+  DistinctCounter counter;
+  NS_TEST_EXPECT_MSG_EQ (counter.GetCount (), 0, "Empty counter");
+  for (uint32_t repeat = 0; repeat < 3; repeat++)
+    {
+      for (uint64_t value = 0; value < DISTINCT_EXACT_LIMIT; value++)
+        counter.Add (value * 7919);
+    }
+  NS_TEST_EXPECT_MSG_EQ (counter.IsExact (), true, "The counter left the exact mode before the limit");
+  NS_TEST_EXPECT_MSG_EQ (counter.GetCount (), DISTINCT_EXACT_LIMIT, "Wrong exact count with repeated values");
+
+  /* 4 desvíos estándar de 1.04/sqrt(2^DISTINCT_PRECISION) */
+  double tolerance = 4 * 1.04 / std::sqrt ((double)(1 << DISTINCT_PRECISION));
+  uint64_t checkpoints[] = {DISTINCT_EXACT_LIMIT + 1, 1000, 20000, 500000};
+  uint64_t value = DISTINCT_EXACT_LIMIT;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      for (; value < checkpoints[i]; value++)
+        {
+          counter.Add (value * 7919);
+          counter.Add (value * 7919);
+        }
+      NS_TEST_EXPECT_MSG_EQ (counter.IsExact (), false, "The counter did not switch to the estimate");
+      NS_TEST_EXPECT_MSG_EQ_TOL (counter.GetCount () / (double)checkpoints[i], 1, tolerance,
+                                 "Estimate out of bounds for " << checkpoints[i] << " distinct values");
+    }
+}
+
+/**
+ * ArapAnonymityMetrics calcula la entropía, la min-entropía, los intermedios usados y los
+ * caminos distintos de caminos armados a mano igual que la cuenta a mano.
+ */
+class ArapAnonymityMetricsTestCase : public TestCase
+{
+public:
+  ArapAnonymityMetricsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ArapAnonymityMetricsTestCase::ArapAnonymityMetricsTestCase ()
+  : TestCase ("ArapAnonymityMetrics: entropy and diversity of hand-built paths")
+{
+}
+
+void
+ArapAnonymityMetricsTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+  ArapNodeDirectory directory;
+  directory.Build (nodes, Ipv4Address ("10.0.0.0"));
+  ArapAnonymityMetrics metrics;
+
+  /* Hacia el nodo 5: 1-2, 1-2, 2-1, 3-1 y 4. Conteos 4, 3, 1 y 1 (T = 9), 4 caminos distintos
+   * (1-2 y 2-1 son distintos). Hacia el nodo 3: un solo camino 2
+   */
+  uint32_t hops[][3] = {{1, 2, 5}, {1, 2, 5}, {2, 1, 5}, {3, 1, 5}, {4, 5, 0}, {2, 3, 0}};
+  uint32_t lengths[] = {3, 3, 3, 3, 2, 2};
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      std::list<Ipv4Address> path;
+      for (uint32_t j = 0; j < lengths[i]; j++)
+        path.push_back (directory.GetAddress (hops[i][j]));
+      metrics.Record (path, directory);
+    }
+
+  /* H = -(4/9·log2(4/9) + 3/9·log2(3/9) + 2·1/9·log2(1/9)) y Hmin = log2(9/4) */
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetPathCount (5), 5, "Wrong path count");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetDistinctPathCount (5), 4, "Wrong distinct path count");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetUsedIntermediates (5), 4, "Wrong used intermediates");
+  NS_TEST_EXPECT_MSG_EQ_TOL (metrics.GetEntropy (5), 1.7527152789797045, 1e-12, "Wrong entropy");
+  NS_TEST_EXPECT_MSG_EQ_TOL (metrics.GetMinEntropy (5), 1.1699250014423124, 1e-12, "Wrong min-entropy");
+
+  /* Un solo intermedio: sin incertidumbre */
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetPathCount (3), 1, "Wrong path count of the second target");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetDistinctPathCount (3), 1, "Wrong distinct path count of the second target");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetUsedIntermediates (3), 1, "Wrong used intermediates of the second target");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetEntropy (3), 0, "Entropy of a single intermediate");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetMinEntropy (3), 0, "Min-entropy of a single intermediate");
+
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetPathCount (4), 0, "Paths counted for a target without paths");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetEntropy (4), 0, "Entropy of a target without paths");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetTotalPaths (), 6, "Wrong total paths");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetIntermediateUsage (1), 4, "Wrong usage of node 1 over all targets");
+  NS_TEST_EXPECT_MSG_EQ (metrics.GetIntermediateUsage (2), 4, "Wrong usage of node 2 over all targets");
+  Simulator::Destroy ();
+}
+
+/**
+ * Posición inicial de un ID de hormiga en una tabla hash de RoutingTable de 2^bits posiciones
+ * (El mismo hash multiplicativo que RoutingTable::Hash()).
+ */
+static uint32_t
+RoutingTableHome (uint64_t antID, uint32_t bits)
+{
+  return (antID * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+}
+
+/**
+ * RoutingTable encuentra todas las filas luego de eliminar filas del medio de una secuencia
+ * de sondeo (Desplazamiento hacia atrás), también cuando la secuencia da la vuelta a la tabla.
+ */
+class RoutingTableProbeTestCase : public TestCase
+{
+public:
+  RoutingTableProbeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Verifica que estén en la tabla exactamente las filas de la referencia.
+   */
+  void CheckRows (const RoutingTable& table, const std::map<uint64_t, uint32_t>& reference,
+                  const std::vector<uint64_t>& erased);
+};
+
+RoutingTableProbeTestCase::RoutingTableProbeTestCase ()
+  : TestCase ("RoutingTable: rows stay reachable after erasing from the middle of a probe run")
+{
+}
+
+void
+RoutingTableProbeTestCase::CheckRows (const RoutingTable& table, const std::map<uint64_t, uint32_t>& reference,
+                                      const std::vector<uint64_t>& erased)
+{
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), reference.size (), "Wrong table size");
+  for (std::map<uint64_t, uint32_t>::const_iterator it = reference.begin (); it != reference.end (); it++)
+    {
+      const RoutingTableRow* row = table.Find (it->first);
+      NS_TEST_EXPECT_MSG_NE (row, 0, "Row " << it->first << " not found");
+      if (row != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (row->GetAntID (), it->first, "Wrong ant ID of row " << it->first);
+          NS_TEST_EXPECT_MSG_EQ (row->GetTargetIP (), Ipv4Address (it->second), "Wrong target of row " << it->first);
+        }
+    }
+  for (uint32_t i = 0; i < erased.size (); i++)
+    {
+      if (reference.find (erased[i]) == reference.end ())
+        NS_TEST_EXPECT_MSG_EQ (table.Find (erased[i]), 0, "Erased row " << erased[i] << " found");
+    }
+}
+
+void
+RoutingTableProbeTestCase::DoRun (void)
+{
+  /* La tabla empieza con 64 posiciones y crece al superar la mitad: con 24 filas no crece.
+   * Se buscan 6 IDs que caen en la posición 62, 4 en la 63 y 4 en la 0, por lo que forman
+   * una sola secuencia de sondeo que da la vuelta a la tabla
+   */
+  uint32_t homes[] = {62, 63, 0};
+  uint32_t wanted[] = {6, 4, 4};
+  std::vector<uint64_t> ids;
+  for (uint32_t h = 0; h < 3; h++)
+    {
+      uint32_t found = 0;
+      for (uint64_t id = 1; found < wanted[h]; id++)
+        {
+          if (RoutingTableHome (id, 6) == homes[h])
+            {
+              ids.push_back (id);
+              found++;
+            }
+        }
+    }
+
+  RoutingTable table;
+  table.SetRttMultiple (0);
+  std::map<uint64_t, uint32_t> reference;
+  for (uint32_t i = 0; i < ids.size (); i++)
+    {
+      table.Insert (Ipv4Address ("10.0.0.1"), Ipv4Address (i + 1), ids[i]);
+      reference[ids[i]] = i + 1;
+    }
+  CheckRows (table, reference, ids);
+
+  /* Medio de la secuencia de la posición 62, el último que cae en la 62 (Las filas de la 63 y
+   * la 0 se desplazan), el primero de la 63 y el último de la secuencia
+   */
+  uint32_t order[] = {2, 5, 6, ids.size () - 1, 0};
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (table.Remove (ids[order[i]]), true, "Remove of an existing row failed");
+      NS_TEST_EXPECT_MSG_EQ (table.Remove (ids[order[i]]), false, "Remove of an erased row succeeded");
+      reference.erase (ids[order[i]]);
+      CheckRows (table, reference, ids);
+    }
+
+  /* Reinsertar en los huecos */
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      table.Insert (Ipv4Address ("10.0.0.1"), Ipv4Address (100 + i), ids[order[i]]);
+      reference[ids[order[i]]] = 100 + i;
+    }
+  CheckRows (table, reference, ids);
+
+  /* Secuencia aleatoria de altas y bajas (Con crecimiento de la tabla) contra un std::map */
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (11);
+  std::vector<uint64_t> all (ids);
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint64_t id = random->GetInteger (1, 3000);
+      if (random->GetValue () < 0.55)
+        {
+          table.Insert (Ipv4Address ("10.0.0.1"), Ipv4Address (i + 1), id);
+          reference[id] = i + 1;
+          all.push_back (id);
+        }
+      else
+        {
+          bool existed = reference.erase (id) > 0;
+          NS_TEST_EXPECT_MSG_EQ (table.Remove (id), existed, "Remove disagrees with the reference for " << id);
+        }
+    }
+  CheckRows (table, reference, all);
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), 0, "Rows expired with expiration disabled");
+  Simulator::Destroy ();
+}
+
+/**
+ * Las filas de RoutingTable sin respuesta expiran recién luego de rttMultiple·SRTT y se
+ * cuentan como hormigas perdidas; las filas con respuesta no.
+ */
+class RoutingTableExpirationTestCase : public TestCase
+{
+public:
+  RoutingTableExpirationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Avanza la simulación hasta el instante indicado.
+   */
+  void RunUntil (Time time);
+};
+
+RoutingTableExpirationTestCase::RoutingTableExpirationTestCase ()
+  : TestCase ("RoutingTable: rows expire after rttMultiple times the SRTT and count as lost")
+{
+}
+
+void
+RoutingTableExpirationTestCase::RunUntil (Time time)
+{
+  Simulator::Stop (time - Simulator::Now ());
+  Simulator::Run ();
+}
+
+void
+RoutingTableExpirationTestCase::DoRun (void)
+{
+  Ipv4Address source ("10.0.0.1");
+  Ipv4Address target ("10.0.0.2");
+  RoutingTable table;
+  table.SetRttMultiple (2);
+
+  /* Una respuesta a 1 s: SRTT = 0.875·10 s + 0.125·1 s = 8.875 s */
+  table.Insert (source, target, 1);
+  RunUntil (Seconds (1));
+  NS_TEST_ASSERT_MSG_EQ (table.Remove (1), true, "Row not found");
+  NS_TEST_EXPECT_MSG_EQ (table.GetSmoothedRtt (), MilliSeconds (8875), "Wrong SRTT");
+
+  /* Filas 2 a 4 sin respuesta; la 5 recibe respuesta antes de expirar */
+  Time expiration = Seconds (1) + MilliSeconds (2 * 8875);
+  for (uint64_t id = 2; id <= 5; id++)
+    table.Insert (source, target, id);
+  RunUntil (Seconds (5));
+  NS_TEST_EXPECT_MSG_EQ (table.Remove (5), true, "Row removed before its expiration");
+
+  RunUntil (expiration - MilliSeconds (1));
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 3, "Rows expired before rttMultiple times the SRTT");
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), 0, "Expired rows counted too early");
+
+  /* La rueda tiene resolución de ROUTING_TABLE_WHEEL_TICK */
+  RunUntil (expiration + MilliSeconds (ROUTING_TABLE_WHEEL_TICK + 1));
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Rows without reply did not expire");
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), 3, "Wrong number of lost ants");
+  NS_TEST_EXPECT_MSG_EQ (table.Find (3), 0, "Expired row found");
+  NS_TEST_EXPECT_MSG_EQ (table.Remove (3), false, "Late reply to an expired row removed a row");
+
+  /* Expiración más larga que una vuelta de la rueda */
+  Time start = Simulator::Now ();
+  table.SetRttMultiple (10);
+  table.Insert (source, target, 6);
+  double srtt = table.GetSmoothedRtt ().GetMilliSeconds ();
+  Time longExpiration = start + MilliSeconds (10 * srtt);
+  NS_TEST_ASSERT_MSG_GT (10 * srtt, ROUTING_TABLE_WHEEL_SLOTS * ROUTING_TABLE_WHEEL_TICK, "The expiration does not wrap the wheel");
+  RunUntil (longExpiration - MilliSeconds (1));
+  NS_TEST_EXPECT_MSG_NE (table.Find (6), 0, "Row expired in an earlier turn of the wheel");
+  RunUntil (longExpiration + MilliSeconds (ROUTING_TABLE_WHEEL_TICK + 1));
+  NS_TEST_EXPECT_MSG_EQ (table.Find (6), 0, "Row did not expire after a full turn of the wheel");
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), 4, "Wrong number of lost ants");
+  Simulator::Destroy ();
+}
+
+/**
+ * RoutingTable reutiliza las filas liberadas de sus bloques de memoria sin arrastrar datos de
+ * la fila anterior (Campos, instante de inserción ni vencimiento).
+ */
+class RoutingTableSlabReuseTestCase : public TestCase
+{
+public:
+  RoutingTableSlabReuseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RoutingTableSlabReuseTestCase::RoutingTableSlabReuseTestCase ()
+  : TestCase ("RoutingTable: freed slab rows are reused without stale data")
+{
+}
+
+void
+RoutingTableSlabReuseTestCase::DoRun (void)
+{
+  RoutingTable table;
+  table.SetRttMultiple (2);
+
+  /* Más de un bloque de filas */
+  uint32_t count = ROUTING_TABLE_SLAB_ROWS + 10;
+  std::vector<const RoutingTableRow*> rows;
+  for (uint32_t i = 0; i < count; i++)
+    table.Insert (Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"), i);
+  for (uint32_t i = 0; i < count; i++)
+    rows.push_back (table.Find (i));
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < count; i++)
+    table.Remove (i);
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Rows left after removing all");
+  Time srtt = table.GetSmoothedRtt ();
+
+  /* Las filas nuevas ocupan las posiciones liberadas y solo tienen sus propios datos */
+  for (uint32_t i = 0; i < count; i++)
+    table.Insert (Ipv4Address ("10.0.1.1"), Ipv4Address ("10.0.1.2"), count + i);
+  NS_TEST_EXPECT_MSG_EQ (table.GetMaxSize (), count, "Freed rows were not reused");
+  for (uint32_t i = 0; i < count; i++)
+    {
+      const RoutingTableRow* row = table.Find (count + i);
+      NS_TEST_ASSERT_MSG_NE (row, 0, "New row not found");
+      NS_TEST_EXPECT_MSG_EQ ((std::find (rows.begin (), rows.end (), row) != rows.end ()), true,
+                             "New row outside the freed slab rows");
+      NS_TEST_EXPECT_MSG_EQ (row->GetAntID (), count + i, "Stale ant ID");
+      NS_TEST_EXPECT_MSG_EQ (row->GetSourceIP (), Ipv4Address ("10.0.1.1"), "Stale source");
+      NS_TEST_EXPECT_MSG_EQ (row->GetTargetIP (), Ipv4Address ("10.0.1.2"), "Stale target");
+      NS_TEST_EXPECT_MSG_EQ (table.Find (i), 0, "Freed row still found by its old ID");
+    }
+
+  /* La respuesta inmediata usa el instante de inserción nuevo (RTT 0), no el de la fila anterior */
+  table.Remove (count);
+  NS_TEST_EXPECT_MSG_EQ_TOL (table.GetSmoothedRtt ().GetMilliSeconds (), 0.875 * srtt.GetMilliSeconds (), 1,
+                             "RTT sample used the insertion time of the previous row");
+
+  /* Las filas reutilizadas vencen a 2·SRTT de su propia inserción (Antes que las filas
+   * anteriores, insertadas con el RTT inicial), y la rueda quedó consistente
+   */
+  Time expiration = Seconds (3) + MilliSeconds (2 * srtt.GetMilliSeconds ());
+  NS_TEST_ASSERT_MSG_LT (expiration, MilliSeconds (2 * ROUTING_TABLE_INITIAL_RTT), "The previous rows would expire first");
+  Simulator::Stop (expiration - MilliSeconds (1) - Simulator::Now ());
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), 0, "Reused rows expired before their expiration");
+  Simulator::Stop (MilliSeconds (ROUTING_TABLE_WHEEL_TICK + 2));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Reused rows did not expire");
+  NS_TEST_EXPECT_MSG_EQ (table.GetExpiredCount (), count - 1, "Wrong number of lost ants");
+  Simulator::Destroy ();
+}
+
+/**
+ * SparsePathManager creado con un directorio propio, para probarlo sin la simulación.
+ */
+class TestSparsePathManager : public SparsePathManager
+{
+public:
+  TestSparsePathManager (uint32_t candidates, uint32_t rotation, const ArapNodeDirectory& directory,
+                         const Ipv4Address& localIP, uint32_t numHops)
+    : SparsePathManager (candidates, rotation, DEFAULT_C1, DEFAULT_C2, DEFAULT_ZETA, DEFAULT_WMAX, DEFAULT_VARSIGMA)
+  {
+    InitModels (directory);
+    AllocateCandidates (directory, localIP, numHops);
+  }
+
+  std::vector<uint32_t> Sample (uint32_t targetIndex, uint32_t count)
+  {
+    std::list<Ipv4Address> path;
+    SampleCandidates (targetIndex, count, path);
+    std::vector<uint32_t> indexes;
+    for (std::list<Ipv4Address>::iterator it = path.begin (); it != path.end (); it++)
+      indexes.push_back (m_directory->GetIndex (*it));
+    return indexes;
+  }
+};
+
+/**
+ * SparsePathManager: muestreo sin reemplazo entre los K candidatos, rotación de candidatos
+ * sin repetir nodos ni elegir el nodo local o el destino, importación de los K mayores y
+ * filas que suman 1 (En float) luego de cada actualización.
+ */
+class SparsePathManagerTestCase : public TestCase
+{
+public:
+  SparsePathManagerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Verifica que la fila tenga K candidatos distintos, ninguno el nodo local ni el destino,
+   * y que sus probabilidades sumen 1.
+   *
+   * @return Candidatos de la fila
+   */
+  std::set<uint32_t> CheckRow (const SparsePathManager& manager, uint32_t localIndex, uint32_t targetIndex,
+                               uint32_t candidates, const std::string& when);
+
+  ArapNodeDirectory m_directory; //!< Directorio de 12 nodos
+};
+
+SparsePathManagerTestCase::SparsePathManagerTestCase ()
+  : TestCase ("SparsePathManager: sampling, rotation and import over the K candidates")
+{
+}
+
+std::set<uint32_t>
+SparsePathManagerTestCase::CheckRow (const SparsePathManager& manager, uint32_t localIndex, uint32_t targetIndex,
+                                     uint32_t candidates, const std::string& when)
+{
+  std::vector<uint32_t> mediums;
+  manager.GetExplorerMediums (targetIndex, mediums);
+  std::set<uint32_t> unique (mediums.begin (), mediums.end ());
+  NS_TEST_EXPECT_MSG_EQ (mediums.size (), candidates, "Wrong number of candidates " << when);
+  NS_TEST_EXPECT_MSG_EQ (unique.size (), mediums.size (), "Repeated candidate " << when);
+  NS_TEST_EXPECT_MSG_EQ ((unique.count (localIndex) == 0), true, "The local node is a candidate " << when);
+  NS_TEST_EXPECT_MSG_EQ ((unique.count (targetIndex) == 0), true, "The target is a candidate " << when);
+  NS_TEST_EXPECT_MSG_EQ ((*unique.rbegin () < m_directory.GetCount ()), true, "Invalid candidate " << when);
+
+  std::vector<std::pair<uint32_t, double> > row;
+  manager.ExportRow (targetIndex, row);
+  double sum = 0;
+  for (uint32_t j = 0; j < row.size (); j++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((unique.count (row[j].first) == 1), true, "Probability outside the candidates " << when);
+      sum += row[j].second;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (sum, 1, 1e-6, "The row does not add up to 1 " << when);
+  return unique;
+}
+
+void
+SparsePathManagerTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (7);
+  NodeContainer nodes;
+  nodes.Create (12);
+  m_directory.Build (nodes, Ipv4Address ("10.0.0.0"));
+  uint32_t localIndex = 3;
+  uint32_t targetIndex = 7;
+  uint32_t candidates = 5;
+  TestSparsePathManager manager (candidates, 0, m_directory, m_directory.GetAddress (localIndex), 4);
+  for (uint32_t i = 0; i < m_directory.GetCount (); i++)
+    {
+      if (i != localIndex)
+        CheckRow (manager, localIndex, i, candidates, "after creating the table");
+    }
+
+  /* Importación: se ignoran el nodo local y el destino, quedan los 5 mayores (1, 9, 4, 6 y 8,
+   * que suman 0.98) renormalizados
+   */
+  double weights[12] = {0.05, 0.3, 0, 0.9, 0.2, 0.02, 0.15, 0.5, 0.08, 0.25, 0.01, 0};
+  std::map<Ipv4Address, std::map<Ipv4Address, double> > table;
+  for (uint32_t j = 0; j < 12; j++)
+    table[m_directory.GetAddress (targetIndex)][m_directory.GetAddress (j)] = weights[j];
+  /* Fila con menos de K valores: se completa con intermedios sin probabilidad */
+  table[m_directory.GetAddress (0)][m_directory.GetAddress (5)] = 0.6;
+  table[m_directory.GetAddress (0)][m_directory.GetAddress (9)] = 0.2;
+  manager.ImportProbTable (table);
+
+  std::vector<double> expected (12, 0);
+  uint32_t top[] = {1, 9, 4, 6, 8};
+  for (uint32_t j = 0; j < 5; j++)
+    expected[top[j]] = weights[top[j]] / 0.98;
+  std::set<uint32_t> imported = CheckRow (manager, localIndex, targetIndex, candidates, "after importing");
+  NS_TEST_EXPECT_MSG_EQ ((imported == std::set<uint32_t> (top, top + 5)), true, "The import did not keep the top K");
+  for (uint32_t j = 0; j < 5; j++)
+    NS_TEST_EXPECT_MSG_EQ_TOL (manager.GetProbability (m_directory.GetAddress (targetIndex), m_directory.GetAddress (top[j])),
+                               expected[top[j]], 1e-6, "Imported probability of node " << top[j]);
+  std::set<uint32_t> padded = CheckRow (manager, localIndex, 0, candidates, "after importing a short row");
+  NS_TEST_EXPECT_MSG_EQ ((padded.count (5) + padded.count (9)), 2, "The import dropped a value of a short row");
+  NS_TEST_EXPECT_MSG_EQ_TOL (manager.GetProbability (m_directory.GetAddress (0), m_directory.GetAddress (5)), 0.75, 1e-6,
+                             "Short row not renormalized");
+
+  /* Muestreo sin reemplazo entre los candidatos importados. Primer salto: p(i). Segundo salto:
+   * suma sobre el primero k de p(k)·p(i)/(1-p(k))
+   */
+  uint32_t paths = 100000;
+  std::vector<std::vector<uint32_t> > counts (2, std::vector<uint32_t> (12, 0));
+  for (uint32_t n = 0; n < paths; n++)
+    {
+      std::vector<uint32_t> path = manager.Sample (targetIndex, 3);
+      NS_TEST_EXPECT_MSG_EQ (path.size (), 3, "Wrong number of intermediates");
+      for (uint32_t hop = 0; hop < path.size (); hop++)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((imported.count (path[hop]) == 1), true, "Intermediate outside the candidates");
+          NS_TEST_EXPECT_MSG_EQ ((std::count (path.begin (), path.end (), path[hop]) == 1), true, "Repeated intermediate");
+        }
+      counts[0][path[0]]++;
+      counts[1][path[1]]++;
+    }
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      double second = 0;
+      for (uint32_t k = 0; k < 12; k++)
+        {
+          if (k != i && expected[k] > 0)
+            second += expected[k] * expected[i] / (1 - expected[k]);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (counts[0][i] / (double)paths, expected[i], 0.006, "First hop frequency of node " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (counts[1][i] / (double)paths, second, 0.006, "Second hop frequency of node " << i);
+    }
+  std::vector<uint32_t> all = manager.Sample (targetIndex, candidates);
+  NS_TEST_EXPECT_MSG_EQ ((std::set<uint32_t> (all.begin (), all.end ()) == imported), true, "A path of K hops is not a permutation of the candidates");
+
+  /* Respuestas de exploradoras sin rotación: los candidatos no cambian y la fila suma 1 */
+  Ptr<UniformRandomVariable> rtt = CreateObject<UniformRandomVariable> ();
+  rtt->SetStream (3);
+  for (uint32_t n = 0; n < 200; n++)
+    {
+      manager.HandleExplorer (m_directory.GetAddress (targetIndex), m_directory.GetAddress (top[n % 5]),
+                              MilliSeconds (rtt->GetInteger (20, 80)));
+      std::ostringstream when;
+      when << "after explorer " << n;
+      NS_TEST_EXPECT_MSG_EQ ((CheckRow (manager, localIndex, targetIndex, candidates, when.str ()) == imported), true,
+                             "Candidates changed without rotation");
+    }
+
+  /* Rotación luego de cada respuesta: entra un único intermedio que no era candidato */
+  TestSparsePathManager rotating (candidates, 1, m_directory, m_directory.GetAddress (localIndex), 4);
+  for (uint32_t n = 0; n < 300; n++)
+    {
+      std::vector<uint32_t> mediums;
+      rotating.GetExplorerMediums (targetIndex, mediums);
+      std::set<uint32_t> before (mediums.begin (), mediums.end ());
+      rotating.HandleExplorer (m_directory.GetAddress (targetIndex), m_directory.GetAddress (mediums[n % candidates]),
+                               MilliSeconds (rtt->GetInteger (20, 80)));
+      std::ostringstream when;
+      when << "after rotation " << n;
+      std::set<uint32_t> after = CheckRow (rotating, localIndex, targetIndex, candidates, when.str ());
+      uint32_t entered = 0;
+      for (std::set<uint32_t>::iterator it = after.begin (); it != after.end (); it++)
+        entered += before.count (*it) == 0;
+      NS_TEST_EXPECT_MSG_EQ (entered, 1, "The rotation did not replace exactly one candidate with an outsider");
+    }
+  rotating.ImportProbTable (table);
+  CheckRow (rotating, localIndex, targetIndex, candidates, "after importing into a rotated row");
+
+  /* K mayor que los intermedios: la fila tiene a todos y la rotación no cambia nada */
+  TestSparsePathManager full (20, 1, m_directory, m_directory.GetAddress (localIndex), 4);
+  std::set<uint32_t> everyone = CheckRow (full, localIndex, targetIndex, 10, "with every intermediate as candidate");
+  for (uint32_t n = 0; n < 50; n++)
+    {
+      full.HandleExplorer (m_directory.GetAddress (targetIndex), m_directory.GetAddress (top[n % 5]),
+                           MilliSeconds (rtt->GetInteger (20, 80)));
+      NS_TEST_EXPECT_MSG_EQ ((CheckRow (full, localIndex, targetIndex, 10, "after rotating a full row") == everyone), true,
+                             "A full row changed its candidates");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * SmartPathManager con filas asignables, para aplicar recompensas sin la simulación.
+ */
+class TestSmartPathManager : public SmartPathManager
+{
+public:
+  TestSmartPathManager (const ArapNodeDirectory& directory, const Ipv4Address& localIP)
+  {
+    InitModels (directory);
+    AllocateTable (directory, localIP);
+  }
+
+  void SetRow (uint32_t targetIndex, const std::vector<double>& row)
+  {
+    std::copy (row.begin (), row.end (), GetRow (targetIndex));
+    InvalidateRow (targetIndex);
+  }
+
+  std::vector<double> GetRowCopy (uint32_t targetIndex)
+  {
+    return std::vector<double> (GetRow (targetIndex), GetRow (targetIndex) + m_numNodes);
+  }
+
+  /**
+   * Aplica las recompensas (Intermedio, R) en un solo llamado a ApplyRewards() (fused) o
+   * con un llamado por recompensa.
+   */
+  void Apply (uint32_t targetIndex, const std::vector<std::pair<uint32_t, double> >& rewards, bool fused)
+  {
+    std::vector<PendingReward> pending;
+    for (uint32_t k = 0; k < rewards.size (); k++)
+      {
+        PendingReward reward;
+        reward.medium = rewards[k].first;
+        reward.reward = rewards[k].second;
+        pending.push_back (reward);
+        if (!fused)
+          {
+            ApplyRewards (targetIndex, pending);
+            pending.clear ();
+          }
+      }
+    if (fused)
+      ApplyRewards (targetIndex, pending);
+  }
+};
+
+/**
+ * SmartPathManager::ApplyRewards() con varias recompensas juntas da las mismas filas que
+ * aplicarlas una a una y que la actualización original (Incremento, reducción y reparto del
+ * excedente de MAX_PROB), con recompensas repetidas sobre el mismo intermedio.
+ */
+class SmartPathManagerRewardsTestCase : public TestCase
+{
+public:
+  SmartPathManagerRewardsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SmartPathManagerRewardsTestCase::SmartPathManagerRewardsTestCase ()
+  : TestCase ("SmartPathManager: fused rewards match applying them one by one")
+{
+}
+
+void
+SmartPathManagerRewardsTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (10);
+  ArapNodeDirectory directory;
+  directory.Build (nodes, Ipv4Address ("10.0.0.0"));
+  uint32_t numNodes = 10;
+  uint32_t localIndex = 2;
+  TestSmartPathManager fused (directory, directory.GetAddress (localIndex));
+  TestSmartPathManager sequential (directory, directory.GetAddress (localIndex));
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (5);
+
+  uint32_t clamped = 0;
+  for (uint32_t targetIndex = 0; targetIndex < numNodes; targetIndex++)
+    {
+      if (targetIndex == localIndex)
+        continue;
+      std::vector<double> row (numNodes, 0);
+      double total = 0;
+      for (uint32_t i = 0; i < numNodes; i++)
+        {
+          if (i != localIndex && i != targetIndex)
+            {
+              row[i] = random->GetValue (0.1, 1);
+              total += row[i];
+            }
+        }
+      for (uint32_t i = 0; i < numNodes; i++)
+        row[i] /= total;
+      fused.SetRow (targetIndex, row);
+      sequential.SetRow (targetIndex, row);
+
+      /* La primera fila usa una secuencia fija con intermedios repetidos y recompensas que
+       * superan MAX_PROB, las demás secuencias al azar
+       */
+      std::vector<std::pair<uint32_t, double> > rewards;
+      if (targetIndex == 0)
+        {
+          uint32_t mediums[] = {1, 4, 1, 4, 7, 3, 7, 7};
+          double values[] = {0.3, 0.95, 0.2, 0.5, 0.85, 0.1, 0.6, 0.99};
+          for (uint32_t k = 0; k < 8; k++)
+            rewards.push_back (std::make_pair (mediums[k], values[k]));
+        }
+      else
+        {
+          uint32_t count = random->GetInteger (1, 12);
+          for (uint32_t k = 0; k < count; k++)
+            {
+              uint32_t medium = random->GetInteger (0, numNodes - 1);
+              while (medium == localIndex || medium == targetIndex)
+                medium = random->GetInteger (0, numNodes - 1);
+              rewards.push_back (std::make_pair (medium, random->GetValue (0, 1)));
+            }
+        }
+
+      /* Referencia: la actualización original, una recompensa por vez */
+      for (uint32_t k = 0; k < rewards.size (); k++)
+        {
+          uint32_t medium = rewards[k].first;
+          double reward = rewards[k].second;
+          for (uint32_t i = 0; i < numNodes; i++)
+            {
+              if (i == medium)
+                row[i] = row[i] + reward * (1 - row[i]);
+              else if (i != localIndex && i != targetIndex)
+                row[i] = row[i] - reward * row[i];
+            }
+          if (row[medium] > MAX_PROB)
+            {
+              double gain = (row[medium] - MAX_PROB) / (numNodes - 2 - 1);
+              row[medium] = MAX_PROB;
+              for (uint32_t i = 0; i < numNodes; i++)
+                {
+                  if (i != medium && i != localIndex && i != targetIndex)
+                    row[i] = row[i] + gain;
+                }
+              clamped++;
+            }
+        }
+
+      fused.Apply (targetIndex, rewards, true);
+      sequential.Apply (targetIndex, rewards, false);
+      std::vector<double> fusedRow = fused.GetRowCopy (targetIndex);
+      std::vector<double> sequentialRow = sequential.GetRowCopy (targetIndex);
+      double sum = 0;
+      for (uint32_t i = 0; i < numNodes; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (fusedRow[i], sequentialRow[i], 1e-12, "Fused and one by one differ at row " << targetIndex << " column " << i);
+          NS_TEST_EXPECT_MSG_EQ_TOL (fusedRow[i], row[i], 1e-12, "Fused and the reference differ at row " << targetIndex << " column " << i);
+          sum += fusedRow[i];
+        }
+      NS_TEST_EXPECT_MSG_EQ (fusedRow[localIndex], 0, "Probability on the local node");
+      NS_TEST_EXPECT_MSG_EQ (fusedRow[targetIndex], 0, "Probability on the target");
+      NS_TEST_EXPECT_MSG_EQ_TOL (sum, 1, 1e-12, "Row " << targetIndex << " does not add up to 1");
+    }
+  NS_TEST_EXPECT_MSG_GT (clamped, 3, "The sequences did not exercise the MAX_PROB clamp");
+  Simulator::Destroy ();
+}
+
+/**
+ * ArapAbstractNetwork entrega las hormigas de cada cola en orden aunque el delay del enlace
+ * baje entre dos envíos.
+ */
+class ArapAbstractNetworkOrderTestCase : public TestCase
+{
+public:
+  ArapAbstractNetworkOrderTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Envía una hormiga y registra el instante de su llegada.
+   */
+  void Send (uint32_t source, uint32_t target);
+
+  ArapAbstractNetwork m_network; //!< Red de 3 nodos
+  std::vector<Time> m_arrivals; //!< Instante de llegada de cada hormiga, en orden de envío
+};
+
+ArapAbstractNetworkOrderTestCase::ArapAbstractNetworkOrderTestCase ()
+  : TestCase ("ArapAbstractNetwork: ants are not reordered when the link delay drops")
+{
+}
+
+void
+ArapAbstractNetworkOrderTestCase::Send (uint32_t source, uint32_t target)
+{
+  m_arrivals.push_back (Simulator::Now () + m_network.Transmit (source, target, 958));
+}
+
+void
+ArapAbstractNetworkOrderTestCase::DoRun (void)
+{
+  /* 1000 Bytes con las cabeceras a 8 Mbps: 1 ms por cola sin tráfico previo */
+  m_network.Build (3, 8000000);
+  for (uint32_t i = 0; i < 3; i++)
+    m_network.SetDataRate (i, 8000000);
+  m_network.SetLinkDelay (0, MilliSeconds (40));
+  m_network.SetLinkDelay (1, MilliSeconds (10));
+  m_network.SetLinkDelay (2, MilliSeconds (10));
+
+  /* El delay del nodo 0 baja de 40 ms a 1 ms entre el primer y el segundo envío hacia el
+   * nodo 1, y el nodo 2 envía al nodo 1 por un enlace rápido mientras tanto
+   */
+  Simulator::Schedule (Seconds (0), &ArapAbstractNetworkOrderTestCase::Send, this, 0, 1);
+  Simulator::Schedule (MilliSeconds (5), &ArapAbstractNetwork::SetLinkDelay, &m_network, 0, MilliSeconds (1));
+  Simulator::Schedule (MilliSeconds (6), &ArapAbstractNetworkOrderTestCase::Send, this, 0, 1);
+  Simulator::Schedule (MilliSeconds (7), &ArapAbstractNetworkOrderTestCase::Send, this, 2, 1);
+  Simulator::Schedule (Seconds (10), &ArapAbstractNetworkOrderTestCase::Send, this, 0, 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_arrivals.size (), 4, "Wrong number of ants");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_arrivals[0].GetSeconds (), 0.052, 1e-4, "Wrong arrival without previous traffic");
+  for (uint32_t i = 1; i < 3; i++)
+    NS_TEST_EXPECT_MSG_EQ ((m_arrivals[i] >= m_arrivals[i - 1]), true, "Ant " << i << " overtook the previous one");
+  /* Luego de que se vacían las colas el delay nuevo se aplica sin esperas */
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_arrivals[3].GetSeconds (), 10.013, 1e-4, "Wrong arrival with the new delay");
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +1680,23 @@ AnonymityTestSuite::AnonymityTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new AnonymityTestCase1, TestCase::QUICK);
+  AddTestCase (new QuantileSketchAccuracyTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileSketchCollapseTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileSketchMergeTestCase, TestCase::QUICK);
+  AddTestCase (new LoadAntsStatisticsMomentsTestCase, TestCase::QUICK);
+  AddTestCase (new LoadAntsStatisticsSerializeTestCase, TestCase::QUICK);
+  AddTestCase (new SampleIntermediatesTestCase, TestCase::QUICK);
+  AddTestCase (new SparsePathManagerTestCase, TestCase::QUICK);
+  AddTestCase (new SmartPathManagerRewardsTestCase, TestCase::QUICK);
+  AddTestCase (new ArapAntHeaderRoundTripTestCase, TestCase::QUICK);
+  AddTestCase (new ArapWorkloadRoundTripTestCase, TestCase::QUICK);
+  AddTestCase (new ArapDelayChannelTraceTestCase, TestCase::QUICK);
+  AddTestCase (new ArapAbstractNetworkOrderTestCase, TestCase::QUICK);
+  AddTestCase (new DistinctCounterTestCase, TestCase::QUICK);
+  AddTestCase (new ArapAnonymityMetricsTestCase, TestCase::QUICK);
+  AddTestCase (new RoutingTableProbeTestCase, TestCase::QUICK);
+  AddTestCase (new RoutingTableExpirationTestCase, TestCase::QUICK);
+  AddTestCase (new RoutingTableSlabReuseTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -73,6 +73,12 @@ PointToPointHelper::SetChannelAttribute (std::string n1, const AttributeValue &v
   m_remoteChannelFactory.Set (n1, v1);
 }
 
+void 
+PointToPointHelper::SetChannelType (std::string type)
+{
+  m_channelFactory.SetTypeId (type);
+}
+
 void 
 PointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
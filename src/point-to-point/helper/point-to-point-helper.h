@@ -100,6 +100,16 @@ public:
    */
   void SetChannelAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * Set the type of the local channels created by the helper.
+   *
+   * \param type the type of channel, a subclass of ns3::PointToPointChannel
+   *
+   * Remote channels (used when MPI is enabled and the nodes are in different
+   * ranks) are always ns3::PointToPointRemoteChannel.
+   */
+  void SetChannelType (std::string type);
+
   /**
    * \param c a set of nodes
    * \return a NetDeviceContainer for nodes
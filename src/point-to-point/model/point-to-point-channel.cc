@@ -102,7 +102,7 @@ PointToPointChannel::TransmitStart (
                                   m_link[wire].m_dst, p);
 
   // Call the tx anim callback on the net device
-  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+  TxRxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
   return true;
 }
 
@@ -146,6 +146,13 @@ PointToPointChannel::GetDestination (uint32_t i) const
   return m_link[i].m_dst;
 }
 
+void
+PointToPointChannel::TxRxPointToPoint (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
+                                       Ptr<PointToPointNetDevice> dst, Time txTime, Time rxTime)
+{
+  m_txrxPointToPoint (p, src, dst, txTime, rxTime);
+}
+
 bool
 PointToPointChannel::IsInitialized (void) const
 {
@@ -129,6 +129,21 @@ protected:
    */
   Ptr<PointToPointNetDevice> GetDestination (uint32_t i) const;
 
+  /**
+   * \brief Fire the packet transmission animation trace
+   *
+   * Lets subclasses that override TransmitStart keep the TxRxPointToPoint
+   * trace source.
+   *
+   * \param p the packet being transmitted
+   * \param src the transmitting net-device
+   * \param dst the receiving net-device
+   * \param txTime the amount of time to transmit the packet
+   * \param rxTime last bit receive time (relative to now)
+   */
+  void TxRxPointToPoint (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
+                         Ptr<PointToPointNetDevice> dst, Time txTime, Time rxTime);
+
   /**
    * TracedCallback signature for packet transmission animation events.
    *